@@ -9,11 +9,13 @@
 #include <stdint.h>
 #include <string.h>
 #include "queue.h"
+#include "pool.h"
 #include "scheduler.h"
 #include "hel_lcd.h"
 
-/* For testing purpose, when the macro UTEST is defined the safe_sate function is not used */
-#ifndef UTEST
+/* For testing purpose, when the macro UTEST is defined the safe_sate function is not used, except in
+the host simulation (SIM) that provides its own safe_state to report the error */
+#if !defined( UTEST ) || defined( SIM )
 #define assert_error(expr, error)           ((expr) ? (void)0U : safe_state(__FILE__, __LINE__, (error))) /*!< Macro to handle errrors */
 extern void safe_state( const char *file, uint32_t line, uint8_t error );
 
@@ -32,7 +34,12 @@ extern void safe_state( const char *file, uint32_t line, uint8_t error );
 #define PERIOD_DISPLAY_TASK     100u        /*!< Display task periodicity */
 #define PERIOD_LCD_TASK         50u         /*!< Task to control LCD intensity and contrast periodicity */
 #define TASKS_N                 6u          /*!< Number of tasks registered in the scheduler */
-#define TIMERS_N                3u          /*!< Number of timers registered in the scheduler */
+#ifdef CPU_LOAD_CAN
+#define TIMERS_N                6u          /*!< Number of timers registered in the scheduler, two for ISO-TP and one sends the CPU load */
+#else
+#define TIMERS_N                5u          /*!< Number of timers registered in the scheduler, two for ISO-TP */
+#endif
+#define FRAMES_N                120u        /*!< Size of the frame table, 60 ticks of hyperperiod plus 48 task runs */
 
 /**
  * @brief   Variable with external linkage that is used to configure interrupt in ints.c file.
@@ -40,10 +47,16 @@ extern void safe_state( const char *file, uint32_t line, uint8_t error );
 extern FDCAN_HandleTypeDef CANHandler;
 
 /** @brief  ClockQueue external reference */
-extern AppQue_Queue ClockQueue;
+extern AppQue_PrioQueue ClockQueue;
+
+/** @brief  Event flag set by the CAN queue to activate the serial task */
+extern volatile uint8_t SerialEvent;
+
+/** @brief  Event flag set by the ClockQueue to activate the clock task */
+extern volatile uint8_t ClockEvent;
 
-/** @brief  DisplayQueue external reference */
-extern AppQue_Queue DisplayQueue;
+/** @brief  Event flag set by the DisplayQueue to activate the display task */
+extern volatile uint8_t DisplayEvent;
 
 /** @brief  Scheduler external reference */
 extern AppSched_Scheduler Scheduler;
@@ -63,6 +76,9 @@ extern SPI_HandleTypeDef SPI_Handler;
 /** @brief  TIM6 Handler external reference */
 extern TIM_HandleTypeDef TIM6_Handler;
 
+/** @brief  TIM7 Handler external reference */
+extern TIM_HandleTypeDef TIM7_Handler;
+
 /** @brief  Update Timer ID external reference */
 extern uint8_t UpdateTimerID;
 
@@ -72,6 +88,15 @@ extern uint8_t TimerAlarmActiveOneSecond_ID;
 /** @brief  Variable to save the TimerAlarmActiveOneMinute_ID ID */
 extern uint8_t TimerDeactivateAlarm_ID;
 
+/** @brief  Load Timer ID external reference */
+extern uint8_t LoadTimerID;
+
+/** @brief  ISO-TP RX Timer ID external reference */
+extern uint8_t TpRxTimerID;
+
+/** @brief  ISO-TP TX Timer ID external reference */
+extern uint8_t TpTxTimerID;
+
 /** @brief TIM3 Handler external reference */
 extern TIM_HandleTypeDef TIM3_Handler;
 
@@ -85,6 +110,8 @@ typedef enum {
     SERIAL_MSG_ALARM,       /*!< Msg type alarm */
     SERIAL_MSG_OK,          /*!< Msg type ok */
     SERIAL_MSG_ERROR,       /*!< Msg type error */
+    SERIAL_MSG_LOAD,        /*!< Msg type CPU load */
+    SERIAL_MSG_CONFIG,      /*!< Msg type CONFIG, an ISO-TP frame of the CONFIG ID */
     SERIAL_N_EVENTS,        /*!< Number of events */
     SERIAL_MSG_NONE         /*!< Msg type none */
 } APP_Messages;
@@ -122,6 +149,7 @@ typedef struct _App_CanTypeDef
     uint16_t id;            /*!< CAN message ID*/
     uint8_t bytes[ 8u ];    /*!< CAN message*/
     uint8_t lenght;         /*!< CAN messsge lenght*/
+    uint8_t event;          /*!< Msg type of a frame received, from the filter that accepted it*/
 } APP_CanTypeDef;
 
 /**
@@ -202,7 +230,9 @@ typedef enum _App_ErrorsCode
     POT0_H_READING_ERROR,
     POT0_L_READING_ERROR,
     POT1_H_READING_ERROR,
-    POT1_L_READING_ERROR
+    POT1_L_READING_ERROR,
+    POOL_RET_ERROR,
+    POOL_PAR_ERROR
 
 } App_ErrorsCode;
 
@@ -5,18 +5,30 @@
  */
 #include "clock.h"
 #include "bsp.h"
+#include "display.h"
 #include "analogs.h"
 
-#define N_MESSAGES_CLKQUEUE 20u     /*!< Number of messages in ClkQueue (20)*/
+#define CLOCK_LEVELS        3u      /*!< Priority levels of ClockQueue */
+#define CLOCK_LEVEL_USER    0u      /*!< Level of the alarm and button events, the highest */
+#define CLOCK_LEVEL_CONFIG  1u      /*!< Level of the time, date and alarm settings */
+#define CLOCK_LEVEL_DISPLAY 2u      /*!< Level of the display refreshes, the lowest */
+#define N_MSGS_LEVEL_USER   8u      /*!< Number of messages in the user events lane, power of two */
+#define N_MSGS_LEVEL_CONFIG 32u     /*!< Number of messages in the settings lane, power of two */
+#define N_MSGS_LEVEL_DISPLAY 8u     /*!< Number of messages in the display lane, power of two */
 #define CENTENARY           100u    /*!< Value of a centenary */
 #define TIM14_PRESCALER     40U     /*!< Value of the TIM14 prescaler */
 #define TIM14_PERIOD        1600u   /*!< Value of the TIM14 period */
 #define BUZZER_DUTY_CYCLE   (TIM14_Handler.Init.Period / 2) /*!< 50% of duty cycle, TIM14 channel */
 
 /**
- * @brief Queue to communicate serial and clock tasks.
+ * @brief Queue to communicate serial and clock tasks, with a lane for each priority level.
  */
-AppQue_Queue ClockQueue;
+AppQue_PrioQueue ClockQueue;
+
+/**
+ * @brief Flag set by each write in the ClockQueue lanes, the clock task is bound to it in main.c.
+ */
+volatile uint8_t ClockEvent;
 
 /**
  * @brief   RTC structure
@@ -60,6 +72,12 @@ STATIC APP_MsgTypeDef Clock_ButtonReleased( APP_MsgTypeDef *PtrMsgClk );
 
 STATIC APP_MsgTypeDef Clock_GetAlarm( APP_MsgTypeDef *PtrMsgClk );
 
+STATIC unsigned char Clock_MsgLevel( const void *data );
+
+STATIC unsigned char Clock_Coalesce( const void *data, const void *element );
+
+STATIC unsigned char Clock_DisplayCoalesce( const APP_MsgTypeDef *data, const APP_MsgTypeDef *element );
+
 /**
  * @brief   Function to initialize RTC module and ClkQueue.
  *
@@ -99,7 +117,15 @@ void Clock_InitTask( void )
     assert_error( Status == HAL_OK, TIM_RET_ERROR );
 
     /*Clock Queue config*/
-    static APP_MsgTypeDef messagesClock[ N_MESSAGES_CLKQUEUE ];
+    static APP_MsgTypeDef messagesUser[ N_MSGS_LEVEL_USER ];
+    static APP_MsgTypeDef messagesConfig[ N_MSGS_LEVEL_CONFIG ];
+    static APP_MsgTypeDef messagesDisplay[ N_MSGS_LEVEL_DISPLAY ];
+    static AppQue_Queue ClockLanes[ CLOCK_LEVELS ];
+#ifdef QUEUE_STATS
+    static unsigned long stampsUser[ N_MSGS_LEVEL_USER ];       /*ticks when each message was written*/
+    static unsigned long stampsConfig[ N_MSGS_LEVEL_CONFIG ];
+    static unsigned long stampsDisplay[ N_MSGS_LEVEL_DISPLAY ];
+#endif
 
     GPIO_InitTypeDef GPIO_InitStruct;
 
@@ -114,10 +140,30 @@ void Clock_InitTask( void )
     HAL_NVIC_SetPriority( EXTI4_15_IRQn, 2, 0 );
     HAL_NVIC_EnableIRQ( EXTI4_15_IRQn );
 
-    ClockQueue.Buffer   = messagesClock;
-    ClockQueue.Elements = N_MESSAGES_CLKQUEUE;
-    ClockQueue.Size     = sizeof( APP_MsgTypeDef );
-    AppQueue_initQueue( &ClockQueue );
+    ClockLanes[ CLOCK_LEVEL_USER ].Buffer       = messagesUser;
+    ClockLanes[ CLOCK_LEVEL_USER ].Elements     = N_MSGS_LEVEL_USER;
+    ClockLanes[ CLOCK_LEVEL_CONFIG ].Buffer     = messagesConfig;
+    ClockLanes[ CLOCK_LEVEL_CONFIG ].Elements   = N_MSGS_LEVEL_CONFIG;
+    ClockLanes[ CLOCK_LEVEL_DISPLAY ].Buffer    = messagesDisplay;
+    ClockLanes[ CLOCK_LEVEL_DISPLAY ].Elements  = N_MSGS_LEVEL_DISPLAY;
+#ifdef QUEUE_STATS
+    ClockLanes[ CLOCK_LEVEL_USER ].Stats.Stamps     = stampsUser;
+    ClockLanes[ CLOCK_LEVEL_CONFIG ].Stats.Stamps   = stampsConfig;
+    ClockLanes[ CLOCK_LEVEL_DISPLAY ].Stats.Stamps  = stampsDisplay;
+#endif
+
+    for( uint8_t i = 0; i < CLOCK_LEVELS; i++ )
+    {
+        ClockLanes[ i ].Size = sizeof( APP_MsgTypeDef );
+        ClockLanes[ i ].Pow2 = TRUE;
+        ClockLanes[ i ].Event = &ClockEvent;
+    }
+    ClockLanes[ CLOCK_LEVEL_DISPLAY ].Coalesce = Clock_Coalesce;   /*only one pending display refresh*/
+
+    ClockQueue.Lanes    = ClockLanes;
+    ClockQueue.Levels   = CLOCK_LEVELS;
+    ClockQueue.Level    = Clock_MsgLevel;
+    AppQueue_initPrioQueue( &ClockQueue );
 
     /*RTC configuration*/
     h_rtc.Instance          = RTC;
@@ -164,7 +210,7 @@ void ClockUpdate_Callback( void )
 
     msgCallback.msg = CLOCK_MSG_DISPLAY;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &msgCallback );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &msgCallback );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = AppSched_startTimer( &Scheduler, UpdateTimerID ); /*Restart the timer */
@@ -200,7 +246,7 @@ void TimerAlarmOneSecond_Callback( void )
     displayEvent.msg        = DISPLAY_MSG_BACKLIGHT;
     displayEvent.displayBkl = LCD_TOGGLE;
 
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &displayEvent );
+    Status = DisplayQ_write( &DisplayQueue, &displayEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = AppSched_startTimer( &Scheduler, TimerAlarmActiveOneSecond_ID );
@@ -220,7 +266,7 @@ void TimerDeactivateAlarm_Callback( void )
     APP_MsgTypeDef alarmMsg;
     alarmMsg.msg = CLOCK_MSG_DEACTIVATE_ALARM;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &alarmMsg );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &alarmMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 }
 
@@ -229,11 +275,12 @@ void TimerDeactivateAlarm_Callback( void )
  *
  * The state machine implementation is made througha a switch sentence where is evaluated
  * a ClkState variable that is in charge to save the next state to run.
+ * The messages are processed in place from the ClockQueue buffer with peek/release, so they are
+ * not copied before call the event function. The highest priority message is always the next one,
+ * then the alarm and button events don't wait behind the display refreshes.
  */
 void Clock_PeriodicTask( void )
 {
-    APP_MsgTypeDef MsgClkRead = { 0 };
-
     APP_MsgTypeDef ( *ClockEventsMachine[ N_CLK_EVENTS ] )( APP_MsgTypeDef *PtrMsgClk ) =
     {
     Clock_Set_Time,
@@ -247,17 +294,25 @@ void Clock_PeriodicTask( void )
     Clock_GetAlarm
     };
 
-    while( ( HIL_QUEUE_isQueueEmptyISR( &ClockQueue ) == FALSE ) )
+    uint8_t level = 0;
+
+    /*cppcheck-suppress misra-c2012-11.5 ; the queue return a void pointer to the element*/
+    APP_MsgTypeDef *MsgClkRead = HIL_QUEUE_peekPrioISR( &ClockQueue, &level );
+
+    while( MsgClkRead != NULL )
     {
         uint8_t Status = FALSE;
 
-        Status = HIL_QUEUE_readDataISR( &ClockQueue, &MsgClkRead );
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
-
-        if( MsgClkRead.msg < (uint8_t) N_CLK_EVENTS )
+        if( MsgClkRead->msg < (uint8_t) N_CLK_EVENTS )
         {
-            (void) ClockEventsMachine[ MsgClkRead.msg ]( &MsgClkRead );
+            (void) ClockEventsMachine[ MsgClkRead->msg ]( MsgClkRead );
         }
+
+        Status = HIL_QUEUE_releasePrioISR( &ClockQueue, level );
+        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+
+        /*cppcheck-suppress misra-c2012-11.5 ; the queue return a void pointer to the element*/
+        MsgClkRead = HIL_QUEUE_peekPrioISR( &ClockQueue, &level );
     }
 }
 
@@ -288,7 +343,7 @@ STATIC APP_MsgTypeDef Clock_Set_Time( APP_MsgTypeDef *PtrMsgClk )
     Status = HAL_RTC_SetTime( &h_rtc, &sTime, RTC_FORMAT_BIN );
     assert_error( Status == HAL_OK, RTC_RET_ERROR );
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &nextEvent );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &nextEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     APP_MsgTypeDef alarmMsg = {0};
@@ -298,7 +353,7 @@ STATIC APP_MsgTypeDef Clock_Set_Time( APP_MsgTypeDef *PtrMsgClk )
     {
         alarmMsg.msg = CLOCK_MSG_DEACTIVATE_ALARM;
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &alarmMsg );
+        Status = HIL_QUEUE_writePrioISR( &ClockQueue, &alarmMsg );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
 
@@ -335,7 +390,7 @@ STATIC APP_MsgTypeDef Clock_Set_Date( APP_MsgTypeDef *PtrMsgClk )
     Status = HAL_RTC_SetDate( &h_rtc, &sDate, RTC_FORMAT_BIN );
     assert_error( Status == HAL_OK, RTC_RET_ERROR );
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &nextEvent );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &nextEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     APP_MsgTypeDef alarmMsg = {0};
@@ -345,7 +400,7 @@ STATIC APP_MsgTypeDef Clock_Set_Date( APP_MsgTypeDef *PtrMsgClk )
     {
         alarmMsg.msg = CLOCK_MSG_DEACTIVATE_ALARM;
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &alarmMsg );
+        Status = HIL_QUEUE_writePrioISR( &ClockQueue, &alarmMsg );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
 
@@ -381,7 +436,7 @@ STATIC APP_MsgTypeDef Clock_Set_Alarm( APP_MsgTypeDef *PtrMsgClk )
     {
         alarmMsg.msg = CLOCK_MSG_DEACTIVATE_ALARM;
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &alarmMsg );
+        Status = HIL_QUEUE_writePrioISR( &ClockQueue, &alarmMsg );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
 
@@ -393,7 +448,7 @@ STATIC APP_MsgTypeDef Clock_Set_Alarm( APP_MsgTypeDef *PtrMsgClk )
     Status = HAL_RTC_SetAlarm_IT( &h_rtc, &sAlarm, RTC_FORMAT_BIN );
     assert_error( Status == HAL_OK, RTC_RET_ERROR );
 
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &nextEventDisplay );
+    Status = DisplayQ_write( &DisplayQueue, &nextEventDisplay );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     return alarmMsg;
@@ -404,7 +459,8 @@ STATIC APP_MsgTypeDef Clock_Set_Alarm( APP_MsgTypeDef *PtrMsgClk )
  *
  * This funtion get the date, time and alarm values using the structures sTime, sDate and sAlarm,
  * and the respective functions from HAL library.
- * And then that information is writed in the DisplayQueue.
+ * And then that information is writed in the DisplayQueue, where a pending message of the same type
+ * is updated with the new values instead of write another one.
  *
  * @param   PtrMsgClk [in] Pointer to the clock message read from ClkQueue.
  * 
@@ -439,12 +495,12 @@ STATIC APP_MsgTypeDef Clock_Send_Display_Msg( APP_MsgTypeDef *PtrMsgClk )
     /*Write to the display queue to show temp */
     updateMsg.temperature = Analogs_GetTemperature( );
     updateMsg.msg = DISPLAY_MSG_TEMPERATURE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &updateMsg );
+    Status = DisplayQ_writeCoalesce( &DisplayQueue, &updateMsg, Clock_DisplayCoalesce );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     /*Write to the display queue to show time and date */
     updateMsg.msg = DISPLAY_MSG_UPDATE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &updateMsg );
+    Status = DisplayQ_writeCoalesce( &DisplayQueue, &updateMsg, Clock_DisplayCoalesce );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     return updateMsg;
@@ -455,7 +511,9 @@ STATIC APP_MsgTypeDef Clock_Send_Display_Msg( APP_MsgTypeDef *PtrMsgClk )
  *
  * This event is in charge of start the processes to indicate that the alarm has been activated
  * first set the AlarmActivated_flg to TRUE, stop the update timer, start the Alarm Timers and
- * write in the DisplayQueue to show the message "ALARM!!!" in the LCD.
+ * write in the DisplayQueue to show the message "ALARM!!!" in the LCD. The refreshes pending in the
+ * display lane of ClockQueue are discarded, they run after this event and would draw the time
+ * over the alarm message.
  *
  * @param   PtrMsgClk Pointer to message clock read.
  * 
@@ -471,17 +529,19 @@ STATIC APP_MsgTypeDef Clock_Alarm_Activated( APP_MsgTypeDef *PtrMsgClk )
 
     AlarmActivated_flg = TRUE;  /* Set flag */
 
-    HIL_QUEUE_flushQueueISR( &DisplayQueue );
+    DisplayQ_flush( &DisplayQueue );
 
     Status = AppSched_stopTimer( &Scheduler, UpdateTimerID );
     assert_error( Status == TRUE, SCHE_RET_ERROR );
 
+    HIL_QUEUE_flushPrioISR( &ClockQueue, CLOCK_LEVEL_DISPLAY );  /*drop the refreshes already queued*/
+
     displayMsg.msg = DISPLAY_MSG_CLEAR_SECOND_LINE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &displayMsg );
+    Status = DisplayQ_write( &DisplayQueue, &displayMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     displayMsg.msg = DISPLAY_MSG_ALARM_ACTIVE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &displayMsg );
+    Status = DisplayQ_write( &DisplayQueue, &displayMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = AppSched_startTimer( &Scheduler, TimerDeactivateAlarm_ID );
@@ -521,7 +581,7 @@ STATIC APP_MsgTypeDef Clock_Deactivate_Alarm( APP_MsgTypeDef *PtrMsgClk )
     Status = HAL_TIM_PWM_Stop( &TIM14_Handler, TIM_CHANNEL_1 ); /* Turn off the buzzer */
     assert_error( Status == HAL_OK, TIM_RET_ERROR );
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &updateMsg ); /* Write the update display event */
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &updateMsg ); /* Write the update display event */
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = AppSched_stopTimer( &Scheduler, TimerAlarmActiveOneSecond_ID );
@@ -536,7 +596,7 @@ STATIC APP_MsgTypeDef Clock_Deactivate_Alarm( APP_MsgTypeDef *PtrMsgClk )
     displayEvent.msg        = DISPLAY_MSG_BACKLIGHT;
     displayEvent.displayBkl = LCD_ON;
     
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &displayEvent );
+    Status = DisplayQ_write( &DisplayQueue, &displayEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     return updateMsg;
@@ -545,6 +605,9 @@ STATIC APP_MsgTypeDef Clock_Deactivate_Alarm( APP_MsgTypeDef *PtrMsgClk )
 /**
  * @brief   Button pressed event.
  * 
+ * Stop the update timer and discard the refreshes pending in the display lane of ClockQueue, the
+ * message shown while the button is pressed must not be overwritten by the time.
+ * 
  * @param   PtrMsgClk Pointer to the clock message read.
  * 
  * @retval  The next event, can be an event of the clock or display.
@@ -560,32 +623,34 @@ STATIC APP_MsgTypeDef Clock_ButtonPressed( APP_MsgTypeDef *PtrMsgClk )
     Status = AppSched_stopTimer( &Scheduler, UpdateTimerID );
     assert_error( Status == TRUE, SCHE_RET_ERROR );
 
-    HIL_QUEUE_flushQueueISR( &DisplayQueue );
+    HIL_QUEUE_flushPrioISR( &ClockQueue, CLOCK_LEVEL_DISPLAY );  /*drop the refreshes already queued*/
+
+    DisplayQ_flush( &DisplayQueue );
 
     if( AlarmActivated_flg == TRUE )
     {
         nextEvent.msg = CLOCK_MSG_DEACTIVATE_ALARM;                       
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &nextEvent );
+        Status = HIL_QUEUE_writePrioISR( &ClockQueue, &nextEvent );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
     else if( AlarmSet_flg == TRUE )
     {
         nextEvent.msg = CLOCK_MSG_GET_ALARM;
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &nextEvent );   
+        Status = HIL_QUEUE_writePrioISR( &ClockQueue, &nextEvent );   
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
     else        /* Alarm no config */
     {
         nextEvent.msg = DISPLAY_MSG_CLEAR_SECOND_LINE;
 
-        Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &nextEvent ); 
+        Status = DisplayQ_write( &DisplayQueue, &nextEvent ); 
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
         nextEvent.msg = DISPLAY_MSG_ALARM_NO_CONF;
 
-        Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &nextEvent ); 
+        Status = DisplayQ_write( &DisplayQueue, &nextEvent ); 
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
 
@@ -609,11 +674,11 @@ STATIC APP_MsgTypeDef Clock_ButtonReleased( APP_MsgTypeDef *PtrMsgClk )
     uint8_t Status = FALSE;
 
     nextDisplayEvent.msg = DISPLAY_MSG_CLEAR_SECOND_LINE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &nextDisplayEvent );
+    Status = DisplayQ_write( &DisplayQueue, &nextDisplayEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     updateMsg.msg = CLOCK_MSG_DISPLAY;
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &updateMsg );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &updateMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = AppSched_startTimer( &Scheduler, UpdateTimerID ); 
@@ -623,7 +688,7 @@ STATIC APP_MsgTypeDef Clock_ButtonReleased( APP_MsgTypeDef *PtrMsgClk )
     {
         nextDisplayEvent.msg = DISPLAY_MSG_ALARM_SET;       /* Print the letter A again */
 
-        Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &nextDisplayEvent );
+        Status = DisplayQ_write( &DisplayQueue, &nextDisplayEvent );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
     }
 
@@ -652,14 +717,14 @@ STATIC APP_MsgTypeDef Clock_GetAlarm( APP_MsgTypeDef *PtrMsgClk )
     assert_error( Status == HAL_OK, RTC_RET_ERROR );
 
     alarmMsg.msg = DISPLAY_MSG_CLEAR_SECOND_LINE;
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &alarmMsg );
+    Status = DisplayQ_write( &DisplayQueue, &alarmMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     alarmMsg.msg        = DISPLAY_MSG_ALARM_VALUES;
     alarmMsg.tm.tm_hour = sAlarm.AlarmTime.Hours;
     alarmMsg.tm.tm_min  = sAlarm.AlarmTime.Minutes;
     
-    Status = HIL_QUEUE_writeDataISR( &DisplayQueue, &alarmMsg );
+    Status = DisplayQ_write( &DisplayQueue, &alarmMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     return alarmMsg;
@@ -681,7 +746,7 @@ void HAL_RTC_AlarmAEventCallback( RTC_HandleTypeDef *hrtc )
     APP_MsgTypeDef alarmMsg;
     alarmMsg.msg = CLOCK_MSG_ALARM_ACTIVATED;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &alarmMsg );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &alarmMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     Status = HAL_RTC_DeactivateAlarm( hrtc, RTC_ALARM_A );     /* Disable the alarm A*/
@@ -706,7 +771,7 @@ void HAL_GPIO_EXTI_Falling_Callback( uint16_t GPIO_Pin )
 
     buttonMsg.msg = CLOCK_MSG_BTN_PRESSED;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &buttonMsg );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &buttonMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 }
 
@@ -728,6 +793,106 @@ void HAL_GPIO_EXTI_Rising_Callback( uint16_t GPIO_Pin )
 
     buttonMsg.msg = CLOCK_MSG_BTN_RELEASED;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &buttonMsg );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &buttonMsg );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
-}
\ No newline at end of file
+}
+/**
+ * @brief   Function to get the priority level of a clock message.
+ *
+ * Used by ClockQueue to choose the lane where each message is written, the alarm and button
+ * events go first, then the settings from the serial task and at last the display refreshes.
+ *
+ * @param   data [in] Pointer to the clock message to be written in ClockQueue.
+ *
+ * @return  The priority level of the message, an unknown message takes the lowest one.
+ */
+STATIC unsigned char Clock_MsgLevel( const void *data )
+{
+    static const unsigned char ClockMsgLevel[ N_CLK_EVENTS ] =
+    {
+        CLOCK_LEVEL_CONFIG,     /*CLOCK_MSG_TIME*/
+        CLOCK_LEVEL_CONFIG,     /*CLOCK_MSG_DATE*/
+        CLOCK_LEVEL_CONFIG,     /*CLOCK_MSG_ALARM*/
+        CLOCK_LEVEL_DISPLAY,    /*CLOCK_MSG_DISPLAY*/
+        CLOCK_LEVEL_USER,       /*CLOCK_MSG_ALARM_ACTIVATED*/
+        CLOCK_LEVEL_USER,       /*CLOCK_MSG_DEACTIVATE_ALARM*/
+        CLOCK_LEVEL_USER,       /*CLOCK_MSG_BTN_PRESSED*/
+        CLOCK_LEVEL_USER,       /*CLOCK_MSG_BTN_RELEASED*/
+        CLOCK_LEVEL_USER,       /*CLOCK_MSG_GET_ALARM*/
+        CLOCK_LEVEL_DISPLAY     /*CLOCK_MSG_GET_TEMPERATURE*/
+    };
+
+    /*cppcheck-suppress misra-c2012-11.5 ; the queue pass a void pointer to the element*/
+    const APP_MsgTypeDef *msgClk = (const APP_MsgTypeDef*) data;
+
+    unsigned char level = CLOCK_LEVEL_DISPLAY;
+
+    if( msgClk->msg < (uint8_t) N_CLK_EVENTS )
+    {
+        level = ClockMsgLevel[ msgClk->msg ];
+    }
+
+    return level;
+}
+
+/**
+ * @brief   Coalesce function of the ClockQueue display lane.
+ *
+ * A CLOCK_MSG_DISPLAY only ask to read the RTC and refresh the display, so if there is one pending
+ * the new one is merged with it, saving the RTC reads and the DisplayQueue writes of the repeated
+ * requests. The rest of the messages of the lane are not related with it.
+ *
+ * @param   data [in] Pointer to the clock message to be written in ClockQueue.
+ * @param   element [in] Pointer to a message pending in the lane.
+ *
+ * @return  QUEUE_COALESCE_MERGE when both messages are CLOCK_MSG_DISPLAY, otherwise QUEUE_COALESCE_SKIP.
+ */
+STATIC unsigned char Clock_Coalesce( const void *data, const void *element )
+{
+    /*cppcheck-suppress misra-c2012-11.5 ; the queue pass void pointers to the elements*/
+    const APP_MsgTypeDef *msgNew = (const APP_MsgTypeDef*) data;
+    /*cppcheck-suppress misra-c2012-11.5 ; the queue pass void pointers to the elements*/
+    const APP_MsgTypeDef *msgPending = (const APP_MsgTypeDef*) element;
+
+    unsigned char verdict = QUEUE_COALESCE_SKIP;
+
+    if( ( msgNew->msg == (uint8_t) CLOCK_MSG_DISPLAY ) && ( msgPending->msg == (uint8_t) CLOCK_MSG_DISPLAY ) )
+    {
+        verdict = QUEUE_COALESCE_MERGE;
+    }
+
+    return verdict;
+}
+
+/**
+ * @brief   Coalesce function used to write the display refreshes in the DisplayQueue.
+ *
+ * A pending DISPLAY_MSG_UPDATE or DISPLAY_MSG_TEMPERATURE is updated with the new values of the
+ * same type of message, both write different places of the LCD so they can pass each other, but
+ * any other message (like clear the second line) must be shown before the new values, so the
+ * search stops there and the message is written at the end of the queue.
+ *
+ * @param   data [in] Pointer to the display message to be written in DisplayQueue.
+ * @param   element [in] Pointer to a message pending in DisplayQueue.
+ *
+ * @return  QUEUE_COALESCE_MERGE, QUEUE_COALESCE_SKIP or QUEUE_COALESCE_STOP.
+ */
+STATIC unsigned char Clock_DisplayCoalesce( const APP_MsgTypeDef *data, const APP_MsgTypeDef *element )
+{
+    unsigned char verdict = QUEUE_COALESCE_STOP;
+
+    if( element->msg == data->msg )
+    {
+        verdict = QUEUE_COALESCE_MERGE;
+    }
+    else if( ( element->msg == (uint8_t) DISPLAY_MSG_UPDATE ) || ( element->msg == (uint8_t) DISPLAY_MSG_TEMPERATURE ) )
+    {
+        verdict = QUEUE_COALESCE_SKIP;
+    }
+    else
+    {
+        /*the new message must go after this one*/
+    }
+
+    return verdict;
+}
@@ -18,9 +18,14 @@
 #define TIM3_PERIOD     100u            /*!< TIM3 period to get 100 Hz frequency */
 
 /**
- * @brief Queue to communicate clock and display tasks.
+ * @brief Queue to communicate clock and display tasks, typed queue defined in bsp.h.
 */
-AppQue_Queue DisplayQueue;
+DisplayQ_Queue DisplayQueue;
+
+/**
+ * @brief Flag set by each write in the DisplayQueue, the display task is bound to it in main.c.
+*/
+volatile uint8_t DisplayEvent;
 
 /**
  * @brief LCD Handler.
@@ -33,6 +38,14 @@ SPI_HandleTypeDef SPI_Handler;
 /** @brief TIM3 Handler */
 TIM_HandleTypeDef TIM3_Handler;
 
+/** @brief Resume point of the LCD initialization, run by the display task */
+static AppSched_Coroutine LcdInit;
+
+/** @brief TRUE when the LCD initialization has ended, the display tasks don't use the LCD before */
+STATIC uint8_t LcdReady = FALSE;
+
+STATIC void Display_LcdInit( void );
+
 STATIC APP_MsgTypeDef Display_Update( APP_MsgTypeDef *pDisplayMsg );
 
 STATIC APP_MsgTypeDef Display_AlarmSet( APP_MsgTypeDef *pDisplayMsg );
@@ -60,28 +73,23 @@ STATIC void TemperatureString( char *string, int8_t temperature );
 /**
  * @brief   Initialize all required to work with the LCD.
  * 
- * Initialize the DisplayQueue, and write a message of type CLOCK_MSG_DISPLAY in the ClockQueue
- * to get the time and date, updating the display after its initialization. Additionally, configure
- * the SPI module to initialize the LCD.
+ * Write a message of type CLOCK_MSG_DISPLAY in the ClockQueue to get the time and date, updating
+ * the display after its initialization. Additionally, configure the SPI module to initialize the LCD.
+ * The DisplayQueue is a typed queue, it is empty from the start and needs no initialization.
+ * The initialization routine of the LCD takes more than 200 ms, it's run later by the display task,
+ * see Display_LcdInit.
 */
 void Display_InitTask( void )
 {
     HAL_StatusTypeDef Status = HAL_ERROR;
 
-    /*Display queue configuration*/
-    static APP_MsgTypeDef DisplayMsgs[ N_DISPLAY_MSGS ];
-
-    DisplayQueue.Buffer     = DisplayMsgs;
-    DisplayQueue.Elements   = N_DISPLAY_MSGS;
-    DisplayQueue.Size       = sizeof( APP_MsgTypeDef );
-
-    AppQueue_initQueue( &DisplayQueue );
+    DisplayQueue.Event = &DisplayEvent;     /*each write activates the display task*/
 
     /* Write a msg to update the display after the initialization  */
-    APP_MsgTypeDef nextEvent;
+    APP_MsgTypeDef nextEvent = {0};
     nextEvent.msg = CLOCK_MSG_DISPLAY;
 
-    Status = HIL_QUEUE_writeDataISR( &ClockQueue, &nextEvent );
+    Status = HIL_QUEUE_writePrioISR( &ClockQueue, &nextEvent );
     assert_error( Status == TRUE, QUEUE_RET_ERROR );
 
     /*SPI configuration*/
@@ -136,17 +144,13 @@ void Display_InitTask( void )
     LCD_Handler.CsPin     = GPIO_PIN_3;
 
     LCD_Handler.TimHandler = &TIM3_Handler;
-
-    Status = HEL_LCD_Init( &LCD_Handler );
-    assert_error( Status == HAL_OK, LCD_RET_ERROR );
-
-    Status = HEL_LCD_Backlight( &LCD_Handler, LCD_ON );
-    assert_error( Status == HAL_OK, LCD_RET_ERROR );
-
 }
 
 /**
  * @brief   Function where the display event machine it's implemented.
+ *
+ * The messages are processed in place from the DisplayQueue buffer with peek/release. Until the LCD
+ * is ready the task runs its initialization instead, and the messages wait in the queue.
 */
 void Display_PeriodicTask( void )
 {
@@ -162,28 +166,73 @@ void Display_PeriodicTask( void )
         Display_Temperature
     };
 
-    APP_MsgTypeDef readMsg = {0};
+    APP_MsgTypeDef *readMsg = NULL;
 
-    while ( HIL_QUEUE_isQueueEmptyISR( &DisplayQueue ) == FALSE )
+    if ( LcdReady == FALSE )
+    {
+        Display_LcdInit( );
+    }
+
+    if ( LcdReady == TRUE )
+    {
+        readMsg = DisplayQ_peek( &DisplayQueue );
+    }
+
+    while ( readMsg != NULL )
     {
         uint8_t Status = FALSE;
         
-        Status = HIL_QUEUE_readDataISR( &DisplayQueue, &readMsg );
+        if ( readMsg->msg < (uint8_t) N_DISPLAY_EVENTS )
+        {
+            (void) DisplayEventMachine[ readMsg->msg ]( readMsg );
+        }
+
+        Status = DisplayQ_release( &DisplayQueue );
         assert_error( Status == TRUE, QUEUE_RET_ERROR );
         
-        if ( readMsg.msg < (uint8_t) N_DISPLAY_EVENTS )
+        readMsg = DisplayQ_peek( &DisplayQueue );
+    }
+}
+
+/**
+ * @brief   Run the initialization routine of the LCD without block the scheduler.
+ * 
+ * Resumable task run by the display task, each step of HEL_LCD_InitStep is sent in a run and the
+ * display task is held by the scheduler for the delay before the next step, so the rest of the
+ * tasks keep running. At the end the backlight is turned on and the LCD is ready.
+*/
+STATIC void Display_LcdInit( void )
+{
+    static uint8_t step = 0u;
+    uint32_t delay = 0u;
+    uint8_t Status = HAL_ERROR;
+
+    SCHED_CO_BEGIN( &LcdInit );
+
+    for ( step = 0u; step < HEL_LCD_INIT_STEPS; step++ )
+    {
+        Status = HEL_LCD_InitStep( &LCD_Handler, step, &delay );
+        assert_error( Status == HAL_OK, LCD_RET_ERROR );
+
+        if ( delay > 0u )
         {
-            (void) DisplayEventMachine[ readMsg.msg ]( &readMsg );
+            SCHED_CO_WAIT_MS( &Scheduler, &LcdInit, delay );
         }
-        
     }
+
+    Status = HEL_LCD_Backlight( &LCD_Handler, LCD_ON );
+    assert_error( Status == HAL_OK, LCD_RET_ERROR );
+
+    LcdReady = TRUE;
+
+    SCHED_CO_END( &LcdInit );
 }
 
 /**
  * @brief   Update the LCD's intensity and contrast values.
  * 
  * The aim of this function is to check if the intensity or contrast values have changed
- * and update this these values on the LCD.
+ * and update this these values on the LCD, once it's ready.
 */
 void Display_LcdTask( void )
 {
@@ -193,28 +242,32 @@ void Display_LcdTask( void )
     static uint8_t current_intensity = 0u;
     uint8_t new_intensity;
 
-    new_contrast = Analogs_GetContrast( );
-
-    if ( new_contrast != current_contrast )
+    /*the contrast set by the LCD initialization would be overwritten, wait until it's ready*/
+    if ( LcdReady == TRUE )
     {
-        HAL_StatusTypeDef Status = HAL_ERROR;
+        new_contrast = Analogs_GetContrast( );
 
-        current_contrast = new_contrast;
+        if ( new_contrast != current_contrast )
+        {
+            HAL_StatusTypeDef Status = HAL_ERROR;
 
-        Status = HEL_LCD_Contrast( &LCD_Handler, new_contrast );
-        assert_error( Status == HAL_OK, LCD_RET_ERROR );
-    }
+            current_contrast = new_contrast;
 
-    new_intensity = Analogs_GetIntensity( );
+            Status = HEL_LCD_Contrast( &LCD_Handler, new_contrast );
+            assert_error( Status == HAL_OK, LCD_RET_ERROR );
+        }
 
-    if ( new_intensity != current_intensity )
-    {
-        uint8_t Status_Intensity = false;
+        new_intensity = Analogs_GetIntensity( );
 
-        current_intensity = new_intensity;
+        if ( new_intensity != current_intensity )
+        {
+            uint8_t Status_Intensity = false;
+
+            current_intensity = new_intensity;
 
-        Status_Intensity = HEL_LCD_Intensity( &LCD_Handler, new_intensity );
-        assert_error( Status_Intensity == true, LCD_RET_ERROR );
+            Status_Intensity = HEL_LCD_Intensity( &LCD_Handler, new_intensity );
+            assert_error( Status_Intensity == true, LCD_RET_ERROR );
+        }
     }
     
 }
@@ -7,8 +7,8 @@
 #define DISPLAY_H__
 
 #include "hel_lcd.h"
+#include "bsp.h"
 
-#define N_DISPLAY_MSGS          20u     /*!< Buffer size of DisplayQueue */
 #define UPSET_ASCII_NUM         48u     /*!< Value to convert a number to it's ascii value */
 #define MONTH_N_CHARACTERS      4u      /*!< Number of characters in months array */
 #define N_MONTHS                12u     /*!< Number of months */
@@ -17,6 +17,13 @@
 #define LCD_CHARACTERS          16u     /*!< Number of characters in a line of the LCD */
 #define OFFSET_ARRAY            1u      /*!< Offset to get the correct value of wday or months array */
 #define TWO_THOUSANDS           2000u   /*!< 2000 years to add to the year that will be in the LCD */
+#define N_DISPLAY_MSGS          20u     /*!< Buffer size of DisplayQueue, the refreshes are merged so a few are pending at once */
+
+/* Typed queue DisplayQ_Queue with its functions DisplayQ_write, DisplayQ_peek, DisplayQ_release... */
+QUEUE_DEFINE( DisplayQ, APP_MsgTypeDef, N_DISPLAY_MSGS )
+
+/** @brief  DisplayQueue external reference */
+extern DisplayQ_Queue DisplayQueue;
 
 void Display_InitTask( void );
 
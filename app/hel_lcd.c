@@ -12,7 +12,8 @@
  * @brief   Initialization routine of the LCD.
  * 
  * Here the SPI module is initialized, and the commands to initialize the LCD are sent through
- * SPI, setting an optimum contrast level and the maximum internal frequency.
+ * SPI, setting an optimum contrast level and the maximum internal frequency. The steps of
+ * HEL_LCD_InitStep are run one after the other, with HAL_Delay for the time between them.
  * 
  * @param   hlcd Pointer to the LCD handle structure.
  * 
@@ -21,59 +22,98 @@
 uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd )
 {
     uint8_t retValue = HAL_OK;
-    uint8_t commands [ 10 ];
-    uint8_t i = 0u;
-
-    /* Initialization commands */
-    commands[ 0 ] = CMD_WAKEUP;
-    commands[ 1 ] = CMD_WAKEUP;
-    commands[ 2 ] = FUNCTION_SET | ( 1u << DL_POS ) | ( 1u << N_POS ) | ( 0u << DH_POS ) | ( 1u << IS_POS );
-    commands[ 3 ] = OSC_FREQUENCY | ( 0u << BS_POS ) | ( 1u << F2_POS ) | ( 1u << F1_POS ) | ( 1u << F0_POS );
-    commands[ 4 ] = PWR_ICON_CONTRAST | ( 0u << ION_POS ) | ( 1u << BON_POS ) | ( 1u << C5_POS ) | ( 0u << C4_POS );
-    commands[ 5 ] = FOLLOWER_CONTROL | ( 1u << FON_POS ) | ( 1u << RAB2_POS ) | ( 0u << RAB1_POS ) | ( 1u << RAB0_POS );
-    commands[ 6 ] = CONTRAST_SET | ( 0u << C3_POS ) | ( 0u << C2_POS ) | ( 0u << C1_POS ) | ( 0u << C0_POS );
-    commands[ 7 ] = DISPLAY_ON_OFF | ( 1u << D_POS ) | ( 0u << C_POS ) | ( 0u << B_POS );
-    commands[ 8 ] = ENTRY_MODE | ( 1u << I_D_POS ) | ( 0u << S_POS );
-    commands[ 9 ] = CMD_CLEAR_DISPLAY;
-
-    HEL_LCD_MspInit( hlcd );
-
-    HAL_GPIO_WritePin( hlcd->CsPort, hlcd->CsPin, SET );        /*CS off*/
-    HAL_GPIO_WritePin( hlcd->RsPort, hlcd->RsPin, RESET );      /*RS instruction*/
-
-    HAL_GPIO_WritePin( hlcd->RstPort, hlcd->RstPin, RESET );    /*Reset*/
-    
-    HAL_Delay( 2u );
+    uint32_t delay = 0u;
+    uint8_t step = 0u;
 
-    HAL_GPIO_WritePin( hlcd->RstPort, hlcd->RstPin, SET );      /*clear Reset*/
-    
-    HAL_Delay( 20u );
-    
-    retValue = HEL_LCD_Command( hlcd, CMD_WAKEUP );
-    
-    HAL_Delay( 2u );
-
-    while ( ( retValue == HAL_OK ) && ( i < FIRST_PART_CMDS ) )    /* send first 7 initialization commands */
+    while ( ( retValue == HAL_OK ) && ( step < HEL_LCD_INIT_STEPS ) )
     {
-        retValue = HEL_LCD_Command( hlcd, commands[ i ] );
-        i++;
+        retValue = HEL_LCD_InitStep( hlcd, step, &delay );
+        HAL_Delay( delay );
+        step++;
     }
 
-    HAL_Delay( 200u );
+    return retValue;
+}
+
+/**
+ * @brief   Run a step of the initialization routine of the LCD.
+ * 
+ * The routine is split in the parts between its delays, so it can be run without blocking the CPU,
+ * for example from a resumable task of the scheduler. The steps must be run in order, from zero to
+ * HEL_LCD_INIT_STEPS less one, waiting the delay returned by each one before the next step.
+ * 
+ * @param   hlcd Pointer to the LCD handle structure.
+ * @param   step Step to run.
+ * @param   delay [out] Time in ms to wait before the next step.
+ * 
+ * @retval  HAL_OK if the commands of the step were sent, otherwise HAL_ERROR.
+*/
+uint8_t HEL_LCD_InitStep( LCD_HandleTypeDef *hlcd, uint8_t step, uint32_t *delay )
+{
+    uint8_t retValue = HAL_OK;
+    uint8_t i;
 
-    while( ( retValue == HAL_OK ) && ( i < SECOND_PART_CMDS ) )    /* send the last 3 initialization commands */
+    /* Initialization commands */
+    static const uint8_t commands[ SECOND_PART_CMDS ] =
     {
-        retValue = HEL_LCD_Command( hlcd, commands[ i ] );
-        i++;
-    }
+        CMD_WAKEUP,
+        CMD_WAKEUP,
+        FUNCTION_SET | ( 1u << DL_POS ) | ( 1u << N_POS ) | ( 0u << DH_POS ) | ( 1u << IS_POS ),
+        OSC_FREQUENCY | ( 0u << BS_POS ) | ( 1u << F2_POS ) | ( 1u << F1_POS ) | ( 1u << F0_POS ),
+        PWR_ICON_CONTRAST | ( 0u << ION_POS ) | ( 1u << BON_POS ) | ( 1u << C5_POS ) | ( 0u << C4_POS ),
+        FOLLOWER_CONTROL | ( 1u << FON_POS ) | ( 1u << RAB2_POS ) | ( 0u << RAB1_POS ) | ( 1u << RAB0_POS ),
+        CONTRAST_SET | ( 0u << C3_POS ) | ( 0u << C2_POS ) | ( 0u << C1_POS ) | ( 0u << C0_POS ),
+        DISPLAY_ON_OFF | ( 1u << D_POS ) | ( 0u << C_POS ) | ( 0u << B_POS ),
+        ENTRY_MODE | ( 1u << I_D_POS ) | ( 0u << S_POS ),
+        CMD_CLEAR_DISPLAY
+    };
+
+    /* Delay after each step */
+    static const uint8_t delays[ HEL_LCD_INIT_STEPS ] = { 2u, 20u, 2u, 200u, 2u, 0u };
+
+    switch ( step )
+    {
+        case 0u:
+            HEL_LCD_MspInit( hlcd );
+
+            HAL_GPIO_WritePin( hlcd->CsPort, hlcd->CsPin, SET );        /*CS off*/
+            HAL_GPIO_WritePin( hlcd->RsPort, hlcd->RsPin, RESET );      /*RS instruction*/
+            HAL_GPIO_WritePin( hlcd->RstPort, hlcd->RstPin, RESET );    /*Reset*/
+            break;
 
-    HAL_Delay( 2u );
+        case 1u:
+            HAL_GPIO_WritePin( hlcd->RstPort, hlcd->RstPin, SET );      /*clear Reset*/
+            break;
 
-    if( retValue == HAL_OK )     /* If the initialization routine has been executed correctly.. */
-    {
-        retValue = HEL_LCD_Command( hlcd, SET_DDRAM_ADDRESS );  /*Set DDRAM address 0x00*/
+        case 2u:
+            retValue = HEL_LCD_Command( hlcd, CMD_WAKEUP );
+            break;
+
+        case 3u:
+            for ( i = 0u; ( retValue == HAL_OK ) && ( i < FIRST_PART_CMDS ); i++ )   /* send first 7 initialization commands */
+            {
+                retValue = HEL_LCD_Command( hlcd, commands[ i ] );
+            }
+            break;
+
+        case 4u:
+            for ( i = FIRST_PART_CMDS; ( retValue == HAL_OK ) && ( i < SECOND_PART_CMDS ); i++ )    /* send the last 3 initialization commands */
+            {
+                retValue = HEL_LCD_Command( hlcd, commands[ i ] );
+            }
+            break;
+
+        case 5u:
+            retValue = HEL_LCD_Command( hlcd, SET_DDRAM_ADDRESS );  /*Set DDRAM address 0x00*/
+            break;
+
+        default:
+            retValue = HAL_ERROR;
+            break;
     }
 
+    *delay = ( step < HEL_LCD_INIT_STEPS ) ? delays[ step ] : 0u;
+
     return retValue;
 }
 
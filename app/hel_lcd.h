@@ -13,6 +13,8 @@
 
 #define MAX_INTENSITY       100u    /*!< Maximum intensity value */
 
+#define HEL_LCD_INIT_STEPS  6u  /*!< Number of steps of HEL_LCD_InitStep */
+
 #define MAX_COL   15u     /*!< Maximum column number */
 #define ROW_0     0u      /*!< Row 0 value */
 #define COL_0     0u      /*!< Column 0 value */
@@ -146,6 +148,8 @@ typedef struct
 
 uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd );
 
+uint8_t HEL_LCD_InitStep( LCD_HandleTypeDef *hlcd, uint8_t step, uint32_t *delay );
+
 __attribute__((weak)) void HEL_LCD_MspInit( LCD_HandleTypeDef *hlcd );
 
 uint8_t HEL_LCD_Command( LCD_HandleTypeDef *hlcd, uint8_t cmd );
@@ -34,7 +34,9 @@ void SysTick_Handler( void )
 /* cppcheck-suppress misra-c2012-8.4 ; its external linkage is declared at HAL library */
 void TIM16_FDCAN_IT0_IRQHandler( void )
 {
+    TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_FDCAN, 0u );
     HAL_FDCAN_IRQHandler( &CANHandler );
+    TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_FDCAN, 0u );
 }
 
 /* cppcheck-suppress misra-c2012-8.4 ; its external linkage is declared at HAL library */
@@ -58,11 +60,15 @@ void FLASH_IRQHandler( void )
 /* cppcheck-suppress misra-c2012-8.4 ; its external linkage is declared at HAL library */
 void RTC_TAMP_IRQHandler( void )
 {
+    TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_RTC, 0u );
     HAL_RTC_AlarmIRQHandler( &h_rtc );
+    TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_RTC, 0u );
 }
 
 /* cppcheck-suppress misra-c2012-8.4 ; its external linkage is declared at HAL library */
 void EXTI4_15_IRQHandler( void )
 {
+    TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_EXTI, 0u );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_15 );
+    TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_EXTI, 0u );
 }
@@ -40,9 +40,21 @@ uint8_t TimerAlarmActiveOneSecond_ID;
 /** @brief  Variable to save the TimerAlarmActiveOneMinute_ID */
 uint8_t TimerDeactivateAlarm_ID;
 
+/** @brief  Variable to save the timer ID that sends the CPU load */
+uint8_t LoadTimerID;
+
+/** @brief  Variable to save the timer ID of the ISO-TP transfers received */
+uint8_t TpRxTimerID;
+
+/** @brief  Variable to save the timer ID of the ISO-TP transfers sent */
+uint8_t TpTxTimerID;
+
 /** @brief  TIM6 Handler struct */
 TIM_HandleTypeDef TIM6_Handler;
 
+/** @brief  TIM7 Handler struct */
+TIM_HandleTypeDef TIM7_Handler;
+
 /**
  * @brief   **Application entry point**
  *
@@ -58,36 +70,65 @@ int main( void )
 
     HAL_Init( );
 
+#ifdef TRACE
+    AppTrace_init( );       /*the events are recorded since the tasks are initialized*/
+#endif
+
     /*Scheduler config*/
     static AppSched_Task tasks[ TASKS_N ];
     static AppSched_Timer timers[ TIMERS_N ];
+    static uint8_t frames[ FRAMES_N ];
 
     Scheduler.tick      = TICK_VAL;
     Scheduler.tasks     = TASKS_N;
     Scheduler.taskPtr   = tasks;
     Scheduler.timers    = TIMERS_N;
     Scheduler.timerPtr  = timers;
+    Scheduler.frames    = FRAMES_N;
+    Scheduler.framePtr  = frames;
+    Scheduler.idleFunc  = AppSched_sleep;  /*sleep between the ticks with nothing to run*/
 
     AppSched_initScheduler( &Scheduler );
     /*Register serial task*/
     Status = AppSched_registerTask( &Scheduler, Serial_InitTask, Serial_PeriodicTask, PERIOD_SERIAL_TASK );
     assert_error( Status != FALSE, SCHE_RET_ERROR );
 
+    Status = AppSched_eventTask( &Scheduler, (uint8_t) Status, &SerialEvent );  /*run also when its queue is written*/
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
     Status = AppSched_registerTask( &Scheduler, Clock_InitTask, Clock_PeriodicTask, PERIOD_CLOCK_TASK );
     assert_error( Status != FALSE, SCHE_RET_ERROR );
 
+    Status = AppSched_eventTask( &Scheduler, (uint8_t) Status, &ClockEvent );  /*run also when its queue is written*/
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
     Status = AppSched_registerTask( &Scheduler, Heartbeat_InitTask, Heartbeat_PeriodicTask, PERIOD_HEARTBEAT_TASK );    
     assert_error( Status != FALSE, SCHE_RET_ERROR );
 
     Status = AppSched_registerTask( &Scheduler, Display_InitTask, Display_PeriodicTask, PERIOD_DISPLAY_TASK );
     assert_error( Status != FALSE, SCHE_RET_ERROR );
 
+    Status = AppSched_eventTask( &Scheduler, (uint8_t) Status, &DisplayEvent );  /*run also when its queue is written*/
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
     Status = AppSched_registerTask( &Scheduler, Analogs_Init, Display_LcdTask, PERIOD_LCD_TASK );
     assert_error( Status != FALSE, SCHE_RET_ERROR );
     
     Status = AppSched_registerTask( &Scheduler, Watchdog_InitTask, Watchdog_PeriodicTask, PERIOD_WATCHDOG_TASK );
     assert_error( Status != FALSE, SCHE_RET_ERROR );
 
+    /*the first refresh must be inside the window of the WWDG, after 110 ms*/
+    Status = AppSched_offsetTask( &Scheduler, (uint8_t) Status, PERIOD_WATCHDOG_TASK );
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
+    /*spread the tasks along the ticks instead of run all of them together every 300 ms*/
+    Status = AppSched_staggerTasks( &Scheduler );
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
+    /*the task set is fixed, each tick just runs the tasks listed for it*/
+    Status = AppSched_buildTable( &Scheduler );
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
     /*Software timer register to update time and date in display*/
     UpdateTimerID = AppSched_registerTimer( &Scheduler, ONE_SECOND, ClockUpdate_Callback );
     
@@ -100,6 +141,19 @@ int main( void )
     /*Software timer to know when is time to deactivate the alarm */
     TimerDeactivateAlarm_ID = AppSched_registerTimer( &Scheduler, ONE_MINUTE, TimerDeactivateAlarm_Callback );
 
+    /*Software timers of the ISO-TP transfers on CAN, started by the serial task*/
+    TpRxTimerID = AppSched_registerTimer( &Scheduler, SERIAL_TP_TIMEOUT_MS, SerialTpRx_Callback );
+
+    TpTxTimerID = AppSched_registerTimer( &Scheduler, SERIAL_TP_TIMEOUT_MS, SerialTpTx_Callback );
+
+#ifdef CPU_LOAD_CAN
+    /*Software timer to send the CPU load on CAN, once per load window*/
+    LoadTimerID = AppSched_registerTimer( &Scheduler, SCHED_LOAD_WINDOW_MS, SerialLoad_Callback );
+
+    Status = AppSched_startTimer( &Scheduler, LoadTimerID );
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+#endif
+
     AppSched_startScheduler( &Scheduler );
 
     return 0u;
@@ -186,12 +240,17 @@ static void Watchdog_PeriodicTask( void )
  * @param   line Line where the error its detected.
  * @param   error Error code. 
 */
+#ifndef SIM    /*the host simulation reports the error instead*/
 void safe_state( const char *file, uint32_t line, uint8_t error )
 {
     ShutdownOS();
     
     __disable_irq();        /* Disable interrupts */
 
+#ifdef TRACE
+    AppTrace_enable( FALSE );   /* Freeze the trace ring with the events before the error */
+#endif
+
     (void) file;
     (void) line;
 
@@ -224,5 +283,6 @@ void safe_state( const char *file, uint32_t line, uint8_t error )
     }
 
 }
+#endif
 
 
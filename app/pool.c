@@ -0,0 +1,175 @@
+/**
+ * @file    pool.c
+ * @brief   Implementation of a pool of fixed size blocks.
+ *
+ * The pool is an array of blocks of the same size given by the user, the free blocks are linked in
+ * a list where each free block stores in its first bytes the address of the next one, so the pool
+ * doesn't need any memory besides the array. Allocate a block takes the first one in the list and
+ * free a block puts it back at the front, both in constant time without search in the array.
+ *
+ * The blocks are intended to pass messages between an interrupt and a task through a queue of
+ * pointers, the producer allocates a block and fills it, only the block address is written in the
+ * queue, and the consumer frees the block after process the message. Allocate and free modify the
+ * list with the interrupts disabled, so both functions can be called from an interrupt or a task.
+ */
+
+#include <string.h>
+#include "pool.h"
+#include "bsp.h"
+
+static void *Pool_Next( const void *block );
+
+static void Pool_Link( void *block, void *next );
+
+
+/**
+ * @brief   Interface to initialize the pool.
+ *
+ * This interface links all the blocks of the array in the free list, in the same order they are
+ * in the array, so the first allocated block is the first one in the array.
+ *
+ * @param   pool [in] It's the memory address of the pool.
+ *
+ * @note Before using this function it's mandatory initialized the elements: Buffer, Blocks and Size,
+ * Size can not be lower than the size of a pointer because the free blocks store the address of
+ * the next one.
+ */
+void AppPool_initPool( AppPool_Pool *pool )
+{
+    assert_error( ( pool->Buffer != NULL ), POOL_PAR_ERROR );
+    assert_error( ( pool->Blocks != 0u ), POOL_PAR_ERROR );
+    assert_error( ( pool->Size >= sizeof( void * ) ), POOL_PAR_ERROR );
+
+    unsigned char *block = (unsigned char *) pool->Buffer;
+
+    for( unsigned long i = 1u; i < pool->Blocks; i++ )
+    {
+        Pool_Link( block, &block[ pool->Size ] );   //each block points to the next one in the array
+        block = &block[ pool->Size ];
+    }
+    Pool_Link( block, NULL );                       //the last block ends the list
+
+    pool->Free      = pool->Buffer;
+    pool->Available = pool->Blocks;
+    pool->LowWater  = pool->Blocks;
+}
+
+/**
+ * @brief   Interface to allocate a block.
+ *
+ * The first block of the free list is removed from it, the content of the block is not cleared.
+ *
+ * @param   pool [in] It's the memory address of the pool.
+ *
+ * @retval  The address of the block, or NULL if all the blocks are in use.
+ */
+void *AppPool_alloc( AppPool_Pool *pool )
+{
+#ifndef UTEST
+    uint32_t primask = __get_PRIMASK( );
+    __disable_irq( );
+#endif
+
+    void *block = pool->Free;
+
+    if( block != NULL )
+    {
+        pool->Free = Pool_Next( block );
+        pool->Available--;
+
+        if( pool->Available < pool->LowWater )
+        {
+            pool->LowWater = pool->Available;
+        }
+    }
+
+#ifndef UTEST
+    __set_PRIMASK( primask );
+#endif
+
+    return block;
+}
+
+/**
+ * @brief   Interface to free a block.
+ *
+ * The block is put back at the front of the free list, an address outside the array of the pool or
+ * that is not the start of a block is rejected, as well as any block when all of them are already
+ * free.
+ *
+ * @param   pool [in] It's the memory address of the pool.
+ * @param   block [in] Address of the block, returned by AppPool_alloc.
+ *
+ * @retval  Returns TRUE if the block was freed, and FALSE if it doesn't belong to the pool.
+ */
+unsigned char AppPool_free( AppPool_Pool *pool, void *block )
+{
+    unsigned char varRet = FALSE;
+    const unsigned char *first = (const unsigned char *) pool->Buffer;
+    const unsigned char *end = &first[ pool->Blocks * pool->Size ];
+    const unsigned char *address = (const unsigned char *) block;
+
+    /* cppcheck-suppress misra-c2012-18.3 ; the block is compared with the limits of the array to check it belongs to it */
+    if( ( address >= first ) && ( address < end ) && ( ( (unsigned long) ( address - first ) % pool->Size ) == 0u ) )
+    {
+#ifndef UTEST
+        uint32_t primask = __get_PRIMASK( );
+        __disable_irq( );
+#endif
+
+        if( pool->Available < pool->Blocks )
+        {
+            Pool_Link( block, pool->Free );
+            pool->Free = block;
+            pool->Available++;
+            varRet = TRUE;
+        }
+
+#ifndef UTEST
+        __set_PRIMASK( primask );
+#endif
+    }
+
+    return varRet;
+}
+
+/**
+ * @brief   Interface to know the number of free blocks.
+ *
+ * @param   pool [in] It's the memory address of the pool.
+ *
+ * @retval  Number of blocks that can be allocated.
+ */
+unsigned long AppPool_available( const AppPool_Pool *pool )
+{
+    return pool->Available;
+}
+
+/**
+ * @brief   Read the address of the next free block.
+ *
+ * The address is copied with memcpy because the blocks may not be aligned to a pointer.
+ *
+ * @param   block [in] Free block.
+ *
+ * @retval  Address stored in the block.
+ */
+static void *Pool_Next( const void *block )
+{
+    void *next;
+
+    (void) memcpy( (void *) &next, block, sizeof( void * ) );
+
+    return next;
+}
+
+/**
+ * @brief   Store in a free block the address of the next one.
+ *
+ * @param   block [in] Free block.
+ * @param   next [in] Address of the next free block, NULL at the end of the list.
+ */
+static void Pool_Link( void *block, void *next )
+{
+    (void) memcpy( block, (const void *) &next, sizeof( void * ) );
+}
@@ -0,0 +1,36 @@
+/**
+ * @file pool.h
+ *
+ * @brief Here is defined the AppPool_Pool struct, and the functions prototypes of
+ * the pool.c file
+*/
+#ifndef POOL_H_
+#define POOL_H_
+
+/**
+ * @struct AppPool_Pool
+ *
+ * @brief Struct with the elements of a pool of fixed size blocks.
+ *
+*/
+typedef struct
+{
+    void *Buffer;                   /*!< pointer to the array of Blocks elements of Size bytes*/
+    unsigned long Blocks;           /*!< number of blocks in the pool*/
+    unsigned char Size;             /*!< size of each block, at least the size of a pointer*/
+    void *volatile Free;            /*!< first block of the free list, NULL when all blocks are in use*/
+    volatile unsigned long Available;   /*!< number of blocks in the free list*/
+    unsigned long LowWater;         /*!< min number of free blocks since the pool was initialized*/
+} AppPool_Pool;
+
+
+
+void AppPool_initPool( AppPool_Pool *pool );
+
+void *AppPool_alloc( AppPool_Pool *pool );
+
+unsigned char AppPool_free( AppPool_Pool *pool, void *block );
+
+unsigned long AppPool_available( const AppPool_Pool *pool );
+
+#endif
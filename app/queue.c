@@ -4,14 +4,77 @@
  *
  * This queue make a copy of the elements to be written and always make a copy of the elements read, 
  * the interface contain fuctions to initialize the queue, write data, read data, to know if the
- * queue is empty and a function to flush the queue.
+ * queue is empty and a function to flush the queue. To avoid the copies there are also functions
+ * to reserve/commit a space to write an element in place and to peek/release the oldest element,
+ * and to move several elements with a single call there are the batch write and read functions.
  * 
+ * The queue can also work in SPSC mode (single producer, single consumer), intended to pass data
+ * from an interrupt to a task without disable the interrupts, in this mode the producer only writes
+ * the Head index and the consumer only writes the Tail index, both indexes run from 0 to
+ * 2*Elements - 1 so the queue can tell apart the full and empty conditions without the flags Empty
+ * and Full, which are shared by both sides.
+ *
+ * The Cortex-M0+ has no hardware divider, so the modulo used to wrap the indexes ends in a call to
+ * a software division routine. When the element Pow2 is set to TRUE the queue only accept a power
+ * of two number of Elements and the indexes are wrapped with a mask instead, in both modes.
+ *
+ * A priority queue (AppQue_PrioQueue) is built with one queue per level, named lanes, the level of
+ * each element is given by a user function, and a bitmap with one bit per non empty lane allows to
+ * find the highest priority element with a table look up instead of visiting every lane.
+ *
+ * When the macro QUEUE_STATS is defined each queue keeps the occupancy counters in the element
+ * Stats: high-water mark, written and rejected elements, and the max time an element waited, this
+ * last one only if an array to stamp each slot is given in Stats.Stamps.
+ *
+ * Some messages only need to be pending once, like a request to refresh the display, for that a
+ * queue can have a Coalesce function, used by the write to merge the new element with a pending one
+ * of the same kind instead of append it.
+ *
+ * A queue can also activate its consumer task, each successful write sets to TRUE the flag pointed
+ * by the element Event, and the scheduler runs the task bound to that flag on its next loop,
+ * without wait for the task period.
+ *
+ * When the macro TRACE is defined each write and read is recorded in the trace ring of trace.c, with
+ * the number of elements moved, zero for a write merged with a pending element.
+ *
+ * For a queue with a fixed type of elements the macro QUEUE_DEFINE in queue.h generates a typed
+ * queue, its functions are static inline and do not use the functions in this file.
  */
 
 #include <string.h>
 #include "queue.h"
 #include "bsp.h"
 
+static unsigned long Queue_Used( const AppQue_Queue *queue, unsigned char head, unsigned char tail );
+
+static unsigned long Queue_Slot( const AppQue_Queue *queue, unsigned char index );
+
+static unsigned char Queue_Next( const AppQue_Queue *queue, unsigned char index );
+
+static unsigned char *Queue_Element( const AppQue_Queue *queue, unsigned char index );
+
+static unsigned char Queue_Wrap( const AppQue_Queue *queue, unsigned char index );
+
+static void Queue_Notify( const AppQue_Queue *queue );
+
+static unsigned long Queue_Count( const AppQue_Queue *queue, unsigned char head, unsigned char tail );
+
+static unsigned char Queue_Advance( const AppQue_Queue *queue, unsigned char index, unsigned long n );
+
+static unsigned char *Queue_Coalesce( const AppQue_Queue *queue, const void *data );
+
+static void Queue_SetReady( AppQue_PrioQueue *prio, unsigned char level );
+
+static void Queue_ClearReady( AppQue_PrioQueue *prio, unsigned char level );
+
+static unsigned char Queue_HighestLevel( unsigned char ready );
+
+#ifdef QUEUE_STATS
+static void Queue_StatsWrite( AppQue_Queue *queue, unsigned char head, unsigned char tail, unsigned long n );
+
+static void Queue_StatsRead( AppQue_Queue *queue, unsigned char tail, unsigned long n );
+#endif
+
 
 /**
  * @brief   Interface to initialize the queue.
@@ -21,19 +84,47 @@
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
  *
+ * @retval  Return TRUE if the queue was initialized, and FALSE when its elements are rejected, in that
+ * case the queue is not modified and can not be used.
  *
- * @note Before using this function it's mandatory initialized the elements: Buffer, Elements and Size.
+ * @note Before using this function it's mandatory initialized the elements: Buffer, Elements and Size,
+ * to work in SPSC mode the element Spsc must be set to TRUE and Elements can not be greater than
+ * QUEUE_SPSC_MAX_ELEMENTS. When Pow2 is set to TRUE Elements must be a power of two, any other value
+ * is rejected with QUEUE_PAR_ERROR. With QUEUE_STATS the counters are
+ * cleared, and Stats.Stamps must be set before, to an array of Elements or NULL. The element
+ * Coalesce is optional (NULL), and it can not be used in SPSC mode.
  */
-void AppQueue_initQueue( AppQue_Queue *queue )
+unsigned char AppQueue_initQueue( AppQue_Queue *queue )
 {
     assert_error( ( queue->Buffer != NULL ), QUEUE_PAR_ERROR );
     assert_error( ( queue->Elements != 0u ), QUEUE_PAR_ERROR );
     assert_error( ( queue->Size != 0u ), QUEUE_PAR_ERROR );
-    
-    queue->Head = 0;      //Setting index Tail and Head to zero
-    queue->Tail = 0;
-    queue->Empty = TRUE;  //Empty flag to TRUE and Full flg to FALSE
-    queue->Full = FALSE;
+    assert_error( ( queue->Spsc == FALSE ) || ( queue->Elements <= QUEUE_SPSC_MAX_ELEMENTS ), QUEUE_PAR_ERROR );
+    assert_error( ( queue->Pow2 == FALSE ) || ( ( queue->Elements & ( queue->Elements - 1u ) ) == 0u ), QUEUE_PAR_ERROR );
+    assert_error( ( queue->Spsc == FALSE ) || ( queue->Coalesce == NULL ), QUEUE_PAR_ERROR );
+
+    unsigned char varRet = FALSE;
+
+    if ( ( queue->Buffer != NULL ) && ( queue->Elements != 0u ) && ( queue->Size != 0u ) &&
+         ( ( queue->Spsc == FALSE ) || ( ( queue->Elements <= QUEUE_SPSC_MAX_ELEMENTS ) && ( queue->Coalesce == NULL ) ) ) &&
+         ( ( queue->Pow2 == FALSE ) || ( ( queue->Elements & ( queue->Elements - 1u ) ) == 0u ) ) )
+    {
+        queue->Head = 0;      //Setting index Tail and Head to zero
+        queue->Tail = 0;
+        queue->Empty = TRUE;  //Empty flag to TRUE and Full flg to FALSE
+        queue->Full = FALSE;
+        queue->Peeked = FALSE;
+
+#ifdef QUEUE_STATS
+        queue->Stats.HighWater  = 0u;   //Stamps is set by the user, it's not modified
+        queue->Stats.Writes     = 0u;
+        queue->Stats.Rejects    = 0u;
+        queue->Stats.MaxDwell   = 0u;
+#endif
+        varRet = TRUE;
+    }
+
+    return varRet;
 }
 
 /**
@@ -42,12 +133,17 @@ void AppQueue_initQueue( AppQue_Queue *queue )
  * First of all, verify if the queue isn't Full to write data, and as a void pointers is received, it's 
  * necessary cast it to use pointer's arithmetic and to be able to copy the data in the buffer, later
  * increment Head, and to know if reach the Tail compare them, in an TRUE case set the Full flag to TRUE.
+ * To do that the function reserve the space pointed by Head, copy the data and then commit it.
+ * In SPSC mode the queue is full when there are Elements between Tail and Head, the data is copied
+ * before the new Head value is published, so the consumer never sees a half written element.
+ * When the queue has a Coalesce function the data can replace a pending element in place, instead
+ * of take a new space, see Queue_Coalesce.
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
  * @param   data [in] Memory address where is the data to be written.
  *
- * @retval  Return the success of the write action, TRUE if the data was written, and FALSE in case the
- * queue is Full.
+ * @retval  Return the success of the write action, TRUE if the data was written or merged, and FALSE
+ * in case the queue is Full.
  */
 /* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
 unsigned char AppQueue_writeData( AppQue_Queue *queue, const void *data )
@@ -58,27 +154,31 @@ unsigned char AppQueue_writeData( AppQue_Queue *queue, const void *data )
     assert_error( ( data != NULL ), QUEUE_PAR_ERROR );
 
     unsigned char varRet = FALSE;
+    void *element = NULL;
 
-    if ( queue->Full == FALSE)
+    if ( ( queue->Coalesce != NULL ) && ( queue->Spsc == FALSE ) )
     {
-        queue->Empty = FALSE;       //if access to write then the queue will no longer be empty
+        element = Queue_Coalesce( queue, data );
+    }
 
-        /*cppcheck-suppress misra-c2012-11.5 ; 
-        The function receive a void pointer to the buffer
-        if this is changed, the queue can no longer handle any type of data.*/
-        unsigned char *ptrBuffer = (unsigned char*) queue->Buffer;
+    if ( element != NULL )
+    {
+        (void) memcpy( element, data, queue->Size );    //update the pending element in place
+        Queue_Notify( queue );
+        TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, 0u );    //zero elements, merged with a pending one
 
-        (void) memcpy( &ptrBuffer[queue->Head * queue->Size], data, queue->Size );
-        
-        queue->Head++;
-        queue->Head = queue->Head % queue->Elements;
+        varRet = TRUE;
+    }
+    else
+    {
+        element = AppQueue_reserveData( queue );
 
-        if ( queue->Head == queue->Tail )
+        if ( element != NULL )
         {
-            queue->Full = TRUE;
+            (void) memcpy( element, data, queue->Size );
+            
+            varRet = AppQueue_commitData( queue );
         }
-        
-        varRet = TRUE;
     }
     
     return varRet;
@@ -89,6 +189,9 @@ unsigned char AppQueue_writeData( AppQue_Queue *queue, const void *data )
  *
  * First verify if the queue has at least one element, then make a copy of data in the queue, increment
  * Tail, reset it if it's necessary, and check if the queue now its empty to set the corresponding flag.
+ * To do that the function peek the element pointed by Tail, copy it and then release its space.
+ * In SPSC mode the queue is empty when Tail reach Head, the element is copied before the new Tail
+ * value is published, so the producer can not overwrite it while it's been read.
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
  * @param   data [out] Memory address where the read data will be copied.
@@ -103,131 +206,390 @@ unsigned char AppQueue_readData( AppQue_Queue *queue, void *data )
 
     unsigned char varRet = FALSE;
 
-    if ( queue->Empty == FALSE)
+    const void *element = AppQueue_peekData( queue );
+
+    if ( element != NULL )
     {
-        queue->Full = FALSE;
+        (void) memcpy( data, element, queue->Size );
 
-        /*cppcheck-suppress misra-c2012-11.5 ; 
-        The function receive a void pointer to the buffer
-        if this paremeter is changed, the queue can no longer handle any type of data.*/
-        const unsigned char *ptrBuffer = (unsigned char*) queue->Buffer;
+        varRet = AppQueue_releaseData( queue );
+    }
+    
+    return varRet;
+}
 
-        (void) memcpy( data, &ptrBuffer[queue->Tail * queue->Size], queue->Size );
+/**
+ * @brief   Reserve the next free space of the queue to write an element in place.
+ *
+ * Return the address of the space pointed by Head without moving it, the producer can build the
+ * element directly in the queue buffer and then call AppQueue_commitData to make it visible to the
+ * consumer, this avoid the copy made by AppQueue_writeData.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return the address of the reserved space, or NULL in case the queue is Full.
+ *
+ * @note    Only one space can be reserved at a time, calling this function again before commit
+ * returns the same space.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+void *AppQueue_reserveData( AppQue_Queue *queue )
+{
+    void *element = NULL;
 
-        queue->Tail++;
-        queue->Tail = queue->Tail % queue->Elements;
+    if ( queue->Spsc == TRUE )
+    {
+        unsigned char head = queue->Head;   /*only the producer writes Head*/
+        unsigned char tail = queue->Tail;   /*snapshot of the consumer index*/
 
-        if ( queue->Tail == queue->Head )
+        if ( Queue_Used( queue, head, tail ) < queue->Elements )
         {
-            queue->Empty = TRUE;
+            element = Queue_Element( queue, head );
         }
+    }
+    else if ( queue->Full == FALSE )
+    {
+        element = Queue_Element( queue, queue->Head );
+    }
+    else
+    {
+        /*queue full, nothing to reserve*/
+    }
+
+#ifdef QUEUE_STATS
+    if ( element == NULL )
+    {
+        queue->Stats.Rejects++;
+    }
+#endif
+
+    return element;
+}
+
+/**
+ * @brief   Commit the space previously reserved with AppQueue_reserveData.
+ *
+ * Increment Head, and to know if reach the Tail compare them, in an TRUE case set the Full flag to
+ * TRUE. In SPSC mode the new Head value is published only after the element was written.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return TRUE if the element was committed, and FALSE in case the queue is Full.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned char AppQueue_commitData( AppQue_Queue *queue )
+{
+    unsigned char varRet = FALSE;
+
+    if ( queue->Spsc == TRUE )
+    {
+        unsigned char head = queue->Head;
+        unsigned char tail = queue->Tail;
+
+        if ( Queue_Used( queue, head, tail ) < queue->Elements )
+        {
+#ifdef QUEUE_STATS
+            Queue_StatsWrite( queue, head, tail, 1u );
+#endif
+            __COMPILER_BARRIER( );  /*the element must be in the buffer before publish the new Head*/
+
+            queue->Head = Queue_Next( queue, head );
+            Queue_Notify( queue );
+            TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, 1u );
+
+            varRet = TRUE;
+        }
+    }
+    else if ( queue->Full == FALSE )
+    {
+#ifdef QUEUE_STATS
+        Queue_StatsWrite( queue, queue->Head, queue->Tail, 1u );
+#endif
+        queue->Empty = FALSE;       //if access to write then the queue will no longer be empty
+
+        queue->Head = Queue_Wrap( queue, queue->Head );
+
+        if ( queue->Head == queue->Tail )
+        {
+            queue->Full = TRUE;
+        }
+        Queue_Notify( queue );
+        TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, 1u );
 
         varRet = TRUE;
     }
-    
+    else
+    {
+        /*queue full, nothing to commit*/
+    }
+
     return varRet;
 }
 
 /**
- * @brief   Indicate if the queue is Empty or not
+ * @brief   Get the address of the oldest element in the queue without remove it.
  *
- * Just return value of the element (flag) Empty.
+ * Return the address of the element pointed by Tail, the consumer can process the element directly
+ * from the queue buffer and then call AppQueue_releaseData to free its space, this avoid the copy
+ * made by AppQueue_readData.
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
  *
- * @retval  Return the actual value of the flag Empty, TRUE when the queue is empty, and FALSE when
- * the queue has at least one element.
+ * @retval  Return the address of the oldest element, or NULL in case the queue is Empty.
+ *
+ * @note    The element is valid until AppQueue_releaseData or a flush are called.
  */
 /* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
-unsigned char AppQueue_isQueueEmpty( const AppQue_Queue *queue )
+void *AppQueue_peekData( AppQue_Queue *queue )
 {
-    return queue->Empty;
+    void *element = NULL;
+
+    if ( queue->Spsc == TRUE )
+    {
+        unsigned char tail = queue->Tail;   /*only the consumer writes Tail*/
+        unsigned char head = queue->Head;   /*snapshot of the producer index*/
+
+        if ( head != tail )
+        {
+            __COMPILER_BARRIER( );  /*read the element only after the Head snapshot*/
+
+            element = Queue_Element( queue, tail );
+        }
+    }
+    else if ( queue->Empty == FALSE )
+    {
+        queue->Peeked = TRUE;   /*the oldest element can not be merged until its release*/
+
+        element = Queue_Element( queue, queue->Tail );
+    }
+    else
+    {
+        /*queue empty, nothing to peek*/
+    }
+
+    return element;
 }
 
 /**
- * @brief   This function empty the queue.
+ * @brief   Remove the oldest element from the queue.
+ *
+ * Increment Tail, reset it if it's necessary, and check if the queue now its empty to set the
+ * corresponding flag. In SPSC mode the new Tail value is published only after the element was
+ * used, so the producer can not overwrite it before.
  *
- * Reset the elements Tail and Head to zero, and the flags Empty and Full to TRUE and FALSE,
- * respectively, this causes the information contained in the queue to be discarded.
- * 
  * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return TRUE if the element was removed, and FALSE in case the queue is Empty.
  */
 /* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
-void AppQueue_flushQueue( AppQue_Queue *queue )
+unsigned char AppQueue_releaseData( AppQue_Queue *queue )
 {
-    queue->Head = 0;      //Setting index Tail and Head to zero
-    queue->Tail = 0;
-    queue->Empty = TRUE;  //Empty flag to TRUE and Full flg to FALSE
-    queue->Full = FALSE;
-}
+    unsigned char varRet = FALSE;
+
+    if ( queue->Spsc == TRUE )
+    {
+        unsigned char tail = queue->Tail;
+        unsigned char head = queue->Head;
+
+        if ( head != tail )
+        {
+#ifdef QUEUE_STATS
+            Queue_StatsRead( queue, tail, 1u );
+#endif
+            __COMPILER_BARRIER( );  /*the element must be used before release its space*/
+
+            queue->Tail = Queue_Next( queue, tail );
+            TRACE_QUEUE( TRACE_QUEUE_READ, queue, 1u );
+
+            varRet = TRUE;
+        }
+    }
+    else if ( queue->Empty == FALSE )
+    {
+#ifdef QUEUE_STATS
+        Queue_StatsRead( queue, queue->Tail, 1u );
+#endif
+        queue->Full = FALSE;
+        queue->Peeked = FALSE;
+
+        queue->Tail = Queue_Wrap( queue, queue->Tail );
+
+        if ( queue->Tail == queue->Head )
+        {
+            queue->Empty = TRUE;
+        }
+        TRACE_QUEUE( TRACE_QUEUE_READ, queue, 1u );
+
+        varRet = TRUE;
+    }
+    else
+    {
+        /*queue empty, nothing to release*/
+    }
 
+    return varRet;
+}
 
 /**
- * @brief   Copy the given data in the queue buffer.
+ * @brief   Copy up to count elements in the queue buffer with a single call.
+ *
+ * The free space is computed once, then the elements are copied with at most two memcpy, one up
+ * to the end of the buffer and another from the beginning of it, and finally the Head is moved
+ * all the elements at once. In SPSC mode the new Head value is published after the copies.
  *
- * First of all, verify if the queue isn't Full to write data, and as a void pointers is received, it's 
- * necessary cast it to use pointer's arithmetic and to be able to copy the data in the buffer, later
- * increment Head, and to know if reach the Tail compare them, in an TRUE case set the Full flag to TRUE.
- * This function disable the all Interrupts at the beggining and enable them when the task has been 
- * completed.
- * 
  * @param   queue [in] It's the memory address of the queue to access the elements.
- * @param   data [in] Memory address where is the data to be written.
+ * @param   data [in] Memory address of the array with the elements to be written.
+ * @param   count [in] Number of elements in the data array.
  *
- * @retval  Return the success of the write action, TRUE if the data was written, and FALSE in case the
- * queue is Full.
+ * @retval  Return the number of elements written, it's less than count if there is not enough
+ * space in the queue.
  */
-unsigned char HIL_QUEUE_writeDataISR( AppQue_Queue *queue, const void *data )
-{   
-    //__disable_irq( );
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned long AppQueue_writeBatch( AppQue_Queue *queue, const void *data, unsigned long count )
+{
+    assert_error( ( queue->Buffer != NULL ), QUEUE_PAR_ERROR );
+    assert_error( ( queue->Size != 0u ), QUEUE_PAR_ERROR );
+    assert_error( ( data != NULL ), QUEUE_PAR_ERROR );
 
-    unsigned char varRet = AppQueue_writeData( queue, data );
-    
-    //__enable_irq( );
-    
-    return varRet;
+    unsigned char head = queue->Head;
+    unsigned char tail = queue->Tail;
+
+    unsigned long n = queue->Elements - Queue_Count( queue, head, tail );  /*free space*/
+
+    if ( count < n )
+    {
+        n = count;
+    }
+
+#ifdef QUEUE_STATS
+    queue->Stats.Rejects += count - n;
+#endif
+
+    if ( n > 0u )
+    {
+        /*cppcheck-suppress misra-c2012-11.5 ; 
+        The queue receive a void pointer to the data
+        if this is changed, the queue can no longer handle any type of data.*/
+        const unsigned char *ptrData = (const unsigned char*) data;
+
+        unsigned long first = queue->Elements - Queue_Slot( queue, head );  /*space up to the end*/
+
+        if ( n < first )
+        {
+            first = n;
+        }
+
+        (void) memcpy( Queue_Element( queue, head ), ptrData, first * queue->Size );
+        (void) memcpy( Queue_Element( queue, 0u ), &ptrData[ first * queue->Size ], ( n - first ) * queue->Size );
+
+#ifdef QUEUE_STATS
+        Queue_StatsWrite( queue, head, tail, n );
+#endif
+        __COMPILER_BARRIER( );  /*the elements must be in the buffer before publish the new Head*/
+
+        queue->Head = Queue_Advance( queue, head, n );
+
+        if ( queue->Spsc == FALSE )
+        {
+            queue->Empty = FALSE;
+            queue->Full  = ( queue->Head == queue->Tail ) ? TRUE : FALSE;
+        }
+        Queue_Notify( queue );
+        TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, n );
+    }
+
+    return n;
 }
 
 /**
- * @brief   Copy the data of the buffer in the memmory address given.
+ * @brief   Copy up to count elements of the queue in the memory address given with a single call.
  *
- * First verify if the queue has at least one element, then make a copy of data in the queue, increment
- * Tail, reset it if it's necessary, and check if the queue now its empty to set the corresponding flag.  
- * This function disable the all Interrupts at the beggining and enable them when the task has been 
- * completed.
+ * The number of elements stored is computed once, then the elements are copied with at most two
+ * memcpy, one up to the end of the buffer and another from the beginning of it, and finally the
+ * Tail is moved all the elements at once. In SPSC mode the new Tail value is published after the
+ * copies.
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
- * @param   data [out] Memory address where the read data will be copied.
+ * @param   data [out] Memory address of the array where the read elements will be copied.
+ * @param   count [in] Max number of elements that fit in the data array.
  *
- * @retval  Return the success of the read action, TRUE if the data was read, and FALSE in case the
- * queue is Empty.
+ * @retval  Return the number of elements read, zero in case the queue is Empty.
  */
-unsigned char HIL_QUEUE_readDataISR( AppQue_Queue *queue, void *data )
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned long AppQueue_readBatch( AppQue_Queue *queue, void *data, unsigned long count )
 {
-    //__disable_irq( );
+    assert_error( ( data != NULL ), QUEUE_PAR_ERROR );
 
-    unsigned char varRet = AppQueue_readData( queue, data );
-    
-    //__enable_irq( );
+    unsigned char tail = queue->Tail;
+    unsigned char head = queue->Head;
 
-    return varRet;
+    unsigned long n = Queue_Count( queue, head, tail );
+
+    if ( count < n )
+    {
+        n = count;
+    }
+
+    if ( n > 0u )
+    {
+        /*cppcheck-suppress misra-c2012-11.5 ; 
+        The queue receive a void pointer to the data
+        if this is changed, the queue can no longer handle any type of data.*/
+        unsigned char *ptrData = (unsigned char*) data;
+
+        unsigned long first = queue->Elements - Queue_Slot( queue, tail );  /*elements up to the end*/
+
+        if ( n < first )
+        {
+            first = n;
+        }
+
+        __COMPILER_BARRIER( );  /*read the elements only after the Head snapshot*/
+
+        (void) memcpy( ptrData, Queue_Element( queue, tail ), first * queue->Size );
+        (void) memcpy( &ptrData[ first * queue->Size ], Queue_Element( queue, 0u ), ( n - first ) * queue->Size );
+
+#ifdef QUEUE_STATS
+        Queue_StatsRead( queue, tail, n );
+#endif
+
+        __COMPILER_BARRIER( );  /*the elements must be copied before release its space*/
+
+        queue->Tail = Queue_Advance( queue, tail, n );
+
+        if ( queue->Spsc == FALSE )
+        {
+            queue->Full  = FALSE;
+            queue->Empty = ( queue->Tail == queue->Head ) ? TRUE : FALSE;
+        }
+        TRACE_QUEUE( TRACE_QUEUE_READ, queue, n );
+    }
+
+    return n;
 }
 
 /**
  * @brief   Indicate if the queue is Empty or not
  *
- * Just return value of the element (flag) Empty.
- * This function disable the all Interrupts at the beggining and enable them when the task has been 
- * completed.
+ * Just return value of the element (flag) Empty, in SPSC mode the queue is empty when the indexes
+ * Head and Tail are equal.
  *
  * @param   queue [in] It's the memory address of the queue to access the elements.
  *
  * @retval  Return the actual value of the flag Empty, TRUE when the queue is empty, and FALSE when
  * the queue has at least one element.
  */
-unsigned char HIL_QUEUE_isQueueEmptyISR( const AppQue_Queue *queue )
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned char AppQueue_isQueueEmpty( const AppQue_Queue *queue )
 {
-    return queue->Empty;
+    unsigned char varRet = queue->Empty;
+
+    if ( queue->Spsc == TRUE )
+    {
+        varRet = ( queue->Head == queue->Tail ) ? TRUE : FALSE;
+    }
+
+    return varRet;
 }
 
 /**
@@ -235,14 +597,890 @@ unsigned char HIL_QUEUE_isQueueEmptyISR( const AppQue_Queue *queue )
  *
  * Reset the elements Tail and Head to zero, and the flags Empty and Full to TRUE and FALSE,
  * respectively, this causes the information contained in the queue to be discarded.
- * This function disable the all Interrupts at the beggining and enable them when the task has been 
- * completed.
+ * In SPSC mode the Tail index is moved up to the Head, then the producer index is never written.
  * 
  * @param   queue [in] It's the memory address of the queue to access the elements.
+ * 
+ * @note    In SPSC mode this function can only be called by the consumer.
  */
-void HIL_QUEUE_flushQueueISR( AppQue_Queue *queue )
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+void AppQueue_flushQueue( AppQue_Queue *queue )
 {
-    //__disable_irq( );
-    AppQueue_flushQueue( queue );
+    if ( queue->Spsc == TRUE )
+    {
+        queue->Tail = queue->Head;
+    }
+    else
+    {
+        queue->Head = 0;      //Setting index Tail and Head to zero
+        queue->Tail = 0;
+        queue->Empty = TRUE;  //Empty flag to TRUE and Full flg to FALSE
+        queue->Full = FALSE;
+        queue->Peeked = FALSE;
+    }
+}
+
+/**
+ * @brief   Interface to initialize a priority queue.
+ *
+ * Initialize every lane with AppQueue_initQueue and clear the Ready bitmap.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ *
+ * @note Before using this function it's mandatory initialized the elements: Lanes, Levels and Level,
+ * and the elements Buffer, Elements and Size of each lane. Levels can not be greater than
+ * QUEUE_PRIO_MAX_LEVELS.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+void AppQueue_initPrioQueue( AppQue_PrioQueue *prio )
+{
+    assert_error( ( prio->Lanes != NULL ), QUEUE_PAR_ERROR );
+    assert_error( ( prio->Levels != 0u ) && ( prio->Levels <= QUEUE_PRIO_MAX_LEVELS ), QUEUE_PAR_ERROR );
+    assert_error( ( prio->Level != NULL ), QUEUE_PAR_ERROR );
+
+    for ( unsigned char i = 0; i < prio->Levels; i++ )
+    {
+        (void) AppQueue_initQueue( &prio->Lanes[ i ] );
+    }
+
+    prio->Ready = 0u;
+}
+
+/**
+ * @brief   Copy the given data in the lane of its priority level.
+ *
+ * The level is given by the function Level of the priority queue, a level out of range is taken as
+ * the lowest priority. Once the data is in the lane its bit in the Ready bitmap is set.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   data [in] Memory address where is the data to be written.
+ *
+ * @retval  Return TRUE if the data was written, and FALSE in case the lane is Full.
+ *
+ * @note    A lane can have several producers, tasks and interrupts, and the lanes are not in SPSC
+ * mode, then the write in the lane and the set of its Ready bit are done in a single section with
+ * the interrupts disabled, PRIMASK is restored to its previous state after.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned char AppQueue_writePrio( AppQue_PrioQueue *prio, const void *data )
+{
+    unsigned char level = prio->Level( data );
+
+    if ( level >= prio->Levels )
+    {
+        level = prio->Levels - 1u;
+    }
+
+#ifndef UTEST
+    uint32_t primask = __get_PRIMASK( );
+    __disable_irq( );
+#endif
+
+    unsigned char varRet = AppQueue_writeData( &prio->Lanes[ level ], data );
+
+    if ( varRet == TRUE )
+    {
+        Queue_SetReady( prio, level );
+    }
+
+#ifndef UTEST
+    __set_PRIMASK( primask );
+#endif
+
+    return varRet;
+}
+
+/**
+ * @brief   Get the address of the oldest element of the highest priority level.
+ *
+ * The highest non empty lane is taken from the Ready bitmap with a table look up, so the time it
+ * takes doesn't depend on the number of elements in the lanes, then the element is peeked from
+ * that lane without remove it.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [out] Level of the lane where the element is, to release it later.
+ *
+ * @retval  Return the address of the element, or NULL in case all the lanes are Empty.
+ *
+ * @note    Release the element with AppQueue_releasePrio and the level returned, a new element
+ * with higher priority can arrive before that.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+void *AppQueue_peekPrio( AppQue_PrioQueue *prio, unsigned char *level )
+{
+    void *element = NULL;
+
+    while ( ( element == NULL ) && ( prio->Ready != 0u ) )
+    {
+        *level = Queue_HighestLevel( prio->Ready );
+
+        element = AppQueue_peekData( &prio->Lanes[ *level ] );
+
+        if ( element == NULL )
+        {
+#ifndef UTEST
+            uint32_t primask = __get_PRIMASK( );
+            __disable_irq( );
+#endif
+            if ( AppQueue_isQueueEmpty( &prio->Lanes[ *level ] ) == TRUE )
+            {
+                Queue_ClearReady( prio, *level );   /*bit without elements, should not happen*/
+            }
+#ifndef UTEST
+            __set_PRIMASK( primask );
+#endif
+        }
+    }
+
+    return element;
+}
+
+/**
+ * @brief   Remove the oldest element of a lane.
+ *
+ * Release the element from the lane, and if the lane is now empty clear its bit in the Ready
+ * bitmap. The release and the bitmap update are done with the interrupts disabled, the producers
+ * of the lane can be interrupts writing with AppQueue_writePrio at the same time.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level returned by AppQueue_peekPrio.
+ *
+ * @retval  Return TRUE if the element was removed, and FALSE in case the lane is Empty.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned char AppQueue_releasePrio( AppQue_PrioQueue *prio, unsigned char level )
+{
+    assert_error( ( level < prio->Levels ), QUEUE_PAR_ERROR );
+
+    unsigned char varRet = FALSE;
+
+    if ( level < prio->Levels )
+    {
+#ifndef UTEST
+        uint32_t primask = __get_PRIMASK( );
+        __disable_irq( );
+#endif
+
+        varRet = AppQueue_releaseData( &prio->Lanes[ level ] );
+
+        if ( AppQueue_isQueueEmpty( &prio->Lanes[ level ] ) == TRUE )
+        {
+            Queue_ClearReady( prio, level );
+        }
+
+#ifndef UTEST
+        __set_PRIMASK( primask );
+#endif
+    }
+
+    return varRet;
+}
+
+/**
+ * @brief   Discard all the elements of a lane.
+ *
+ * Flush the lane and clear its bit in the Ready bitmap, both with the interrupts disabled because
+ * the producers of the lane can be interrupts writing with AppQueue_writePrio at the same time.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level of the lane to discard.
+ *
+ * @note    Must be called from the consumer of the priority queue and never while an element of
+ * that lane is peeked.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+void AppQueue_flushPrio( AppQue_PrioQueue *prio, unsigned char level )
+{
+    assert_error( ( level < prio->Levels ), QUEUE_PAR_ERROR );
+
+    if ( level < prio->Levels )
+    {
+#ifndef UTEST
+        uint32_t primask = __get_PRIMASK( );
+        __disable_irq( );
+#endif
+
+        AppQueue_flushQueue( &prio->Lanes[ level ] );
+        Queue_ClearReady( prio, level );
+
+#ifndef UTEST
+        __set_PRIMASK( primask );
+#endif
+    }
+}
+
+/**
+ * @brief   Indicate if all the lanes of the priority queue are Empty.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ *
+ * @retval  Return TRUE when the priority queue is empty, and FALSE when it has at least one element.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned char AppQueue_isPrioQueueEmpty( const AppQue_PrioQueue *prio )
+{
+    return ( prio->Ready == 0u ) ? TRUE : FALSE;
+}
+
+/**
+ * @brief   Free space of the lane where an element would be written.
+ *
+ * The level is given by the function Level of the priority queue like in AppQueue_writePrio, so a
+ * producer can check that several writes fit before start them.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   data [in] Memory address of an element of the lane to check.
+ *
+ * @retval  Return the number of elements that can be written in the lane.
+ */
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned long AppQueue_freePrio( const AppQue_PrioQueue *prio, const void *data )
+{
+    unsigned char level = prio->Level( data );
+
+    if ( level >= prio->Levels )
+    {
+        level = prio->Levels - 1u;
+    }
+
+    const AppQue_Queue *lane = &prio->Lanes[ level ];
+
+    return lane->Elements - Queue_Count( lane, lane->Head, lane->Tail );
+}
+
+
+/**
+ * @brief   Copy the given data in the queue buffer.
+ *
+ * First of all, verify if the queue isn't Full to write data, and as a void pointers is received, it's 
+ * necessary cast it to use pointer's arithmetic and to be able to copy the data in the buffer, later
+ * increment Head, and to know if reach the Tail compare them, in an TRUE case set the Full flag to TRUE.
+ * This function disable the all Interrupts at the beggining and enable them when the task has been 
+ * completed.
+ * 
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   data [in] Memory address where is the data to be written.
+ *
+ * @retval  Return the success of the write action, TRUE if the data was written, and FALSE in case the
+ * queue is Full.
+ */
+unsigned char HIL_QUEUE_writeDataISR( AppQue_Queue *queue, const void *data )
+{   
+    //__disable_irq( );
+
+    unsigned char varRet = AppQueue_writeData( queue, data );
+    
     //__enable_irq( );
-}
\ No newline at end of file
+    
+    return varRet;
+}
+
+/**
+ * @brief   Copy the data of the buffer in the memmory address given.
+ *
+ * First verify if the queue has at least one element, then make a copy of data in the queue, increment
+ * Tail, reset it if it's necessary, and check if the queue now its empty to set the corresponding flag.  
+ * This function disable the all Interrupts at the beggining and enable them when the task has been 
+ * completed.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   data [out] Memory address where the read data will be copied.
+ *
+ * @retval  Return the success of the read action, TRUE if the data was read, and FALSE in case the
+ * queue is Empty.
+ */
+unsigned char HIL_QUEUE_readDataISR( AppQue_Queue *queue, void *data )
+{
+    //__disable_irq( );
+
+    unsigned char varRet = AppQueue_readData( queue, data );
+    
+    //__enable_irq( );
+
+    return varRet;
+}
+
+/**
+ * @brief   Reserve the next free space of the queue to write an element in place.
+ *
+ * Return the address of the space pointed by Head without moving it, through
+ * AppQueue_reserveData. The interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return the address of the reserved space, or NULL in case the queue is Full.
+ */
+void *HIL_QUEUE_reserveDataISR( AppQue_Queue *queue )
+{
+    void *element = AppQueue_reserveData( queue );
+
+    return element;
+}
+
+/**
+ * @brief   Commit the space previously reserved with HIL_QUEUE_reserveDataISR.
+ *
+ * Increment Head and set the Full flag if it reach the Tail, through AppQueue_commitData. The
+ * interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return TRUE if the element was committed, and FALSE in case the queue is Full.
+ */
+unsigned char HIL_QUEUE_commitDataISR( AppQue_Queue *queue )
+{
+    unsigned char varRet = AppQueue_commitData( queue );
+
+    return varRet;
+}
+
+/**
+ * @brief   Get the address of the oldest element in the queue without remove it.
+ *
+ * Return the address of the element pointed by Tail without moving it, through
+ * AppQueue_peekData. The interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return the address of the oldest element, or NULL in case the queue is Empty.
+ */
+void *HIL_QUEUE_peekDataISR( AppQue_Queue *queue )
+{
+    void *element = AppQueue_peekData( queue );
+
+    return element;
+}
+
+/**
+ * @brief   Remove the oldest element from the queue.
+ *
+ * Increment Tail and set the Empty flag if it reach the Head, through AppQueue_releaseData. The
+ * interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return TRUE if the element was removed, and FALSE in case the queue is Empty.
+ */
+unsigned char HIL_QUEUE_releaseDataISR( AppQue_Queue *queue )
+{
+    unsigned char varRet = AppQueue_releaseData( queue );
+
+    return varRet;
+}
+
+/**
+ * @brief   Copy up to count elements in the queue buffer with a single call.
+ *
+ * Call AppQueue_writeBatch. The interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   data [in] Memory address of the array with the elements to be written.
+ * @param   count [in] Number of elements in the data array.
+ *
+ * @retval  Return the number of elements written.
+ */
+unsigned long HIL_QUEUE_writeBatchISR( AppQue_Queue *queue, const void *data, unsigned long count )
+{
+    unsigned long varRet = AppQueue_writeBatch( queue, data, count );
+
+    return varRet;
+}
+
+/**
+ * @brief   Copy up to count elements of the queue in the memory address given with a single call.
+ *
+ * Call AppQueue_readBatch. The interrupts are not masked.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   data [out] Memory address of the array where the read elements will be copied.
+ * @param   count [in] Max number of elements that fit in the data array.
+ *
+ * @retval  Return the number of elements read.
+ */
+unsigned long HIL_QUEUE_readBatchISR( AppQue_Queue *queue, void *data, unsigned long count )
+{
+    unsigned long varRet = AppQueue_readBatch( queue, data, count );
+
+    return varRet;
+}
+
+/**
+ * @brief   Indicate if the queue is Empty or not
+ *
+ * Just return value of the element (flag) Empty.
+ * This function disable the all Interrupts at the beggining and enable them when the task has been 
+ * completed.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ *
+ * @retval  Return the actual value of the flag Empty, TRUE when the queue is empty, and FALSE when
+ * the queue has at least one element.
+ */
+unsigned char HIL_QUEUE_isQueueEmptyISR( const AppQue_Queue *queue )
+{
+    return AppQueue_isQueueEmpty( queue );
+}
+
+/**
+ * @brief   This function empty the queue.
+ *
+ * Reset the elements Tail and Head to zero, and the flags Empty and Full to TRUE and FALSE,
+ * respectively, this causes the information contained in the queue to be discarded.
+ * This function disable the all Interrupts at the beggining and enable them when the task has been 
+ * completed.
+ * 
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ */
+void HIL_QUEUE_flushQueueISR( AppQue_Queue *queue )
+{
+    //__disable_irq( );
+    AppQueue_flushQueue( queue );
+    //__enable_irq( );
+}
+
+/**
+ * @brief   Copy the given data in the lane of its priority level.
+ *
+ * Call AppQueue_writePrio, which masks the interrupts around the lane and Ready update.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   data [in] Memory address where is the data to be written.
+ *
+ * @retval  Return TRUE if the data was written, and FALSE in case the lane is Full.
+ */
+unsigned char HIL_QUEUE_writePrioISR( AppQue_PrioQueue *prio, const void *data )
+{
+    unsigned char varRet = AppQueue_writePrio( prio, data );
+
+    return varRet;
+}
+
+/**
+ * @brief   Get the address of the oldest element of the highest priority level.
+ *
+ * Call AppQueue_peekPrio, which masks the interrupts only to clear an empty lane from Ready.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [out] Level of the lane where the element is, to release it later.
+ *
+ * @retval  Return the address of the element, or NULL in case all the lanes are Empty.
+ */
+void *HIL_QUEUE_peekPrioISR( AppQue_PrioQueue *prio, unsigned char *level )
+{
+    void *element = AppQueue_peekPrio( prio, level );
+
+    return element;
+}
+
+/**
+ * @brief   Remove the oldest element of a lane.
+ *
+ * Call AppQueue_releasePrio, which masks the interrupts around the lane and Ready update.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level returned by HIL_QUEUE_peekPrioISR.
+ *
+ * @retval  Return TRUE if the element was removed, and FALSE in case the lane is Empty.
+ */
+unsigned char HIL_QUEUE_releasePrioISR( AppQue_PrioQueue *prio, unsigned char level )
+{
+    unsigned char varRet = AppQueue_releasePrio( prio, level );
+
+    return varRet;
+}
+
+/**
+ * @brief   Discard all the elements of a lane.
+ *
+ * Call AppQueue_flushPrio, which masks the interrupts around the lane and Ready update.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level of the lane to discard.
+ */
+void HIL_QUEUE_flushPrioISR( AppQue_PrioQueue *prio, unsigned char level )
+{
+    AppQueue_flushPrio( prio, level );
+}
+
+/**
+ * @brief   Free space of the lane where an element would be written.
+ *
+ * Call AppQueue_freePrio. The interrupts are not masked, the value is a snapshot.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   data [in] Memory address of an element of the lane to check.
+ *
+ * @retval  Return the number of elements that can be written in the lane.
+ */
+unsigned long HIL_QUEUE_freePrioISR( const AppQue_PrioQueue *prio, const void *data )
+{
+    unsigned long varRet = AppQueue_freePrio( prio, data );
+
+    return varRet;
+}
+
+/**
+ * @brief   Number of elements stored in a SPSC queue.
+ *
+ * The indexes run from 0 to 2*Elements - 1, then if the Head is behind the Tail it's necessary
+ * add 2*Elements to get the difference between them.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   head [in] Head index snapshot.
+ * @param   tail [in] Tail index snapshot.
+ *
+ * @retval  Return the number of elements in the queue.
+ */
+static unsigned long Queue_Used( const AppQue_Queue *queue, unsigned char head, unsigned char tail )
+{
+    unsigned long used = (unsigned long) head - (unsigned long) tail;
+
+    if ( queue->Pow2 == TRUE )
+    {
+        used &= ( queue->Elements * 2u ) - 1u;
+    }
+    else if ( head < tail )
+    {
+        used = ( queue->Elements * 2u ) - ( (unsigned long) tail - (unsigned long) head );
+    }
+    else
+    {
+        /*Head is ahead of Tail, the difference is already the number of elements*/
+    }
+
+    return used;
+}
+
+/**
+ * @brief   Buffer position of a SPSC index.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   index [in] Head or Tail index.
+ *
+ * @retval  Return the buffer position, from 0 to Elements - 1.
+ */
+static unsigned long Queue_Slot( const AppQue_Queue *queue, unsigned char index )
+{
+    unsigned long slot = index;
+
+    if ( queue->Pow2 == TRUE )
+    {
+        slot &= queue->Elements - 1u;
+    }
+    else if ( slot >= queue->Elements )
+    {
+        slot -= queue->Elements;
+    }
+    else
+    {
+        /*index already inside the buffer*/
+    }
+
+    return slot;
+}
+
+/**
+ * @brief   Next value of a SPSC index.
+ *
+ * Increment the index and reset it when reach 2*Elements, without using a division.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   index [in] Head or Tail index.
+ *
+ * @retval  Return the next index value.
+ */
+static unsigned char Queue_Next( const AppQue_Queue *queue, unsigned char index )
+{
+    unsigned char next = (unsigned char) ( index + 1u );
+
+    if ( queue->Pow2 == TRUE )
+    {
+        next &= (unsigned char) ( ( queue->Elements * 2u ) - 1u );
+    }
+    else if ( next >= ( queue->Elements * 2u ) )
+    {
+        next = 0u;
+    }
+    else
+    {
+        /*the index has not reach 2*Elements*/
+    }
+
+    return next;
+}
+
+/**
+ * @brief   Address of the element pointed by an index.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   index [in] Head or Tail index.
+ *
+ * @retval  Return the address of the element in the queue buffer.
+ */
+static unsigned char *Queue_Element( const AppQue_Queue *queue, unsigned char index )
+{
+    /*cppcheck-suppress misra-c2012-11.5 ; 
+    The queue receive a void pointer to the buffer
+    if this is changed, the queue can no longer handle any type of data.*/
+    unsigned char *ptrBuffer = (unsigned char*) queue->Buffer;
+
+    return &ptrBuffer[ Queue_Slot( queue, index ) * queue->Size ];
+}
+
+/**
+ * @brief   Next value of a Head or Tail index in the classic mode.
+ *
+ * Increment the index and wrap it into the range 0 to Elements - 1, using a mask in Pow2 mode
+ * and the modulo operator otherwise.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   index [in] Head or Tail index.
+ *
+ * @retval  Return the next index value.
+ */
+static unsigned char Queue_Wrap( const AppQue_Queue *queue, unsigned char index )
+{
+    unsigned long next = (unsigned long) index + 1u;
+
+    if ( queue->Pow2 == TRUE )
+    {
+        next &= queue->Elements - 1u;
+    }
+    else
+    {
+        next %= queue->Elements;
+    }
+
+    return (unsigned char) next;
+}
+
+/**
+ * @brief   Number of elements stored in the queue.
+ *
+ * In SPSC mode is computed from the indexes, in the classic mode the Full flag is used to tell
+ * apart a full queue from an empty one when Head and Tail are equal.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   head [in] Head index snapshot.
+ * @param   tail [in] Tail index snapshot.
+ *
+ * @retval  Return the number of elements in the queue.
+ */
+static unsigned long Queue_Count( const AppQue_Queue *queue, unsigned char head, unsigned char tail )
+{
+    unsigned long used;
+
+    if ( queue->Spsc == TRUE )
+    {
+        used = Queue_Used( queue, head, tail );
+    }
+    else if ( queue->Full == TRUE )
+    {
+        used = queue->Elements;
+    }
+    else if ( head >= tail )
+    {
+        used = (unsigned long) head - (unsigned long) tail;
+    }
+    else
+    {
+        used = ( queue->Elements - (unsigned long) tail ) + (unsigned long) head;
+    }
+
+    return used;
+}
+
+/**
+ * @brief   Move a Head or Tail index n positions.
+ *
+ * The indexes run up to Elements - 1, or up to 2*Elements - 1 in SPSC mode, as n is never greater
+ * than Elements a single subtraction is enough to wrap the index, without using a division.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   index [in] Head or Tail index.
+ * @param   n [in] Number of positions to move the index.
+ *
+ * @retval  Return the new index value.
+ */
+static unsigned char Queue_Advance( const AppQue_Queue *queue, unsigned char index, unsigned long n )
+{
+    unsigned long range = ( queue->Spsc == TRUE ) ? ( queue->Elements * 2u ) : queue->Elements;
+    unsigned long next  = (unsigned long) index + n;
+
+    if ( next >= range )
+    {
+        next -= range;
+    }
+
+    return (unsigned char) next;
+}
+
+/**
+ * @brief   Look for a pending element to merge with the new data.
+ *
+ * Pass the data and each pending element to the Coalesce function of the queue, from the newest
+ * element to the oldest, until the function returns QUEUE_COALESCE_MERGE or QUEUE_COALESCE_STOP.
+ * The oldest element is skipped when the flag Peeked is set, the consumer could be processing it
+ * and its release would discard the new data.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   data [in] Memory address of the data to be written.
+ *
+ * @retval  Return the address of the element to replace, or NULL to append the data.
+ */
+static unsigned char *Queue_Coalesce( const AppQue_Queue *queue, const void *data )
+{
+    unsigned char *element = NULL;
+    unsigned char index = queue->Head;
+    unsigned long used = Queue_Count( queue, queue->Head, queue->Tail );
+    unsigned long oldest = ( queue->Peeked == TRUE ) ? 1u : 0u;
+    unsigned char verdict = QUEUE_COALESCE_SKIP;
+
+    while ( ( used > oldest ) && ( verdict == QUEUE_COALESCE_SKIP ) )
+    {
+        index = Queue_Advance( queue, index, queue->Elements - 1u );    //previous index, one lap minus one
+
+        verdict = queue->Coalesce( data, Queue_Element( queue, index ) );
+
+        used--;
+    }
+
+    if ( verdict == QUEUE_COALESCE_MERGE )
+    {
+        element = Queue_Element( queue, index );
+    }
+
+    return element;
+}
+
+/**
+ * @brief   Set the bit of a lane in the Ready bitmap.
+ *
+ * The bitmap is written by the producers, tasks or interrupts, and by the consumer, then the
+ * read-modify-write must be called with the interrupts disabled, together with the lane update.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level of the lane.
+ */
+static void Queue_SetReady( AppQue_PrioQueue *prio, unsigned char level )
+{
+    prio->Ready |= (unsigned char) ( 1u << level );
+}
+
+/**
+ * @brief   Clear the bit of a lane in the Ready bitmap.
+ *
+ * Like Queue_SetReady it must be called with the interrupts disabled.
+ *
+ * @param   prio [in] It's the memory address of the priority queue.
+ * @param   level [in] Level of the lane.
+ */
+static void Queue_ClearReady( AppQue_PrioQueue *prio, unsigned char level )
+{
+    prio->Ready &= (unsigned char) ~( 1u << level );
+}
+
+/**
+ * @brief   Highest priority level with elements.
+ *
+ * Look for the lowest bit set in the Ready bitmap using a table with the answer for each nibble,
+ * the Cortex-M0+ has no instruction to count the zeros.
+ *
+ * @param   ready [in] Ready bitmap snapshot, can not be zero.
+ *
+ * @retval  Return the level of the lowest bit set.
+ */
+static unsigned char Queue_HighestLevel( unsigned char ready )
+{
+    static const unsigned char LowestBit[ 16 ] = { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+    unsigned char level = LowestBit[ ready & 0x0Fu ];
+
+    if ( ( ready & 0x0Fu ) == 0u )
+    {
+        level = 4u + LowestBit[ ready >> 4u ];
+    }
+
+    return level;
+}
+
+/**
+ * @brief   Activate the consumer task of the queue.
+ *
+ * Called after the new elements are visible to the consumer, set to TRUE the flag pointed by Event,
+ * if the queue has one.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ */
+static void Queue_Notify( const AppQue_Queue *queue )
+{
+    if ( queue->Event != NULL )
+    {
+        *queue->Event = TRUE;
+    }
+}
+
+#ifdef QUEUE_STATS
+/**
+ * @brief   Update the counters of the queue when n elements are written.
+ *
+ * Called before the new Head value is published, update the high-water mark and the number of
+ * writes, and stamp the slots of the new elements with the HAL tick.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   head [in] Head index before the write.
+ * @param   tail [in] Tail index snapshot.
+ * @param   n [in] Number of elements written.
+ */
+static void Queue_StatsWrite( AppQue_Queue *queue, unsigned char head, unsigned char tail, unsigned long n )
+{
+    unsigned long used = Queue_Count( queue, head, tail ) + n;
+
+    if ( used > queue->Stats.HighWater )
+    {
+        queue->Stats.HighWater = used;
+    }
+
+    queue->Stats.Writes += n;
+
+    if ( queue->Stats.Stamps != NULL )
+    {
+        uint32_t tick = HAL_GetTick( );
+
+        for ( unsigned long i = 0; i < n; i++ )
+        {
+            queue->Stats.Stamps[ Queue_Slot( queue, head ) ] = tick;
+            head = Queue_Advance( queue, head, 1u );
+        }
+    }
+}
+
+/**
+ * @brief   Update the max dwell time when n elements are read.
+ *
+ * The time each element waited is the HAL tick minus the stamp of its slot.
+ *
+ * @param   queue [in] It's the memory address of the queue to access the elements.
+ * @param   tail [in] Tail index before the read.
+ * @param   n [in] Number of elements read.
+ */
+static void Queue_StatsRead( AppQue_Queue *queue, unsigned char tail, unsigned long n )
+{
+    if ( queue->Stats.Stamps != NULL )
+    {
+        uint32_t tick = HAL_GetTick( );
+
+        for ( unsigned long i = 0; i < n; i++ )
+        {
+            unsigned long dwell = tick - queue->Stats.Stamps[ Queue_Slot( queue, tail ) ];
+
+            if ( dwell > queue->Stats.MaxDwell )
+            {
+                queue->Stats.MaxDwell = dwell;
+            }
+
+            tail = Queue_Advance( queue, tail, 1u );
+        }
+    }
+}
+#endif
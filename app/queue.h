@@ -7,6 +7,8 @@
 #ifndef QUEUE_H_
 #define QUEUE_H_
 
+#include "trace.h"
+
 /** 
   * @defgroup BooleanValues This define are used to avoid magical nmumbers 0 and 1
   @{ */
@@ -15,6 +17,40 @@
 /**
   @} */
 
+#define QUEUE_SPSC_MAX_ELEMENTS     127u    /*!< Max queue lenght in SPSC mode, indexes run up to 2*Elements */
+
+#define QUEUE_PRIO_MAX_LEVELS       8u      /*!< Max number of levels in a priority queue, one bit each in Ready */
+
+/** 
+  * @defgroup CoalesceValues Values returned by the Coalesce function of a queue
+  @{ */
+#define QUEUE_COALESCE_SKIP         0u      /*!< The pending element is not related to the new one, keep looking */
+#define QUEUE_COALESCE_MERGE        1u      /*!< The new element replaces the pending one in place */
+#define QUEUE_COALESCE_STOP         2u      /*!< The new element must go after the pending one, stop looking */
+/**
+  @} */
+
+#ifdef QUEUE_STATS
+/**
+ * @struct AppQue_Stats
+ * 
+ * @brief Occupancy counters of a queue, only compiled when the macro QUEUE_STATS is defined.
+ * 
+*/
+typedef struct
+{
+    unsigned long HighWater;    /*!< max number of elements stored at the same time*/
+    unsigned long Writes;       /*!< total number of elements written*/
+    unsigned long Rejects;      /*!< number of elements rejected because the queue was full*/
+    unsigned long MaxDwell;     /*!< max time in ms (HAL tick) that an element waited to be read*/
+    unsigned long *Stamps;      /*!< array of Elements ticks to stamp each slot, NULL to not measure the dwell*/
+} AppQue_Stats;
+
+#define QUEUE_TYPED_STATS           AppQue_Stats Stats;     /*!< Stats member of the typed queues*/
+#else
+#define QUEUE_TYPED_STATS                                   /*!< without QUEUE_STATS the typed queues have no Stats*/
+#endif
+
 /**
  * @struct AppQue_Queue
  * 
@@ -26,29 +62,304 @@ typedef struct
     void *Buffer;                 /*!< pointer to array that store buffer data */ 
     unsigned long    Elements;    /*!< number of elements to store (the queue lenght)*/ 
     unsigned char     Size;       /*!< size of the elements to store*/ 
-    unsigned char     Head;       /*!< variable to signal the next queue space to write*/  
-    unsigned char     Tail;       /*!< variable to signal the next queue space to read*/
-    unsigned char     Empty;      /*!< flag to indicate if the queue is empty*/
-    unsigned char     Full;       /*!< flag to indicate if the queue is full*/
+    volatile unsigned char Head;  /*!< variable to signal the next queue space to write*/  
+    volatile unsigned char Tail;  /*!< variable to signal the next queue space to read*/
+    unsigned char     Empty;      /*!< flag to indicate if the queue is empty (not used in SPSC mode)*/
+    unsigned char     Full;       /*!< flag to indicate if the queue is full (not used in SPSC mode)*/
+    volatile unsigned char Peeked; /*!< TRUE from the peek of the oldest element to its release, it can not be merged*/
+    unsigned char     Spsc;       /*!< TRUE to work as a lock-free single producer/single consumer ring*/
+    unsigned char     Pow2;       /*!< TRUE to wrap the indexes with a mask, Elements must be a power of two*/
+    unsigned char (*Coalesce)( const void *data, const void *element ); /*!< function to merge a new element with a pending one, NULL to always append*/
+    volatile unsigned char *Event;  /*!< flag set to TRUE after each write to activate the consumer task, NULL for none*/
+#ifdef QUEUE_STATS
+    AppQue_Stats      Stats;      /*!< occupancy counters*/
+#endif
 } AppQue_Queue;
 
+/**
+ * @struct AppQue_PrioQueue
+ * 
+ * @brief Struct of a multi-priority queue, made of one AppQue_Queue (lane) per priority level.
+ * 
+*/
+typedef struct
+{
+    AppQue_Queue *Lanes;                        /*!< array of queues, one per level, level 0 is the highest priority*/
+    unsigned char Levels;                       /*!< number of priority levels (elements in Lanes)*/
+    unsigned char (*Level)( const void *data ); /*!< function to get the priority level of an element*/
+    volatile unsigned char Ready;               /*!< bitmap with the bit n set when the lane n has elements*/
+} AppQue_PrioQueue;
+
+
 
-void AppQueue_initQueue( AppQue_Queue *queue );
+#ifdef QUEUE_STATS
+/* cppcheck-suppress-begin misra-c2012-20.7 ; helpers of QUEUE_DEFINE, the parameter is always a struct pointer */
+#define QUEUE_TYPED_WRITTEN( queue, used )                                                          \
+    do {                                                                                            \
+        (queue)->Stats.Writes++;                                                                    \
+        if( (unsigned long)(used) > (queue)->Stats.HighWater )                                      \
+        {                                                                                           \
+            (queue)->Stats.HighWater = (used);                                                      \
+        }                                                                                           \
+    } while( 0 )                                                    /*!< Count a write in a typed queue */
+#define QUEUE_TYPED_REJECTED( queue )       ( (queue)->Stats.Rejects++ )    /*!< Count a reject in a typed queue */
+/* cppcheck-suppress-end misra-c2012-20.7 */
+#else
+#define QUEUE_TYPED_WRITTEN( queue, used )  ( (void)(queue) )               /*!< Count a write in a typed queue */
+#define QUEUE_TYPED_REJECTED( queue )       ( (void)(queue) )               /*!< Count a reject in a typed queue */
+#endif
+
+/* cppcheck-suppress-begin misra-c2012-20.7 ; helper of QUEUE_DEFINE, the parameter is always a struct pointer */
+#define QUEUE_TYPED_NOTIFY( queue )                                                                 \
+    do {                                                                                            \
+        if( (queue)->Event != NULL )                                                                \
+        {                                                                                           \
+            *(queue)->Event = TRUE;                                                                 \
+        }                                                                                           \
+    } while( 0 )                                                    /*!< Set the event flag of a typed queue */
+/* cppcheck-suppress-end misra-c2012-20.7 */
+
+/**
+ * @brief   Define a typed queue at compile time.
+ *
+ * The macro declares the struct name_Queue, with a buffer of elements of the given type, and the
+ * static inline functions name_write, name_writeCoalesce, name_read, name_peek, name_release,
+ * name_isEmpty and name_flush to work with it. Unlike AppQue_Queue the element size and the queue lenght are
+ * constants known by the compiler, the elements are copied with a struct assignment instead of a
+ * call to memcpy, and the compiler checks the type of the elements written and read. A queue
+ * declared as a global variable (zero initialized) is an empty queue, there is no init function.
+ *
+ * The indexes work like the SPSC mode of AppQue_Queue, they run from 0 to 2*elements - 1 and are
+ * wrapped with a comparison, so one producer and one consumer can use the queue at the same time
+ * without disable the interrupts, but name_flush must be called only when the consumer can not run.
+ * name_writeCoalesce works like the Coalesce function of AppQue_Queue, it receives the function to
+ * compare the new element with the pending ones, the oldest one included while name_peek was not
+ * called on it, and since it modifies elements already written the consumer can not run while it's
+ * called either. The element Event works like in AppQue_Queue,
+ * it's NULL in a zero initialized queue.
+ *
+ * @param   name [in] Prefix for the struct and functions names
+ * @param   type [in] Type of the elements to store
+ * @param   elements [in] Number of elements to store, from 1 to QUEUE_SPSC_MAX_ELEMENTS
+ *
+ * @note    When QUEUE_STATS is defined the queue counts the high-water mark, the writes and the
+ *          rejects in the element Stats, MaxDwell is not measured. When TRACE is defined the
+ *          writes and reads are recorded in the trace ring like the ones of AppQue_Queue.
+*/
+/* cppcheck-suppress-begin [misra-c2012-20.7, misra-c2012-20.10] ; the type can not be parenthesized and the ## operator is needed to name the functions of each queue */
+#define QUEUE_DEFINE( name, type, elements )                                                        \
+    _Static_assert( ((elements) > 0u) && ((elements) <= QUEUE_SPSC_MAX_ELEMENTS),                  \
+                    "wrong number of elements for queue " #name );                                  \
+                                                                                                    \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        type Buffer[ (elements) ];          /* elements stored */                                   \
+        volatile unsigned char Head;        /* next index to write, from 0 to 2*elements - 1 */    \
+        volatile unsigned char Tail;        /* next index to read, from 0 to 2*elements - 1 */     \
+        volatile unsigned char Peeked;      /* TRUE from a peek to the release of the oldest */     \
+        volatile unsigned char *Event;      /* flag set to TRUE after each write, NULL for none */  \
+        QUEUE_TYPED_STATS                                                                           \
+    } name##_Queue;                                                                                 \
+                                                                                                    \
+    static inline unsigned char name##_next( unsigned char index )                                 \
+    {                                                                                               \
+        return ( (index + 1u) == (2u * (elements)) ) ? 0u : (unsigned char)(index + 1u);            \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_slot( unsigned char index )                                 \
+    {                                                                                               \
+        return ( index >= (elements) ) ? (unsigned char)(index - (elements)) : index;               \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_prev( unsigned char index )                                 \
+    {                                                                                               \
+        return ( index == 0u ) ? (unsigned char)((2u * (elements)) - 1u) : (unsigned char)(index - 1u); \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_used( unsigned char head, unsigned char tail )              \
+    {                                                                                               \
+        return ( head >= tail ) ? (unsigned char)(head - tail)                                      \
+                                : (unsigned char)((head + (2u * (elements))) - tail);               \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_write( name##_Queue *queue, const type *data )              \
+    {                                                                                               \
+        unsigned char head = queue->Head;                                                           \
+        unsigned char used = name##_used( head, queue->Tail );                                      \
+        unsigned char Status = FALSE;                                                               \
+                                                                                                    \
+        if( used < (elements) )                                                                     \
+        {                                                                                           \
+            queue->Buffer[ name##_slot( head ) ] = *data;                                           \
+            __COMPILER_BARRIER( );  /* the element must be in the buffer before publish Head */     \
+            queue->Head = name##_next( head );                                                      \
+            QUEUE_TYPED_WRITTEN( queue, used + 1u );                                                \
+            QUEUE_TYPED_NOTIFY( queue );                                                            \
+            TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, 1u );                                            \
+            Status = TRUE;                                                                          \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            QUEUE_TYPED_REJECTED( queue );                                                          \
+        }                                                                                           \
+                                                                                                    \
+        return Status;                                                                              \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_writeCoalesce( name##_Queue *queue, const type *data,       \
+                        unsigned char (*coalesce)( const type *data, const type *element ) )        \
+    {                                                                                               \
+        unsigned char index = queue->Head;                                                          \
+        unsigned char used = name##_used( index, queue->Tail );                                     \
+        unsigned char verdict = QUEUE_COALESCE_SKIP;                                                \
+        unsigned char oldest = ( queue->Peeked == TRUE ) ? 1u : 0u;                                 \
+        unsigned char Status = FALSE;                                                               \
+                                                                                                    \
+        /* from the newest element to the oldest, unless the consumer peeked it and is using it */  \
+        while( (used > oldest) && (verdict == QUEUE_COALESCE_SKIP) )                                \
+        {                                                                                           \
+            index = name##_prev( index );                                                           \
+            verdict = coalesce( data, &queue->Buffer[ name##_slot( index ) ] );                     \
+            used--;                                                                                 \
+        }                                                                                           \
+                                                                                                    \
+        if( verdict == QUEUE_COALESCE_MERGE )                                                       \
+        {                                                                                           \
+            queue->Buffer[ name##_slot( index ) ] = *data;                                          \
+            QUEUE_TYPED_NOTIFY( queue );                                                            \
+            TRACE_QUEUE( TRACE_QUEUE_WRITE, queue, 0u );                                            \
+            Status = TRUE;                                                                          \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            Status = name##_write( queue, data );                                                   \
+        }                                                                                           \
+                                                                                                    \
+        return Status;                                                                              \
+    }                                                                                               \
+                                                                                                    \
+    static inline type *name##_peek( name##_Queue *queue )                                         \
+    {                                                                                               \
+        unsigned char tail = queue->Tail;                                                           \
+        type *element = NULL;                                                                       \
+                                                                                                    \
+        if( queue->Head != tail )                                                                   \
+        {                                                                                           \
+            __COMPILER_BARRIER( );  /* read the element only after the Head snapshot */             \
+            queue->Peeked = TRUE;                                                                   \
+            element = &queue->Buffer[ name##_slot( tail ) ];                                        \
+        }                                                                                           \
+                                                                                                    \
+        return element;                                                                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_release( name##_Queue *queue )                              \
+    {                                                                                               \
+        unsigned char tail = queue->Tail;                                                           \
+        unsigned char Status = FALSE;                                                               \
+                                                                                                    \
+        if( queue->Head != tail )                                                                   \
+        {                                                                                           \
+            __COMPILER_BARRIER( );  /* the element must be used before release its space */         \
+            queue->Tail = name##_next( tail );                                                      \
+            queue->Peeked = FALSE;                                                                  \
+            TRACE_QUEUE( TRACE_QUEUE_READ, queue, 1u );                                             \
+            Status = TRUE;                                                                          \
+        }                                                                                           \
+                                                                                                    \
+        return Status;                                                                              \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_read( name##_Queue *queue, type *data )                     \
+    {                                                                                               \
+        const type *element = name##_peek( queue );                                                 \
+        unsigned char Status = FALSE;                                                               \
+                                                                                                    \
+        if( element != NULL )                                                                       \
+        {                                                                                           \
+            *data = *element;                                                                       \
+            Status = name##_release( queue );                                                       \
+        }                                                                                           \
+                                                                                                    \
+        return Status;                                                                              \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned char name##_isEmpty( const name##_Queue *queue )                        \
+    {                                                                                               \
+        return ( queue->Head == queue->Tail ) ? TRUE : FALSE;                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline void name##_flush( name##_Queue *queue )                                         \
+    {                                                                                               \
+        queue->Tail = queue->Head;                                                                  \
+        queue->Peeked = FALSE;                                                                      \
+    }
+/* cppcheck-suppress-end [misra-c2012-20.7, misra-c2012-20.10] */
+
+unsigned char AppQueue_initQueue( AppQue_Queue *queue );
 
 unsigned char AppQueue_writeData( AppQue_Queue *queue, const void *data );
 
 unsigned char AppQueue_readData( AppQue_Queue *queue, void *data );
 
+void *AppQueue_reserveData( AppQue_Queue *queue );
+
+unsigned char AppQueue_commitData( AppQue_Queue *queue );
+
+void *AppQueue_peekData( AppQue_Queue *queue );
+
+unsigned char AppQueue_releaseData( AppQue_Queue *queue );
+
+unsigned long AppQueue_writeBatch( AppQue_Queue *queue, const void *data, unsigned long count );
+
+unsigned long AppQueue_readBatch( AppQue_Queue *queue, void *data, unsigned long count );
+
 unsigned char AppQueue_isQueueEmpty( const AppQue_Queue *queue );
 
 void AppQueue_flushQueue( AppQue_Queue *queue );
 
+void AppQueue_initPrioQueue( AppQue_PrioQueue *prio );
+
+unsigned char AppQueue_writePrio( AppQue_PrioQueue *prio, const void *data );
+
+void *AppQueue_peekPrio( AppQue_PrioQueue *prio, unsigned char *level );
+
+unsigned char AppQueue_releasePrio( AppQue_PrioQueue *prio, unsigned char level );
+
+void AppQueue_flushPrio( AppQue_PrioQueue *prio, unsigned char level );
+
+unsigned char AppQueue_isPrioQueueEmpty( const AppQue_PrioQueue *prio );
+
+unsigned long AppQueue_freePrio( const AppQue_PrioQueue *prio, const void *data );
+
 unsigned char HIL_QUEUE_writeDataISR( AppQue_Queue *queue, const void *data );
 
 unsigned char HIL_QUEUE_readDataISR( AppQue_Queue *queue, void *data );
 
+void *HIL_QUEUE_reserveDataISR( AppQue_Queue *queue );
+
+unsigned char HIL_QUEUE_commitDataISR( AppQue_Queue *queue );
+
+void *HIL_QUEUE_peekDataISR( AppQue_Queue *queue );
+
+unsigned char HIL_QUEUE_releaseDataISR( AppQue_Queue *queue );
+
+unsigned long HIL_QUEUE_writeBatchISR( AppQue_Queue *queue, const void *data, unsigned long count );
+
+unsigned long HIL_QUEUE_readBatchISR( AppQue_Queue *queue, void *data, unsigned long count );
+
 unsigned char HIL_QUEUE_isQueueEmptyISR( const AppQue_Queue *queue );
 
 void HIL_QUEUE_flushQueueISR( AppQue_Queue *queue );
 
+unsigned char HIL_QUEUE_writePrioISR( AppQue_PrioQueue *prio, const void *data );
+
+void *HIL_QUEUE_peekPrioISR( AppQue_PrioQueue *prio, unsigned char *level );
+
+unsigned char HIL_QUEUE_releasePrioISR( AppQue_PrioQueue *prio, unsigned char level );
+
+void HIL_QUEUE_flushPrioISR( AppQue_PrioQueue *prio, unsigned char level );
+
+unsigned long HIL_QUEUE_freePrioISR( const AppQue_PrioQueue *prio, const void *data );
+
 #endif
\ No newline at end of file
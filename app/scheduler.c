@@ -5,44 +5,176 @@
  * This driver help to manage a structure that contain the tasks to run and the software timers. It has
  * functions to initialize the scheduler, register task/timer, start task/timer, stop task/timer, to 
  * change their periodicity and the most important to run the scheduler.
+ *
+ * Between ticks the scheduler can sleep instead of polling the HAL tick, when the element idleFunc
+ * is set it's called with the time left to the next task or timer that has to run, the ticks in
+ * between have nothing to do and are processed all together after waking up. AppSched_sleep is the
+ * idle function for the target, it stops the SysTick interrupts for the whole sleep.
+ *
+ * A task can also be bound to an event flag, usually the Event of the queue it reads, the task runs
+ * on the next loop after the flag is set besides its period, so a message written in the queue is
+ * processed without wait for the next period of the task.
+ *
+ * The software timers are kept in a hierarchical timer wheel, so start, stop and the work of each
+ * tick don't depend on the number of timers. A started timer is linked in a slot of the level that
+ * holds its expiration, the first level has a slot per tick and each slot of an upper level spans
+ * all the slots of the level below. On each tick only one slot of the first level is processed, and
+ * when a level completes a turn the next slot of the upper level is cascaded, its timers are linked
+ * again in the lower levels that are closer to the expiration.
+ *
+ * Each run of a task is timed with TIM7, a free running counter of 1 us, to keep in the TCB the
+ * min, max and average execution time, the number of runs and the periodic runs that end after its
+ * period since the tick that released them, AppSched_statsTask gives a copy of them.
+ *
+ * By default all the tasks are released together every time their periods line up, the first run of
+ * each task can be moved with AppSched_offsetTask, or AppSched_staggerTasks spreads the tasks along
+ * the hyperperiod to get the lowest number of tasks released in the same tick, and
+ * AppSched_loadProfile reports how many tasks are released in each tick.
+ *
+ * For a fixed task set the scheduler can work as a cyclic executive, AppSched_buildTable writes in
+ * framePtr the tasks to run in each tick, the minor frame, along the hyperperiod, the major frame,
+ * then each tick only runs the tasks listed for it in the table, in the order of its taskID,
+ * without check the period of every task. The tasks activated by a flag are kept in a bitmap, and
+ * the ones held by a wait in a count, so the tick and the loop only visit those TCBs.
+ *
+ * When a tick is processed late, after a task that takes too long, the element catchUp selects how
+ * the missed ticks are processed, one by one running the tasks in bursts, or all of them together
+ * running each due task once or only the ones due in the current tick, the ticks are always counted
+ * from the start of the scheduler so there is no drift. The scheduler counts the late ticks and the
+ * max lateness, and each task the activations skipped.
+ *
+ * A task can be resumable, a coroutine written with the Coroutine macros of scheduler.h that returns
+ * in the middle of a long sequence and continues on a later run. Inside the task AppSched_waitTask
+ * holds it for a time and AppSched_untilTask until a flag is set, a held task is not released by its
+ * period, its frames or its event, and the other tasks keep running meanwhile. When the wait ends the
+ * task runs again and its period restarts from there.
+ *
+ * The scheduler also measures the CPU load, the time spent in each pass that processes a tick, in the
+ * tasks run by its event and in the interrupts that wake up the CPU is added with TIM7, and every
+ * SCHED_LOAD_WINDOW_MS of ticks it's compared with the window, the rest of the time the scheduler
+ * was polling or sleeping. AppSched_cpuLoad gives the load of the last window and the peak since
+ * the start.
+ *
+ * When the macro TRACE is defined the start and end of each task run and of each timer callback are
+ * recorded in the trace ring of trace.c, the taskID or timerID identifies them.
  *  
  */
 
 #include "scheduler.h"
 #include <stddef.h>
+#include <limits.h>
 #include "bsp.h"
 
 #define MAX_COUNT_TIM6          0xFFFFu     /*!< Maximum count value allowed by TIM6 */
 #define TIM6_PRESCALER          64000u      /*!< TIM6 prescaler value to get 1 ms period */
+#define MAX_COUNT_TIM7          0xFFFFu     /*!< Maximum count value allowed by TIM7 */
+#define TIM7_PRESCALER          63u         /*!< TIM7 prescaler value to get 1 us count, the clock is divided by 63 + 1 */
+#define US_PER_MS               1000u       /*!< us in one ms */
+#define STAGGER_TICKS_N         240u        /*!< Max hyperperiod in ticks that AppSched_staggerTasks can handle */
 #define ERROR_2MS               2u            /*!< Error range for task's periodicity */
+#define SLEEP_MAX_MS            200u        /*!< Max sleep, the SysTick reload (24 bits) holds 262 ms at 64 MHz */
 
 static void Scheduler_monitoring_Init( void );
 
+static unsigned long Scheduler_IdleTime( const AppSched_Scheduler *scheduler, unsigned long sinceTick );
+
+static void Scheduler_RunEvents( AppSched_Scheduler *scheduler );
+
+static void Scheduler_RunEvent( AppSched_Scheduler *scheduler, unsigned char task );
+
+static void Scheduler_Flagged( AppSched_Scheduler *scheduler, unsigned char task );
+
+static unsigned char Scheduler_EventPending( const AppSched_Scheduler *scheduler );
+
+static void Wheel_Insert( AppSched_Scheduler *scheduler, unsigned char timer );
+
+static void Wheel_Remove( AppSched_Scheduler *scheduler, unsigned char timer );
+
+static void Wheel_Start( AppSched_Scheduler *scheduler, unsigned char timer );
+
+static void Wheel_Tick( AppSched_Scheduler *scheduler );
+
+static unsigned long Wheel_NextTicks( const AppSched_Scheduler *scheduler );
+
+static uint16_t Scheduler_ProfileCount( void );
+
+static unsigned long Scheduler_PeriodTicks( const AppSched_Scheduler *scheduler, const AppSched_Task *task );
+
+static unsigned long Scheduler_FirstTick( const AppSched_Scheduler *scheduler, const AppSched_Task *task );
+
+static unsigned long Scheduler_Hyperperiod( const AppSched_Scheduler *scheduler, unsigned char running );
+
+static void Scheduler_RunTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long late, uint16_t tickCount );
+
+static void Scheduler_ReleaseTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long ticks, unsigned long late, uint16_t tickCount );
+
+static void Scheduler_RunFrames( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long late, uint16_t tickCount );
+
+static void Scheduler_Lateness( AppSched_Scheduler *scheduler, unsigned long now, unsigned long first, unsigned long ticks, unsigned long wake );
+
+static void Scheduler_Resume( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long late, uint16_t tickCount );
+
+static unsigned char Scheduler_Held( const AppSched_Task *task );
+
+static unsigned long Scheduler_FrameIdle( const AppSched_Scheduler *scheduler );
+
+static void Scheduler_AddLoad( const AppSched_Scheduler *scheduler, const AppSched_Task *task, unsigned char *load, unsigned long ticks );
+
+static void Scheduler_Place( const AppSched_Scheduler *scheduler, AppSched_Task *task, unsigned char *load, unsigned long ticks );
+
+STATIC void Scheduler_Profile( AppSched_Task *task, unsigned long exec, unsigned long response );
+
+STATIC void Scheduler_CpuLoad( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long busy );
+
 /**
  * @brief   array to store the lastTick value of each task.
 */
 static uint16_t lastTick[ TASKS_N ];
 
+/**
+ * @brief   tasks released in each tick of the hyperperiod, used by AppSched_staggerTasks.
+*/
+static unsigned char StaggerLoad[ STAGGER_TICKS_N ];
+
 /**
  * @brief   Interface to initialize the scheduler.
  *
  * In this fuction initialize the scheduler, to do that is just necessary set the tasks and timers count to
- * zero.
+ * zero, and empty the timer wheel.
  *
  * @param   scheduler [in] It's the memory address of the scheduler to access the elements.
  *
  *
  * @note Before using this function it's mandatory initialized the elements: tick, tasks, taskPtr, timeout
- * timers and timerPtr.
+ * timers and timerPtr, tasks can not be greater than SCHED_MAX_TASKS. The elements idleFunc, catchUp, frames and framePtr are optional (NULL and zero).
  */
 void AppSched_initScheduler( AppSched_Scheduler *scheduler)
 {
     assert_error( scheduler->taskPtr != NULL, SCHE_PAR_ERROR );
     assert_error( scheduler->tick > 0u, SCHE_PAR_ERROR );
     assert_error( scheduler->tasks > 0u, SCHE_PAR_ERROR );
+    assert_error( scheduler->tasks <= SCHED_MAX_TASKS, SCHE_PAR_ERROR );
 
     scheduler->tasksCount = 0;
     scheduler->timersCount = 0;
+    scheduler->framesCount = 0;
+    scheduler->frameIndex = 0;
+    scheduler->wheelTick = 0;
+    scheduler->lateTicks = 0;
+    scheduler->maxLate = 0;
+    scheduler->running = 0;
+    scheduler->runEvent = FALSE;
+    scheduler->flagged = 0;
+    scheduler->held = 0;
+    scheduler->busyTime = 0;
+    scheduler->loadTicks = 0;
+    scheduler->cpuLoad = 0;
+    scheduler->cpuPeak = 0;
+
+    for( unsigned char i = 0; i < ( WHEEL_LEVELS * WHEEL_SLOTS ); i++ )
+    {
+        scheduler->wheel[ i ] = 0;
+    }
 }
 
 /**
@@ -76,7 +208,12 @@ unsigned char AppSched_registerTask( AppSched_Scheduler *scheduler, void (*initP
         scheduler->taskPtr[ scheduler->tasksCount ].period = period;
         scheduler->taskPtr[ scheduler->tasksCount ].elapsed = 0;
         scheduler->taskPtr[ scheduler->tasksCount ].runTask = TRUE;
+        scheduler->taskPtr[ scheduler->tasksCount ].event = NULL;
+        scheduler->taskPtr[ scheduler->tasksCount ].offset = 0;
+        scheduler->taskPtr[ scheduler->tasksCount ].wait = 0;
+        scheduler->taskPtr[ scheduler->tasksCount ].until = NULL;
         scheduler->tasksCount++;
+        (void) AppSched_clearStatsTask( scheduler, scheduler->tasksCount );
 
         varRetRt = scheduler->tasksCount;
     }
@@ -163,257 +300,1705 @@ unsigned char AppSched_periodTask( AppSched_Scheduler *scheduler, unsigned char
 }
 
 /**
- * @brief This function runs the scheduler for the time set in timeout.
- * 
- * When the function is called runs the init functions if there are, then enter in a while loop until
- * the timeout has elapsed, the base of time is the number of ticks, that is checked using the function
- * miliseconds. In the cycle every time a tick happens check all the tasks and timers to know if it's
- * time to run the corresponding function.
+ * @brief   Bind a registered task to an event flag.
  * 
- * @param scheduler [in] Memory address of the scheduler to access the elements.
+ * The task keeps running with its period, and also runs on the next scheduler loop after the flag is
+ * set to TRUE, the scheduler clears the flag before running the task. The flag is usually the Event
+ * of the queue the task reads, so the queue sets it on each write.
  * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] the taskID of the task to bind.
+ * @param   event [in] Memory address of the flag, NULL to remove the binding.
  * 
- * @note 
+ * @retval  Return the action success, TRUE if it's a valid taskID, and FALSE if not.
 */
-
-void AppSched_startScheduler( AppSched_Scheduler *scheduler )
+unsigned char AppSched_eventTask( AppSched_Scheduler *scheduler, unsigned char task, volatile unsigned char *event )
 {
-    (void) lastTick;
-    unsigned long tickstart; 
-    static unsigned long countTicks = 1;  //variable to count ticks
+    unsigned char varRetEt = FALSE;
 
-    #ifndef UTEST
-    uint16_t currentTick;
+    if ( ( task > 0u ) && ( task <= scheduler->tasksCount ) )
+    {
+        scheduler->taskPtr[ task - 1u ].event = event;
+        Scheduler_Flagged( scheduler, task - 1u );
+        varRetEt = TRUE;
+    }
 
-    /*if a task is added it's mandatory add the error code */
-    const App_ErrorsCode TasksError[ TASKS_N ] = 
-    { TASK_SERIAL_ERROR, TASK_CLOCK_ERROR, TASK_HEARTBEAT_ERROR, TASK_DISPLAY_ERROR, TASK_WWDG_ERROR, TASK_LCD_ERROR };
-    #endif
+    return varRetEt;
+}
 
-    for (unsigned char i = 0; i < scheduler->tasksCount; i++)   //cicle for init tasks
+/**
+ * @brief   Set the time of the first run of a task.
+ * 
+ * The task runs offset ms after the scheduler starts and then with its period, so tasks with periods
+ * that line up can run in different ticks. A task registered without offset runs for the first time
+ * after its period, the same as an offset equal to the period. AppSched_staggerTasks keeps the
+ * offset set by this function.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] the taskID of the task.
+ * @param   offset [in] Time of the first run, a tick multiple from tick up to the period of the task.
+ * 
+ * @retval  Return the action success, TRUE if it's a valid taskID and offset, and FALSE if not.
+ * 
+ * @note    It must be called before start the scheduler.
+*/
+unsigned char AppSched_offsetTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long offset )
+{
+    unsigned char varRetOt = FALSE;
+
+    if ( ( task > 0u ) && ( task <= scheduler->tasksCount ) && ( offset >= scheduler->tick ) && 
+         ( offset <= scheduler->taskPtr[ task - 1u ].period ) && ( ( offset % scheduler->tick ) == 0u ) )
     {
-        if ( scheduler->taskPtr[i].initFunc != NULL )
-        {
-            scheduler->taskPtr[i].initFunc();
-        }
+        scheduler->taskPtr[ task - 1u ].offset = offset;
+        scheduler->taskPtr[ task - 1u ].elapsed = scheduler->taskPtr[ task - 1u ].period - offset;
+        varRetOt = TRUE;
     }
 
-    Scheduler_monitoring_Init();
-    
-    tickstart = HAL_GetTick();  /* Get current tick value */
-    
-    while ( FOREVER() > 0 )
+    return varRetOt;
+}
+
+/**
+ * @brief   Set the first run of the tasks to spread them along the hyperperiod.
+ * 
+ * The tasks are placed from the shortest period to the longest one, each one in the first tick,
+ * up to its period, where the max number of tasks released in the same tick is the lowest, counting
+ * the tasks already placed and the ones with an offset set by AppSched_offsetTask, these last ones
+ * are not moved. Only the running tasks are taken into account.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * 
+ * @retval  Return the action success, TRUE if the tasks were placed, and FALSE if the hyperperiod is
+ *          longer than STAGGER_TICKS_N ticks.
+ * 
+ * @note    It must be called before start the scheduler, after register the tasks.
+*/
+unsigned char AppSched_staggerTasks( AppSched_Scheduler *scheduler )
+{
+    unsigned char varRetSg = FALSE;
+    unsigned long ticks = Scheduler_Hyperperiod( scheduler, TRUE );
+    unsigned long last = 0;
+    unsigned long period;
+
+    if ( ( ticks > 0u ) && ( ticks <= STAGGER_TICKS_N ) )
     {
+        for ( unsigned long k = 0; k < ticks; k++ )
+        {
+            StaggerLoad[ k ] = 0;
+        }
 
-        if( ( HAL_GetTick() - tickstart ) >= ( scheduler->tick * countTicks ) )    //if to know tick happens
+        for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )    //the tasks that are not moved
         {
-            for (unsigned char i = 0; i < scheduler->tasksCount; i++)   //run all tasks if its time
+            if ( ( scheduler->taskPtr[ i ].runTask == TRUE ) && ( scheduler->taskPtr[ i ].offset != 0u ) )
             {
-                scheduler->taskPtr[i].elapsed += scheduler->tick;
-                
-                if ( ( scheduler->taskPtr[i].elapsed >= ( scheduler->taskPtr[i].period ) ) && ( scheduler->taskPtr[i].runTask == TRUE ) )
-                {
-                    #ifndef UTEST
-                    currentTick = __HAL_TIM_GetCounter( &TIM6_Handler );
-
-                    assert_error( ( currentTick - lastTick[i] ) <= ( scheduler->taskPtr[i].period + ERROR_2MS ) , TasksError[i] );
-                    #endif
+                Scheduler_AddLoad( scheduler, &scheduler->taskPtr[ i ], StaggerLoad, ticks );
+            }
+        }
 
-                    scheduler->taskPtr[i].taskFunc();
-                    scheduler->taskPtr[i].elapsed = 0;          //reset elapsed time
+        do
+        {
+            period = ULONG_MAX;     //the next shortest period to place
 
-                    #ifndef UTEST
-                    lastTick[ i ] = __HAL_TIM_GetCounter( &TIM6_Handler );
-                    #endif
-                } 
-            }
-             
-            for (unsigned char j = 0; j < scheduler->timersCount; j++)
+            for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
             {
-                if ( scheduler->timerPtr[j].startFlag == TRUE )
+                if ( ( scheduler->taskPtr[ i ].runTask == TRUE ) && ( scheduler->taskPtr[ i ].offset == 0u ) &&
+                     ( scheduler->taskPtr[ i ].period >= last ) && ( scheduler->taskPtr[ i ].period < period ) )
                 {
-                    scheduler->timerPtr[j].count -= scheduler->tick;    //decrement the count timer
+                    period = scheduler->taskPtr[ i ].period;
+                }
+            }
 
-                    if ( ( AppSched_getTimer( scheduler, j + 1u ) == 0u ) && ( scheduler->timerPtr[j].callbackPtr != NULL ) )
-                    {
-                        scheduler->timerPtr[j].startFlag = FALSE;
-                        scheduler->timerPtr[j].callbackPtr();
-                    }
+            for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
+            {
+                if ( ( scheduler->taskPtr[ i ].runTask == TRUE ) && ( scheduler->taskPtr[ i ].offset == 0u ) &&
+                     ( scheduler->taskPtr[ i ].period == period ) )
+                {
+                    Scheduler_Place( scheduler, &scheduler->taskPtr[ i ], StaggerLoad, ticks );
                 }
             }
 
-            ++countTicks;       //increment the tick.
-        
-        }   
-        
+            last = period + 1u;
+        }
+        while ( period != ULONG_MAX );
+
+        varRetSg = TRUE;
     }
-    
-}
 
+    return varRetSg;
+}
 
 /**
- * @brief   Register a timer if the timeout is valid.
+ * @brief   Report the number of tasks released in each tick.
  * 
- * This function register a timer, to do that verify if the timeout is a multiple of tick, in the TRUE case,
- * register the timer setting the callback fuction in the corresponding TCB position with its timeout, the
- * timeout is assigned to the actual count, and the startFlag is set FALSE and the timersCount increment by
- * one.
+ * The profile covers the hyperperiod of the running tasks, the least common multiple of its periods,
+ * load[ 0 ] is the next tick to process, and after the hyperperiod the same profile repeats. The max
+ * value is the worst case of tasks that run in the same tick.
  * 
  * @param   scheduler [in] Memory address of the scheduler to access the elements.
- * @param   timeout [in] Timer timeout to decrement. 
- * @param   callbackPtr [in] Memory address of the function to be run when the count down to zero.
+ * @param   load [out] Memory address of the array where the tasks released in each tick are written.
+ * @param   ticks [in] Number of elements of load.
  * 
- * @retval  Returns the timerID if the timer has been registered succesfully, and returns a zero if not.
+ * @retval  The hyperperiod in ticks, the number of elements written, or zero if it's longer than
+ *          ticks or there are no running tasks.
 */
-unsigned char AppSched_registerTimer( AppSched_Scheduler *scheduler, unsigned long timeout, void (*callbackPtr)(void) )
+unsigned long AppSched_loadProfile( const AppSched_Scheduler *scheduler, unsigned char *load, unsigned long ticks )
 {
-    assert_error( scheduler->timerPtr != NULL, SCHE_BUFFER_ERROR );
-    assert_error( scheduler->timersCount < scheduler->timers, SCHE_BUFFER_ERROR );
+    unsigned long hyperperiod = Scheduler_Hyperperiod( scheduler, TRUE );
 
-    unsigned char timerID = 0;
+    if ( ( hyperperiod > 0u ) && ( hyperperiod <= ticks ) )
+    {
+        for ( unsigned long k = 0; k < hyperperiod; k++ )
+        {
+            load[ k ] = 0;
+        }
 
-    if ( ( timeout % scheduler->tick ) == 0u )
+        for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
+        {
+            if ( scheduler->taskPtr[ i ].runTask == TRUE )
+            {
+                Scheduler_AddLoad( scheduler, &scheduler->taskPtr[ i ], load, hyperperiod );
+            }
+        }
+    }
+    else
     {
-        scheduler->timerPtr[ scheduler->timersCount ].timeout = timeout;
-        scheduler->timerPtr[ scheduler->timersCount ].callbackPtr = callbackPtr;
-        scheduler->timerPtr[ scheduler->timersCount ].count = scheduler->timerPtr[ scheduler->timersCount ].timeout;
-        scheduler->timerPtr[ scheduler->timersCount ].startFlag = FALSE;
-        scheduler->timersCount++;
-        timerID = scheduler->timersCount;
+        hyperperiod = 0;
     }
 
-    return timerID;
+    return hyperperiod;
 }
 
 /**
- * @brief   Function to get the actual timer count.
+ * @brief   Build the table of the cyclic executive.
  * 
- * This function help to know the actual count of the timer, to do that before check if the parameter timer
- * is valid, it means that is in the range between 1 and the actual timersCount value, if it's valid use an
- * auxiliary variable to return the count of the respective timer, if the timerID doesn't exist returns 0. 
+ * The table has a minor frame for each tick of the hyperperiod of all the registered tasks, each
+ * frame is the list of the taskIDs that run in the tick ended with a zero, the ticks come from the
+ * period and the offset of each task. Once the table is built the scheduler runs the tasks from it,
+ * the stopped tasks are skipped and can be started again.
  * 
  * @param   scheduler [in] Memory address of the scheduler to access the elements.
- * @param   timer [in] the timerID of the timer to get the count.
  * 
- * @retval  Returns the actual count of the timer if the timerID is valid, if not returns zero.
+ * @retval  Return the action success, TRUE if the table was built, and FALSE if it doesn't fit in
+ *          the frames elements of framePtr, in that case the tasks are run checking its periods.
  * 
+ * @note    It must be called before start the scheduler, after register the tasks and set its
+ *          offsets, a change of period later is not taken into account.
 */
-/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
-unsigned long AppSched_getTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+unsigned char AppSched_buildTable( AppSched_Scheduler *scheduler )
 {
-    unsigned long retGtimer = 0;
+    unsigned char varRetBt = FALSE;
+    unsigned long ticks = Scheduler_Hyperperiod( scheduler, FALSE );
+    unsigned long size = ticks;
+    unsigned long first;
+    unsigned short index = 0;
 
-    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    scheduler->framesCount = 0;
+    scheduler->frameIndex = 0;
+
+    for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
     {
-        retGtimer = scheduler->timerPtr[ timer - 1u ].count;
+        size += ticks / Scheduler_PeriodTicks( scheduler, &scheduler->taskPtr[ i ] );
     }
 
-    return retGtimer;
+    if ( ( ticks > 0u ) && ( scheduler->framePtr != NULL ) && ( size <= scheduler->frames ) )
+    {
+        for ( unsigned long k = 1; k <= ticks; k++ )
+        {
+            for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
+            {
+                first = Scheduler_FirstTick( scheduler, &scheduler->taskPtr[ i ] );
+
+                if ( ( k >= first ) && ( ( ( k - first ) % Scheduler_PeriodTicks( scheduler, &scheduler->taskPtr[ i ] ) ) == 0u ) )
+                {
+                    scheduler->framePtr[ index ] = (unsigned char) ( i + 1u );
+                    index++;
+                }
+            }
+
+            scheduler->framePtr[ index ] = 0;   //end of the minor frame
+            index++;
+        }
+
+        scheduler->framesCount = index;
+        varRetBt = TRUE;
+    }
+
+    return varRetBt;
 }
 
 /**
- * @brief   Function to start the timer setting a new timeout.
- * 
- * This function set a new timeout value, first verify the timerID is valid and if the timeout is a multiple 
- * of tick, in a TRUE case set the new value in the elements count and timeout and start the timer setting
- * the startFlag to TRUE, in the FALSE case the function just return a zero.
+ * @brief   Get the execution time statistics of a task.
  * 
+ * The statistics are copied to stats and the average execution time is computed, the times are in
+ * us measured with TIM7, a task that has not run yet has all the values in zero.
  * 
  * @param   scheduler [in] Memory address of the scheduler to access the elements.
- * @param   timer [in] the timerID of the timer to get the count.
- * @param   timeout [in] the new value of the timer timeout.
+ * @param   task [in] the taskID of the task.
+ * @param   stats [out] Memory address where the statistics are copied.
  * 
- * @retval  Returns the success of the the function, TRUE when a new timeout was set and FALSE when not.
+ * @retval  Return the action success, TRUE if it's a valid taskID, and FALSE if not.
 */
-unsigned char AppSched_reloadTimer( AppSched_Scheduler *scheduler, unsigned char timer, unsigned long timeout )
+unsigned char AppSched_statsTask( const AppSched_Scheduler *scheduler, unsigned char task, AppSched_Stats *stats )
 {
-    unsigned char varRetReload = FALSE;
+    unsigned char varRetSt = FALSE;
 
-    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) && ( ( timeout % scheduler->tick ) == 0u ) )
+    if ( ( task > 0u ) && ( task <= scheduler->tasksCount ) )
     {
-        scheduler->timerPtr[ timer - 1u ].timeout = timeout;
-        scheduler->timerPtr[ timer - 1u ].count = timeout;
-        scheduler->timerPtr[ timer - 1u ].startFlag = TRUE;
-        varRetReload = TRUE;
+        *stats = scheduler->taskPtr[ task - 1u ].stats;
+        stats->avgTime = 0;
+
+        if ( stats->runs > 0u )
+        {
+            stats->avgTime = (unsigned long) ( stats->totalTime / stats->runs );
+        }
+        else
+        {
+            stats->minTime = 0;     //there is no min yet
+        }
+
+        varRetSt = TRUE;
     }
 
-    return varRetReload;
+    return varRetSt;
 }
 
 /**
- * @brief   Function to start the timer and reset the count.
+ * @brief   Clear the execution time statistics of a task.
  * 
- * To start the timer first check if the timerID is valid, if it is then set the value of the timeout
- * to the actual count and set the startFlag to TRUE, and if the timer doesn't exist it returns FALSE.
+ * Useful to measure the tasks only during a window of interest, like a burst of CAN messages.
  * 
  * @param   scheduler [in] Memory address of the scheduler to access the elements.
- * @param   timer [in] the timerID of the timer to start.
+ * @param   task [in] the taskID of the task.
  * 
- * @retval  Returns the success, TRUE if the timer was started and FALSE if the timer don't exist.
+ * @retval  Return the action success, TRUE if it's a valid taskID, and FALSE if not.
+*/
+unsigned char AppSched_clearStatsTask( AppSched_Scheduler *scheduler, unsigned char task )
+{
+    unsigned char varRetCs = FALSE;
+
+    if ( ( task > 0u ) && ( task <= scheduler->tasksCount ) )
+    {
+        scheduler->taskPtr[ task - 1u ].stats.runs = 0;
+        scheduler->taskPtr[ task - 1u ].stats.overruns = 0;
+        scheduler->taskPtr[ task - 1u ].stats.skips = 0;
+        scheduler->taskPtr[ task - 1u ].stats.minTime = ULONG_MAX;
+        scheduler->taskPtr[ task - 1u ].stats.maxTime = 0;
+        scheduler->taskPtr[ task - 1u ].stats.avgTime = 0;
+        scheduler->taskPtr[ task - 1u ].stats.totalTime = 0;
+        varRetCs = TRUE;
+    }
+
+    return varRetCs;
+}
+
+/**
+ * @brief   Hold the running task for a time, to be called inside a resumable task.
  * 
+ * The task is not released again until ms have passed, then it runs on the tick where the time ends
+ * and its period restarts from there. The wait is rounded up to ticks counted from the tick that
+ * released the task, a task run by its event flag is between ticks so it waits one tick more.
  * 
- * @note    This function is also used to restart the timer, using it in the callback function.
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   ms [in] Time to wait, zero to run again on the next tick.
+ * 
+ * @retval  Return the action success, TRUE if it's called from a task, and FALSE if not.
+ * 
+ * @note    The task must return after the call, SCHED_CO_WAIT_MS does both.
 */
-unsigned char AppSched_startTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+unsigned char AppSched_waitTask( AppSched_Scheduler *scheduler, unsigned long ms )
 {
-    unsigned char retStart = FALSE;
+    unsigned char varRetWt = FALSE;
+    unsigned long wait;
 
-    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    if ( scheduler->running > 0u )
     {
-        scheduler->timerPtr[ timer - 1u ].count = scheduler->timerPtr[timer - 1u].timeout;
-        scheduler->timerPtr[ timer - 1u ].startFlag = TRUE;
-        retStart = TRUE;
+        wait = ( ms + scheduler->tick - 1u ) / scheduler->tick;
+
+        if ( ( wait == 0u ) || ( scheduler->runEvent == TRUE ) )
+        {
+            wait++;
+        }
+
+        if ( scheduler->taskPtr[ scheduler->running - 1u ].wait == 0u )
+        {
+            scheduler->held++;
+        }
+
+        scheduler->taskPtr[ scheduler->running - 1u ].wait = wait;
+        varRetWt = TRUE;
     }
 
-    return retStart;
+    return varRetWt;
 }
 
 /**
- * @brief   Function to stop a existing timer.
+ * @brief   Hold the running task until a flag is set, to be called inside a resumable task.
  * 
- * This function is used to set the startFlag to FALSE, it first check for the existence of the timer, if exists
- * it sets the flag and if not, it returns FALSE.
+ * The task is not released again until the flag is TRUE, then it runs on the next scheduler loop,
+ * like an event the flag is cleared before the run. The flag is usually the Event of a queue, so the
+ * task waits until the queue is written.
  * 
  * @param   scheduler [in] Memory address of the scheduler to access the elements.
- * @param   timer [in] the timerID of the timer to stop.
+ * @param   flag [in] Memory address of the flag to wait for.
  * 
- * @retval  Returns the success, TRUE if the timer was stopped and FALSE if the timer don't exist.
+ * @retval  Return the action success, TRUE if it's called from a task with a valid flag, and FALSE if not.
  * 
+ * @note    The task must return after the call, SCHED_CO_WAIT_UNTIL does both.
 */
-unsigned char AppSched_stopTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+unsigned char AppSched_untilTask( AppSched_Scheduler *scheduler, volatile unsigned char *flag )
 {
-    unsigned char retStop = FALSE;
+    unsigned char varRetUt = FALSE;
 
-    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    if ( ( scheduler->running > 0u ) && ( flag != NULL ) )
     {
-        scheduler->timerPtr[ timer - 1u ].startFlag = FALSE;
-        retStop = TRUE;
+        scheduler->taskPtr[ scheduler->running - 1u ].until = flag;
+        Scheduler_Flagged( scheduler, scheduler->running - 1u );
+        varRetUt = TRUE;
     }
 
-    return retStop;
+    return varRetUt;
 }
 
 /**
- * @brief function where the TIM6 it's initialized.
+ * @brief   Get the CPU load measured by the scheduler.
  * 
- * In this application we are working with a APB prescaler of 2, then it makes the TIM6 clock
- * frequency set to PCLK * 2, it is 64MHz. (reference maunal pag. 173).
- * To make things easier is used a TIM6 prescaler of 64000 to get a 1 ms period.
+ * The load is the time the CPU was busy in the last window of SCHED_LOAD_WINDOW_MS, running the tasks,
+ * the timers and the interrupts that woke it up, in 0.01 % units, SCHED_LOAD_FULL is 100 %. The
+ * difference up to SCHED_LOAD_FULL is the headroom left at the current tick.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   peak [out] Memory address where the max load of a window since the start is written, it
+ *          could be NULL.
+ * 
+ * @retval  The load of the last window, zero until the first window ends.
 */
-static void Scheduler_monitoring_Init( void )
+unsigned short AppSched_cpuLoad( const AppSched_Scheduler *scheduler, unsigned short *peak )
 {
-    TIM6_Handler.Instance           = TIM6;
-    TIM6_Handler.Init.Prescaler     = TIM6_PRESCALER;
-    TIM6_Handler.Init.CounterMode   = TIM_COUNTERMODE_UP;
-    TIM6_Handler.Init.Period        = MAX_COUNT_TIM6;
-    TIM6_Handler.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-    
-    HAL_NVIC_SetPriority( TIM6_DAC_LPTIM1_IRQn, 2, 0 );
-    HAL_NVIC_EnableIRQ( TIM6_DAC_LPTIM1_IRQn );
+    if ( peak != NULL )
+    {
+        *peak = scheduler->cpuPeak;
+    }
 
-    HAL_TIM_Base_Init( &TIM6_Handler );
+    return scheduler->cpuLoad;
+}
 
-    HAL_TIM_Base_Start_IT( &TIM6_Handler );
+/**
+ * @brief This function runs the scheduler for the time set in timeout.
+ * 
+ * When the function is called runs the init functions if there are, then enter in a while loop until
+ * the timeout has elapsed, the base of time is the number of ticks, that is checked using the function
+ * miliseconds. In the cycle every time a tick happens check all the tasks and timers to know if it's
+ * time to run the corresponding function, or with a frame table just run the tasks of the tick. On every loop the tasks with its event flag set are run,
+ * and if the tick has not happened and there is an idleFunc, it is called with the time left to the
+ * tick where the next task or timer must run, unless an event was set meanwhile.
+ * 
+ * @param scheduler [in] Memory address of the scheduler to access the elements.
+ * 
+ * 
+ * @note 
+*/
+
+void AppSched_startScheduler( AppSched_Scheduler *scheduler )
+{
+    (void) lastTick;
+    unsigned long tickstart; 
+    unsigned long now;
+    unsigned long idle;
+    unsigned long countTicks = 1;  //variable to count ticks
+    unsigned long ticks;           //ticks processed in the same pass
+    unsigned long wake = 0;        //first tick after the last sleep, the ones before it were slept on purpose
+    unsigned long late;            //ms since the tick to process
+    uint16_t tickCount;            //TIM7 count when the tick starts to be processed
+
+    for (unsigned char i = 0; i < scheduler->tasksCount; i++)   //cicle for init tasks
+    {
+        if ( scheduler->taskPtr[i].initFunc != NULL )
+        {
+            scheduler->taskPtr[i].initFunc();
+        }
+    }
+
+    Scheduler_monitoring_Init();
+    
+    tickstart = HAL_GetTick();  /* Get current tick value */
+    
+    while ( FOREVER() > 0 )
+    {
+        Scheduler_RunEvents( scheduler );
+
+        now = HAL_GetTick() - tickstart;
+
+        if( now >= ( scheduler->tick * countTicks ) )    //if to know tick happens
+        {
+            ticks = 1;
+
+            if ( scheduler->catchUp != SCHED_CATCHUP_BURST )
+            {
+                ticks = ( now / scheduler->tick ) - countTicks + 1u;    //all the ticks already due
+            }
+
+            late = now - ( scheduler->tick * ( countTicks + ticks - 1u ) );
+            Scheduler_Lateness( scheduler, now, countTicks, ticks, wake );
+            tickCount = Scheduler_ProfileCount( );
+            Scheduler_Resume( scheduler, ticks, late, tickCount );    //release the tasks whose wait ends
+
+            if ( scheduler->framesCount > 0u )
+            {
+                Scheduler_RunFrames( scheduler, ticks, late, tickCount );   //run the tasks listed for these ticks
+            }
+            else
+            {
+                for (unsigned char i = 0; i < scheduler->tasksCount; i++)   //run all tasks if its time
+                {
+                    Scheduler_ReleaseTask( scheduler, i, ticks, late, tickCount );
+                }
+            }
+
+            for ( unsigned long i = 0; i < ticks; i++ )
+            {
+                Wheel_Tick( scheduler );    //run the timers that expire in these ticks
+            }
+
+            Scheduler_CpuLoad( scheduler, ticks, (uint16_t) ( Scheduler_ProfileCount( ) - tickCount ) );
+            countTicks += ticks;    //increment the tick.
+        
+        }   
+        else if( scheduler->idleFunc != NULL )
+        {
+            /*time since the last tick processed*/
+            now -= scheduler->tick * ( countTicks - 1u );
+            idle = Scheduler_IdleTime( scheduler, now );
+
+            #ifndef UTEST
+            /*an event set after the check must wake up the CPU, the interrupt stays pending*/
+            uint32_t primask = __get_PRIMASK( );
+            __disable_irq( );
+            #endif
+
+            if( Scheduler_EventPending( scheduler ) == FALSE )
+            {
+                scheduler->idleFunc( idle );
+                wake = countTicks - 1u + ( ( now + idle ) / scheduler->tick );
+            }
+
+            #ifndef UTEST
+            uint16_t wakeCount = Scheduler_ProfileCount( );
+            __set_PRIMASK( primask );
+            /*the interrupt that woke up the CPU runs here, its time is busy time*/
+            scheduler->busyTime += (uint16_t) ( Scheduler_ProfileCount( ) - wakeCount );
+            #endif
+        }
+        else
+        {
+            /*keep polling the tick*/
+        }
+    }
+    
+}
+
+/**
+ * @brief   Sleep the CPU until the next task or timer, or any interrupt.
+ * 
+ * Idle function for the element idleFunc. The CPU enters the sleep mode with WFI, instead of the
+ * stop mode, because the FDCAN reception and the LCD PWM need their clocks. The SysTick interrupt
+ * is stopped during the sleep, the counter is reloaded to expire after ms and the HAL tick is
+ * advanced with the whole milliseconds slept, any other interrupt wakes up the CPU before. After
+ * waking up the SysTick is reloaded with the remainder of the current millisecond, so the HAL tick
+ * keeps its phase and no time is lost or added.
+ * 
+ * @param   ms [in] Time to sleep in ms, up to SLEEP_MAX_MS.
+ * 
+ * @note    The HAL tick must have the default frequency of 1 kHz. In the host simulation the virtual
+ * clock jumps to the end of the sleep or to the interrupt that wakes up the CPU.
+*/
+void AppSched_sleep( unsigned long ms )
+{
+#ifndef UTEST
+    const uint32_t load = SysTick->LOAD + 1u;  /*cycles in one ms*/
+    uint32_t reload;
+    uint32_t counted;
+    uint32_t remain;
+    uint32_t primask;
+    uint32_t sleep = ( ms > SLEEP_MAX_MS ) ? SLEEP_MAX_MS : ms;
+
+    if( sleep > 1u )   /*a single ms is just the next SysTick interrupt*/
+    {
+        primask = __get_PRIMASK( );
+        __disable_irq( );
+
+        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+        remain = SysTick->VAL;                              /*cycles left to the end of this ms*/
+
+        if( ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) == 0u )  /*the current ms has not ended*/
+        {
+            reload = remain + ( ( sleep - 1u ) * load ) - 1u;
+            SysTick->LOAD = reload;
+            SysTick->VAL  = 0u;
+            SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+            __DSB( );
+            __WFI( );
+            __ISB( );
+
+            SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+            counted = reload - SysTick->VAL;                /*cycles since the start, or since the end when it expired*/
+
+            if( ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) != 0u )
+            {
+                /*all the time slept, the pending interrupt counts the last ms*/
+                uwTick += sleep - 1u;
+                remain = load - counted;
+            }
+            else if( counted < remain )
+            {
+                /*woken up in the same ms*/
+                remain -= counted;
+            }
+            else
+            {
+                counted -= remain;
+                uwTick += 1u + ( counted / load );
+                remain = load - ( counted % load );
+            }
+        }
+
+        if( remain == 0u )
+        {
+            remain = load;      /*the counter stopped just at the end of the ms*/
+        }
+
+        /*finish the current ms and then continue with the regular period*/
+        SysTick->LOAD = remain - 1u;
+        SysTick->VAL  = 0u;
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        SysTick->LOAD = load - 1u;
+
+        __set_PRIMASK( primask );
+    }
+    else
+    {
+        __WFI( );
+    }
+#elif defined( SIM )
+    Sim_Sleep( ( ms > SLEEP_MAX_MS ) ? SLEEP_MAX_MS : ms );    /*the simulated clock jumps to the wake up*/
+#else
+    (void) ms;
+#endif
+}
+
+
+/**
+ * @brief   Register a timer if the timeout is valid.
+ * 
+ * This function register a timer, to do that verify if the timeout is a multiple of tick, in the TRUE case,
+ * register the timer setting the callback fuction in the corresponding TCB position with its timeout, the
+ * timeout is assigned to the actual count, and the startFlag is set FALSE and the timersCount increment by
+ * one.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timeout [in] Timer timeout to decrement. 
+ * @param   callbackPtr [in] Memory address of the function to be run when the count down to zero.
+ * 
+ * @retval  Returns the timerID if the timer has been registered succesfully, and returns a zero if not.
+*/
+unsigned char AppSched_registerTimer( AppSched_Scheduler *scheduler, unsigned long timeout, void (*callbackPtr)(void) )
+{
+    assert_error( scheduler->timerPtr != NULL, SCHE_BUFFER_ERROR );
+    assert_error( scheduler->timersCount < scheduler->timers, SCHE_BUFFER_ERROR );
+
+    unsigned char timerID = 0;
+
+    if ( ( timeout % scheduler->tick ) == 0u )
+    {
+        scheduler->timerPtr[ scheduler->timersCount ].timeout = timeout;
+        scheduler->timerPtr[ scheduler->timersCount ].callbackPtr = callbackPtr;
+        scheduler->timerPtr[ scheduler->timersCount ].count = scheduler->timerPtr[ scheduler->timersCount ].timeout;
+        scheduler->timerPtr[ scheduler->timersCount ].startFlag = FALSE;
+        scheduler->timersCount++;
+        timerID = scheduler->timersCount;
+    }
+
+    return timerID;
+}
+
+/**
+ * @brief   Function to get the actual timer count.
+ * 
+ * This function help to know the actual count of the timer, to do that before check if the parameter timer
+ * is valid, it means that is in the range between 1 and the actual timersCount value, if it's valid use an
+ * auxiliary variable to return the count of the respective timer, if the timerID doesn't exist returns 0.
+ * The count of a started timer is the time left to its expiration in the wheel, and a stopped timer
+ * keeps the count it had when it was stopped. 
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to get the count.
+ * 
+ * @retval  Returns the actual count of the timer if the timerID is valid, if not returns zero.
+ * 
+*/
+/* cppcheck-suppress misra-c2012-8.7 ; this function can be used externally later in this project*/
+unsigned long AppSched_getTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    unsigned long retGtimer = 0;
+
+    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    {
+        retGtimer = scheduler->timerPtr[ timer - 1u ].count;
+
+        if ( scheduler->timerPtr[ timer - 1u ].startFlag == TRUE )
+        {
+            retGtimer = ( scheduler->timerPtr[ timer - 1u ].expires - scheduler->wheelTick ) * scheduler->tick;
+        }
+    }
+
+    return retGtimer;
+}
+
+/**
+ * @brief   Function to start the timer setting a new timeout.
+ * 
+ * This function set a new timeout value, first verify the timerID is valid and if the timeout is a multiple 
+ * of tick, in a TRUE case set the new value in the elements count and timeout and start the timer setting
+ * the startFlag to TRUE, in the FALSE case the function just return a zero.
+ * 
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to get the count.
+ * @param   timeout [in] the new value of the timer timeout.
+ * 
+ * @retval  Returns the success of the the function, TRUE when a new timeout was set and FALSE when not.
+*/
+unsigned char AppSched_reloadTimer( AppSched_Scheduler *scheduler, unsigned char timer, unsigned long timeout )
+{
+    unsigned char varRetReload = FALSE;
+
+    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) && ( ( timeout % scheduler->tick ) == 0u ) )
+    {
+        scheduler->timerPtr[ timer - 1u ].timeout = timeout;
+        Wheel_Start( scheduler, timer );
+        varRetReload = TRUE;
+    }
+
+    return varRetReload;
+}
+
+/**
+ * @brief   Function to start the timer and reset the count.
+ * 
+ * To start the timer first check if the timerID is valid, if it is then set the value of the timeout
+ * to the actual count and set the startFlag to TRUE, and if the timer doesn't exist it returns FALSE.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to start.
+ * 
+ * @retval  Returns the success, TRUE if the timer was started and FALSE if the timer don't exist.
+ * 
+ * 
+ * @note    This function is also used to restart the timer, using it in the callback function.
+*/
+unsigned char AppSched_startTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    unsigned char retStart = FALSE;
+
+    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    {
+        Wheel_Start( scheduler, timer );
+        retStart = TRUE;
+    }
+
+    return retStart;
+}
+
+/**
+ * @brief   Function to stop a existing timer.
+ * 
+ * This function is used to set the startFlag to FALSE, it first check for the existence of the timer, if exists
+ * it sets the flag, saves the time left in count and removes the timer from the wheel, and if not, it
+ * returns FALSE.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to stop.
+ * 
+ * @retval  Returns the success, TRUE if the timer was stopped and FALSE if the timer don't exist.
+ * 
+*/
+unsigned char AppSched_stopTimer( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    unsigned char retStop = FALSE;
+
+    if ( ( timer > 0u ) && ( timer <= scheduler->timersCount ) )
+    {
+        if ( scheduler->timerPtr[ timer - 1u ].startFlag == TRUE )
+        {
+            scheduler->timerPtr[ timer - 1u ].count = AppSched_getTimer( scheduler, timer );
+            scheduler->timerPtr[ timer - 1u ].startFlag = FALSE;
+            Wheel_Remove( scheduler, timer );
+        }
+        retStop = TRUE;
+    }
+
+    return retStop;
+}
+
+/**
+ * @brief   Time left to the next tick where a task or a timer must run.
+ * 
+ * For each running task the time left is its period less the elapsed time, or the ticks left of its
+ * wait, and for the timers the time to the next slot of the wheel with timers, all are multiples of
+ * the tick, so the nearest one is the time to sleep without miss any tick with something to do. The
+ * stopped tasks and timers, and the tasks held until a flag is set, are not taken into account.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   sinceTick [in] Time since the last tick processed, lower than the tick.
+ * 
+ * @retval  Time in ms to the next task or timer, at least the time to the next tick.
+*/
+static unsigned long Scheduler_IdleTime( const AppSched_Scheduler *scheduler, unsigned long sinceTick )
+{
+    unsigned long nearest = ULONG_MAX;
+    unsigned long left;
+
+    if( scheduler->framesCount > 0u )
+    {
+        nearest = Scheduler_FrameIdle( scheduler );
+    }
+
+    for( unsigned char i = 0; i < scheduler->tasksCount; i++ )
+    {
+        left = ULONG_MAX;
+
+        if( scheduler->taskPtr[ i ].runTask == FALSE )
+        {
+            /*a stopped task doesn't run*/
+        }
+        else if( scheduler->taskPtr[ i ].wait > 0u )
+        {
+            left = scheduler->taskPtr[ i ].wait * scheduler->tick;
+        }
+        else if( ( scheduler->taskPtr[ i ].until != NULL ) || ( scheduler->framesCount > 0u ) )
+        {
+            /*its flag wakes up the CPU, or the table has the time to its next frame*/
+        }
+        else
+        {
+            left = scheduler->tick;     /*a task with the period already elapsed runs the next tick*/
+
+            if( scheduler->taskPtr[ i ].elapsed < scheduler->taskPtr[ i ].period )
+            {
+                left = scheduler->taskPtr[ i ].period - scheduler->taskPtr[ i ].elapsed;
+            }
+        }
+
+        if( left < nearest )
+        {
+            nearest = left;
+        }
+    }
+
+    left = Wheel_NextTicks( scheduler );
+
+    if( ( left != ULONG_MAX ) && ( ( left * scheduler->tick ) < nearest ) )
+    {
+        nearest = left * scheduler->tick;
+    }
+
+    if( nearest < scheduler->tick )
+    {
+        nearest = scheduler->tick;
+    }
+
+    return nearest - sinceTick;
+}
+
+/**
+ * @brief   Run the tasks activated by its event flag, and the ones held until a flag that is set.
+ * 
+ * Only the tasks with its bit set in the bitmap flagged are checked, the ones without a flag are
+ * not visited, see Scheduler_RunEvent.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+*/
+static void Scheduler_RunEvents( AppSched_Scheduler *scheduler )
+{
+    unsigned long flagged = scheduler->flagged;
+    unsigned char task = 0;
+
+    while( flagged != 0u )
+    {
+        if( ( flagged & 1u ) != 0u )
+        {
+            Scheduler_RunEvent( scheduler, task );
+        }
+
+        flagged >>= 1u;
+        task++;
+    }
+}
+
+/**
+ * @brief   Run a task if its event flag is set, or the flag it's held until.
+ * 
+ * The flag is cleared before running the task, so a write made while the task runs sets it again
+ * and the task runs once more on the next loop. The event of a held task stays set until the task
+ * is released again.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Position of the task in the TCB block, the taskID less one.
+*/
+static void Scheduler_RunEvent( AppSched_Scheduler *scheduler, unsigned char task )
+{
+    uint16_t runStart;
+    uint16_t exec;
+    AppSched_Task *tcb = &scheduler->taskPtr[ task ];
+    volatile unsigned char *event = tcb->event;
+
+    if( ( tcb->wait == 0u ) && ( tcb->until != NULL ) && ( *tcb->until == TRUE ) )
+    {
+        event = tcb->until;     /*the flag it waits for releases the task*/
+        tcb->until = NULL;
+        tcb->elapsed = 0;       /*the period restarts from the resume*/
+        Scheduler_Flagged( scheduler, task );
+
+        #if !defined( UTEST ) || defined( SIM )
+        lastTick[ task ] = __HAL_TIM_GetCounter( &TIM6_Handler );
+        #endif
+    }
+
+    if( ( event != NULL ) && ( *event == TRUE ) && ( tcb->runTask == TRUE ) && ( Scheduler_Held( tcb ) == FALSE ) )
+    {
+        *event = FALSE;
+        scheduler->running = task + 1u;
+        scheduler->runEvent = TRUE;
+        TRACE_EVENT( TRACE_TASK_START, task + 1u, TRUE );
+        runStart = Scheduler_ProfileCount( );
+        tcb->taskFunc();
+        exec = (uint16_t) ( Scheduler_ProfileCount( ) - runStart );
+        TRACE_EVENT( TRACE_TASK_END, task + 1u, 0u );
+        Scheduler_Profile( tcb, exec, 0 );
+        scheduler->busyTime += exec;
+        scheduler->running = 0;
+        scheduler->runEvent = FALSE;
+    }
+}
+
+/**
+ * @brief   Update the bit of a task in the bitmap flagged.
+ * 
+ * The bit is set while the task has an event flag or waits for a flag with AppSched_untilTask.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Position of the task in the TCB block, the taskID less one.
+*/
+static void Scheduler_Flagged( AppSched_Scheduler *scheduler, unsigned char task )
+{
+    if( ( scheduler->taskPtr[ task ].event != NULL ) || ( scheduler->taskPtr[ task ].until != NULL ) )
+    {
+        scheduler->flagged |= ( 1UL << task );
+    }
+    else
+    {
+        scheduler->flagged &= ~( 1UL << task );
+    }
+}
+
+/**
+ * @brief   Know if a running task has its event flag set, or the flag it's held until.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * 
+ * @retval  TRUE if there is a task to run by its event, FALSE if not.
+*/
+static unsigned char Scheduler_EventPending( const AppSched_Scheduler *scheduler )
+{
+    unsigned char pending = FALSE;
+    unsigned long flagged = scheduler->flagged;     /*the tasks without a flag are not checked*/
+    const AppSched_Task *tcb = scheduler->taskPtr;
+    volatile const unsigned char *event;
+
+    while( flagged != 0u )
+    {
+        event = ( ( flagged & 1u ) != 0u ) ? tcb->event : NULL;
+
+        if( ( ( flagged & 1u ) != 0u ) && ( tcb->wait == 0u ) && ( tcb->until != NULL ) )
+        {
+            event = tcb->until;
+        }
+        else if( Scheduler_Held( tcb ) == TRUE )
+        {
+            event = NULL;       /*the event waits until the task is released*/
+        }
+        else
+        {
+            /*its own event*/
+        }
+
+        if( ( event != NULL ) && ( *event == TRUE ) && ( tcb->runTask == TRUE ) )
+        {
+            pending = TRUE;
+        }
+
+        flagged >>= 1u;
+        tcb++;
+    }
+
+    return pending;
+}
+
+/**
+ * @brief   Link a started timer in the slot of the wheel that holds its expiration.
+ * 
+ * The level is the first one that reaches the expiration from the current wheel tick, in the first
+ * level the slot is the expiration tick itself, and in the upper ones the slot is cascaded at the
+ * start of the ticks span where the timer expires. A timer beyond the last level is linked in the
+ * last slot to cascade, from where it's linked again closer to its expiration.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to link.
+*/
+static void Wheel_Insert( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    AppSched_Timer *timerPtr = &scheduler->timerPtr[ timer - 1u ];
+    unsigned long delta = timerPtr->expires - scheduler->wheelTick;
+    unsigned long slot;
+    unsigned char level = 0;
+
+    while( ( level < ( WHEEL_LEVELS - 1u ) ) && ( delta >= ( 1uL << ( WHEEL_BITS * ( level + 1u ) ) ) ) )
+    {
+        level++;
+    }
+
+    if( delta < ( 1uL << ( WHEEL_BITS * ( level + 1u ) ) ) )
+    {
+        slot = timerPtr->expires >> ( WHEEL_BITS * level );
+    }
+    else
+    {
+        slot = ( scheduler->wheelTick >> ( WHEEL_BITS * level ) ) + WHEEL_MASK;
+    }
+
+    timerPtr->slot = (unsigned char) ( ( level * WHEEL_SLOTS ) + ( slot & WHEEL_MASK ) );
+    timerPtr->prev = 0;
+    timerPtr->next = scheduler->wheel[ timerPtr->slot ];
+
+    if( timerPtr->next != 0u )
+    {
+        scheduler->timerPtr[ timerPtr->next - 1u ].prev = timer;
+    }
+
+    scheduler->wheel[ timerPtr->slot ] = timer;
+}
+
+/**
+ * @brief   Unlink a timer from its slot of the wheel.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to unlink.
+*/
+static void Wheel_Remove( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    const AppSched_Timer *timerPtr = &scheduler->timerPtr[ timer - 1u ];
+
+    if( timerPtr->prev != 0u )
+    {
+        scheduler->timerPtr[ timerPtr->prev - 1u ].next = timerPtr->next;
+    }
+    else
+    {
+        scheduler->wheel[ timerPtr->slot ] = timerPtr->next;
+    }
+
+    if( timerPtr->next != 0u )
+    {
+        scheduler->timerPtr[ timerPtr->next - 1u ].prev = timerPtr->prev;
+    }
+}
+
+/**
+ * @brief   Start or restart a timer with its timeout.
+ * 
+ * The timer expires after timeout / tick ticks of the wheel, at least one, a started timer is
+ * unlinked before linked again with the new expiration.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   timer [in] the timerID of the timer to start.
+*/
+static void Wheel_Start( AppSched_Scheduler *scheduler, unsigned char timer )
+{
+    AppSched_Timer *timerPtr = &scheduler->timerPtr[ timer - 1u ];
+    unsigned long ticks = timerPtr->timeout / scheduler->tick;
+
+    if( timerPtr->startFlag == TRUE )
+    {
+        Wheel_Remove( scheduler, timer );
+    }
+
+    if( ticks == 0u )
+    {
+        ticks = 1u;
+    }
+
+    timerPtr->count = timerPtr->timeout;
+    timerPtr->expires = scheduler->wheelTick + ticks;
+    timerPtr->startFlag = TRUE;
+    Wheel_Insert( scheduler, timer );
+}
+
+/**
+ * @brief   Advance the wheel one tick and run the callbacks of the expired timers.
+ * 
+ * The upper levels that complete a turn with this tick are cascaded first, from the last one, then
+ * the slot of the tick in the first level is processed. The timers are taken one by one from the
+ * head of the slot, so a callback can start or stop any timer, an expired timer is stopped with a
+ * zero count before its callback runs, and a timer that not expires yet is linked in a lower level.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+*/
+static void Wheel_Tick( AppSched_Scheduler *scheduler )
+{
+    unsigned char slot;
+    unsigned char timer;
+    AppSched_Timer *timerPtr;
+
+    scheduler->wheelTick++;
+
+    for( unsigned char level = WHEEL_LEVELS; level > 0u; level-- )
+    {
+        if( ( scheduler->wheelTick & ( ( 1uL << ( WHEEL_BITS * ( level - 1u ) ) ) - 1u ) ) == 0u )
+        {
+            slot = (unsigned char) ( ( ( level - 1u ) * WHEEL_SLOTS ) + ( ( scheduler->wheelTick >> ( WHEEL_BITS * ( level - 1u ) ) ) & WHEEL_MASK ) );
+
+            while( scheduler->wheel[ slot ] != 0u )
+            {
+                timer = scheduler->wheel[ slot ];
+                timerPtr = &scheduler->timerPtr[ timer - 1u ];
+                Wheel_Remove( scheduler, timer );
+
+                if( timerPtr->expires == scheduler->wheelTick )
+                {
+                    timerPtr->count = 0;
+                    timerPtr->startFlag = FALSE;
+
+                    if( timerPtr->callbackPtr != NULL )
+                    {
+                        TRACE_EVENT( TRACE_TIMER_START, timer, 0u );
+                        timerPtr->callbackPtr();
+                        TRACE_EVENT( TRACE_TIMER_END, timer, 0u );
+                    }
+                }
+                else
+                {
+                    Wheel_Insert( scheduler, timer );   //cascade to a lower level
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Ticks to the next slot of the wheel with timers.
+ * 
+ * Each level is checked from the next slot to process, a slot of the first level is the expiration
+ * of its timers and a slot of an upper level is the tick to cascade them, so the nearest one is the
+ * time the scheduler can sleep without miss a timer, the cost is fixed by the size of the wheel.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * 
+ * @retval  Ticks to the next slot with timers, ULONG_MAX if there are no started timers.
+*/
+static unsigned long Wheel_NextTicks( const AppSched_Scheduler *scheduler )
+{
+    unsigned long nearest = ULONG_MAX;
+    unsigned long base;
+    unsigned long ticks;
+
+    for( unsigned char level = 0; level < WHEEL_LEVELS; level++ )
+    {
+        base = scheduler->wheelTick >> ( WHEEL_BITS * level );
+
+        for( unsigned long m = 1; m <= WHEEL_SLOTS; m++ )
+        {
+            if( scheduler->wheel[ ( level * WHEEL_SLOTS ) + ( ( base + m ) & WHEEL_MASK ) ] != 0u )
+            {
+                ticks = ( ( base + m ) << ( WHEEL_BITS * level ) ) - scheduler->wheelTick;
+
+                if( ticks < nearest )
+                {
+                    nearest = ticks;
+                }
+                break;
+            }
+        }
+    }
+
+    return nearest;
+}
+
+/**
+ * @brief   Period of a task in ticks.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Memory address of the TCB of the task.
+ * 
+ * @retval  Period in ticks, a task with period zero runs every tick.
+*/
+static unsigned long Scheduler_PeriodTicks( const AppSched_Scheduler *scheduler, const AppSched_Task *task )
+{
+    unsigned long ticks = task->period / scheduler->tick;
+
+    return ( ticks == 0u ) ? 1u : ticks;
+}
+
+/**
+ * @brief   Next tick where a task runs, counting from the next tick to process.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Memory address of the TCB of the task.
+ * 
+ * @retval  Number of the tick, from 1 up to the period in ticks.
+*/
+static unsigned long Scheduler_FirstTick( const AppSched_Scheduler *scheduler, const AppSched_Task *task )
+{
+    unsigned long first = 1;
+
+    if ( task->elapsed < task->period )
+    {
+        first = ( task->period - task->elapsed ) / scheduler->tick;
+    }
+
+    return first;
+}
+
+/**
+ * @brief   Least common multiple of the periods of the tasks.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   running [in] TRUE to take into account only the running tasks, FALSE for all of them.
+ * 
+ * @retval  Hyperperiod in ticks, zero if there are no running tasks or it overflows.
+*/
+static unsigned long Scheduler_Hyperperiod( const AppSched_Scheduler *scheduler, unsigned char running )
+{
+    unsigned long hyperperiod = 0;
+    unsigned long period;
+    unsigned long a;
+    unsigned long b;
+    unsigned long r;
+
+    for ( unsigned char i = 0; i < scheduler->tasksCount; i++ )
+    {
+        if ( ( scheduler->taskPtr[ i ].runTask == TRUE ) || ( running == FALSE ) )
+        {
+            period = Scheduler_PeriodTicks( scheduler, &scheduler->taskPtr[ i ] );
+
+            if ( hyperperiod == 0u )
+            {
+                hyperperiod = period;
+            }
+            else
+            {
+                a = hyperperiod;    //greatest common divisor, Euclid's algorithm
+                b = period;
+                while ( b != 0u )
+                {
+                    r = a % b;
+                    a = b;
+                    b = r;
+                }
+
+                period /= a;
+                hyperperiod = ( hyperperiod > ( ULONG_MAX / period ) ) ? 0u : ( hyperperiod * period );
+            }
+
+            if ( hyperperiod == 0u )
+            {
+                break;
+            }
+        }
+    }
+
+    return hyperperiod;
+}
+
+/**
+ * @brief   Add the releases of a task to a load profile.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Memory address of the TCB of the task.
+ * @param   load [in] Tasks released in each tick of the hyperperiod.
+ * @param   ticks [in] Hyperperiod in ticks, a multiple of the period of the task.
+*/
+static void Scheduler_AddLoad( const AppSched_Scheduler *scheduler, const AppSched_Task *task, unsigned char *load, unsigned long ticks )
+{
+    unsigned long period = Scheduler_PeriodTicks( scheduler, task );
+
+    for ( unsigned long k = Scheduler_FirstTick( scheduler, task ); k <= ticks; k += period )
+    {
+        load[ k - 1u ]++;
+    }
+}
+
+/**
+ * @brief   Set the first run of a task in the tick with the lowest load.
+ * 
+ * Each tick up to the period is tried as the first run, the cost is the max load of the ticks where
+ * the task would run, the first tick with the lowest cost is used.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Memory address of the TCB of the task.
+ * @param   load [in] Tasks released in each tick of the hyperperiod, the task is added.
+ * @param   ticks [in] Hyperperiod in ticks, a multiple of the period of the task.
+*/
+static void Scheduler_Place( const AppSched_Scheduler *scheduler, AppSched_Task *task, unsigned char *load, unsigned long ticks )
+{
+    unsigned long period = Scheduler_PeriodTicks( scheduler, task );
+    unsigned long first = 1;
+    unsigned char best = UCHAR_MAX;
+    unsigned char cost;
+
+    for ( unsigned long o = 1; o <= period; o++ )
+    {
+        cost = 0;
+
+        for ( unsigned long k = o; k <= ticks; k += period )
+        {
+            if ( load[ k - 1u ] > cost )
+            {
+                cost = load[ k - 1u ];
+            }
+        }
+
+        if ( cost < best )
+        {
+            best = cost;
+            first = o;
+        }
+    }
+
+    task->elapsed = ( task->period > ( first * scheduler->tick ) ) ? ( task->period - ( first * scheduler->tick ) ) : 0u;
+
+    Scheduler_AddLoad( scheduler, task, load, ticks );
+}
+
+/**
+ * @brief   Run a task released in the tick.
+ * 
+ * The time since the last run is checked with TIM6 when the ticks are processed in bursts, the event flag of the task is cleared because
+ * this run attends it too, and the run is added to the statistics of the task.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Position of the task in the TCB block, the taskID less one.
+ * @param   late [in] ms since the tick to process.
+ * @param   tickCount [in] TIM7 count when the tick started to be processed.
+*/
+static void Scheduler_RunTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long late, uint16_t tickCount )
+{
+    AppSched_Task *tcb = &scheduler->taskPtr[ task ];
+    uint16_t runStart;
+    uint16_t runEnd;
+
+    #if !defined( UTEST ) || defined( SIM )
+    uint16_t currentTick;
+
+    /*if a task is added it's mandatory add the error code */
+    static const App_ErrorsCode TasksError[ TASKS_N ] = 
+    { TASK_SERIAL_ERROR, TASK_CLOCK_ERROR, TASK_HEARTBEAT_ERROR, TASK_DISPLAY_ERROR, TASK_WWDG_ERROR, TASK_LCD_ERROR };
+
+    currentTick = __HAL_TIM_GetCounter( &TIM6_Handler );
+
+    if ( scheduler->catchUp == SCHED_CATCHUP_BURST )
+    {
+        /*the other policies leave out activations, the lateness is counted instead*/
+        assert_error( ( currentTick - lastTick[ task ] ) <= ( tcb->period + ERROR_2MS ) , TasksError[ task ] );
+    }
+    #endif
+
+    if ( tcb->event != NULL )
+    {
+        *tcb->event = FALSE;        //this run attends the event too
+    }
+
+    scheduler->running = task + 1u;
+    TRACE_EVENT( TRACE_TASK_START, task + 1u, FALSE );
+    runStart = Scheduler_ProfileCount( );
+    tcb->taskFunc();
+    runEnd = Scheduler_ProfileCount( );
+    TRACE_EVENT( TRACE_TASK_END, task + 1u, 0u );
+    scheduler->running = 0;
+
+    /*the response time counts from the tick, when the task was released*/
+    Scheduler_Profile( tcb, (uint16_t) ( runEnd - runStart ), ( late * US_PER_MS ) + (uint16_t) ( runEnd - tickCount ) );
+
+    #if !defined( UTEST ) || defined( SIM )
+    lastTick[ task ] = __HAL_TIM_GetCounter( &TIM6_Handler );
+    #endif
+}
+
+/**
+ * @brief   Release a task in the ticks processed.
+ * 
+ * The ticks are added to the elapsed time, when the period is reached the task runs following the
+ * catch up policy, in bursts the elapsed time restarts from zero, the other policies keep the rest
+ * of the division by the period so the next activations stay in the same ticks. The activations in
+ * the ticks processed that the task doesn't run are counted as skips, the ones missed while the task
+ * was stopped are not. A held task is not released, its period restarts when it's resumed.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   task [in] Position of the task in the TCB block, the taskID less one.
+ * @param   ticks [in] Number of ticks processed, one in bursts.
+ * @param   late [in] ms since the last tick processed.
+ * @param   tickCount [in] TIM7 count when the ticks started to be processed.
+*/
+static void Scheduler_ReleaseTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long ticks, unsigned long late, uint16_t tickCount )
+{
+    AppSched_Task *tcb = &scheduler->taskPtr[ task ];
+    unsigned long before = tcb->elapsed;
+    unsigned long missed;
+
+    if ( Scheduler_Held( tcb ) == FALSE )
+    {
+        tcb->elapsed += scheduler->tick * ticks;
+    }
+
+    if ( ( tcb->elapsed >= tcb->period ) && ( tcb->runTask == TRUE ) && ( Scheduler_Held( tcb ) == FALSE ) )
+    {
+        if ( ( scheduler->catchUp == SCHED_CATCHUP_BURST ) || ( tcb->period == 0u ) )
+        {
+            Scheduler_RunTask( scheduler, task, late, tickCount );
+            tcb->elapsed = 0;       //reset elapsed time
+        }
+        else
+        {
+            missed = ( tcb->elapsed / tcb->period ) - ( before / tcb->period );     //activations in these ticks
+
+            if ( ( scheduler->catchUp == SCHED_CATCHUP_ONCE ) || ( ( tcb->elapsed % tcb->period ) == 0u ) )
+            {
+                Scheduler_RunTask( scheduler, task, late, tickCount );
+                missed = ( missed > 0u ) ? ( missed - 1u ) : 0u;
+            }
+
+            tcb->stats.skips += missed;
+            tcb->elapsed %= tcb->period;
+        }
+    }
+}
+
+/**
+ * @brief   Run the tasks of the next minor frames of the table.
+ * 
+ * The taskIDs of each frame are read up to the zero that ends it, then the position is moved to the
+ * next frame, after the last one the table starts again. When several frames are processed in the
+ * same pass, the tasks run only in the last one skipping the rest, or with SCHED_CATCHUP_ONCE each
+ * task runs in the first frame where it's listed and skips the others. A held task is left out of
+ * the frames without count them as skips.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   ticks [in] Number of frames to process, one in bursts.
+ * @param   late [in] ms since the last tick processed.
+ * @param   tickCount [in] TIM7 count when the ticks started to be processed.
+*/
+static void Scheduler_RunFrames( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long late, uint16_t tickCount )
+{
+    unsigned long done = 0u;    //a bit for each task already run in these frames, up to SCHED_MAX_TASKS
+    unsigned char task;
+    unsigned char run;
+
+    for ( unsigned long frame = ticks; frame > 0u; frame-- )
+    {
+        task = scheduler->framePtr[ scheduler->frameIndex ];
+
+        while ( task != 0u )
+        {
+            if ( ( scheduler->taskPtr[ task - 1u ].runTask == TRUE ) && ( Scheduler_Held( &scheduler->taskPtr[ task - 1u ] ) == FALSE ) )
+            {
+                run = ( frame == 1u ) ? TRUE : FALSE;
+
+                if ( scheduler->catchUp == SCHED_CATCHUP_ONCE )
+                {
+                    run = ( ( done & ( 1UL << ( task - 1u ) ) ) == 0u ) ? TRUE : FALSE;
+                    done |= ( 1UL << ( task - 1u ) );
+                }
+
+                if ( run == TRUE )
+                {
+                    Scheduler_RunTask( scheduler, task - 1u, late, tickCount );
+                }
+                else
+                {
+                    scheduler->taskPtr[ task - 1u ].stats.skips++;
+                }
+            }
+
+            scheduler->frameIndex++;
+            task = scheduler->framePtr[ scheduler->frameIndex ];
+        }
+
+        scheduler->frameIndex++;        //skip the end of the frame
+
+        if ( scheduler->frameIndex >= scheduler->framesCount )
+        {
+            scheduler->frameIndex = 0;
+        }
+    }
+}
+
+/**
+ * @brief   Count the ticks processed late.
+ * 
+ * A tick is late when it's processed one tick or more after it was due, the ticks before the wake
+ * up of the last sleep are not counted because the idle function was asked to sleep over them.
+ * The max lateness is taken from the first tick processed that was not slept.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   now [in] ms since the scheduler started.
+ * @param   first [in] First tick processed.
+ * @param   ticks [in] Number of ticks processed.
+ * @param   wake [in] Tick where the last sleep should end.
+*/
+static void Scheduler_Lateness( AppSched_Scheduler *scheduler, unsigned long now, unsigned long first, unsigned long ticks, unsigned long wake )
+{
+    unsigned long from = ( first > wake ) ? first : wake;
+    unsigned long last = first + ticks - 1u;
+    unsigned long behind;
+
+    if ( from <= last )
+    {
+        if ( ( now - ( scheduler->tick * from ) ) > scheduler->maxLate )
+        {
+            scheduler->maxLate = now - ( scheduler->tick * from );
+        }
+
+        if ( now >= ( scheduler->tick * ( from + 1u ) ) )
+        {
+            behind = ( now / scheduler->tick ) - 1u;    //last tick processed one tick late or more
+
+            if ( behind > last )
+            {
+                behind = last;
+            }
+
+            scheduler->lateTicks += behind - from + 1u;
+        }
+    }
+}
+
+/**
+ * @brief   Count the ticks of the tasks held by AppSched_waitTask and release the ones whose wait ends.
+ * 
+ * It's called before the tasks are released, so a wait set in these ticks is counted from the next
+ * one. The resumed task runs as released in the tick and its period restarts from there, with a frame
+ * table it runs in its next frame instead, from this same tick. A task stopped when its wait ends
+ * keeps held one more tick, so it's resumed on the first tick after it's started. The time checked
+ * with TIM6 restarts on the resume too, the task was held on purpose. The TCBs are visited only
+ * while the count held is not zero.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   ticks [in] Number of ticks processed.
+ * @param   late [in] ms since the last tick processed.
+ * @param   tickCount [in] TIM7 count when the ticks started to be processed.
+*/
+static void Scheduler_Resume( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long late, uint16_t tickCount )
+{
+    AppSched_Task *tcb;
+    unsigned char held = scheduler->held;   /*tasks held left to visit*/
+
+    for ( unsigned char i = 0; held > 0u; i++ )
+    {
+        tcb = &scheduler->taskPtr[ i ];
+
+        if ( tcb->wait > 0u )
+        {
+            held--;
+            tcb->wait = ( tcb->wait > ticks ) ? ( tcb->wait - ticks ) : 0u;
+
+            if ( ( tcb->wait == 0u ) && ( tcb->runTask == FALSE ) )
+            {
+                tcb->wait = 1;
+            }
+            else if ( tcb->wait == 0u )
+            {
+                scheduler->held--;
+
+                #if !defined( UTEST ) || defined( SIM )
+                lastTick[ i ] = __HAL_TIM_GetCounter( &TIM6_Handler );
+                #endif
+
+                if ( scheduler->framesCount == 0u )
+                {
+                    tcb->elapsed = 0;
+                    Scheduler_RunTask( scheduler, i, late, tickCount );
+                }
+            }
+            else
+            {
+                /*still waiting*/
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Know if a task is held by AppSched_waitTask or AppSched_untilTask.
+ * 
+ * @param   task [in] Memory address of the TCB.
+ * 
+ * @retval  TRUE if the task is held, FALSE if not.
+*/
+static unsigned char Scheduler_Held( const AppSched_Task *task )
+{
+    return ( ( task->wait > 0u ) || ( task->until != NULL ) ) ? TRUE : FALSE;
+}
+
+/**
+ * @brief   Time to the next minor frame of the table with tasks.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * 
+ * @retval  Time in ms, the tasks of the frame could be stopped, then the scheduler wakes up before
+ *          it's needed.
+*/
+static unsigned long Scheduler_FrameIdle( const AppSched_Scheduler *scheduler )
+{
+    unsigned long frames = 1;
+    unsigned short index = scheduler->frameIndex;
+
+    while ( ( scheduler->framePtr[ index ] == 0u ) && ( frames < scheduler->framesCount ) )
+    {
+        frames++;
+        index++;            //the next frame, each empty one is just its end
+
+        if ( index >= scheduler->framesCount )
+        {
+            index = 0;
+        }
+    }
+
+    return frames * scheduler->tick;
+}
+
+/**
+ * @brief   Read the TIM7 count used to time the tasks.
+ * 
+ * @retval  Count in us, it overflows every 65.5 ms, zero for the unit tests, the host simulation
+ *          reads the count of its virtual TIM7.
+*/
+static uint16_t Scheduler_ProfileCount( void )
+{
+    uint16_t count = 0;
+
+    #if !defined( UTEST ) || defined( SIM )
+    count = (uint16_t) __HAL_TIM_GetCounter( &TIM7_Handler );
+    #endif
+
+    return count;
+}
+
+/**
+ * @brief   Add a run to the execution time statistics of a task.
+ * 
+ * A periodic run is an overrun when its response time, since the tick that released it until the
+ * end of the run, is longer than the period, the next run of the task is already late.
+ * 
+ * @param   task [in] Memory address of the TCB of the task.
+ * @param   exec [in] Execution time of the run in us.
+ * @param   response [in] Response time of the run in us, zero for a run by its event.
+*/
+STATIC void Scheduler_Profile( AppSched_Task *task, unsigned long exec, unsigned long response )
+{
+    task->stats.runs++;
+    task->stats.totalTime += exec;
+
+    if( exec < task->stats.minTime )
+    {
+        task->stats.minTime = exec;
+    }
+
+    if( exec > task->stats.maxTime )
+    {
+        task->stats.maxTime = exec;
+    }
+
+    if( response > ( task->period * US_PER_MS ) )
+    {
+        task->stats.overruns++;
+    }
+}
+
+/**
+ * @brief   Add a pass of the scheduler to the CPU load and end the window when it's complete.
+ * 
+ * The window is counted in ticks processed, when they reach SCHED_LOAD_WINDOW_MS the busy time is
+ * compared with the time of the ticks, the load is kept and the peak updated, and a new window starts.
+ * The load is limited to SCHED_LOAD_FULL, a pass that ends after the window could count more.
+ * 
+ * @param   scheduler [in] Memory address of the scheduler to access the elements.
+ * @param   ticks [in] Number of ticks processed in the pass.
+ * @param   busy [in] Time in us of the pass.
+ * 
+ * @note    A pass longer than 65 ms can not be measured with TIM7, the same as a task.
+*/
+STATIC void Scheduler_CpuLoad( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long busy )
+{
+    unsigned long window;
+    unsigned long load;
+
+    scheduler->busyTime += busy;
+    scheduler->loadTicks += ticks;
+    window = scheduler->loadTicks * scheduler->tick;
+
+    if ( window >= SCHED_LOAD_WINDOW_MS )
+    {
+        load = (unsigned long) ( ( (unsigned long long) scheduler->busyTime * SCHED_LOAD_FULL ) / 
+                                 ( (unsigned long long) window * US_PER_MS ) );
+
+        if ( load > SCHED_LOAD_FULL )
+        {
+            load = SCHED_LOAD_FULL;
+        }
+
+        scheduler->cpuLoad = (unsigned short) load;
+
+        if ( scheduler->cpuLoad > scheduler->cpuPeak )
+        {
+            scheduler->cpuPeak = scheduler->cpuLoad;
+        }
+
+        scheduler->busyTime = 0;
+        scheduler->loadTicks = 0;
+    }
+}
+
+/**
+ * @brief function where the TIM6 and TIM7 are initialized.
+ * 
+ * In this application we are working with a APB prescaler of 2, then it makes the TIM6 clock
+ * frequency set to PCLK * 2, it is 64MHz. (reference maunal pag. 173).
+ * To make things easier is used a TIM6 prescaler of 64000 to get a 1 ms period.
+ * TIM7 has the same clock and a prescaler of 64 to count us, it runs free without interrupts and
+ * its count is used to time the tasks.
+*/
+static void Scheduler_monitoring_Init( void )
+{
+    TIM6_Handler.Instance           = TIM6;
+    TIM6_Handler.Init.Prescaler     = TIM6_PRESCALER;
+    TIM6_Handler.Init.CounterMode   = TIM_COUNTERMODE_UP;
+    TIM6_Handler.Init.Period        = MAX_COUNT_TIM6;
+    TIM6_Handler.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    
+    HAL_NVIC_SetPriority( TIM6_DAC_LPTIM1_IRQn, 2, 0 );
+    HAL_NVIC_EnableIRQ( TIM6_DAC_LPTIM1_IRQn );
+
+    HAL_TIM_Base_Init( &TIM6_Handler );
+
+    HAL_TIM_Base_Start_IT( &TIM6_Handler );
+
+    TIM7_Handler.Instance           = TIM7;
+    TIM7_Handler.Init.Prescaler     = TIM7_PRESCALER;
+    TIM7_Handler.Init.CounterMode   = TIM_COUNTERMODE_UP;
+    TIM7_Handler.Init.Period        = MAX_COUNT_TIM7;
+    TIM7_Handler.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+
+    HAL_TIM_Base_Init( &TIM7_Handler );
+
+    HAL_TIM_Base_Start( &TIM7_Handler );
 }
 
 /**
@@ -9,7 +9,11 @@
 
 #include "stdint.h"
 
-#ifndef TEST_L
+#if defined( SIM )
+unsigned char Sim_Running( void );
+void Sim_Sleep( unsigned long ms );
+#define FOREVER() Sim_Running()  /*!< The host simulation ends the loop after the simulated time */
+#elif !defined( TEST_L )
 #define FOREVER() 1             /*!< MACRO defined with test purposes */  
 #else 
 extern unsigned char numLoops;
@@ -24,6 +28,73 @@ extern unsigned char numLoops;
 /**
   @} */
 
+/** 
+  * @defgroup CatchUp Policies to process the ticks missed when a tick is processed late
+  @{ */
+#define SCHED_CATCHUP_BURST     0u  /*!< Process each missed tick in its own loop, the tasks run once per missed activation */
+#define SCHED_CATCHUP_ONCE      1u  /*!< Process all the missed ticks together, each task due runs once */
+#define SCHED_CATCHUP_SKIP      2u  /*!< Process all the missed ticks together, only the tasks due in the current tick run */
+/**
+  @} */
+
+/** 
+  * @defgroup TaskLimit Max number of tasks, each task has a bit in the internal bitmap of the tasks
+  * activated by a flag
+  @{ */
+#define SCHED_MAX_TASKS         32u /*!< Max value of the element tasks of the scheduler */
+/**
+  @} */
+
+/** 
+  * @defgroup CpuLoad CPU load measured by the scheduler, the time running tasks, timers and interrupts
+  * against the time of the window, the load is given in 0.01 % units
+  @{ */
+#define SCHED_LOAD_WINDOW_MS    1000u   /*!< Time of each measurement window of the CPU load */
+#define SCHED_LOAD_FULL         10000u  /*!< CPU load of 100 % */
+/**
+  @} */
+
+/** 
+  * @defgroup Coroutine Macros for a resumable task, the task function keeps in an AppSched_Coroutine
+  * the point where it waits and returns, the scheduler holds the task until the wait ends and the
+  * next run continues after the wait. The local variables are lost in a wait, the ones used after it
+  * must be static, and a switch can not be used between SCHED_CO_BEGIN and SCHED_CO_END
+  @{ */
+#define SCHED_CO_BEGIN( co )    switch( (co)->line ) { case 0u:     /*!< Start of the resumable code, jump to the last wait */
+#define SCHED_CO_YIELD( co )    (co)->line = __LINE__; return; case __LINE__: ; /*!< Return, the next run continues from here */
+#define SCHED_CO_WAIT_MS( sched, co, ms ) \
+    (void) AppSched_waitTask( (sched), (ms) ); SCHED_CO_YIELD( co )  /*!< Wait at least ms, the task is held meanwhile */
+#define SCHED_CO_WAIT_UNTIL( sched, co, cond, flag ) \
+    while( !( cond ) ) { (void) AppSched_untilTask( (sched), (flag) ); SCHED_CO_YIELD( co ) }  /*!< Wait until cond, checked each time flag is set */
+#define SCHED_CO_END( co )      default: break; } (co)->line = 0u   /*!< End of the resumable code, the next run starts again */
+/**
+  @} */
+
+/** 
+  * @defgroup TimerWheel Size of the timer wheel, each level has WHEEL_SLOTS slots and each slot of
+  * a level spans WHEEL_SLOTS slots of the level below, the first level has one tick per slot
+  @{ */
+#define WHEEL_BITS      4u                      /*!< Bits of the tick count used by each level */
+#define WHEEL_SLOTS     ( 1u << WHEEL_BITS )    /*!< Number of slots in each level */
+#define WHEEL_MASK      ( WHEEL_SLOTS - 1u )    /*!< Mask to get the slot in a level */
+#define WHEEL_LEVELS    4u                      /*!< Number of levels, 65536 ticks without cascade the timer again from the last level */
+/**
+  @} */
+
+/**
+ * @brief Execution time statistics of a task, the times are in us.
+*/
+typedef struct _AppSched_Stats
+{
+    unsigned long runs;             /*!< Number of runs, periodic or by its event */
+    unsigned long overruns;         /*!< Periodic runs that end after its period since its tick */
+    unsigned long skips;            /*!< Periodic activations not run because of the catch up policy */
+    unsigned long minTime;          /*!< Min execution time */
+    unsigned long maxTime;          /*!< Max execution time */
+    unsigned long avgTime;          /*!< Average execution time, only set by AppSched_statsTask */
+    unsigned long long totalTime;   /*!< Sum of all the execution times */
+} AppSched_Stats;
+
 /**
  * @brief This struct is the task control block (TCB).
 */
@@ -34,8 +105,21 @@ typedef struct _task
     void (*initFunc)(void);     /*!< pointer to init task function */
     void (*taskFunc)(void);     /*!< pointer to task function */
     unsigned char runTask;      /*!< indicate the task is stopped or not*/
+    unsigned long offset;       /*!< time of the first run set by AppSched_offsetTask, zero to let AppSched_staggerTasks set it */
+    volatile unsigned char *event;  /*!< flag that activates the task when it's TRUE, NULL for a periodic only task */
+    AppSched_Stats stats;       /*!< execution time statistics of the task */
+    unsigned long wait;         /*!< Ticks left of the wait set by AppSched_waitTask, the task is held meanwhile */
+    volatile unsigned char *until;  /*!< flag set by AppSched_untilTask, the task is held until it's TRUE */
 }AppSched_Task;
 
+/**
+ * @brief Resume point of a resumable task, see the Coroutine macros.
+*/
+typedef struct _AppSched_Coroutine
+{
+    unsigned short line;        /*!< Line of the last wait, zero to start from the beginning */
+} AppSched_Coroutine;
+
 /**
  * @brief Struct to control the software timers.
 */
@@ -45,6 +129,10 @@ typedef struct _AppSched_Timer
     unsigned long count;         /*!< Actual timer decrement count. */
     unsigned char startFlag;     /*!< Flag to start timer count. */
     void(*callbackPtr)(void);    /*!< Pointer to callback function function. */
+    unsigned long expires;       /*!< Wheel tick when the timer expires, valid while it's started */
+    unsigned char slot;          /*!< Slot of the wheel where the timer is linked */
+    unsigned char next;          /*!< timerID of the next timer in the slot, zero at the end */
+    unsigned char prev;          /*!< timerID of the previous timer in the slot, zero at the head */
 } AppSched_Timer;
 
 /**
@@ -59,6 +147,24 @@ typedef struct _scheduler
     unsigned char timers;       /*!< Number of software timer to use */ 
     AppSched_Timer *timerPtr;   /*!< Pointer to buffer timer array */    
     unsigned char timersCount;  /*!< Internal timer counter. */
+    void (*idleFunc)(unsigned long ms); /*!< Function to sleep up to ms when there is nothing to run, NULL to wait polling the tick */
+    unsigned char catchUp;      /*!< Policy for the missed ticks, SCHED_CATCHUP_BURST (zero) by default */
+    unsigned long lateTicks;    /*!< Internal number of ticks processed one tick or more after they were due */
+    unsigned long maxLate;      /*!< Internal max time in ms between a tick was due and it was processed */
+    unsigned short frames;      /*!< Size of the frame table, zero to run the tasks checking its periods */
+    unsigned char *framePtr;    /*!< Pointer to buffer for the frame table, built by AppSched_buildTable */
+    unsigned short framesCount; /*!< Internal number of elements used in the frame table, zero when it's not built */
+    unsigned short frameIndex;  /*!< Internal position of the next minor frame in the table */
+    unsigned long wheelTick;    /*!< Internal count of ticks processed by the timer wheel */
+    unsigned char running;      /*!< Internal taskID of the task running, zero out of the tasks */
+    unsigned char runEvent;     /*!< Internal TRUE when the task running was activated by an event flag */
+    unsigned long flagged;      /*!< Internal bitmap, the bit n is set when the taskID n+1 has an event flag or waits for a flag */
+    unsigned char held;         /*!< Internal number of tasks held by AppSched_waitTask */
+    unsigned long busyTime;     /*!< Internal time in us with the CPU busy in the current load window */
+    unsigned long loadTicks;    /*!< Internal ticks processed in the current load window */
+    unsigned short cpuLoad;     /*!< Internal CPU load of the last window ended, in 0.01 % */
+    unsigned short cpuPeak;     /*!< Internal max CPU load of a window since the start, in 0.01 % */
+    unsigned char wheel[ WHEEL_LEVELS * WHEEL_SLOTS ];  /*!< Internal timerID of the first timer in each slot, zero for an empty slot */
 }AppSched_Scheduler;
 
 
@@ -67,7 +173,18 @@ unsigned char AppSched_registerTask( AppSched_Scheduler *scheduler, void (*initP
 unsigned char AppSched_stopTask( AppSched_Scheduler *scheduler, unsigned char task );
 unsigned char AppSched_startTask( AppSched_Scheduler *scheduler, unsigned char task );
 unsigned char AppSched_periodTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long period);
+unsigned char AppSched_eventTask( AppSched_Scheduler *scheduler, unsigned char task, volatile unsigned char *event );
+unsigned char AppSched_offsetTask( AppSched_Scheduler *scheduler, unsigned char task, unsigned long offset );
+unsigned char AppSched_staggerTasks( AppSched_Scheduler *scheduler );
+unsigned char AppSched_buildTable( AppSched_Scheduler *scheduler );
+unsigned long AppSched_loadProfile( const AppSched_Scheduler *scheduler, unsigned char *load, unsigned long ticks );
+unsigned char AppSched_statsTask( const AppSched_Scheduler *scheduler, unsigned char task, AppSched_Stats *stats );
+unsigned char AppSched_clearStatsTask( AppSched_Scheduler *scheduler, unsigned char task );
+unsigned char AppSched_waitTask( AppSched_Scheduler *scheduler, unsigned long ms );
+unsigned char AppSched_untilTask( AppSched_Scheduler *scheduler, volatile unsigned char *flag );
+unsigned short AppSched_cpuLoad( const AppSched_Scheduler *scheduler, unsigned short *peak );
 void AppSched_startScheduler( AppSched_Scheduler *scheduler );
+void AppSched_sleep( unsigned long ms );
 
 unsigned char AppSched_registerTimer( AppSched_Scheduler *scheduler, unsigned long timeout, void (*callbackPtr)(void) );
 unsigned long AppSched_getTimer( AppSched_Scheduler *scheduler, unsigned char timer );
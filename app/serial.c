@@ -5,7 +5,18 @@
  * Here it is implemented the message processing using a state machine, which has 7 states IDLE
  * where wait for a message, MESSAGE where the msg is evaluated, ALARM, DATE and TIME to 
  * evaluate the parameter of respective msg type, finally OK and ERROR states to send a msg.
- * Messagges are sent and received through FDCAN module. 
+ * Messagges are sent and received through FDCAN module. The LOAD state sends the CPU load measured
+ * by the scheduler, written each second by SerialLoad_Callback when the timer is registered in main.c.
+ *
+ * The CONFIG ID carries several settings in a single ISO-TP (ISO 15765-2) transfer, up to
+ * SERIAL_TP_SIZE bytes split in a first frame and consecutive frames. The CAN interrupt writes the
+ * frames of this ID as they are in the queue, and the serial task reassembles them, it answers the
+ * first frame and each block of SERIAL_TP_BLOCK_SIZE frames with a flow control on the RESPONSE ID.
+ * The payload is a list of items, the type of the setting (SERIAL_MSG_TIME, DATE or ALARM) followed
+ * by its parameters, all of them are checked before apply any, and the response lists the OK or
+ * ERROR of the transfer followed by one per item, sent with a multi-frame transfer when it doesn't
+ * fit in a single frame. Two scheduler timers, registered in main.c, abort a transfer when the next
+ * frame or flow control is late and pace the consecutive frames sent with the STmin of the tester.
 */
 #include "serial.h"
 #include "bsp.h" 
@@ -23,16 +34,53 @@ FDCAN_HandleTypeDef CANHandler;
 static FDCAN_TxHeaderTypeDef CANTxHeader;
 
 /**
- * @brief   Queue to manage the event machine.
+ * @brief   Queue to pass the received messages from the CAN interrupt to the event machine.
+ * 
+ * It works in SPSC mode, the CAN interrupt is the only producer and the serial task the only consumer.
+ * The queue only stores the address of the messages, which are blocks of the MessagesPool.
 */
 static AppQue_Queue queue;
 
+/**
+ * @brief   Pool of blocks where the CAN interrupt reads the received messages.
+ * 
+ * The interrupt allocates a block per message and the serial task frees it once it's processed.
+*/
+static AppPool_Pool MessagesPool;
+
+/**
+ * @brief   Flag set by each write in the CAN queue, the serial task is bound to it in main.c.
+*/
+volatile uint8_t SerialEvent;
+
+/**
+ * @brief   Queue where the event machine writes its own OK and ERROR events.
+ * 
+ * These events are kept out of the CAN queue to keep the interrupt as its only producer.
+*/
+static AppQue_Queue ResponseQueue;
+
+/**
+ * @brief   Frames and responses dropped by the flow control, read from a debugger.
+*/
+APP_SerialStats SerialStats;
+
+/**
+ * @brief   ISO-TP transfer received on the CONFIG ID.
+*/
+STATIC APP_TpTypeDef TpRx;
+
+/**
+ * @brief   ISO-TP transfer sent with the response to a CONFIG transfer.
+*/
+STATIC APP_TpTypeDef TpTx;
+
 
 
 /*Functions prototypes*/
 STATIC void Serial_SingleFrameTx( uint8_t *data, uint8_t size );
 
-STATIC uint8_t Serial_SingleFrameRx( uint8_t *data, uint8_t *size);
+STATIC uint8_t Serial_SingleFrameRx( const uint8_t *data, uint8_t *size);
 
 STATIC uint8_t Validate_LeapYear( uint16_t year );
 
@@ -48,17 +96,49 @@ STATIC APP_Messages Evaluate_Date_Parameters( APP_CanTypeDef *SerialMsgPtr );
 
 STATIC APP_Messages Evaluate_Alarm_Parameters( APP_CanTypeDef *SerialMsgPtr );
 
+STATIC APP_Messages Evaluate_Config_Frame( APP_CanTypeDef *SerialMsgPtr );
+
 STATIC APP_Messages Send_Ok_Message( APP_CanTypeDef *SerialMsgPtr );
 
 STATIC APP_Messages Send_Error_Message( APP_CanTypeDef *SerialMsgPtr );
 
+STATIC APP_Messages Send_Load_Message( APP_CanTypeDef *SerialMsgPtr );
+
+STATIC APP_Messages Serial_TimeItem( const uint8_t *params, uint8_t apply );
+
+STATIC APP_Messages Serial_DateItem( const uint8_t *params, uint8_t apply );
+
+STATIC APP_Messages Serial_AlarmItem( const uint8_t *params, uint8_t apply );
+
+STATIC APP_Messages Serial_ConfigItems( const uint8_t *payload, uint16_t length, uint8_t apply, uint8_t *status, uint8_t *items );
+
+STATIC void Evaluate_Config_Parameters( const uint8_t *payload, uint16_t length );
+
+STATIC void Serial_TpReceive( const uint8_t *frame );
+
+STATIC void Serial_TpSend( const uint8_t *data, uint16_t length );
+
+STATIC void Serial_TpConsecutive( void );
+
+STATIC void Serial_TpFlowControl( uint8_t status );
+
+STATIC void Serial_TpFrame( const uint8_t *frame );
+
+STATIC unsigned long Serial_TpTime( uint8_t stMin );
+
+STATIC void Serial_RxDrain( FDCAN_HandleTypeDef *hfdcan );
+
+STATIC uint8_t Serial_Transmit( FDCAN_TxHeaderTypeDef *header, uint8_t *data );
+
+STATIC uint8_t Serial_SendBusy( uint16_t id, uint32_t count );
+
 
 /**
  * @brief Interface to initialize all required about message processing.
  * 
  * FDCAN module is initialize to work with a baudrate of 250kps to transmit and receive
- * standard messages, and also is configured 2 filters, one of them its a mask type and other
- * is Dual type, with 3 differents ID's.
+ * standard messages, and also are configured FILTERS_N filters of mask type, one per ID, the
+ * index of each filter gives the message type of the frames it accepts.
  * Here is also configured the queue in charge of pass the messages from the CAN interrupt
  * to the state machine.
  * The FDCAN module works with PCLK clock which has been configured to have a frequency of
@@ -77,7 +157,12 @@ void Serial_InitTask( void )
 {
     HAL_StatusTypeDef Status = HAL_ERROR;
 
-    static APP_CanTypeDef messages[ MESSAGES_N ];   /*queue buffer*/
+    static APP_CanTypeDef *messages[ MESSAGES_N ];  /*queue buffer, addresses of the pool blocks*/
+    static APP_CanTypeDef blocks[ MESSAGES_N ];     /*pool buffer*/
+    static APP_CanTypeDef responses[ MESSAGES_N ];  /*response queue buffer*/
+#ifdef QUEUE_STATS
+    static unsigned long messagesStamps[ MESSAGES_N ];  /*ticks when each message was written*/
+#endif
     /*structure to config CAN filters*/
     FDCAN_FilterTypeDef CANFilter;
 
@@ -101,7 +186,7 @@ void Serial_InitTask( void )
 
     /*Config filter to ID TIME*/
     CANFilter.IdType        = FDCAN_STANDARD_ID;
-    CANFilter.FilterIndex   = 0;
+    CANFilter.FilterIndex   = SERIAL_FILTER_TIME;
     CANFilter.FilterType    = FDCAN_FILTER_MASK;
     CANFilter.FilterConfig  = FDCAN_FILTER_TO_RXFIFO0;
     CANFilter.FilterID1     = ID_TIME_MSG;
@@ -110,15 +195,27 @@ void Serial_InitTask( void )
     Status = HAL_FDCAN_ConfigFilter( &CANHandler, &CANFilter );
     assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
 
-    /*Config filter to ID DATE and ID ALARM*/
-    CANFilter.FilterIndex   = 1;
-    CANFilter.FilterType    = FDCAN_FILTER_DUAL;
+    /*Config filter to ID DATE*/
+    CANFilter.FilterIndex   = SERIAL_FILTER_DATE;
     CANFilter.FilterID1     = ID_DATE_MSG;
-    CANFilter.FilterID2     = ID_ALARM_MSG;
     
     Status = HAL_FDCAN_ConfigFilter ( &CANHandler, &CANFilter );
     assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
 
+    /*Config filter to ID ALARM*/
+    CANFilter.FilterIndex   = SERIAL_FILTER_ALARM;
+    CANFilter.FilterID1     = ID_ALARM_MSG;
+
+    Status = HAL_FDCAN_ConfigFilter ( &CANHandler, &CANFilter );
+    assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
+
+    /*Config filter to ID CONFIG*/
+    CANFilter.FilterIndex   = SERIAL_FILTER_CONFIG;
+    CANFilter.FilterID1     = ID_CONFIG_MSG;
+
+    Status = HAL_FDCAN_ConfigFilter( &CANHandler, &CANFilter );
+    assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
+
     /*FDCAN to normal mode*/
     Status = HAL_FDCAN_Start( &CANHandler );
     assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
@@ -130,21 +227,62 @@ void Serial_InitTask( void )
     CANTxHeader.Identifier  = RESPONSE_ID;          
     CANTxHeader.DataLength  = FDCAN_DLC_BYTES_8;
 
+#ifdef SERIAL_RX_WATERMARK
+    /*interrupt only with the FIFO0 full, the serial task drains the frames below it*/
+    Status = HAL_FDCAN_ActivateNotification( &CANHandler, FDCAN_IT_RX_FIFO0_FULL, 0 );
+#else
     Status = HAL_FDCAN_ActivateNotification( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE, 0 );
+#endif
     assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
 
-    /*Queue configuration*/
+    /*Pool and queue configuration*/
+    MessagesPool.Buffer = blocks;
+    MessagesPool.Blocks = MESSAGES_N;
+    MessagesPool.Size   = sizeof( APP_CanTypeDef );
+    AppPool_initPool( &MessagesPool );
+
     queue.Buffer    = messages;
     queue.Elements  = MESSAGES_N;
-    queue.Size      = sizeof( APP_CanTypeDef );
-    AppQueue_initQueue( &queue );
+    queue.Size      = sizeof( APP_CanTypeDef * );
+    queue.Spsc      = TRUE;
+    queue.Event     = &SerialEvent;
+#ifdef QUEUE_STATS
+    queue.Stats.Stamps = messagesStamps;
+#endif
+    (void) AppQueue_initQueue( &queue );
+
+    ResponseQueue.Buffer    = responses;
+    ResponseQueue.Elements  = MESSAGES_N;
+    ResponseQueue.Size      = sizeof( APP_CanTypeDef );
+    (void) AppQueue_initQueue( &ResponseQueue );
+
+    TpRx.state = TP_IDLE;
+    TpTx.state = TP_IDLE;
+
+    SerialStats.RxDropped   = 0u;
+    SerialStats.RespDropped = 0u;
+    SerialStats.Reported    = 0u;
+    SerialStats.BusySent    = 0u;
+    SerialStats.TxRetries   = 0u;
+    SerialStats.TxDropped   = 0u;
 }
 
 /**
  * @brief Interface to implement serial event machine.
  * 
  * The event machine implementation is made using a pointer to functions array, in each case a function
- * is called depending on the type of msg read from the queue.
+ * is called depending on the type of msg read from the queue. First are processed all the received
+ * messages and then the OK and ERROR events written by them in the ResponseQueue, each queue is
+ * drained with a single batch read, the messages that arrive meanwhile are processed the next period.
+ * The received messages are read from the pool blocks and each block is freed after its message
+ * is processed, the SERIAL_MSG_CONFIG event passes the frames of the CONFIG ID to the ISO-TP reassembly.
+ * With SERIAL_RX_WATERMARK the FDCAN only interrupts with the FIFO0 full, so first the frames below
+ * it are drained here with the FDCAN interrupt masked, the CAN queue keeps a single producer.
+ * 
+ * The responses are read only up to the free elements of the TX FIFO, the rest wait in the
+ * ResponseQueue and are sent the next period. Before them a BUSY response tells the frames dropped
+ * since the last one, and with SERIAL_BUSY_CAN a BUSY status is sent on SERIAL_BUSY_ID when the
+ * frames read in the period reach SERIAL_BUSY_LEVEL, so the other nodes can slow down.
 */
 void Serial_PeriodicTask( void )
 {
@@ -154,31 +292,134 @@ void Serial_PeriodicTask( void )
         Evaluate_Date_Parameters,
         Evaluate_Alarm_Parameters,
         Send_Ok_Message,
-        Send_Error_Message
+        Send_Error_Message,
+        Send_Load_Message,
+        Evaluate_Config_Frame
     };
 
-    APP_CanTypeDef SerialMsg;
+    static APP_CanTypeDef *ReceivedMsgs[ MESSAGES_N ];  /*pool blocks drained from the queue*/
+    static APP_CanTypeDef SerialMsgs[ MESSAGES_N ];     /*messages drained from the ResponseQueue*/
+    unsigned char Status = FALSE;
+
+#ifdef SERIAL_RX_WATERMARK
+    HAL_NVIC_DisableIRQ( TIM16_FDCAN_IT0_IRQn );
+    Serial_RxDrain( &CANHandler );
+    HAL_NVIC_EnableIRQ( TIM16_FDCAN_IT0_IRQn );
+#endif
+
+    unsigned long nMsgs = HIL_QUEUE_readBatchISR( &queue, ReceivedMsgs, MESSAGES_N );
 
-    while( HIL_QUEUE_isQueueEmptyISR( &queue ) == FALSE )
+    for( unsigned long i = 0; i < nMsgs; i++ )
     {
-        uint8_t Status = FALSE;
-        
-        Status = HIL_QUEUE_readDataISR( &queue, &SerialMsg );
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+        if( ReceivedMsgs[ i ]->event < (uint8_t) SERIAL_N_EVENTS )   /*Check if the event is valid*/
+        {
+            (void) SerialEventMachine[ ReceivedMsgs[ i ]->event ]( ReceivedMsgs[ i ] );
+        }
+
+        Status = AppPool_free( &MessagesPool, ReceivedMsgs[ i ] );        /*the block can be used again*/
+        assert_error( Status == TRUE, POOL_RET_ERROR );
+    }
 
-        if( SerialMsg.bytes[ MSG ] < (uint8_t) SERIAL_N_EVENTS )          /*Check if the event is valid*/
+    unsigned long nFree = HAL_FDCAN_GetTxFifoFreeLevel( &CANHandler );     /*frames that can be sent now*/
+    uint32_t dropped = ( SerialStats.RxDropped + SerialStats.RespDropped ) - SerialStats.Reported;
+
+    if( ( dropped > 0u ) && ( nFree > 0u ) && ( Serial_SendBusy( RESPONSE_ID, dropped ) == TRUE ) )
+    {
+        SerialStats.Reported += dropped;
+        nFree--;
+    }
+
+#ifdef SERIAL_BUSY_CAN
+    if( ( nMsgs >= SERIAL_BUSY_LEVEL ) && ( nFree > 0u ) && ( Serial_SendBusy( SERIAL_BUSY_ID, nMsgs ) == TRUE ) )
+    {
+        nFree--;
+    }
+#endif
+
+    unsigned long nResponses = HIL_QUEUE_readBatchISR( &ResponseQueue, SerialMsgs, nFree );
+
+    for( unsigned long i = 0; i < nResponses; i++ )
+    {
+        if( SerialMsgs[ i ].bytes[ MSG ] < (uint8_t) SERIAL_N_EVENTS )      /*Check if the event is valid*/
         {
-            (void) SerialEventMachine[ SerialMsg.bytes[ MSG ] ]( &SerialMsg );
+            (void) SerialEventMachine[ SerialMsgs[ i ].bytes[ MSG ] ]( &SerialMsgs[ i ] );
         }
     }
-    
+
+    if( ( nResponses == nFree ) && ( HIL_QUEUE_isQueueEmptyISR( &ResponseQueue ) == FALSE ) )
+    {
+        SerialStats.TxRetries++;        /*the responses left are sent the next period*/
+    }
+}
+
+/**
+ * @brief   Timer callback to send the CPU load on CAN.
+ * 
+ * The load of the last second and the peak since the start are read from the scheduler and written
+ * in the ResponseQueue as a SERIAL_MSG_LOAD event, most significant byte first, the serial task sends
+ * them on its next period, then the timer is restarted.
+*/
+void SerialLoad_Callback( void )
+{
+    uint8_t Status = FALSE;
+    APP_CanTypeDef SerialMsg = {0};
+    unsigned short peak = 0u;
+    unsigned short load = AppSched_cpuLoad( &Scheduler, &peak );
+
+    SerialMsg.bytes[ PARAMETER_1 ] = (uint8_t) ( load >> 8u );
+    SerialMsg.bytes[ PARAMETER_2 ] = (uint8_t) load;
+    SerialMsg.bytes[ PARAMETER_3 ] = (uint8_t) ( peak >> 8u );
+    SerialMsg.bytes[ PARAMETER_4 ] = (uint8_t) peak;
+    SerialMsg.bytes[ MSG ] = SERIAL_MSG_LOAD;
+
+    if( HIL_QUEUE_writeDataISR( &ResponseQueue, &SerialMsg ) == FALSE )
+    {
+        SerialStats.TxDropped++;        /*the load is sent again in a second*/
+    }
+
+    Status = AppSched_startTimer( &Scheduler, LoadTimerID ); /*Restart the timer */
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+}
+
+/**
+ * @brief   Timer callback when a consecutive frame of the CONFIG transfer is late (N_Cr).
+ * 
+ * The transfer received is discarded and an ERROR response is sent.
+*/
+void SerialTpRx_Callback( void )
+{
+    const uint8_t response[ N_BYTES_RESPONSE ] = { ERROR_RESPONSE };
+
+    if( TpRx.state == TP_RECEIVING )
+    {
+        TpRx.state = TP_IDLE;
+        Serial_TpSend( response, N_BYTES_RESPONSE );
+    }
+}
+
+/**
+ * @brief   Timer callback of the transfer sent.
+ * 
+ * While a block is sent the timer paces the consecutive frames, each expiration sends the next one,
+ * while a flow control is awaited the expiration means it's late (N_Bs) and the transfer is aborted.
+*/
+void SerialTpTx_Callback( void )
+{
+    if( TpTx.state == TP_SENDING )
+    {
+        Serial_TpConsecutive( );
+    }
+    else
+    {
+        TpTx.state = TP_IDLE;
+    }
 }
 
 /**
  * @brief Callback function called by FDCAN interrupt.
  * 
- * In this function is the code to read the message from the FIFO0 and check if its a valid CAN_TP
- * single frame to copy the bytes of the message and the identifier in the queue buffer
+ * All the frames in the FIFO0 are read in a single interrupt with Serial_RxDrain, so a burst of
+ * frames costs one entry to the interrupt instead of one per frame.
  * 
  * @param   hfdcan [in] is the FDCAN init structure.
  * @param   TxEventFifoITs [in] is the interrupt by which the function is called.
@@ -188,40 +429,95 @@ void HAL_FDCAN_RxFifo0Callback( FDCAN_HandleTypeDef *hfdcan, uint32_t TxEventFif
 {
     (void) TxEventFifoITs;
 
+    Serial_RxDrain( hfdcan );
+}
+
+/**
+ * @brief Function to move the frames of the FIFO0 to the queue.
+ * 
+ * The frames are read while the fill level of the FIFO0 is not zero, up to its SERIAL_RX_FIFO_N
+ * elements, each one directly from the message RAM to a block of the pool, that is the only copy of
+ * the frame. The message type comes from the index of the filter that accepted the frame, one per ID,
+ * and it's written in the event of the block, so the parameters stay where they were received
+ * starting at SERIAL_RX_PAYLOAD. The addresses of the blocks are written in the queue with a single
+ * batch write, and the blocks of the frames discarded or not written are freed here. The frames of
+ * the CONFIG ID are written as they are with the SERIAL_MSG_CONFIG event, the serial task
+ * reassembles the ISO-TP transfer. When the pool is empty or the queue is full the frames are
+ * dropped and counted in SerialStats.RxDropped, the serial task answers them with a BUSY response.
+ * 
+ * @param   hfdcan [in] is the FDCAN init structure.
+*/
+STATIC void Serial_RxDrain( FDCAN_HandleTypeDef *hfdcan )
+{
     HAL_StatusTypeDef Status = HAL_ERROR;
+    unsigned long Written = 0u;
+    unsigned long nFrames = 0u;
+    unsigned long nRead = 0u;
 
-    APP_CanTypeDef MsgCAN;
     /*structure CAN Rx Header*/
     FDCAN_RxHeaderTypeDef CANRxHeader;
-    
-    /*get the msg from fifo0*/
-    Status = HAL_FDCAN_GetRxMessage( hfdcan, FDCAN_RX_FIFO0, &CANRxHeader, MsgCAN.bytes );
-    assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
 
-    /*evaluate if its a valid CAN-TP single frame*/
-    if ( Serial_SingleFrameRx( MsgCAN.bytes, &MsgCAN.lenght ) == TRUE )     
+    /*bytes of a frame dropped with the pool empty*/
+    uint8_t Dropped[ N_BYTES_CAN_MSG ];
+
+    /*blocks of the pool with the frames to write in the queue*/
+    APP_CanTypeDef *Frames[ SERIAL_RX_FIFO_N ];
+
+    /*message type of the frames accepted by each filter, the CONFIG frames are not single frames*/
+    static const uint8_t RxEvents[ FILTERS_N ] = { SERIAL_MSG_TIME, SERIAL_MSG_DATE, SERIAL_MSG_ALARM, SERIAL_MSG_CONFIG };
+
+    while( ( nRead < SERIAL_RX_FIFO_N ) && ( HAL_FDCAN_GetRxFifoFillLevel( hfdcan, FDCAN_RX_FIFO0 ) > 0u ) )
     {
-        MsgCAN.id = CANRxHeader.Identifier;                   /*get msg ID*/
-        switch( MsgCAN.id )
+        /*block of the pool where the msg is read*/
+        APP_CanTypeDef *MsgCAN = (APP_CanTypeDef *) AppPool_alloc( &MessagesPool );
+        nRead++;
+
+        if( MsgCAN == NULL )
         {
-            case ID_TIME_MSG:
-                MsgCAN.bytes[MSG] = SERIAL_MSG_TIME;
-                break;
-            
-            case ID_DATE_MSG:
-                MsgCAN.bytes[MSG] = SERIAL_MSG_DATE;
-                break;
-            
-            case ID_ALARM_MSG:
-                MsgCAN.bytes[MSG] = SERIAL_MSG_ALARM;
-                break;
-            
-            default:
-                break;
+            /*the frame is taken out of the FIFO0 anyway, and reported in the next BUSY response*/
+            Status = HAL_FDCAN_GetRxMessage( hfdcan, FDCAN_RX_FIFO0, &CANRxHeader, Dropped );
+            assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
+            SerialStats.RxDropped++;
         }
+        else
+        {
+            /*get the msg from fifo0*/
+            Status = HAL_FDCAN_GetRxMessage( hfdcan, FDCAN_RX_FIFO0, &CANRxHeader, MsgCAN->bytes );
+            assert_error( Status == HAL_OK, FDCAN_RET_ERROR );
+
+            MsgCAN->id = CANRxHeader.Identifier;                          /*get msg ID*/
+            MsgCAN->event = ( CANRxHeader.FilterIndex < FILTERS_N ) ? RxEvents[ CANRxHeader.FilterIndex ] : (uint8_t) SERIAL_MSG_NONE;
+
+            if( MsgCAN->event == (uint8_t) SERIAL_MSG_CONFIG )
+            {
+                MsgCAN->lenght = N_BYTES_CAN_MSG;
+
+                Frames[ nFrames ] = MsgCAN;
+                nFrames++;
+            }
+            /*evaluate if its a valid CAN-TP single frame of one of the filters*/
+            else if( ( MsgCAN->event != (uint8_t) SERIAL_MSG_NONE ) &&
+                     ( Serial_SingleFrameRx( MsgCAN->bytes, &MsgCAN->lenght ) == TRUE ) )
+            {
+                Frames[ nFrames ] = MsgCAN;
+                nFrames++;
+            }
+            else
+            {
+                (void) AppPool_free( &MessagesPool, MsgCAN );      /*the msg is discarded*/
+            }
+        }
+    }
 
-        Status = HIL_QUEUE_writeDataISR( &queue, &MsgCAN );     /*add msg to queue*/
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+    if( nFrames > 0u )
+    {
+        Written = HIL_QUEUE_writeBatchISR( &queue, Frames, nFrames );   /*add the msgs addresses to queue*/
+
+        for( unsigned long i = Written; i < nFrames; i++ )
+        {
+            (void) AppPool_free( &MessagesPool, Frames[ i ] );     /*the msg is dropped with the queue full*/
+            SerialStats.RxDropped++;
+        }
     }
 }
 
@@ -255,32 +551,27 @@ STATIC void Serial_SingleFrameTx( uint8_t *data, uint8_t size )
 }
 
 /**
- * @brief Function to unpack a msg in the CAN-TP single frame format.
+ * @brief Function to check a msg in the CAN-TP single frame format.
  * 
  * The function will receive an array of 8 bytes of data with CAN-TP format where the first
  * byte indicate if it was a single frame and the number of valid bytes received. Function
- * must validate if it was a valid single frame and after that remove the first byte and
- * return TRUE.
+ * must validate if it was a valid single frame and return TRUE, the payload is not moved, it
+ * starts at SERIAL_RX_PAYLOAD.
  * 
- * @param   data [out] the bytes that contain the msg.
+ * @param   data [in] the bytes that contain the msg.
  * @param   size [out] the number of payload bytes.
  * 
  * @retval return TRUE if the msg has the CAN-TP single frame format.
  * 
 */
-STATIC uint8_t Serial_SingleFrameRx( uint8_t *data, uint8_t *size)
+STATIC uint8_t Serial_SingleFrameRx( const uint8_t *data, uint8_t *size)
 {
     uint8_t varRet = FALSE;
     *size = data[0] & LS_NIBBLE_MASK;
 
-    if ( ( (data[0] & MS_NIBBLE_MASK) == 0u ) && (*size > 0u) && (*size < N_BYTES_CAN_MSG) )  /*check if its a valid CAN-TP single frame*/
+    if ( ( (data[0] & MS_NIBBLE_MASK) == TP_SINGLE_FRAME ) && (*size > 0u) && (*size < N_BYTES_CAN_MSG) )  /*check if its a valid CAN-TP single frame*/
     {
         varRet = TRUE;                           /*if it is, return TRUE*/
-        for (uint8_t i = 0u; i < *size; i++)     /*and remove the first byte of data*/
-        {
-            data[ i ] = data[ i + 1u ];
-        }
-        
     }
     
     return varRet;
@@ -289,9 +580,9 @@ STATIC uint8_t Serial_SingleFrameRx( uint8_t *data, uint8_t *size)
 /**
  * @brief   Function to evaluate the time parameters of a message.
  * 
- * This function receive the memmory address of a read message and uses the MACRO BCD_TO_BIN
- * to convert the message parameter and then evaluate if are valid, in true case save the time
- * in the tm_msg struct and change the type of msg to SERIAL_MSG_OK. 
+ * This function receive the memmory address of a read message and evaluates its parameters with
+ * Serial_TimeItem, which writes the time in the ClockQueue when they are valid, then the OK or ERROR
+ * event is written in the ResponseQueue.
  * 
  * @param   SerialMsgPtr [in] is the message with time parameters.
  * 
@@ -299,43 +590,25 @@ STATIC uint8_t Serial_SingleFrameRx( uint8_t *data, uint8_t *size)
 */
 STATIC APP_Messages Evaluate_Time_Parameters( APP_CanTypeDef *SerialMsgPtr )
 {   
-    uint8_t Status = FALSE;
-    APP_MsgTypeDef ClkMsg;
     APP_CanTypeDef SerialMsg;
-    APP_Messages eventRet = SERIAL_MSG_ERROR;
+    APP_Messages eventRet = Serial_TimeItem( &SerialMsgPtr->bytes[ SERIAL_RX_PAYLOAD ], TRUE );
 
-    SerialMsg.bytes[MSG] = SERIAL_MSG_ERROR;
+    SerialMsg.bytes[MSG] = (uint8_t) eventRet;
 
-    uint8_t hour    = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_1 ] );     /*time parameter 1*/
-    uint8_t minutes = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_2 ] );     /*time parameter 2*/
-    uint8_t seconds = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_3 ] );     /*time parameter 3*/
-    
-    if ( Validate_Time( hour, minutes, seconds ) == TRUE )
+    if( HIL_QUEUE_writeDataISR( &ResponseQueue, &SerialMsg ) == FALSE )
     {
-        eventRet = SERIAL_MSG_OK;
-        SerialMsg.bytes[MSG] = SERIAL_MSG_OK;
-        
-        ClkMsg.msg        = CLOCK_MSG_TIME;
-        ClkMsg.tm.tm_hour = hour;
-        ClkMsg.tm.tm_min  = minutes;
-        ClkMsg.tm.tm_sec  = seconds;
-
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &ClkMsg );
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+        SerialStats.RespDropped++;      /*reported in the next BUSY response*/
     }
 
-    Status = HIL_QUEUE_writeDataISR( &queue, &SerialMsg );
-    assert_error( Status == TRUE, QUEUE_RET_ERROR );
-
     return eventRet;
 }
 
 /**
  * @brief   Function to evaluate the date parameters of a message.
  * 
- * This function receive the memmory address of a read message and uses the MACRO BCD_TO_BIN
- * to convert the message parameter and then evaluate if are valid, in true case save the time
- * in the ClkMsg struct and change the type of msg to SERIAL_MSG_OK.  
+ * This function receive the memmory address of a read message and evaluates its parameters with
+ * Serial_DateItem, which writes the date in the ClockQueue when they are valid, then the OK or ERROR
+ * event is written in the ResponseQueue.
  * 
  * @param   SerialMsgPtr [in] is the message with date parameters.
  * 
@@ -343,45 +616,25 @@ STATIC APP_Messages Evaluate_Time_Parameters( APP_CanTypeDef *SerialMsgPtr )
 */
 STATIC APP_Messages Evaluate_Date_Parameters( APP_CanTypeDef *SerialMsgPtr )
 {
-    uint8_t Status = FALSE;
-    APP_MsgTypeDef ClkMsg;
     APP_CanTypeDef SerialMsg;
-    APP_Messages eventRet = SERIAL_MSG_ERROR;
+    APP_Messages eventRet = Serial_DateItem( &SerialMsgPtr->bytes[ SERIAL_RX_PAYLOAD ], TRUE );
 
-    SerialMsg.bytes[MSG] = SERIAL_MSG_ERROR;
+    SerialMsg.bytes[MSG] = (uint8_t) eventRet;
 
-    uint8_t day   = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_1 ] );           /*date parameter 1*/
-    uint8_t month = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_2 ] );           /*date parameter 2*/
-    uint16_t year = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_3 ] ) * 100u;     /*param 3 * 100 to get two most significant figures of the year */
-    year += BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_4 ] );                   /*add param 4 */
-    
-    if( Validate_Date( day, month, year ) == TRUE )
+    if( HIL_QUEUE_writeDataISR( &ResponseQueue, &SerialMsg ) == FALSE )
     {
-        eventRet = SERIAL_MSG_OK;
-        SerialMsg.bytes[MSG] = SERIAL_MSG_OK;
-
-        ClkMsg.msg        = CLOCK_MSG_DATE;
-        ClkMsg.tm.tm_mday = day;
-        ClkMsg.tm.tm_mon  = month;
-        ClkMsg.tm.tm_year = year;
-        ClkMsg.tm.tm_wday = WeekDay( day, month, year );
-
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &ClkMsg );
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+        SerialStats.RespDropped++;      /*reported in the next BUSY response*/
     }
 
-    Status = HIL_QUEUE_writeDataISR( &queue, &SerialMsg );
-    assert_error( Status == TRUE, QUEUE_RET_ERROR );
-
     return eventRet;
 }
 
 /**
  * @brief   Function to evaluate the alarm parameters of a message.
  * 
- * This function receive the memmory address of a read message and uses the MACRO BCD_TO_BIN
- * to convert the message parameters and then evaluate if are valid, in true case save the time
- * in the ClkMsg struct and change the type of msg to SERIAL_MSG_OK.  
+ * This function receive the memmory address of a read message and evaluates its parameters with
+ * Serial_AlarmItem, which writes the alarm in the ClockQueue when they are valid, then the OK or
+ * ERROR event is written in the ResponseQueue.
  * 
  * @param   SerialMsgPtr [in] is the message with alarm parameters.
  * 
@@ -389,31 +642,158 @@ STATIC APP_Messages Evaluate_Date_Parameters( APP_CanTypeDef *SerialMsgPtr )
 */
 STATIC APP_Messages Evaluate_Alarm_Parameters( APP_CanTypeDef *SerialMsgPtr )
 {
-    uint8_t Status = FALSE;
-    APP_MsgTypeDef ClkMsg;
     APP_CanTypeDef SerialMsg;
-    APP_Messages eventRet = SERIAL_MSG_ERROR;
+    APP_Messages eventRet = Serial_AlarmItem( &SerialMsgPtr->bytes[ SERIAL_RX_PAYLOAD ], TRUE );
+
+    SerialMsg.bytes[MSG] = (uint8_t) eventRet;
 
-    SerialMsg.bytes[MSG] = SERIAL_MSG_ERROR;
+    if( HIL_QUEUE_writeDataISR( &ResponseQueue, &SerialMsg ) == FALSE )
+    {
+        SerialStats.RespDropped++;      /*reported in the next BUSY response*/
+    }
 
-    uint8_t hour    = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_1 ] );     /*Alarm parameter 1*/
-    uint8_t minutes = BCD_TO_BIN( SerialMsgPtr->bytes[ PARAMETER_2 ] );     /*Alarm parameter 2*/
+    return eventRet;
+}
 
-    if ( Validate_Time( hour, minutes, VALID_SECONDS_PARAM ) == TRUE )
+/**
+ * @brief   Function to process a frame of the CONFIG ID.
+ * 
+ * The frame is passed as it is to Serial_TpReceive, which reassembles the ISO-TP transfer and
+ * writes the responses.
+ * 
+ * @param   SerialMsgPtr [in] is the message with the ISO-TP frame.
+ * 
+ * @retval  Return SERIAL_MSG_NONE, the response is written when the transfer is complete.
+*/
+STATIC APP_Messages Evaluate_Config_Frame( APP_CanTypeDef *SerialMsgPtr )
+{
+    Serial_TpReceive( SerialMsgPtr->bytes );
+
+    return SERIAL_MSG_NONE;
+}
+
+/**
+ * @brief   Function to check the time parameters of a setting.
+ * 
+ * The parameters are converted with the MACRO BCD_TO_BIN and evaluated, when they are valid and
+ * apply is TRUE the time is written in the ClockQueue.
+ * 
+ * @param   params [in] Hour, minutes and seconds in BCD format.
+ * @param   apply [in] TRUE to write the time in the ClockQueue, FALSE to only check it.
+ * 
+ * @retval  SERIAL_MSG_OK when the parameters are valid, SERIAL_MSG_ERROR when not or when the
+ *          ClockQueue is full and the setting can not be applied.
+*/
+STATIC APP_Messages Serial_TimeItem( const uint8_t *params, uint8_t apply )
+{
+    APP_MsgTypeDef ClkMsg;
+    APP_Messages eventRet = SERIAL_MSG_ERROR;
+
+    uint8_t hour    = BCD_TO_BIN( params[ PARAMETER_1 ] );     /*time parameter 1*/
+    uint8_t minutes = BCD_TO_BIN( params[ PARAMETER_2 ] );     /*time parameter 2*/
+    uint8_t seconds = BCD_TO_BIN( params[ PARAMETER_3 ] );     /*time parameter 3*/
+    
+    if ( Validate_Time( hour, minutes, seconds ) == TRUE )
     {
         eventRet = SERIAL_MSG_OK;
-        SerialMsg.bytes[MSG] = SERIAL_MSG_OK;
 
-        ClkMsg.msg = CLOCK_MSG_ALARM;
-        ClkMsg.tm.tm_hour = hour;
-        ClkMsg.tm.tm_min  = minutes;
+        if( apply == TRUE )
+        {
+            ClkMsg.msg        = CLOCK_MSG_TIME;
+            ClkMsg.tm.tm_hour = hour;
+            ClkMsg.tm.tm_min  = minutes;
+            ClkMsg.tm.tm_sec  = seconds;
+
+            if( HIL_QUEUE_writePrioISR( &ClockQueue, &ClkMsg ) == FALSE )
+            {
+                eventRet = SERIAL_MSG_ERROR;    /*CONFIG lane full, the setting is not applied*/
+            }
+        }
+    }
+
+    return eventRet;
+}
 
-        Status = HIL_QUEUE_writeDataISR( &ClockQueue, &ClkMsg );
-        assert_error( Status == TRUE, QUEUE_RET_ERROR );
+/**
+ * @brief   Function to check the date parameters of a setting.
+ * 
+ * The parameters are converted with the MACRO BCD_TO_BIN and evaluated, when they are valid and
+ * apply is TRUE the date and its week day are written in the ClockQueue.
+ * 
+ * @param   params [in] Day, month and the two halves of the year in BCD format.
+ * @param   apply [in] TRUE to write the date in the ClockQueue, FALSE to only check it.
+ * 
+ * @retval  SERIAL_MSG_OK when the parameters are valid, SERIAL_MSG_ERROR when not or when the
+ *          ClockQueue is full and the setting can not be applied.
+*/
+STATIC APP_Messages Serial_DateItem( const uint8_t *params, uint8_t apply )
+{
+    APP_MsgTypeDef ClkMsg;
+    APP_Messages eventRet = SERIAL_MSG_ERROR;
+
+    uint8_t day   = BCD_TO_BIN( params[ PARAMETER_1 ] );           /*date parameter 1*/
+    uint8_t month = BCD_TO_BIN( params[ PARAMETER_2 ] );           /*date parameter 2*/
+    uint16_t year = BCD_TO_BIN( params[ PARAMETER_3 ] ) * 100u;     /*param 3 * 100 to get two most significant figures of the year */
+    year += BCD_TO_BIN( params[ PARAMETER_4 ] );                   /*add param 4 */
+    
+    if( Validate_Date( day, month, year ) == TRUE )
+    {
+        eventRet = SERIAL_MSG_OK;
+
+        if( apply == TRUE )
+        {
+            ClkMsg.msg        = CLOCK_MSG_DATE;
+            ClkMsg.tm.tm_mday = day;
+            ClkMsg.tm.tm_mon  = month;
+            ClkMsg.tm.tm_year = year;
+            ClkMsg.tm.tm_wday = WeekDay( day, month, year );
+
+            if( HIL_QUEUE_writePrioISR( &ClockQueue, &ClkMsg ) == FALSE )
+            {
+                eventRet = SERIAL_MSG_ERROR;    /*CONFIG lane full, the setting is not applied*/
+            }
+        }
     }
 
-    Status = HIL_QUEUE_writeDataISR( &queue, &SerialMsg );
-    assert_error( Status == TRUE, QUEUE_RET_ERROR );
+    return eventRet;
+}
+
+/**
+ * @brief   Function to check the alarm parameters of a setting.
+ * 
+ * The parameters are converted with the MACRO BCD_TO_BIN and evaluated, when they are valid and
+ * apply is TRUE the alarm is written in the ClockQueue.
+ * 
+ * @param   params [in] Hour and minutes in BCD format.
+ * @param   apply [in] TRUE to write the alarm in the ClockQueue, FALSE to only check it.
+ * 
+ * @retval  SERIAL_MSG_OK when the parameters are valid, SERIAL_MSG_ERROR when not or when the
+ *          ClockQueue is full and the setting can not be applied.
+*/
+STATIC APP_Messages Serial_AlarmItem( const uint8_t *params, uint8_t apply )
+{
+    APP_MsgTypeDef ClkMsg;
+    APP_Messages eventRet = SERIAL_MSG_ERROR;
+
+    uint8_t hour    = BCD_TO_BIN( params[ PARAMETER_1 ] );     /*Alarm parameter 1*/
+    uint8_t minutes = BCD_TO_BIN( params[ PARAMETER_2 ] );     /*Alarm parameter 2*/
+
+    if ( Validate_Time( hour, minutes, VALID_SECONDS_PARAM ) == TRUE )
+    {
+        eventRet = SERIAL_MSG_OK;
+
+        if( apply == TRUE )
+        {
+            ClkMsg.msg = CLOCK_MSG_ALARM;
+            ClkMsg.tm.tm_hour = hour;
+            ClkMsg.tm.tm_min  = minutes;
+
+            if( HIL_QUEUE_writePrioISR( &ClockQueue, &ClkMsg ) == FALSE )
+            {
+                eventRet = SERIAL_MSG_ERROR;    /*CONFIG lane full, the setting is not applied*/
+            }
+        }
+    }
 
     return eventRet;
 }
@@ -431,7 +811,6 @@ STATIC APP_Messages Evaluate_Alarm_Parameters( APP_CanTypeDef *SerialMsgPtr )
 */
 STATIC APP_Messages Send_Ok_Message( APP_CanTypeDef *SerialMsgPtr )
 {
-    HAL_StatusTypeDef Status = HAL_ERROR;
     APP_Messages eventRet = SERIAL_MSG_NONE;
     
     (void) SerialMsgPtr;
@@ -440,8 +819,7 @@ STATIC APP_Messages Send_Ok_Message( APP_CanTypeDef *SerialMsgPtr )
 
     Serial_SingleFrameTx( data, N_BYTES_RESPONSE );
 
-    Status = HAL_FDCAN_AddMessageToTxFifoQ( &CANHandler, &CANTxHeader, data );
-    assert_error( Status != HAL_ERROR, FDCAN_RET_ERROR );
+    (void) Serial_Transmit( &CANTxHeader, data );
 
     return eventRet;
 }
@@ -459,7 +837,6 @@ STATIC APP_Messages Send_Ok_Message( APP_CanTypeDef *SerialMsgPtr )
 */
 STATIC APP_Messages Send_Error_Message( APP_CanTypeDef *SerialMsgPtr )
 { 
-    HAL_StatusTypeDef Status = HAL_ERROR;
     APP_Messages eventRet = SERIAL_MSG_NONE;
 
     (void) SerialMsgPtr;
@@ -468,13 +845,521 @@ STATIC APP_Messages Send_Error_Message( APP_CanTypeDef *SerialMsgPtr )
 
     Serial_SingleFrameTx( data, N_BYTES_RESPONSE );
 
-    Status = HAL_FDCAN_AddMessageToTxFifoQ( &CANHandler, &CANTxHeader, data );
-    assert_error( Status != HAL_ERROR, FDCAN_RET_ERROR );
+    (void) Serial_Transmit( &CANTxHeader, data );
+
+    return eventRet;
+}
+
+/**
+ * @brief   Function to send a "LOAD" message.
+ * 
+ * This function copies the CPU load and peak written by SerialLoad_Callback, two bytes each in 0.01 %
+ * units, and uses the Serial_SingleFrameTx to pack them in the CAN-TP format, this msg is sent with
+ * the LOAD_ID (0x123).
+ * 
+ * @param   SerialMsgPtr [in] the message with the load and peak bytes.
+ * 
+ * @retval  Return the event type that was writed in the queue (None).
+*/
+STATIC APP_Messages Send_Load_Message( APP_CanTypeDef *SerialMsgPtr )
+{
+    APP_Messages eventRet = SERIAL_MSG_NONE;
+    FDCAN_TxHeaderTypeDef LoadTxHeader = CANTxHeader;
+
+    uint8_t data[ N_BYTES_CAN_MSG ] = {0};
+
+    for ( uint8_t i = 0; i < N_BYTES_LOAD; i++ )
+    {
+        data[ i ] = SerialMsgPtr->bytes[ i ];
+    }
+
+    Serial_SingleFrameTx( data, N_BYTES_LOAD );
+
+    LoadTxHeader.Identifier = LOAD_ID;
+    (void) Serial_Transmit( &LoadTxHeader, data );
 
     return eventRet;
 }
 
 
+/**
+ * @brief   Function to check or apply the items of a CONFIG transfer.
+ * 
+ * Each item is the type of the setting, SERIAL_MSG_TIME, SERIAL_MSG_DATE or SERIAL_MSG_ALARM,
+ * followed by the same parameters of its single message. The status of each item is written in
+ * status, an item with an unknown type or cut by the end of the payload is an error and the rest
+ * of the payload is not read.
+ * 
+ * @param   payload [in] Payload of the transfer.
+ * @param   length [in] Bytes of the payload.
+ * @param   apply [in] TRUE to write the settings in the ClockQueue, FALSE to only check them.
+ * @param   status [out] OK_RESPONSE or ERROR_RESPONSE of each item.
+ * @param   items [out] Number of items read.
+ * 
+ * @retval  SERIAL_MSG_OK when all the items are valid, SERIAL_MSG_ERROR when not or there is none.
+*/
+STATIC APP_Messages Serial_ConfigItems( const uint8_t *payload, uint16_t length, uint8_t apply, uint8_t *status, uint8_t *items )
+{
+    APP_Messages (*const ConfigItem[ TP_ITEM_TYPES ]) ( const uint8_t *params, uint8_t apply ) =
+    {
+        Serial_TimeItem,
+        Serial_DateItem,
+        Serial_AlarmItem
+    };
+    static const uint8_t ItemParams[ TP_ITEM_TYPES ] = { TP_TIME_PARAMS, TP_DATE_PARAMS, TP_ALARM_PARAMS };
+
+    APP_Messages eventRet = ( length > 0u ) ? SERIAL_MSG_OK : SERIAL_MSG_ERROR;
+    uint8_t malformed = FALSE;
+    uint16_t i = 0u;
+    uint8_t n = 0u;
+
+    while( ( i < length ) && ( malformed == FALSE ) )
+    {
+        uint8_t type = payload[ i ];
+
+        if( ( type < TP_ITEM_TYPES ) && ( ( i + 1u + ItemParams[ type ] ) <= length ) )
+        {
+            status[ n ] = OK_RESPONSE;
+
+            if( ConfigItem[ type ]( &payload[ i + 1u ], apply ) != SERIAL_MSG_OK )
+            {
+                status[ n ] = ERROR_RESPONSE;
+                eventRet = SERIAL_MSG_ERROR;
+            }
+
+            i += 1u + ItemParams[ type ];
+        }
+        else
+        {
+            status[ n ] = ERROR_RESPONSE;
+            eventRet = SERIAL_MSG_ERROR;
+            malformed = TRUE;
+        }
+
+        n++;
+    }
+
+    *items = n;
+
+    return eventRet;
+}
+
+/**
+ * @brief   Function to evaluate the payload of a CONFIG transfer.
+ * 
+ * The items are checked first and only when all of them are valid and the settings lane of the
+ * ClockQueue has space for all of them are written, so a transfer is applied whole or not at all.
+ * A transfer that doesn't fit in the lane is answered with ERROR in the transfer and in each item.
+ * The response is the OK or ERROR of the transfer followed by the status of each item.
+ * 
+ * @param   payload [in] Payload of the transfer.
+ * @param   length [in] Bytes of the payload.
+*/
+STATIC void Evaluate_Config_Parameters( const uint8_t *payload, uint16_t length )
+{
+    uint8_t response[ SERIAL_TP_SIZE ] = {0};
+    uint8_t items = 0u;
+    APP_MsgTypeDef ClkMsg;
+
+    APP_Messages eventRet = Serial_ConfigItems( payload, length, FALSE, &response[ 1 ], &items );
+
+    ClkMsg.msg = CLOCK_MSG_TIME;    /*the time, date and alarm share the settings lane*/
+
+    if( ( eventRet == SERIAL_MSG_OK ) && ( HIL_QUEUE_freePrioISR( &ClockQueue, &ClkMsg ) < items ) )
+    {
+        eventRet = SERIAL_MSG_ERROR;
+
+        for( uint8_t i = 0u; i < items; i++ )
+        {
+            response[ i + 1u ] = ERROR_RESPONSE;
+        }
+    }
+
+    if( eventRet == SERIAL_MSG_OK )
+    {
+        (void) Serial_ConfigItems( payload, length, TRUE, &response[ 1 ], &items );
+    }
+
+    response[ PARAMETER_1 ] = ( eventRet == SERIAL_MSG_OK ) ? OK_RESPONSE : ERROR_RESPONSE;
+
+    Serial_TpSend( response, (uint16_t) items + 1u );
+}
+
+/**
+ * @brief   Function to process an ISO-TP frame received on the CONFIG ID.
+ * 
+ * A single frame is evaluated at once. A first frame starts the reassembly, it replaces a transfer
+ * in progress, and it's answered with a flow control, OVERFLOW when the transfer doesn't fit in
+ * SERIAL_TP_SIZE. The consecutive frames are copied while its sequence number is the expected one,
+ * a flow control is sent after each block and the RX timer is restarted with each frame, a wrong
+ * sequence number aborts the transfer with an ERROR response. The flow controls are the answers of
+ * the tester to the response sent, they are ignored when no one is awaited.
+ * 
+ * @param   frame [in] The 8 bytes of the frame, the first one is the PCI.
+*/
+STATIC void Serial_TpReceive( const uint8_t *frame )
+{
+    const uint8_t response[ N_BYTES_RESPONSE ] = { ERROR_RESPONSE };
+    uint8_t Status = FALSE;
+    uint16_t length = 0u;
+
+    switch( frame[ 0 ] & MS_NIBBLE_MASK )
+    {
+        case TP_SINGLE_FRAME:
+            length = frame[ 0 ] & LS_NIBBLE_MASK;
+
+            if( ( length > 0u ) && ( length < N_BYTES_CAN_MSG ) )
+            {
+                Evaluate_Config_Parameters( &frame[ 1 ], length );
+            }
+            break;
+
+        case TP_FIRST_FRAME:
+            length = ( (uint16_t) ( frame[ 0 ] & LS_NIBBLE_MASK ) << 8u ) | frame[ 1 ];
+
+            if( length > SERIAL_TP_SIZE )
+            {
+                Serial_TpFlowControl( TP_FC_OVERFLOW );
+            }
+            else if( length >= N_BYTES_CAN_MSG )    /*a shorter one must be a single frame*/
+            {
+                for( uint8_t i = 0u; i < TP_FF_BYTES; i++ )
+                {
+                    TpRx.buffer[ i ] = frame[ i + 2u ];
+                }
+
+                TpRx.state     = TP_RECEIVING;
+                TpRx.length    = length;
+                TpRx.index     = TP_FF_BYTES;
+                TpRx.sequence  = 1u;
+                TpRx.blockLeft = SERIAL_TP_BLOCK_SIZE;
+
+                Serial_TpFlowControl( TP_FC_CTS );
+
+                Status = AppSched_startTimer( &Scheduler, TpRxTimerID );
+                assert_error( Status == TRUE, SCHE_RET_ERROR );
+            }
+            else
+            {
+                /*not a valid first frame, ignored*/
+            }
+            break;
+
+        case TP_CONSECUTIVE_FRAME:
+            if( TpRx.state != TP_RECEIVING )
+            {
+                /*no transfer in progress, ignored*/
+            }
+            else if( ( frame[ 0 ] & LS_NIBBLE_MASK ) != TpRx.sequence )
+            {
+                TpRx.state = TP_IDLE;
+
+                Status = AppSched_stopTimer( &Scheduler, TpRxTimerID );
+                assert_error( Status == TRUE, SCHE_RET_ERROR );
+
+                Serial_TpSend( response, N_BYTES_RESPONSE );
+            }
+            else
+            {
+                length = TpRx.length - TpRx.index;
+                length = ( length > TP_CF_BYTES ) ? TP_CF_BYTES : length;
+
+                for( uint8_t i = 0u; i < length; i++ )
+                {
+                    TpRx.buffer[ TpRx.index + i ] = frame[ i + 1u ];
+                }
+
+                TpRx.index   += length;
+                TpRx.sequence = ( TpRx.sequence + 1u ) & LS_NIBBLE_MASK;
+
+                if( TpRx.index >= TpRx.length )
+                {
+                    TpRx.state = TP_IDLE;
+
+                    Status = AppSched_stopTimer( &Scheduler, TpRxTimerID );
+                    assert_error( Status == TRUE, SCHE_RET_ERROR );
+
+                    Evaluate_Config_Parameters( TpRx.buffer, TpRx.length );
+                }
+                else
+                {
+                    TpRx.blockLeft--;
+
+                    if( TpRx.blockLeft == 0u )      /*with a block size of zero it wraps, more than the frames of a transfer*/
+                    {
+                        TpRx.blockLeft = SERIAL_TP_BLOCK_SIZE;
+                        Serial_TpFlowControl( TP_FC_CTS );
+                    }
+
+                    Status = AppSched_startTimer( &Scheduler, TpRxTimerID );
+                    assert_error( Status == TRUE, SCHE_RET_ERROR );
+                }
+            }
+            break;
+
+        case TP_FLOW_CONTROL:
+            if( TpTx.state != TP_WAIT_FC )
+            {
+                /*no flow control awaited, ignored*/
+            }
+            else if( ( frame[ 0 ] & LS_NIBBLE_MASK ) == TP_FC_CTS )
+            {
+                TpTx.waits     = 0u;
+                TpTx.blockSize = frame[ 1 ];
+                TpTx.blockLeft = frame[ 1 ];
+                TpTx.stMin     = frame[ 2 ];
+
+                if( ( frame[ 2 ] >= TP_STMIN_US_MIN ) && ( frame[ 2 ] <= TP_STMIN_US_MAX ) )
+                {
+                    TpTx.stMin = 0u;
+                }
+                else if( frame[ 2 ] > TP_STMIN_MAX_MS )
+                {
+                    TpTx.stMin = TP_STMIN_MAX_MS;    /*reserved values, the longest time*/
+                }
+                else
+                {
+                    /*already in ms*/
+                }
+
+                TpTx.state     = TP_SENDING;
+
+                Serial_TpConsecutive( );
+            }
+            else if( ( ( frame[ 0 ] & LS_NIBBLE_MASK ) == TP_FC_WAIT ) && ( TpTx.waits < SERIAL_TP_WAIT_MAX ) )
+            {
+                TpTx.waits++;
+
+                Status = AppSched_reloadTimer( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS );
+                assert_error( Status == TRUE, SCHE_RET_ERROR );
+            }
+            else
+            {
+                TpTx.state = TP_IDLE;       /*overflow, too many waits or a reserved flow status*/
+
+                Status = AppSched_stopTimer( &Scheduler, TpTxTimerID );
+                assert_error( Status == TRUE, SCHE_RET_ERROR );
+            }
+            break;
+
+        default:
+            /*reserved PCI, ignored*/
+            break;
+    }
+}
+
+/**
+ * @brief   Function to send a payload on the RESPONSE ID with ISO-TP.
+ * 
+ * A payload up to 7 bytes is sent in a single frame, a longer one is copied in the TX channel and
+ * its first frame is sent, the rest is sent when the flow control of the tester arrives. A new
+ * payload replaces the one in progress.
+ * 
+ * @param   data [in] Payload to send.
+ * @param   length [in] Bytes of the payload, up to SERIAL_TP_SIZE.
+*/
+STATIC void Serial_TpSend( const uint8_t *data, uint16_t length )
+{
+    uint8_t Status = FALSE;
+    uint8_t frame[ N_BYTES_CAN_MSG ] = {0};
+
+    if( length < N_BYTES_CAN_MSG )
+    {
+        for( uint8_t i = 0u; i < length; i++ )
+        {
+            frame[ i ] = data[ i ];
+        }
+
+        Serial_SingleFrameTx( frame, (uint8_t) length );
+        Serial_TpFrame( frame );
+    }
+    else
+    {
+        for( uint16_t i = 0u; i < length; i++ )
+        {
+            TpTx.buffer[ i ] = data[ i ];
+        }
+
+        TpTx.state    = TP_WAIT_FC;
+        TpTx.length   = length;
+        TpTx.index    = TP_FF_BYTES;
+        TpTx.sequence = 1u;
+        TpTx.waits    = 0u;
+
+        frame[ 0 ] = TP_FIRST_FRAME | (uint8_t) ( length >> 8u );
+        frame[ 1 ] = (uint8_t) length;
+
+        for( uint8_t i = 0u; i < TP_FF_BYTES; i++ )
+        {
+            frame[ i + 2u ] = data[ i ];
+        }
+
+        Serial_TpFrame( frame );
+
+        Status = AppSched_reloadTimer( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS );
+        assert_error( Status == TRUE, SCHE_RET_ERROR );
+    }
+}
+
+/**
+ * @brief   Function to send the next consecutive frame of the TX channel.
+ * 
+ * After the last frame the channel is idle, after the last frame of a block the channel waits for
+ * the next flow control, and else the TX timer is set to send the next frame. Only one frame is sent
+ * per expiration, at least one tick apart, which keeps the transfer within the 3 messages of the
+ * FDCAN TX FIFO.
+*/
+STATIC void Serial_TpConsecutive( void )
+{
+    uint8_t Status = FALSE;
+    uint8_t frame[ N_BYTES_CAN_MSG ] = {0};
+    uint16_t length = TpTx.length - TpTx.index;
+
+    length = ( length > TP_CF_BYTES ) ? TP_CF_BYTES : length;
+    frame[ 0 ] = TP_CONSECUTIVE_FRAME | TpTx.sequence;
+
+    for( uint8_t i = 0u; i < length; i++ )
+    {
+        frame[ i + 1u ] = TpTx.buffer[ TpTx.index + i ];
+    }
+
+    TpTx.index   += length;
+    TpTx.sequence = ( TpTx.sequence + 1u ) & LS_NIBBLE_MASK;
+
+    Serial_TpFrame( frame );
+
+    if( TpTx.index >= TpTx.length )
+    {
+        TpTx.state = TP_IDLE;
+
+        Status = AppSched_stopTimer( &Scheduler, TpTxTimerID );
+    }
+    else if( ( TpTx.blockSize > 0u ) && ( TpTx.blockLeft == 1u ) )
+    {
+        TpTx.blockLeft = 0u;
+        TpTx.state = TP_WAIT_FC;
+
+        Status = AppSched_reloadTimer( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS );
+    }
+    else
+    {
+        TpTx.blockLeft--;       /*with a block size of zero it's never the end of a block*/
+
+        Status = AppSched_reloadTimer( &Scheduler, TpTxTimerID, Serial_TpTime( TpTx.stMin ) );
+    }
+
+    assert_error( Status == TRUE, SCHE_RET_ERROR );
+}
+
+/**
+ * @brief   Function to send a flow control for the transfer received.
+ * 
+ * The tester is asked for SERIAL_TP_BLOCK_SIZE frames separated SERIAL_TP_STMIN_MS at least.
+ * 
+ * @param   status [in] Flow status, TP_FC_CTS or TP_FC_OVERFLOW.
+*/
+STATIC void Serial_TpFlowControl( uint8_t status )
+{
+    uint8_t frame[ N_BYTES_CAN_MSG ] = {0};
+
+    frame[ 0 ] = TP_FLOW_CONTROL | status;
+    frame[ 1 ] = SERIAL_TP_BLOCK_SIZE;
+    frame[ 2 ] = SERIAL_TP_STMIN_MS;
+
+    Serial_TpFrame( frame );
+}
+
+/**
+ * @brief   Function to send an ISO-TP frame on the RESPONSE ID.
+ * 
+ * @param   frame [in] The 8 bytes of the frame.
+*/
+STATIC void Serial_TpFrame( const uint8_t *frame )
+{
+    uint8_t data[ N_BYTES_CAN_MSG ];
+
+    for( uint8_t i = 0u; i < N_BYTES_CAN_MSG; i++ )
+    {
+        data[ i ] = frame[ i ];
+    }
+
+    (void) Serial_Transmit( &CANTxHeader, data );   /*a frame lost ends in the timeout of the transfer*/
+}
+
+/**
+ * @brief   Function to add a frame to the TX FIFO.
+ * 
+ * With the TX FIFO full the frame is dropped and counted in SerialStats.TxDropped instead of going
+ * to safe_state, the serial task only sends as many responses as free elements has the FIFO.
+ * 
+ * @param   header [in] Header with the ID of the frame.
+ * @param   data [in] The 8 bytes of the frame.
+ * 
+ * @retval  TRUE when the frame is in the TX FIFO, FALSE when it was dropped.
+*/
+STATIC uint8_t Serial_Transmit( FDCAN_TxHeaderTypeDef *header, uint8_t *data )
+{
+    uint8_t varRet = TRUE;
+
+    if( HAL_FDCAN_AddMessageToTxFifoQ( &CANHandler, header, data ) != HAL_OK )
+    {
+        SerialStats.TxDropped++;
+        varRet = FALSE;
+    }
+
+    return varRet;
+}
+
+/**
+ * @brief   Function to send a BUSY response.
+ * 
+ * The parameter 2 of the response is the count, saturated to 255, packed in the CAN-TP format.
+ * 
+ * @param   id [in] RESPONSE_ID for the frames not answered, SERIAL_BUSY_ID for the BUSY status.
+ * @param   count [in] Frames not answered or frames read in the period.
+ * 
+ * @retval  TRUE when the response is in the TX FIFO.
+*/
+STATIC uint8_t Serial_SendBusy( uint16_t id, uint32_t count )
+{
+    uint8_t varRet = FALSE;
+    FDCAN_TxHeaderTypeDef BusyTxHeader = CANTxHeader;
+    uint8_t data[ N_BYTES_CAN_MSG ] = {0};
+
+    data[ PARAMETER_1 ] = BUSY_RESPONSE;
+    data[ PARAMETER_2 ] = ( count > UINT8_MAX ) ? UINT8_MAX : (uint8_t) count;
+
+    Serial_SingleFrameTx( data, N_BYTES_BUSY );
+
+    BusyTxHeader.Identifier = id;
+    varRet = Serial_Transmit( &BusyTxHeader, data );
+
+    if( varRet == TRUE )
+    {
+        SerialStats.BusySent++;
+    }
+
+    return varRet;
+}
+
+/**
+ * @brief   Function to get the time between the consecutive frames sent.
+ * 
+ * The STmin of the tester is rounded up to the tick, the timers of the scheduler only count ticks.
+ * 
+ * @param   stMin [in] STmin in ms.
+ * 
+ * @retval  Time in ms, a multiple of the tick and one tick at least.
+*/
+STATIC unsigned long Serial_TpTime( uint8_t stMin )
+{
+    unsigned long ticks = ( stMin + Scheduler.tick - 1u ) / Scheduler.tick;
+
+    ticks = ( ticks == 0u ) ? 1u : ticks;
+
+    return ticks * Scheduler.tick;
+}
+
 /**
  * @brief   Function to check if the year is leap or not.
  * 
@@ -6,23 +6,34 @@
 #ifndef SERIAL_H__
 #define SERIAL_H__
 
-#define FILTERS_N           0x03u       /*!< 3 filters are configured in FDCAN module*/
+#include "stdint.h"
+
+#define FILTERS_N           0x04u       /*!< 4 filters are configured in FDCAN module, one per ID*/
 #define ID_TIME_MSG         0x111u      /*!< TIME ID*/
 #define ID_DATE_MSG         0x127u      /*!< DATE ID*/
 #define ID_ALARM_MSG        0x101u      /*!< ALARM ID*/
+#define ID_CONFIG_MSG       0x131u      /*!< CONFIG ID, several settings in one ISO-TP transfer*/
 #define FILTER_MASK         0x7FFu      /*!< Mask to indicate how many bit take in acount to filter*/
 #define MESSAGES_N          20u       /*!< Number of messages that can be received in 10 ms*/
+#define SERIAL_RX_FIFO_N    0x03u       /*!< Elements of the FDCAN FIFO0, the frames read per interrupt at most*/
+#define SERIAL_BUSY_ID      0x124u      /*!< BUSY status ID, sent with SERIAL_BUSY_CAN while the serial task is busy*/
+#define SERIAL_BUSY_LEVEL   15u         /*!< Frames read in a period from which the serial task is busy*/
 #define VALID_SECONDS_PARAM 0x00u       /*!< A valid value for seconds*/
 #define RESPONSE_ID         0x122u      /*!< RESPONSE ID*/
 #define OK_RESPONSE         0x55u       /*!< Parameter 1 of OK response*/
 #define ERROR_RESPONSE      0xAAu       /*!< Parameter 1 of ERROR response*/
 #define N_BYTES_RESPONSE    0x01u       /*!< Number of payload bytes in a response*/
+#define BUSY_RESPONSE       0x5Au       /*!< Parameter 1 of BUSY response, parameter 2 is the number of frames not answered*/
+#define N_BYTES_BUSY        0x02u       /*!< Number of payload bytes in a BUSY response*/
+#define LOAD_ID             0x123u      /*!< CPU LOAD ID*/
+#define N_BYTES_LOAD        0x04u       /*!< Number of payload bytes in a CPU load msg, load and peak*/
 #define N_BYTES_CAN_MSG     0x08u       /*!< Number of data bytes in a standard CAN message*/
 #define PARAMETER_1         0x00u       /*!< Position in data of parameter 1*/
 #define PARAMETER_2         0x01u       /*!< Position in data of parameter 2*/
 #define PARAMETER_3         0x02u       /*!< Position in data of parameter 3*/
 #define PARAMETER_4         0x03u       /*!< Position in data of parameter 4*/
 #define MSG                 0x04u       /*!< Position of msg type*/
+#define SERIAL_RX_PAYLOAD   0x01u       /*!< Position of the first parameter in a frame received*/
 #define MONTHS              0x0Cu       /*!< Number of months in a year*/
 #define MONTH_31_D          0x1Fu       /*!< Number of days (31)*/
 #define MONTH_30_D          0X1Eu       /*!< Number of days (30)*/
@@ -34,8 +45,108 @@
 #define MS_NIBBLE_MASK      0xF0u       /*!< Mask to obtain most significant nibble of a byte*/
 #define LS_NIBBLE_MASK      0x0Fu       /*!< Mask to obtain low significant nibble of a byte*/
 
+/** 
+  * @defgroup RxFilters Index of the FDCAN filter of each ID, read from the header of a frame received
+  @{ */
+#define SERIAL_FILTER_TIME      0x00u   /*!< Filter of the TIME ID*/
+#define SERIAL_FILTER_DATE      0x01u   /*!< Filter of the DATE ID*/
+#define SERIAL_FILTER_ALARM     0x02u   /*!< Filter of the ALARM ID*/
+#define SERIAL_FILTER_CONFIG    0x03u   /*!< Filter of the CONFIG ID*/
+/**
+  @} */
+
+/** 
+  * @defgroup IsoTp Settings of the ISO-TP (ISO 15765-2) transfers on the CONFIG ID, the flow control
+  * sent to the tester asks for SERIAL_TP_BLOCK_SIZE frames each SERIAL_TP_STMIN_MS at least
+  @{ */
+#define SERIAL_TP_SIZE          48u     /*!< Max payload of a transfer, received or sent*/
+#define SERIAL_TP_BLOCK_SIZE    4u      /*!< Consecutive frames received between flow controls, zero for all of them*/
+#define SERIAL_TP_STMIN_MS      0u      /*!< Min time between the consecutive frames received, up to 127 ms*/
+#define SERIAL_TP_TIMEOUT_MS    1000u   /*!< Max wait for a consecutive frame or a flow control (N_Cr, N_Bs)*/
+#define SERIAL_TP_WAIT_MAX      8u      /*!< Max flow controls WAIT in a row before abort a transfer sent*/
+/**
+  @} */
+
+/** 
+  * @defgroup IsoTpFrames Protocol control information (PCI) of the ISO-TP frames
+  @{ */
+#define TP_SINGLE_FRAME         0x00u   /*!< Most significant nibble of a single frame*/
+#define TP_FIRST_FRAME          0x10u   /*!< Most significant nibble of a first frame*/
+#define TP_CONSECUTIVE_FRAME    0x20u   /*!< Most significant nibble of a consecutive frame*/
+#define TP_FLOW_CONTROL         0x30u   /*!< Most significant nibble of a flow control*/
+#define TP_FC_CTS               0x00u   /*!< Flow status continue to send*/
+#define TP_FC_WAIT              0x01u   /*!< Flow status wait*/
+#define TP_FC_OVERFLOW          0x02u   /*!< Flow status overflow, the transfer doesn't fit*/
+#define TP_FF_BYTES             0x06u   /*!< Payload bytes in a first frame*/
+#define TP_CF_BYTES             0x07u   /*!< Payload bytes in a consecutive frame*/
+#define TP_STMIN_MAX_MS         0x7Fu   /*!< Max STmin in ms, the values above are us or reserved*/
+#define TP_STMIN_US_MIN         0xF1u   /*!< STmin of 100 us, below 1 ms it's taken as zero*/
+#define TP_STMIN_US_MAX         0xF9u   /*!< STmin of 900 us, below 1 ms it's taken as zero*/
+/**
+  @} */
+
+/** 
+  * @defgroup ConfigItems Parameters of each type of item in a CONFIG transfer
+  @{ */
+#define TP_ITEM_TYPES           0x03u   /*!< Types of items, SERIAL_MSG_TIME, SERIAL_MSG_DATE and SERIAL_MSG_ALARM*/
+#define TP_TIME_PARAMS          0x03u   /*!< Hour, minutes and seconds*/
+#define TP_DATE_PARAMS          0x04u   /*!< Day, month and the two halves of the year*/
+#define TP_ALARM_PARAMS         0x02u   /*!< Hour and minutes*/
+/**
+  @} */
+
+/** 
+  * @defgroup IsoTpStates States of an ISO-TP channel
+  @{ */
+#define TP_IDLE                 0x00u   /*!< No transfer in progress*/
+#define TP_RECEIVING            0x01u   /*!< Waiting for the consecutive frames of a transfer*/
+#define TP_WAIT_FC              0x02u   /*!< First frame or block sent, waiting for a flow control*/
+#define TP_SENDING              0x03u   /*!< Sending the consecutive frames of a block*/
+/**
+  @} */
+
+/**
+ * @brief   ISO-TP channel, the state of a transfer received or sent.
+*/
+typedef struct _APP_TpTypeDef
+{
+    uint8_t state;                      /*!< One of the IsoTpStates values*/
+    uint8_t buffer[ SERIAL_TP_SIZE ];   /*!< Payload of the transfer*/
+    uint16_t length;                    /*!< Bytes of the payload*/
+    uint16_t index;                     /*!< Bytes already received or sent*/
+    uint8_t sequence;                   /*!< Sequence number of the next consecutive frame*/
+    uint8_t blockSize;                  /*!< Consecutive frames between flow controls, zero for no limit*/
+    uint8_t blockLeft;                  /*!< Consecutive frames left in the current block*/
+    uint8_t stMin;                      /*!< Min time between consecutive frames in ms*/
+    uint8_t waits;                      /*!< Flow controls WAIT received in a row*/
+} APP_TpTypeDef;
+
+/**
+ * @brief   Counters of the frames and responses dropped by the flow control of the serial task.
+ * 
+ * Instead of going to safe_state with the queues or the TX FIFO full, the frames are dropped and
+ * counted here, the counters are read from a debugger.
+*/
+typedef struct _APP_SerialStats
+{
+    volatile uint32_t RxDropped;    /*!< Frames received and dropped, CAN queue full or no block in the pool*/
+    uint32_t RespDropped;           /*!< Responses dropped with the ResponseQueue full*/
+    uint32_t Reported;              /*!< RxDropped plus RespDropped already reported in BUSY responses*/
+    uint32_t BusySent;              /*!< BUSY responses sent*/
+    uint32_t TxRetries;             /*!< Periods that left responses in the ResponseQueue to the next one*/
+    uint32_t TxDropped;             /*!< Frames not sent with the TX FIFO full*/
+} APP_SerialStats;
+
+extern APP_SerialStats SerialStats;
+
 void Serial_InitTask( void );
 
 void Serial_PeriodicTask( void );
 
+void SerialLoad_Callback( void );
+
+void SerialTpRx_Callback( void );
+
+void SerialTpTx_Callback( void );
+
 #endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file    trace.c
+ * @brief   Ring in RAM with the last events of the scheduler, the queues and the interrupts.
+ *
+ * Each event is a record of 8 bytes with the count of TIM7, the free running counter of 1 us that
+ * times the tasks, the lower bits of the HAL tick to unwrap that count, the event code and two
+ * arguments. The ring keeps the last TRACE_RECORDS events, a new event overwrites the oldest one,
+ * so recording is just a few stores with the interrupts disabled and it can be left enabled.
+ *
+ * The events are recorded through the TRACE_EVENT macro of trace.h, compiled out when the symbol
+ * TRACE is not defined. The ring is a single global variable to read it from a debugger, with the
+ * target halted "dump binary value trace.bin TraceRing" in gdb writes it in a file, and the host
+ * tool trace/trace2json.c converts the file to Chrome trace JSON to see it in Perfetto.
+ */
+
+#include "trace.h"
+#include "bsp.h"
+
+static uint16_t Trace_Stamp( void );
+
+/** @brief  Ring with the last events, read from a dump of the RAM */
+AppTrace_Ring TraceRing;
+
+
+/**
+ * @brief   Interface to initialize the trace ring.
+ *
+ * The records are discarded, the mark is written and the recording is enabled.
+ */
+void AppTrace_init( void )
+{
+    TraceRing.Enabled = FALSE;
+    TraceRing.Head    = 0u;
+
+    for( uint32_t i = 0u; i < TRACE_RECORDS; i++ )
+    {
+        TraceRing.Records[ i ].Stamp = 0u;
+        TraceRing.Records[ i ].Tick  = 0u;
+        TraceRing.Records[ i ].Event = 0u;
+        TraceRing.Records[ i ].Id    = 0u;
+        TraceRing.Records[ i ].Arg   = 0u;
+    }
+
+    TraceRing.Magic   = TRACE_MAGIC;
+    TraceRing.Enabled = TRUE;
+}
+
+/**
+ * @brief   Interface to stop or resume the recording.
+ *
+ * Stop the recording freezes the ring with the events before a failure, safe_state stops it so a
+ * dump shows what happened until the error.
+ *
+ * @param   enable [in] TRUE to record the events, FALSE to stop.
+ */
+void AppTrace_enable( uint32_t enable )
+{
+    TraceRing.Enabled = enable;
+}
+
+/**
+ * @brief   Interface to record an event in the ring.
+ *
+ * The record is written in the position of the head with the interrupts disabled, the function is
+ * called from the tasks and the interrupts. The events are discarded before the ring is
+ * initialized and while the recording is stopped.
+ *
+ * @param   event [in] Event code, one of the TraceEvents values.
+ * @param   id [in] Task, timer, interrupt or number of elements of the event.
+ * @param   arg [in] Argument of the event.
+ */
+void AppTrace_record( uint8_t event, uint8_t id, uint16_t arg )
+{
+    #ifndef UTEST
+    uint32_t primask = __get_PRIMASK( );
+    __disable_irq( );
+    #endif
+
+    if( TraceRing.Enabled == TRUE )
+    {
+        AppTrace_Record *record = &TraceRing.Records[ TraceRing.Head & TRACE_MASK ];
+
+        record->Stamp = Trace_Stamp( );
+        record->Tick  = (uint16_t) HAL_GetTick( );
+        record->Event = event;
+        record->Id    = id;
+        record->Arg   = arg;
+
+        TraceRing.Head++;
+    }
+
+    #ifndef UTEST
+    __set_PRIMASK( primask );
+    #endif
+}
+
+/**
+ * @brief   Read the TIM7 count to stamp the events.
+ *
+ * The register is read without the handler, its instance is set when the scheduler starts.
+ *
+ * @retval  Count in us, it overflows every 65.5 ms, zero for the unit tests, the host simulation
+ *          reads the count of its virtual TIM7.
+ */
+static uint16_t Trace_Stamp( void )
+{
+    uint16_t count = 0;
+
+    #if !defined( UTEST ) || defined( SIM )
+    count = (uint16_t) TIM7->CNT;      /*the register, the events before the scheduler starts read zero*/
+    #endif
+
+    return count;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file trace.h
+ *
+ * @brief Here is defined the AppTrace_Record and AppTrace_Ring structs, the event codes, the
+ * TRACE_EVENT hook and the functions prototypes of the trace.c file. The header only depends on
+ * stdint.h, the host converter includes it to read a dump of the ring.
+*/
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "stdint.h"
+
+/**
+  * @defgroup TraceRing Size and mark of the trace ring
+  @{ */
+#define TRACE_RECORDS   256u            /*!< Number of records in the ring, a power of two */
+#define TRACE_MASK      ( TRACE_RECORDS - 1u )  /*!< Mask to get the position of a record in the ring */
+#define TRACE_MAGIC     0x45435254u     /*!< "TRCE" in the first bytes of an initialized ring */
+/**
+  @} */
+
+/**
+  * @defgroup TraceEvents Events recorded in the ring, the meaning of Id and Arg for each one
+  @{ */
+#define TRACE_TASK_START    1u  /*!< Task starts, Id is the taskID, Arg is TRUE when it runs by its event */
+#define TRACE_TASK_END      2u  /*!< Task ends, Id is the taskID */
+#define TRACE_TIMER_START   3u  /*!< Timer callback starts, Id is the timerID */
+#define TRACE_TIMER_END     4u  /*!< Timer callback ends, Id is the timerID */
+#define TRACE_QUEUE_WRITE   5u  /*!< Elements written in a queue, Id is the number of elements, Arg the queue address */
+#define TRACE_QUEUE_READ    6u  /*!< Elements read from a queue, Id is the number of elements, Arg the queue address */
+#define TRACE_ISR_ENTER     7u  /*!< Interrupt handler starts, Id is one of the TraceIsr values */
+#define TRACE_ISR_EXIT      8u  /*!< Interrupt handler ends, Id is one of the TraceIsr values */
+/**
+  @} */
+
+/**
+  * @defgroup TraceIsr Id of the interrupts recorded in the ring
+  @{ */
+#define TRACE_ISR_FDCAN     1u  /*!< FDCAN line 0, the CAN messages received */
+#define TRACE_ISR_RTC       2u  /*!< RTC alarm */
+#define TRACE_ISR_EXTI      3u  /*!< EXTI lines 4 to 15, the button */
+/**
+  @} */
+
+#ifdef TRACE
+#define TRACE_EVENT( event, id, arg )   AppTrace_record( (uint8_t)(event), (uint8_t)(id), (uint16_t)(arg) )    /*!< Record an event in the ring */
+#else
+#define TRACE_EVENT( event, id, arg )   (void)0     /*!< Trace compiled out, nothing is recorded */
+#endif
+
+/** @brief  Record the n elements written or read in a queue, n saturates at 255 and the queue is
+ * identified by the lower 16 bits of its address */
+#define TRACE_QUEUE( event, queue, n ) \
+    TRACE_EVENT( (event), ( (n) > 255u ) ? 255u : (n), (uintptr_t)(const void *)(queue) )
+
+/**
+ * @struct AppTrace_Record
+ *
+ * @brief Record of an event, 8 bytes. The us count of a free running timer gives the resolution, it
+ * wraps each 65.536 ms so the ms tick is also recorded to unwrap it in the host.
+ *
+*/
+typedef struct
+{
+    uint16_t Stamp;     /*!< TIM7 count in us when the event was recorded */
+    uint16_t Tick;      /*!< Lower 16 bits of the HAL tick in ms when the event was recorded */
+    uint8_t Event;      /*!< Event code, one of the TraceEvents values */
+    uint8_t Id;         /*!< Task, timer, interrupt or number of elements of the event */
+    uint16_t Arg;       /*!< Argument of the event */
+} AppTrace_Record;
+
+/**
+ * @struct AppTrace_Ring
+ *
+ * @brief Ring with the last TRACE_RECORDS events, a new event overwrites the oldest one.
+ *
+*/
+typedef struct
+{
+    uint32_t Magic;     /*!< TRACE_MAGIC once the ring is initialized, to validate a dump */
+    volatile uint32_t Head;     /*!< Number of events recorded, the next one goes to Head & TRACE_MASK */
+    volatile uint32_t Enabled;  /*!< The events are recorded only while it's TRUE */
+    AppTrace_Record Records[ TRACE_RECORDS ];   /*!< Records of the events */
+} AppTrace_Ring;
+
+extern AppTrace_Ring TraceRing;
+
+void AppTrace_init( void );
+
+void AppTrace_enable( uint32_t enable );
+
+void AppTrace_record( uint8_t event, uint8_t id, uint16_t arg );
+
+#endif
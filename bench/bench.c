@@ -0,0 +1,573 @@
+/**
+ * @file    bench.c
+ *
+ * @brief   Host microbenchmarks of the hot paths of the application.
+ *
+ * The queue, pool, scheduler, serial, display and trace modules are compiled for the host, with the
+ * HAL and LCD functions replaced by the stubs in bench_stubs.c, and each case is run over millions
+ * of iterations to get the time of one operation. The numbers are host nanoseconds, not Cortex-M0+
+ * cycles, they are meant to compare the same code before and after a change, on the same machine.
+ *
+ * Each case runs BENCH_REPEATS times after a warm up, the best time is reported as ns_per_op (the
+ * less disturbed by the OS) along with the mean. The results are printed and written in a JSON file.
+ *
+ * usage: bench [output file] [iterations]
+*/
+#define _POSIX_C_SOURCE 199309L     /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bsp.h"
+#include "display.h"
+#include "bench.h"
+
+#define BENCH_ITERATIONS        2000000ul   /*!< Default number of iterations of each case */
+#define BENCH_REPEATS           5u          /*!< Times that each case is measured */
+#define BENCH_QUEUE_ELEMENTS    32u         /*!< Number of elements of the benchmarked queues */
+#define BENCH_BATCH             8u          /*!< Number of elements moved by each batch operation */
+#define BENCH_SCHED_LOOPS       255u        /*!< Scheduler loops per call, numLoops is an unsigned char */
+#define BENCH_TICK              5u          /*!< Scheduler tick, the same value used in main.c */
+#define BENCH_NS_PER_S          1000000000.0 /*!< Nanoseconds in one second */
+
+/**
+ * @brief   Struct with a benchmark case.
+*/
+typedef struct
+{
+    const char *Name;                       /*!< Name of the case in the results */
+    void (*Run)( unsigned long iterations ); /*!< Function that runs the given number of operations */
+} Bench_Case;
+
+/**
+ * @brief   Struct with the results of a benchmark case.
+*/
+typedef struct
+{
+    double Best;    /*!< Best time of one operation in ns */
+    double Mean;    /*!< Mean time of one operation in ns */
+} Bench_Result;
+
+/** @brief  Loops of the scheduler, used by the FOREVER macro when TEST_L is defined */
+unsigned char numLoops;
+
+/** @brief  The results of the operations are accumulated here so the compiler can not remove them */
+static volatile unsigned long Bench_Sink;
+
+uint8_t Serial_SingleFrameRx( const uint8_t *data, uint8_t *size );
+
+uint8_t WeekDay( uint8_t days, uint8_t month, uint16_t year );
+
+void DateString( char *string, uint8_t month, uint8_t day, uint16_t year, uint8_t weekday );
+
+static void Bench_QueueRoundTrip( unsigned char spsc, unsigned char pow2, unsigned long iterations );
+
+static void Bench_QueueModulo( unsigned long iterations );
+
+static void Bench_QueuePow2( unsigned long iterations );
+
+static void Bench_QueueSpsc( unsigned long iterations );
+
+static void Bench_QueueBatch( unsigned long iterations );
+
+static void Bench_TypedQueue( unsigned long iterations );
+
+static void Bench_CanByValue( unsigned long iterations );
+
+static void Bench_CanByPointer( unsigned long iterations );
+
+static void Bench_SingleFrameRx( unsigned long iterations );
+
+static void Bench_WeekDay( unsigned long iterations );
+
+static void Bench_DateString( unsigned long iterations );
+
+static void Bench_SchedulerTick( unsigned long iterations );
+
+static void Bench_SchedulerTable( unsigned long iterations );
+
+static void Bench_Scheduler( unsigned long iterations, unsigned char table );
+
+static void Bench_TraceRecord( unsigned long iterations );
+
+static void Bench_EmptyTask( void );
+
+static void Bench_TimerCallback( void );
+
+static double Bench_Now( void );
+
+static Bench_Result Bench_Measure( const Bench_Case *bench, unsigned long iterations );
+
+/** @brief  Scheduler of the tick benchmark */
+static AppSched_Scheduler BenchScheduler;
+
+/**
+ * @brief   Cases to run, the names are the keys in the results file, do not change them.
+*/
+static const Bench_Case BenchCases[ ] =
+{
+    { "queue_write_read_modulo",    Bench_QueueModulo },
+    { "queue_write_read_pow2",      Bench_QueuePow2 },
+    { "queue_write_read_spsc_pow2", Bench_QueueSpsc },
+    { "queue_batch8_write_read",    Bench_QueueBatch },
+    { "typed_queue_write_read",     Bench_TypedQueue },
+    { "can_msg_by_value",           Bench_CanByValue },
+    { "can_msg_by_pointer",         Bench_CanByPointer },
+    { "serial_single_frame_rx",     Bench_SingleFrameRx },
+    { "serial_weekday",             Bench_WeekDay },
+    { "display_date_string",        Bench_DateString },
+    { "scheduler_tick",             Bench_SchedulerTick },
+    { "scheduler_tick_table",       Bench_SchedulerTable },
+    { "trace_record",               Bench_TraceRecord },
+};
+
+/**
+ * @brief   Run all the cases and write the results.
+ *
+ * @param   argc [in] Number of arguments.
+ * @param   argv [in] Output file (default bench_results.json) and number of iterations.
+ *
+ * @retval  Zero, or one if the output file can not be written.
+*/
+int main( int argc, char *argv[] )
+{
+    const char *path = ( argc > 1 ) ? argv[ 1 ] : "bench_results.json";
+    unsigned long iterations = ( argc > 2 ) ? strtoul( argv[ 2 ], NULL, 10 ) : BENCH_ITERATIONS;
+    const size_t nCases = sizeof( BenchCases ) / sizeof( BenchCases[ 0 ] );
+    int ret = 0;
+
+    if( iterations == 0u )
+    {
+        iterations = BENCH_ITERATIONS;
+    }
+
+    FILE *out = fopen( path, "w" );
+
+    if( out == NULL )
+    {
+        (void) fprintf( stderr, "bench: can not open %s\n", path );
+        ret = 1;
+    }
+    else
+    {
+        (void) fprintf( out, "{\n  \"iterations\": %lu,\n  \"repeats\": %u,\n", iterations, BENCH_REPEATS );
+        (void) fprintf( out, "  \"compiler\": \"%s\",\n  \"benchmarks\": [\n", __VERSION__ );
+        (void) printf( "%-28s %12s %12s\n", "benchmark", "ns/op best", "ns/op mean" );
+
+        for( size_t i = 0u; i < nCases; i++ )
+        {
+            Bench_Result result = Bench_Measure( &BenchCases[ i ], iterations );
+
+            (void) printf( "%-28s %12.2f %12.2f\n", BenchCases[ i ].Name, result.Best, result.Mean );
+            (void) fprintf( out, "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"ns_per_op_mean\": %.3f }%s\n",
+                BenchCases[ i ].Name, result.Best, result.Mean, ( ( i + 1u ) < nCases ) ? "," : "" );
+        }
+
+        (void) fprintf( out, "  ]\n}\n" );
+        (void) fclose( out );
+        (void) printf( "results written in %s\n", path );
+    }
+
+    return ret;
+}
+
+/**
+ * @brief   Get the time of the monotonic clock.
+ *
+ * @retval  Time in ns.
+*/
+static double Bench_Now( void )
+{
+    struct timespec now;
+
+    (void) clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( (double) now.tv_sec * BENCH_NS_PER_S ) + (double) now.tv_nsec;
+}
+
+/**
+ * @brief   Measure a case.
+ *
+ * Run the case once with a tenth of the iterations to warm up the caches, and then BENCH_REPEATS
+ * times with all the iterations.
+ *
+ * @param   bench [in] Case to measure.
+ * @param   iterations [in] Number of operations of each run.
+ *
+ * @retval  Best and mean time of one operation.
+*/
+static Bench_Result Bench_Measure( const Bench_Case *bench, unsigned long iterations )
+{
+    Bench_Result result = { 0.0, 0.0 };
+    double total = 0.0;
+
+    bench->Run( ( iterations / 10u ) + 1u );
+
+    for( unsigned char r = 0u; r < BENCH_REPEATS; r++ )
+    {
+        double start = Bench_Now( );
+        bench->Run( iterations );
+        double elapsed = ( Bench_Now( ) - start ) / (double) iterations;
+
+        total += elapsed;
+        if( ( r == 0u ) || ( elapsed < result.Best ) )
+        {
+            result.Best = elapsed;
+        }
+    }
+
+    result.Mean = total / (double) BENCH_REPEATS;
+
+    return result;
+}
+
+/**
+ * @brief   Write and read one element of a queue on each iteration.
+ *
+ * @param   spsc [in] TRUE to work in SPSC mode.
+ * @param   pow2 [in] TRUE to wrap the indexes with a mask.
+ * @param   iterations [in] Number of write/read pairs.
+*/
+static void Bench_QueueRoundTrip( unsigned char spsc, unsigned char pow2, unsigned long iterations )
+{
+    static APP_MsgTypeDef msgs[ BENCH_QUEUE_ELEMENTS ];
+    AppQue_Queue queue = { 0 };
+    APP_MsgTypeDef in = { 0 };
+    APP_MsgTypeDef out = { 0 };
+
+    queue.Buffer    = msgs;
+    queue.Elements  = BENCH_QUEUE_ELEMENTS;
+    queue.Size      = sizeof( APP_MsgTypeDef );
+    queue.Spsc      = spsc;
+    queue.Pow2      = pow2;
+    (void) AppQueue_initQueue( &queue );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        in.msg = (uint8_t) i;
+        (void) AppQueue_writeData( &queue, &in );
+        (void) AppQueue_readData( &queue, &out );
+        Bench_Sink += out.msg;
+    }
+}
+
+/**
+ * @brief   Queue round trip with the modulo indexing.
+ *
+ * @param   iterations [in] Number of write/read pairs.
+*/
+static void Bench_QueueModulo( unsigned long iterations )
+{
+    Bench_QueueRoundTrip( FALSE, FALSE, iterations );
+}
+
+/**
+ * @brief   Queue round trip with the mask indexing.
+ *
+ * @param   iterations [in] Number of write/read pairs.
+*/
+static void Bench_QueuePow2( unsigned long iterations )
+{
+    Bench_QueueRoundTrip( FALSE, TRUE, iterations );
+}
+
+/**
+ * @brief   Queue round trip in SPSC mode with the mask indexing.
+ *
+ * @param   iterations [in] Number of write/read pairs.
+*/
+static void Bench_QueueSpsc( unsigned long iterations )
+{
+    Bench_QueueRoundTrip( TRUE, TRUE, iterations );
+}
+
+/**
+ * @brief   Write and read BENCH_BATCH elements with a single call each.
+ *
+ * @param   iterations [in] Number of batch write/read pairs.
+*/
+static void Bench_QueueBatch( unsigned long iterations )
+{
+    static APP_CanTypeDef msgs[ BENCH_QUEUE_ELEMENTS ];
+    AppQue_Queue queue = { 0 };
+    APP_CanTypeDef in[ BENCH_BATCH ] = { 0 };
+    APP_CanTypeDef out[ BENCH_BATCH ] = { 0 };
+
+    queue.Buffer    = msgs;
+    queue.Elements  = BENCH_QUEUE_ELEMENTS;
+    queue.Size      = sizeof( APP_CanTypeDef );
+    queue.Spsc      = TRUE;
+    queue.Pow2      = TRUE;
+    (void) AppQueue_initQueue( &queue );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        in[ 0 ].id = (uint16_t) i;
+        (void) AppQueue_writeBatch( &queue, in, BENCH_BATCH );
+        Bench_Sink += AppQueue_readBatch( &queue, out, BENCH_BATCH ) + out[ 0 ].id;
+    }
+}
+
+/**
+ * @brief   Write and read one element of the typed DisplayQueue on each iteration.
+ *
+ * @param   iterations [in] Number of write/read pairs.
+*/
+static void Bench_TypedQueue( unsigned long iterations )
+{
+    APP_MsgTypeDef in = { 0 };
+    APP_MsgTypeDef out = { 0 };
+
+    DisplayQ_flush( &DisplayQueue );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        in.msg = (uint8_t) i;
+        (void) DisplayQ_write( &DisplayQueue, &in );
+        (void) DisplayQ_read( &DisplayQueue, &out );
+        Bench_Sink += out.msg;
+    }
+}
+
+/**
+ * @brief   Pass a CAN message through an SPSC queue by value, as the serial queue did before the pool.
+ *
+ * The message is filled in a local variable, copied in the queue and copied back by the read.
+ *
+ * @param   iterations [in] Number of messages passed.
+*/
+static void Bench_CanByValue( unsigned long iterations )
+{
+    static APP_CanTypeDef msgs[ BENCH_QUEUE_ELEMENTS ];
+    AppQue_Queue queue = { 0 };
+    APP_CanTypeDef in = { 0 };
+    APP_CanTypeDef out = { 0 };
+
+    queue.Buffer    = msgs;
+    queue.Elements  = BENCH_QUEUE_ELEMENTS;
+    queue.Size      = sizeof( APP_CanTypeDef );
+    queue.Spsc      = TRUE;
+    queue.Pow2      = TRUE;
+    (void) AppQueue_initQueue( &queue );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        in.id = (uint16_t) i;
+        (void) AppQueue_writeData( &queue, &in );
+        (void) AppQueue_readData( &queue, &out );
+        Bench_Sink += out.id;
+    }
+}
+
+/**
+ * @brief   Pass a CAN message through an SPSC queue by pointer, as the serial queue does now.
+ *
+ * The message is filled in a block of a pool, only its address is copied in the queue, and the
+ * block is freed after the read.
+ *
+ * @param   iterations [in] Number of messages passed.
+*/
+static void Bench_CanByPointer( unsigned long iterations )
+{
+    static APP_CanTypeDef *msgs[ BENCH_QUEUE_ELEMENTS ];
+    static APP_CanTypeDef blocks[ BENCH_QUEUE_ELEMENTS ];
+    AppQue_Queue queue = { 0 };
+    AppPool_Pool pool = { 0 };
+    APP_CanTypeDef *in = NULL;
+    APP_CanTypeDef *out = NULL;
+
+    pool.Buffer = blocks;
+    pool.Blocks = BENCH_QUEUE_ELEMENTS;
+    pool.Size   = sizeof( APP_CanTypeDef );
+    AppPool_initPool( &pool );
+
+    queue.Buffer    = msgs;
+    queue.Elements  = BENCH_QUEUE_ELEMENTS;
+    queue.Size      = sizeof( APP_CanTypeDef * );
+    queue.Spsc      = TRUE;
+    queue.Pow2      = TRUE;
+    (void) AppQueue_initQueue( &queue );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        in = (APP_CanTypeDef *) AppPool_alloc( &pool );
+        in->id = (uint16_t) i;
+        (void) AppQueue_writeData( &queue, &in );
+        (void) AppQueue_readData( &queue, &out );
+        Bench_Sink += out->id;
+        (void) AppPool_free( &pool, out );
+    }
+}
+
+/**
+ * @brief   Parse a CAN-TP single frame with seven bytes of payload on each iteration.
+ *
+ * @param   iterations [in] Number of frames parsed.
+*/
+static void Bench_SingleFrameRx( unsigned long iterations )
+{
+    uint8_t frame[ 8 ] = { 0x07u };    /*the parser checks the header in place, the payload is not moved*/
+    uint8_t size = 0u;
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        frame[ 1 ] = (uint8_t) i;
+        Bench_Sink += Serial_SingleFrameRx( frame, &size ) + frame[ 1 ];
+    }
+}
+
+/**
+ * @brief   Record an event in the trace ring on each iteration.
+ *
+ * The ring is only enabled in this case, in the other ones the trace hooks of the modules just
+ * find it disabled.
+ *
+ * @param   iterations [in] Number of events.
+*/
+static void Bench_TraceRecord( unsigned long iterations )
+{
+    AppTrace_init( );
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        AppTrace_record( TRACE_QUEUE_WRITE, (uint8_t) i, (uint16_t) i );
+    }
+
+    AppTrace_enable( FALSE );
+    Bench_Sink += TraceRing.Head;
+}
+
+/**
+ * @brief   Get the week day of a different date on each iteration.
+ *
+ * @param   iterations [in] Number of dates.
+*/
+static void Bench_WeekDay( unsigned long iterations )
+{
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        uint8_t day     = (uint8_t) ( ( i % 28u ) + 1u );
+        uint8_t month   = (uint8_t) ( ( i % 12u ) + 1u );
+        uint16_t year   = (uint16_t) ( ( i % 199u ) + 1901u );
+
+        Bench_Sink += WeekDay( day, month, year );
+    }
+}
+
+/**
+ * @brief   Build the date string of the LCD on each iteration.
+ *
+ * @param   iterations [in] Number of strings.
+*/
+static void Bench_DateString( unsigned long iterations )
+{
+    char string[ 16 ];
+
+    for( unsigned long i = 0u; i < iterations; i++ )
+    {
+        DateString( string, (uint8_t) ( ( i % 12u ) + 1u ), (uint8_t) ( ( i % 28u ) + 1u ),
+            (uint16_t) ( ( i % 100u ) + 2000u ), (uint8_t) ( i % 7u ) );
+        Bench_Sink += (unsigned char) string[ 1 ];
+    }
+}
+
+/**
+ * @brief   Empty task of the scheduler benchmark.
+*/
+static void Bench_EmptyTask( void )
+{
+    Bench_Sink++;
+}
+
+/**
+ * @brief   Timer callback of the scheduler benchmark, restarts all the timers like a periodic one.
+*/
+static void Bench_TimerCallback( void )
+{
+    for( unsigned char i = 1u; i <= BenchScheduler.timersCount; i++ )
+    {
+        if( BenchScheduler.timerPtr[ i - 1u ].startFlag == FALSE )
+        {
+            (void) AppSched_startTimer( &BenchScheduler, i );
+        }
+    }
+}
+
+/**
+ * @brief   Run scheduler ticks.
+ *
+ * The scheduler has the same tick, tasks periods and timers of main.c, with empty tasks, so the
+ * time is the scheduler overhead of a tick. The stub of HAL_GetTick makes every loop a tick, and
+ * each call to AppSched_startScheduler runs BENCH_SCHED_LOOPS ticks.
+ *
+ * @param   iterations [in] Number of ticks.
+*/
+static void Bench_SchedulerTick( unsigned long iterations )
+{
+    Bench_Scheduler( iterations, FALSE );
+}
+
+/**
+ * @brief   Run scheduler ticks with the frame table of the cyclic executive.
+ *
+ * The same scheduler of Bench_SchedulerTick, with the tasks staggered and the table built as in
+ * main.c.
+ *
+ * @param   iterations [in] Number of ticks.
+*/
+static void Bench_SchedulerTable( unsigned long iterations )
+{
+    Bench_Scheduler( iterations, TRUE );
+}
+
+/**
+ * @brief   Configure the scheduler of the benchmarks and run its ticks.
+ *
+ * @param   iterations [in] Number of ticks.
+ * @param   table [in] TRUE to stagger the tasks and run them from a frame table.
+*/
+static void Bench_Scheduler( unsigned long iterations, unsigned char table )
+{
+    static AppSched_Task tasks[ TASKS_N ];
+    static AppSched_Timer timers[ TIMERS_N ];
+    static unsigned char frames[ FRAMES_N ];
+    const unsigned long periods[ TASKS_N ] =
+    {
+        PERIOD_SERIAL_TASK, PERIOD_CLOCK_TASK, PERIOD_HEARTBEAT_TASK,
+        PERIOD_DISPLAY_TASK, PERIOD_LCD_TASK, PERIOD_WATCHDOG_TASK
+    };
+    const unsigned long timeouts[ TIMERS_N ] = { 1000u, 1000u, 60000u };
+
+    BenchScheduler.tick     = BENCH_TICK;
+    BenchScheduler.tasks    = TASKS_N;
+    BenchScheduler.taskPtr  = tasks;
+    BenchScheduler.timers   = TIMERS_N;
+    BenchScheduler.timerPtr = timers;
+    BenchScheduler.frames   = FRAMES_N;
+    BenchScheduler.framePtr = frames;
+    AppSched_initScheduler( &BenchScheduler );
+
+    for( unsigned char i = 0u; i < TASKS_N; i++ )
+    {
+        (void) AppSched_registerTask( &BenchScheduler, NULL, Bench_EmptyTask, periods[ i ] );
+    }
+
+    if( table == TRUE )
+    {
+        (void) AppSched_staggerTasks( &BenchScheduler );
+        (void) AppSched_buildTable( &BenchScheduler );
+    }
+
+    for( unsigned char i = 0u; i < TIMERS_N; i++ )
+    {
+        unsigned char id = AppSched_registerTimer( &BenchScheduler, timeouts[ i ], Bench_TimerCallback );
+        (void) AppSched_startTimer( &BenchScheduler, id );
+    }
+
+    for( unsigned long done = 0u; done < iterations; done += BENCH_SCHED_LOOPS )
+    {
+        Bench_ResetTick( );
+        numLoops = BENCH_SCHED_LOOPS;
+        AppSched_startScheduler( &BenchScheduler );
+    }
+}
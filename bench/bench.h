@@ -0,0 +1,11 @@
+/**
+ * @file    bench.h
+ *
+ * @brief   Functions shared by the host benchmarks and their HAL stubs.
+*/
+#ifndef BENCH_H_
+#define BENCH_H_
+
+void Bench_ResetTick( void );
+
+#endif
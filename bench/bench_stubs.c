@@ -0,0 +1,124 @@
+/**
+ * @file    bench_stubs.c
+ *
+ * @brief   Host versions of the HAL, LCD and analogs functions used by the benchmarked modules.
+ *
+ * The functions do nothing and return a success value, so the benchmarks measure only the code
+ * of the application. The HAL tick is the exception, see HAL_GetTick.
+*/
+#include "bsp.h"
+#include "analogs.h"
+#include "bench.h"
+
+/** @brief  ClockQueue, defined in clock.c that is not part of the benchmarks */
+AppQue_PrioQueue ClockQueue;
+
+/** @brief  Scheduler, defined in main.c that is not part of the benchmarks */
+AppSched_Scheduler Scheduler;
+
+/** @brief  Timer ID that sends the CPU load, defined in main.c that is not part of the benchmarks */
+uint8_t LoadTimerID;
+
+/** @brief  Timer ID of the ISO-TP transfers received, defined in main.c that is not part of the benchmarks */
+uint8_t TpRxTimerID;
+
+/** @brief  Timer ID of the ISO-TP transfers sent, defined in main.c that is not part of the benchmarks */
+uint8_t TpTxTimerID;
+
+/** @brief  TIM6 Handler, defined in main.c that is not part of the benchmarks */
+TIM_HandleTypeDef TIM6_Handler;
+
+/** @brief  TIM7 Handler, defined in main.c that is not part of the benchmarks */
+TIM_HandleTypeDef TIM7_Handler;
+
+/** @brief  Number of HAL_GetTick calls since the last Bench_ResetTick */
+static unsigned long TickReads = 0u;
+
+/**
+ * @brief   Restart the HAL tick, the next HAL_GetTick returns zero.
+*/
+void Bench_ResetTick( void )
+{
+    TickReads = 0u;
+}
+
+/**
+ * @brief   Host HAL tick.
+ *
+ * The first read after Bench_ResetTick returns zero, and the next ones return the max tick value,
+ * so the scheduler takes zero as its tick start and after that every loop is a tick to process.
+ *
+ * @retval  Zero in the first read, the max tick value in the rest.
+*/
+uint32_t HAL_GetTick( void )
+{
+    return ( TickReads++ == 0u ) ? 0u : UINT32_MAX;
+}
+
+/* cppcheck-suppress-begin misra-c2012-8.4 ; the prototypes are in the HAL and LCD headers */
+HAL_StatusTypeDef HAL_FDCAN_Init( FDCAN_HandleTypeDef *hfdcan ) { (void) hfdcan; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter( FDCAN_HandleTypeDef *hfdcan, FDCAN_FilterTypeDef *sFilterConfig )
+{ (void) hfdcan; (void) sFilterConfig; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigGlobalFilter( FDCAN_HandleTypeDef *hfdcan, uint32_t NonMatchingStd,
+    uint32_t NonMatchingExt, uint32_t RejectRemoteStd, uint32_t RejectRemoteExt )
+{ (void) hfdcan; (void) NonMatchingStd; (void) NonMatchingExt; (void) RejectRemoteStd; (void) RejectRemoteExt; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_Start( FDCAN_HandleTypeDef *hfdcan ) { (void) hfdcan; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification( FDCAN_HandleTypeDef *hfdcan, uint32_t ActiveITs, uint32_t BufferIndexes )
+{ (void) hfdcan; (void) ActiveITs; (void) BufferIndexes; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ( FDCAN_HandleTypeDef *hfdcan, FDCAN_TxHeaderTypeDef *pTxHeader, uint8_t *pTxData )
+{ (void) hfdcan; (void) pTxHeader; (void) pTxData; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage( FDCAN_HandleTypeDef *hfdcan, uint32_t RxLocation, FDCAN_RxHeaderTypeDef *pRxHeader, uint8_t *pRxData )
+{ (void) hfdcan; (void) RxLocation; (void) pRxHeader; (void) pRxData; return HAL_OK; }
+
+uint32_t HAL_FDCAN_GetRxFifoFillLevel( FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo )
+{ (void) hfdcan; (void) RxFifo; return 0u; }
+
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel( FDCAN_HandleTypeDef *hfdcan ) { (void) hfdcan; return 3u; }
+
+void HAL_NVIC_SetPriority( IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority )
+{ (void) IRQn; (void) PreemptPriority; (void) SubPriority; }
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn ) { (void) IRQn; }
+
+void HAL_NVIC_DisableIRQ( IRQn_Type IRQn ) { (void) IRQn; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel( TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *sConfig, uint32_t Channel )
+{ (void) htim; (void) sConfig; (void) Channel; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_SPI_Init( SPI_HandleTypeDef *hspi ) { (void) hspi; return HAL_OK; }
+
+uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd ) { (void) hlcd; return HAL_OK; }
+
+uint8_t HEL_LCD_InitStep( LCD_HandleTypeDef *hlcd, uint8_t step, uint32_t *delay )
+{ (void) hlcd; *delay = 0u; return ( step < HEL_LCD_INIT_STEPS ) ? HAL_OK : HAL_ERROR; }
+
+uint8_t HEL_LCD_Data( LCD_HandleTypeDef *hlcd, uint8_t data ) { (void) hlcd; (void) data; return HAL_OK; }
+
+uint8_t HEL_LCD_String( LCD_HandleTypeDef *hlcd, const char *str ) { (void) hlcd; (void) str; return HAL_OK; }
+
+uint8_t HEL_LCD_SetCursor( LCD_HandleTypeDef *hlcd, uint8_t row, uint8_t col ) { (void) hlcd; (void) row; (void) col; return HAL_OK; }
+
+uint8_t HEL_LCD_Backlight( LCD_HandleTypeDef *hlcd, uint8_t state ) { (void) hlcd; (void) state; return HAL_OK; }
+
+uint8_t HEL_LCD_Contrast( LCD_HandleTypeDef *hlcd, uint8_t contrast ) { (void) hlcd; (void) contrast; return HAL_OK; }
+
+uint8_t HEL_LCD_Intensity( LCD_HandleTypeDef *hlcd, uint8_t intensity ) { (void) hlcd; (void) intensity; return HAL_OK; }
+
+uint8_t Analogs_GetContrast( void ) { return 0u; }
+
+uint8_t Analogs_GetIntensity( void ) { return 0u; }
+/* cppcheck-suppress-end misra-c2012-8.4 */
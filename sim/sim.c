@@ -0,0 +1,584 @@
+/**
+ * @file    sim.c
+ *
+ * @brief   Host simulation of the firmware, runs days of the clock in seconds.
+ *
+ * The main function of the firmware runs unchanged on top of the virtual HAL of sim_hal.c, the
+ * scheduler sleeps in simulated time and the tasks are charged with the cost of SimCost, so the
+ * CPU load reported is the one of the board. The scenario sets the time and date a couple of minutes
+ * before a new year with a single ISO-TP transfer on the CONFIG ID, a first frame and a consecutive
+ * frame sent when the flow control of the firmware arrives, then every day sets the alarm at 07:30
+ * with a burst of SERIAL_RX_FIFO_N frames, read by a single FDCAN interrupt, and on odd days stops it
+ * with the button, while the outputs of the firmware are checked against the simulated RTC:
+ *
+ * - the time on the LCD is the one of the RTC, refreshed every second out of the alarm
+ * - the date on the LCD is the one of the RTC
+ * - the alarm fires once a day at 07:30, and the buzzer stops after one minute or when the button
+ *   is pressed
+ * - the WWDG is refreshed inside its window
+ * - every CAN frame, or transfer on the CONFIG ID, gets an OK response
+ * - the CPU load is sent on CAN every second, when the firmware is built with CPU_LOAD_CAN
+ * - the firmware never calls safe_state
+ * - the trace ring has the FDCAN interrupts of the first frames, when the firmware is built with TRACE,
+ *   with SERIAL_RX_WATERMARK those frames don't fill the FIFO0 and the serial task reads them instead
+ *
+ * The trace ring is frozen when the LCD shows the date for the first time, so it ends with the path
+ * of the CONFIG frames from the FDCAN interrupt to the LCD, and it's written at the end in
+ * the file given, to convert it with trace2json like a dump of the board.
+ *
+ * The program returns zero when all the checks pass. Usage: sim [days] [trace file], one day by
+ * default.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bsp.h"
+#include "serial.h"
+#include "sim.h"
+
+#define SIM_TASKS           6u          /*!< Tasks registered by main.c */
+#define SIM_DAY_S           86400ull    /*!< Seconds in one day */
+#define SIM_EXTRA_S         60ull       /*!< Simulated seconds past the days, the first midnight is two minutes after the boot */
+#define SIM_CONFIG_AT       ( 500ull * SIM_US_PER_MS )  /*!< Time of the first frame of the CONFIG transfer */
+#define SIM_SET_AT          ( 600ull * SIM_US_PER_MS )  /*!< Time the time and date are set by, the LCD is checked from then */
+#define SIM_FRAME_US        1000ull     /*!< Delay of the CAN frames and button edges sent by the scenario */
+#define SIM_RELEASE_US      ( 300ull * SIM_US_PER_MS )  /*!< Time the button is pressed */
+#define SIM_BUZZER_US       ( 61ull * SIM_US_PER_S )    /*!< Max time with the buzzer on since the alarm */
+#define SIM_BUTTON_US       ( 200ull * SIM_US_PER_MS )  /*!< Max time with the buzzer on since the button */
+#define SIM_GAP_US          ( 1200ull * SIM_US_PER_MS ) /*!< Max time between LCD time refreshes */
+#define SIM_WWDG_MIN_US     ( 110ull * SIM_US_PER_MS )  /*!< Start of the WWDG window */
+#define SIM_WWDG_MAX_US     ( 262ull * SIM_US_PER_MS )  /*!< End of the WWDG window */
+#define SIM_ALARM_HOUR      7u          /*!< Hour of the alarm */
+#define SIM_ALARM_MINUTE    30u         /*!< Minute of the alarm */
+#define SIM_SET_HOUR        6u          /*!< Hour the alarm is set every day */
+#define SIM_PRESS_SECOND    10u         /*!< Second of the alarm minute the button is pressed */
+#define SIM_TIME_COLUMN     2u          /*!< Column of the time in the second row of the LCD */
+#define SIM_TIME_END        ( SIM_TIME_COLUMN + 8u )    /*!< Column of the cursor after the whole time is written */
+#define SIM_DATE_COLUMN     5u          /*!< Column of the day of the month in the first row of the LCD */
+#define SIM_ALARM_TEXT      "ALARM!!!"  /*!< Message shown in the second row of the LCD while the alarm is active */
+
+static void Sim_Task( unsigned char task );
+
+static void Sim_Task1( void );
+
+static void Sim_Task2( void );
+
+static void Sim_Task3( void );
+
+static void Sim_Task4( void );
+
+static void Sim_Task5( void );
+
+static void Sim_Task6( void );
+
+static void Sim_Fail( const char *check );
+
+static void Sim_Report( double wall );
+
+#ifdef TRACE
+static unsigned char Sim_Trace( const char *file );
+#endif
+
+static void Sim_TpConsecutive( const uint8_t *control );
+
+int App_Main( void );
+
+/** @brief  Cost in us of each task, in the order of main.c: serial, clock, heartbeat, display, LCD and watchdog,
+ * the LCD bytes and CAN frames are charged apart by the virtual HAL */
+static const unsigned long SimCost[ SIM_TASKS ] = { 25u, 40u, 5u, 30u, 60u, 5u };
+/** @brief  Trampolines that run each task and charge its cost */
+static void ( *const SimTrampolines[ SIM_TASKS ] )( void ) = { Sim_Task1, Sim_Task2, Sim_Task3, Sim_Task4, Sim_Task5, Sim_Task6 };
+/** @brief  Task functions registered by main.c */
+static void ( *SimTasks[ SIM_TASKS ] )( void );
+/** @brief  Simulated time when the simulation ends */
+static unsigned long long SimEnd = 0u;
+/** @brief  Number of checks failed */
+static unsigned long SimFails = 0u;
+/** @brief  Midnights crossed since the date was set */
+static unsigned long SimMidnights = 0u;
+/** @brief  Number of alarms fired */
+static unsigned long SimAlarms = 0u;
+/** @brief  Time of the last alarm */
+static unsigned long long SimAlarmAt = 0u;
+/** @brief  Time the alarm message was shown on the LCD after the last alarm */
+static unsigned long long SimAlarmShownAt = 0u;
+/** @brief  Time the buzzer must be off by, after the alarm or the button */
+static unsigned long long SimBuzzerDeadline = 0u;
+/** @brief  TRUE while the buzzer sounds */
+static unsigned char SimBuzzer = FALSE;
+/** @brief  Time of the last time refresh on the LCD */
+static unsigned long long SimTimeAt = 0u;
+/** @brief  Max time between time refreshes on the LCD out of the alarm */
+static unsigned long long SimMaxGap = 0u;
+/** @brief  Time of the last WWDG refresh */
+static unsigned long long SimWwdgAt = 0u;
+/** @brief  Min time between WWDG refreshes */
+static unsigned long long SimWwdgMin = ~0ull;
+/** @brief  Max time between WWDG refreshes */
+static unsigned long long SimWwdgMax = 0u;
+/** @brief  CAN frames sent by the scenario */
+static unsigned long SimFrames = 0u;
+/** @brief  OK responses of the firmware */
+static unsigned long SimResponses = 0u;
+/** @brief  CPU load frames sent by the firmware */
+static unsigned long SimLoads = 0u;
+/** @brief  Peak CPU load of the last load frame, in 0.01 % */
+static unsigned short SimLoadPeak = 0u;
+/** @brief  Payload of the CONFIG transfer, 23:58:00 and 31/12/2023 */
+static const uint8_t SimConfig[ ] = { SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_DATE, 0x31u, 0x12u, 0x20u, 0x23u };
+/** @brief  Bytes of SimConfig already sent */
+static uint8_t SimConfigSent = 0u;
+/** @brief  Day of the month shown on the LCD */
+static unsigned char SimShownDate = 0u;
+
+/**
+ * @brief   Entry point of the simulation.
+ *
+ * @param   argc [in] Number of arguments.
+ * @param   argv [in] Arguments, the number of days to simulate and the file for the trace ring.
+ *
+ * @retval  Zero when all the checks pass.
+*/
+int main( int argc, char *argv[] )
+{
+    uint8_t first[ N_BYTES_CAN_MSG ] = { TP_FIRST_FRAME, (uint8_t) sizeof( SimConfig ) };
+    const unsigned long days = ( argc > 1 ) ? strtoul( argv[ 1 ], NULL, 10 ) : 1u;
+    const clock_t start = clock( );
+
+    SimEnd = ( ( days * SIM_DAY_S ) + SIM_EXTRA_S ) * SIM_US_PER_S;
+
+    (void) memcpy( &first[ 2 ], SimConfig, TP_FF_BYTES );
+    SimConfigSent = TP_FF_BYTES;
+
+    Sim_Init( );
+    Sim_CanRx( SIM_CONFIG_AT, ID_CONFIG_MSG, first, sizeof( first ) );
+    SimFrames = 1u;     /*the whole transfer gets one response*/
+
+    (void) App_Main( );
+
+    Sim_Report( (double) ( clock( ) - start ) / CLOCKS_PER_SEC );
+
+    if( SimMidnights != days )
+    {
+        Sim_Fail( "midnights crossed" );
+    }
+
+    if( SimAlarms != days )
+    {
+        Sim_Fail( "one alarm a day" );
+    }
+
+    if( SimResponses != SimFrames )
+    {
+        Sim_Fail( "CAN responses" );
+    }
+
+    if( SimShownDate != Sim_Rtc( )->Date )
+    {
+        Sim_Fail( "date on the LCD" );
+    }
+
+#ifdef CPU_LOAD_CAN
+    /*one frame per second, the last one could be still in the queue of the serial task*/
+    if( ( ( SimLoads + 1u ) < ( Sim_Now( ) / SIM_US_PER_S ) ) || ( SimLoadPeak > SCHED_LOAD_FULL ) )
+    {
+        Sim_Fail( "CPU load on CAN" );
+    }
+#endif
+
+#ifdef TRACE
+    if( Sim_Trace( ( argc > 2 ) ? argv[ 2 ] : NULL ) == FALSE )
+    {
+        Sim_Fail( "trace ring" );
+    }
+#endif
+
+    (void) printf( "%s, %lu checks failed\n", ( SimFails == 0u ) ? "PASS" : "FAIL", SimFails );
+
+    return ( SimFails == 0u ) ? 0 : 1;
+}
+
+/**
+ * @brief   Condition of the scheduler loop, FOREVER in the simulation.
+ *
+ * The first call, once the tasks are registered and initialized, replaces the task functions by
+ * the trampolines that charge its cost.
+ *
+ * @retval  FALSE when the simulated time ends or the firmware called safe_state.
+*/
+unsigned char Sim_Running( void )
+{
+    static unsigned char hooked = FALSE;
+
+    if( hooked == FALSE )
+    {
+        hooked = TRUE;
+
+        for( unsigned char i = 0u; i < SIM_TASKS; i++ )
+        {
+            SimTasks[ i ] = Scheduler.taskPtr[ i ].taskFunc;
+            Scheduler.taskPtr[ i ].taskFunc = SimTrampolines[ i ];
+        }
+    }
+
+    return ( ( Sim_Now( ) < SimEnd ) && ( Sim_Stopped( ) == FALSE ) ) ? TRUE : FALSE;
+}
+
+/**
+ * @brief   Safe state of the simulation, reports the error and ends the simulation.
+ *
+ * @param   file [in] File where the error was detected.
+ * @param   line [in] Line where the error was detected.
+ * @param   error [in] Error code.
+*/
+void safe_state( const char *file, uint32_t line, uint8_t error )
+{
+    (void) printf( "safe_state at %.6f s: %s:%u error %u\n", (double) Sim_Now( ) / SIM_US_PER_S, file, (unsigned) line, (unsigned) error );
+    SimFails++;
+    Sim_Stop( );
+}
+
+/**
+ * @brief   Called after each second of the RTC, runs the daily scenario and checks the buzzer.
+*/
+void Sim_OnSecond( void )
+{
+    static const uint8_t alarm[ ] = { 2u, 0x07u, 0x30u };      /*07:30*/
+    const Sim_Calendar *rtc = Sim_Rtc( );
+    const unsigned long long now = Sim_Now( );
+
+    if( ( now > SIM_SET_AT ) && ( rtc->Hours == 0u ) && ( rtc->Minutes == 0u ) && ( rtc->Seconds == 0u ) )
+    {
+        SimMidnights++;
+    }
+
+    if( ( rtc->Hours == SIM_SET_HOUR ) && ( rtc->Minutes == 0u ) && ( rtc->Seconds == 0u ) )
+    {
+        for( uint8_t i = 0u; i < SERIAL_RX_FIFO_N; i++ )
+        {
+            Sim_CanRx( now + SIM_FRAME_US, ID_ALARM_MSG, alarm, sizeof( alarm ) );  /*the alarm is cleared after it fires*/
+            SimFrames++;
+        }
+    }
+
+    if( ( ( SimMidnights % 2u ) == 1u ) && ( rtc->Hours == SIM_ALARM_HOUR ) && ( rtc->Minutes == SIM_ALARM_MINUTE ) &&
+        ( rtc->Seconds == SIM_PRESS_SECOND ) )
+    {
+        Sim_Button( now + SIM_FRAME_US, TRUE );
+        Sim_Button( now + SIM_FRAME_US + SIM_RELEASE_US, FALSE );
+        SimBuzzerDeadline = now + SIM_FRAME_US + SIM_BUTTON_US;
+    }
+
+    if( ( SimBuzzer == TRUE ) && ( now > SimBuzzerDeadline ) )
+    {
+        Sim_Fail( "buzzer stops" );
+        SimBuzzerDeadline = ~0ull;      /*report it once*/
+    }
+}
+
+/**
+ * @brief   Called when the RTC alarm fires.
+*/
+void Sim_OnAlarm( void )
+{
+    const Sim_Calendar *rtc = Sim_Rtc( );
+
+    SimAlarms++;
+    SimAlarmAt = Sim_Now( );
+    SimBuzzerDeadline = SimAlarmAt + SIM_BUZZER_US;
+
+    if( ( rtc->Hours != SIM_ALARM_HOUR ) || ( rtc->Minutes != SIM_ALARM_MINUTE ) || ( rtc->Seconds != 0u ) )
+    {
+        Sim_Fail( "alarm time" );
+    }
+}
+
+/**
+ * @brief   Called when a row of the LCD is written, checks the time and date shown.
+ *
+ * The time is checked only when the write ends at the last column of the time, the other writes
+ * of the second row, like the temperature, leave the time written before on the LCD.
+ * The gap between time refreshes is not counted from a refresh drawn before the alarm message,
+ * it can be on its way to the LCD when the alarm fires.
+ *
+ * @param   row [in] Row written.
+ * @param   column [in] Column of the cursor after the write.
+ * @param   text [in] Characters of the row.
+*/
+void Sim_OnLcd( uint8_t row, uint8_t column, const char *text )
+{
+    const Sim_Calendar *rtc = Sim_Rtc( );
+    const unsigned long long now = Sim_Now( );
+    const char *t = &text[ SIM_TIME_COLUMN ];
+    unsigned int hours;
+    unsigned int minutes;
+    unsigned int seconds;
+    unsigned int date;
+    long diff;
+
+    if( ( row == 1u ) && ( t[ 2 ] == ':' ) && ( t[ 5 ] == ':' ) && ( sscanf( t, "%2u:%2u:%2u", &hours, &minutes, &seconds ) == 3 ) )
+    {
+        /*the time is written a character at a time, only the whole time is checked*/
+        if( ( column == SIM_TIME_END ) && ( t[ 7 ] >= '0' ) && ( t[ 7 ] <= '9' ) && ( now >= SIM_SET_AT ) )
+        {
+            diff = ( ( ( (long) rtc->Hours * 60 ) + rtc->Minutes ) * 60 ) + rtc->Seconds;
+            diff -= ( ( ( (long) hours * 60 ) + minutes ) * 60 ) + seconds;
+            diff = ( diff + (long) SIM_DAY_S ) % (long) SIM_DAY_S;
+
+            if( diff > 1 )
+            {
+                Sim_Fail( "time on the LCD" );
+            }
+
+            /*the refreshes stop while the alarm message is shown, a refresh drawn over it is counted*/
+            if( ( SimTimeAt > SimAlarmShownAt ) && ( ( now - SimTimeAt ) > SimMaxGap ) )
+            {
+                SimMaxGap = now - SimTimeAt;
+
+                if( SimMaxGap > SIM_GAP_US )
+                {
+                    Sim_Fail( "time refreshed every second" );
+                }
+            }
+
+            SimTimeAt = now;
+        }
+    }
+
+    if( ( row == 1u ) && ( SimAlarmShownAt < SimAlarmAt ) && ( strstr( text, SIM_ALARM_TEXT ) != NULL ) )
+    {
+        SimAlarmShownAt = now;
+    }
+
+    if( ( row == 0u ) && ( sscanf( &text[ SIM_DATE_COLUMN ], "%2u", &date ) == 1 ) && ( now >= SIM_SET_AT ) )
+    {
+#ifdef TRACE
+        if( SimShownDate == 0u )
+        {
+            AppTrace_enable( FALSE );   /*keep the events from the CAN frames to the first date shown*/
+        }
+#endif
+        SimShownDate = (unsigned char) date;
+
+        if( ( date != rtc->Date ) && ( ( rtc->Hours != 0u ) || ( rtc->Minutes != 0u ) || ( rtc->Seconds > 1u ) ) )
+        {
+            Sim_Fail( "date on the LCD" );
+        }
+    }
+}
+
+/**
+ * @brief   Called when the buzzer is turned on or off.
+ *
+ * @param   on [in] TRUE when the buzzer is turned on.
+*/
+void Sim_OnBuzzer( unsigned char on )
+{
+    SimBuzzer = on;
+}
+
+/**
+ * @brief   Called on each refresh of the WWDG, checks its window.
+*/
+void Sim_OnWatchdog( void )
+{
+    const unsigned long long interval = Sim_Now( ) - SimWwdgAt;
+
+    SimWwdgMin = ( interval < SimWwdgMin ) ? interval : SimWwdgMin;
+    SimWwdgMax = ( interval > SimWwdgMax ) ? interval : SimWwdgMax;
+
+    if( ( interval < SIM_WWDG_MIN_US ) || ( interval > SIM_WWDG_MAX_US ) )
+    {
+        Sim_Fail( "WWDG window" );
+    }
+
+    SimWwdgAt = Sim_Now( );
+}
+
+/**
+ * @brief   Called on each CAN frame sent, counts the OK responses and the CPU load frames, and
+ *          answers the flow controls of the CONFIG transfer.
+ *
+ * @param   id [in] Identifier of the frame.
+ * @param   data [in] Bytes of the frame.
+*/
+void Sim_OnCanTx( uint32_t id, const uint8_t *data )
+{
+    if( ( id == RESPONSE_ID ) && ( data[ 1 ] == OK_RESPONSE ) )
+    {
+        SimResponses++;
+    }
+
+    if( ( id == RESPONSE_ID ) && ( data[ 0 ] == ( TP_FLOW_CONTROL | TP_FC_CTS ) ) )
+    {
+        Sim_TpConsecutive( data );
+    }
+
+    if( ( id == LOAD_ID ) && ( data[ 0 ] == N_BYTES_LOAD ) )
+    {
+        SimLoads++;
+        SimLoadPeak = (unsigned short) ( ( (unsigned) data[ 3 ] << 8u ) | data[ 4 ] );
+    }
+}
+
+/**
+ * @brief   Schedule the consecutive frames of the CONFIG transfer asked by a flow control.
+ *
+ * The frames are sent as a tester would, the block size and STmin of the flow control are honored.
+ *
+ * @param   control [in] Bytes of the flow control.
+*/
+static void Sim_TpConsecutive( const uint8_t *control )
+{
+    uint8_t frame[ N_BYTES_CAN_MSG ];
+    unsigned long long at = Sim_Now( );
+    const unsigned long long gap = ( control[ 2 ] <= TP_STMIN_MAX_MS ) ? ( control[ 2 ] * SIM_US_PER_MS ) : 0u;
+    uint8_t block = 0u;
+
+    while( ( SimConfigSent < sizeof( SimConfig ) ) && ( ( control[ 1 ] == 0u ) || ( block < control[ 1 ] ) ) )
+    {
+        uint8_t size = (uint8_t) ( sizeof( SimConfig ) - SimConfigSent );
+
+        size = ( size > TP_CF_BYTES ) ? TP_CF_BYTES : size;
+        block++;
+
+        (void) memset( frame, 0, sizeof( frame ) );
+        frame[ 0 ] = TP_CONSECUTIVE_FRAME | ( ( ( SimConfigSent / TP_CF_BYTES ) + 1u ) & LS_NIBBLE_MASK );   /*sequence number from 1*/
+        (void) memcpy( &frame[ 1 ], &SimConfig[ SimConfigSent ], size );
+        SimConfigSent += size;
+
+        at += ( gap > SIM_FRAME_US ) ? gap : SIM_FRAME_US;
+        Sim_CanRx( at, ID_CONFIG_MSG, frame, sizeof( frame ) );
+    }
+}
+
+/**
+ * @brief   Run a task and charge its cost.
+ *
+ * @param   task [in] Index of the task.
+*/
+static void Sim_Task( unsigned char task )
+{
+    SimTasks[ task ]( );
+    Sim_Run( SimCost[ task ], FALSE );
+}
+
+/** @brief  Trampoline of the first task */
+static void Sim_Task1( void ) { Sim_Task( 0u ); }
+
+/** @brief  Trampoline of the second task */
+static void Sim_Task2( void ) { Sim_Task( 1u ); }
+
+/** @brief  Trampoline of the third task */
+static void Sim_Task3( void ) { Sim_Task( 2u ); }
+
+/** @brief  Trampoline of the fourth task */
+static void Sim_Task4( void ) { Sim_Task( 3u ); }
+
+/** @brief  Trampoline of the fifth task */
+static void Sim_Task5( void ) { Sim_Task( 4u ); }
+
+/** @brief  Trampoline of the sixth task */
+static void Sim_Task6( void ) { Sim_Task( 5u ); }
+
+/**
+ * @brief   Report a failed check with the simulated time and the calendar of the RTC.
+ *
+ * @param   check [in] Name of the check.
+*/
+static void Sim_Fail( const char *check )
+{
+    const Sim_Calendar *rtc = Sim_Rtc( );
+
+    (void) printf( "check failed at %.6f s (%02u/%02u/%02u %02u:%02u:%02u): %s\n", (double) Sim_Now( ) / SIM_US_PER_S,
+        rtc->Date, rtc->Month, rtc->Year, rtc->Hours, rtc->Minutes, rtc->Seconds, check );
+    SimFails++;
+}
+
+/**
+ * @brief   Print the CPU use of each task and the scheduler counters.
+ *
+ * @param   wall [in] Seconds of host time spent in the simulation.
+*/
+static void Sim_Report( double wall )
+{
+    static const char *const names[ SIM_TASKS ] = { "serial", "clock", "heartbeat", "display", "lcd", "watchdog" };
+    const double total = (double) Sim_Now( );
+    AppSched_Stats stats;
+    unsigned short load;
+    unsigned short peak;
+    unsigned long frames;
+    unsigned long irqs;
+
+    (void) printf( "simulated %.1f s in %.2f s of wall time\n", total / SIM_US_PER_S, wall );
+    (void) printf( "%-10s %10s %9s %9s %7s %9s %7s\n", "task", "runs", "avg us", "max us", "cpu %", "overruns", "skips" );
+
+    for( unsigned char i = 0u; i < SIM_TASKS; i++ )
+    {
+        if( AppSched_statsTask( &Scheduler, i + 1u, &stats ) == TRUE )
+        {
+            (void) printf( "%-10s %10lu %9lu %9lu %7.3f %9lu %7lu\n", names[ i ], stats.runs, stats.avgTime, stats.maxTime,
+                ( 100.0 * (double) stats.totalTime ) / total, stats.overruns, stats.skips );
+        }
+    }
+
+    (void) printf( "idle %.3f %%, late ticks %lu, max late %lu ms\n", ( 100.0 * (double) Sim_Slept( ) ) / total,
+        Scheduler.lateTicks, Scheduler.maxLate );
+    load = AppSched_cpuLoad( &Scheduler, &peak );
+    (void) printf( "cpu load %.2f %%, peak %.2f %%, %lu load frames on CAN\n", (double) load / 100.0, (double) peak / 100.0,
+        SimLoads );
+    (void) printf( "wwdg refresh %.1f to %.1f ms, lcd time max gap %.1f ms, %lu alarms, %lu/%lu responses\n",
+        (double) SimWwdgMin / SIM_US_PER_MS, (double) SimWwdgMax / SIM_US_PER_MS, (double) SimMaxGap / SIM_US_PER_MS,
+        SimAlarms, SimResponses, SimFrames );
+    frames = Sim_CanFrames( &irqs );
+    (void) printf( "%lu CAN frames received in %lu FDCAN interrupts\n", frames, irqs );
+}
+
+#ifdef TRACE
+/**
+ * @brief   Check the trace ring and write it in a file.
+ *
+ * The ring is written as it is in the RAM of the board, the same bytes of a dump taken with gdb.
+ *
+ * @param   file [in] File to write, NULL to only check the ring.
+ *
+ * @retval  TRUE when the ring has a FDCAN interrupt and it was written.
+*/
+static unsigned char Sim_Trace( const char *file )
+{
+    unsigned char found = FALSE;
+    unsigned char varRet = FALSE;
+    FILE *dump;
+
+#ifdef SERIAL_RX_WATERMARK
+    found = ( TraceRing.Head > 0u ) ? TRUE : FALSE;     /*the first frames don't interrupt*/
+#endif
+
+    for( uint32_t i = 0u; i < TRACE_RECORDS; i++ )
+    {
+        if( ( TraceRing.Records[ i ].Event == TRACE_ISR_ENTER ) && ( TraceRing.Records[ i ].Id == TRACE_ISR_FDCAN ) )
+        {
+            found = TRUE;
+        }
+    }
+
+    if( ( found == TRUE ) && ( file != NULL ) )
+    {
+        dump = fopen( file, "wb" );
+
+        if( dump != NULL )
+        {
+            varRet = ( fwrite( &TraceRing, sizeof( TraceRing ), 1u, dump ) == 1u ) ? TRUE : FALSE;
+            (void) fclose( dump );
+            (void) printf( "trace ring of %lu events written in %s\n", (unsigned long) TraceRing.Head, file );
+        }
+    }
+    else
+    {
+        varRet = found;
+    }
+
+    return varRet;
+}
+#endif
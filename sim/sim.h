@@ -0,0 +1,64 @@
+/**
+ * @file    sim.h
+ *
+ * @brief   Functions shared by the host simulation and its virtual HAL.
+ *
+ * The virtual HAL in sim_hal.c keeps the simulated clock, the RTC calendar and the interrupts
+ * scheduled by the scenario, and calls the Sim_On functions of sim.c when the firmware produces an
+ * output, so the scenario can check it.
+*/
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+#define SIM_US_PER_MS       1000ull         /*!< us in one ms */
+#define SIM_US_PER_S        1000000ull      /*!< us in one second */
+
+/**
+ * @brief   Struct with the calendar of the simulated RTC, in binary format.
+*/
+typedef struct
+{
+    uint8_t Hours;      /*!< hours, range 0 to 23 */
+    uint8_t Minutes;    /*!< minutes, range 0 to 59 */
+    uint8_t Seconds;    /*!< seconds, range 0 to 59 */
+    uint8_t Date;       /*!< day of the month, range 1 to 31 */
+    uint8_t Month;      /*!< month, range 1 to 12 */
+    uint8_t Year;       /*!< last two digits of the year, 20xx */
+    uint8_t WeekDay;    /*!< day of the week, 1 (monday) to 7 (sunday) */
+} Sim_Calendar;
+
+void Sim_Init( void );
+
+unsigned long long Sim_Now( void );
+
+void Sim_Run( unsigned long long us, unsigned char wake );
+
+unsigned long long Sim_Slept( void );
+
+unsigned long Sim_CanFrames( unsigned long *irqs );
+
+void Sim_Stop( void );
+
+unsigned char Sim_Stopped( void );
+
+void Sim_CanRx( unsigned long long at, uint16_t id, const uint8_t *data, uint8_t size );
+
+void Sim_Button( unsigned long long at, unsigned char pressed );
+
+const Sim_Calendar *Sim_Rtc( void );
+
+void Sim_OnSecond( void );
+
+void Sim_OnAlarm( void );
+
+void Sim_OnLcd( uint8_t row, uint8_t column, const char *text );
+
+void Sim_OnBuzzer( unsigned char on );
+
+void Sim_OnWatchdog( void );
+
+void Sim_OnCanTx( uint32_t id, const uint8_t *data );
+
+#endif
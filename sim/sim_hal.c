@@ -0,0 +1,819 @@
+/**
+ * @file    sim_hal.c
+ *
+ * @brief   Virtual HAL of the host simulation, the clock of the board runs in simulated time.
+ *
+ * The time is a count of us that only moves when the firmware spends it: the tasks and the LCD and
+ * CAN transfers are charged with their estimated cost, and the idle function of the scheduler jumps
+ * straight to its wake up, or to the first interrupt scheduled before it. On the way the RTC counts
+ * the seconds of its calendar and fires the alarm A, the TIM6 counter of the scheduler monitoring
+ * overflows every 65.5 s, and the CAN frames and button edges of the scenario are delivered to the
+ * callbacks of the firmware, the same ones called by the interrupts of the board. The CAN frames go
+ * through a FIFO0 of SERIAL_RX_FIFO_N elements like the one of the FDCAN, the frames delivered at the
+ * same time are served by a single interrupt, and the callback is only called for the interrupts
+ * enabled by the firmware, a new frame or the FIFO0 full. The standard filters configured by the
+ * firmware accept the frames, the rest are rejected, and the index of the filter that accepted a
+ * frame is in its header.
+ *
+ * The registers written by the firmware, like the clock enables of the RCC, go to a block of host
+ * memory mapped at the address of the peripherals, TIM6 and TIM7 counters are kept there with the
+ * simulated time. The mapping uses a fixed address, so the simulation can not be built with the
+ * address sanitizer.
+*/
+#define _DEFAULT_SOURCE     /* MAP_ANONYMOUS */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "bsp.h"
+#include "analogs.h"
+#include "serial.h"
+#include "sim.h"
+
+#define SIM_PERIPH_SIZE     0x30000u    /*!< Bytes mapped from PERIPH_BASE, APB and AHB peripherals */
+#define SIM_IRQS            8u          /*!< Max number of interrupts scheduled at the same time */
+#define SIM_IRQ_CAN         0u          /*!< Interrupt of a CAN frame received in the FIFO0 */
+#define SIM_IRQ_PRESS       1u          /*!< Interrupt of the button falling edge */
+#define SIM_IRQ_RELEASE     2u          /*!< Interrupt of the button rising edge */
+#define SIM_TIM6_US         ( 65536ull * SIM_US_PER_MS )    /*!< us between TIM6 overflows, 1 ms count */
+#define SIM_LCD_BYTE_US     30u         /*!< Cost of a byte sent to the LCD, 8 bits at 500 kHz plus the HAL */
+#define SIM_CAN_TX_US       20u         /*!< Cost of a frame written in the FDCAN TX FIFO */
+#define SIM_TX_FIFO_N       3u          /*!< Elements of the TX FIFO, always free since the frames are sent as they are added */
+#define SIM_LCD_ROWS        2u          /*!< Rows of the LCD */
+#define SIM_LCD_COLUMNS     16u         /*!< Characters in a row of the LCD */
+#define SIM_LEAP_YEAR       4u          /*!< The years 20xx multiple of four are leap years */
+#define SIM_DAYS_WEEK       7u          /*!< Days in a week */
+
+/**
+ * @brief   Struct with an interrupt scheduled by the scenario.
+*/
+typedef struct
+{
+    unsigned long long At;  /*!< Simulated time of the interrupt in us */
+    uint8_t Kind;           /*!< SIM_IRQ_CAN, SIM_IRQ_PRESS or SIM_IRQ_RELEASE */
+    uint16_t Id;            /*!< Identifier of the CAN frame */
+    uint8_t Size;           /*!< Number of bytes of the CAN frame */
+    uint8_t Data[ 8 ];      /*!< Bytes of the CAN frame */
+} Sim_Irq;
+
+static unsigned char Sim_Event( void );
+
+static void Sim_Second( void );
+
+static void Sim_Schedule( const Sim_Irq *irq );
+
+static void Sim_Registers( void );
+
+static uint8_t Sim_ToBin( uint8_t value, uint32_t format );
+
+static uint8_t Sim_FromBin( uint8_t value, uint32_t format );
+
+static void Sim_LcdWrite( uint8_t character );
+
+static uint32_t Sim_Filter( uint16_t id );
+
+/** @brief  Simulated time in us */
+static unsigned long long SimNow = 0u;
+/** @brief  Time in us spent in the idle function */
+static unsigned long long SimSleptUs = 0u;
+/** @brief  Time of the next second of the RTC */
+static unsigned long long SimNextSecond = SIM_US_PER_S;
+/** @brief  Time of the next TIM6 overflow */
+static unsigned long long SimNextTim6 = SIM_TIM6_US;
+/** @brief  TRUE when the simulation must end, after an error of the firmware */
+static unsigned char SimStop = FALSE;
+/** @brief  Calendar of the RTC */
+static Sim_Calendar SimCalendar = { 0u, 0u, 0u, 1u, 1u, 0u, 6u };
+/** @brief  Alarm A of the RTC, in binary format */
+static RTC_AlarmTypeDef SimAlarm;
+/** @brief  TRUE when the alarm A is enabled */
+static unsigned char SimAlarmOn = FALSE;
+/** @brief  Interrupts scheduled, sorted by time */
+static Sim_Irq SimIrqs[ SIM_IRQS ];
+/** @brief  Number of interrupts scheduled */
+static unsigned long SimIrqsCount = 0u;
+/** @brief  Frames in the FIFO0, the first one is read by HAL_FDCAN_GetRxMessage */
+static Sim_Irq SimRxFifo[ SERIAL_RX_FIFO_N ];
+/** @brief  Number of frames in the FIFO0 */
+static uint32_t SimRxCount = 0u;
+/** @brief  Standard filters configured by the firmware, by its index */
+static FDCAN_FilterTypeDef SimFilters[ FILTERS_N ];
+/** @brief  FDCAN interrupts enabled by the firmware */
+static uint32_t SimRxITs = 0u;
+/** @brief  Frames received in the FIFO0 */
+static unsigned long SimRxFrames = 0u;
+/** @brief  FDCAN interrupts served */
+static unsigned long SimRxIrqs = 0u;
+/** @brief  Characters of the LCD, each row ends with a zero */
+static char SimLcd[ SIM_LCD_ROWS ][ SIM_LCD_COLUMNS + 1u ];
+/** @brief  Row of the LCD cursor */
+static uint8_t SimLcdRow = 0u;
+/** @brief  Column of the LCD cursor */
+static uint8_t SimLcdColumn = 0u;
+
+/**
+ * @brief   Map the memory of the peripherals and clear the LCD.
+ *
+ * It must be called before any code of the firmware, the program ends if the memory can not be
+ * mapped.
+*/
+void Sim_Init( void )
+{
+    void *periph = mmap( (void *) PERIPH_BASE, SIM_PERIPH_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0 );
+
+    if( periph != (void *) PERIPH_BASE )
+    {
+        (void) fprintf( stderr, "sim: can not map the peripherals at 0x%08lx\n", (unsigned long) PERIPH_BASE );
+        exit( 1 );
+    }
+
+    (void) memset( SimLcd, ' ', sizeof( SimLcd ) );
+
+    for( uint8_t i = 0u; i < SIM_LCD_ROWS; i++ )
+    {
+        SimLcd[ i ][ SIM_LCD_COLUMNS ] = '\0';
+    }
+}
+
+/**
+ * @brief   Simulated time.
+ *
+ * @retval  Time in us since the board was powered.
+*/
+unsigned long long Sim_Now( void )
+{
+    return SimNow;
+}
+
+/**
+ * @brief   Move the simulated time forward.
+ *
+ * The RTC seconds, TIM6 overflows and interrupts on the way are processed in order, each one at
+ * its time.
+ *
+ * @param   us [in] Time to move in us.
+ * @param   wake [in] TRUE to stop at the first interrupt, as a CPU sleeping with WFI.
+*/
+void Sim_Run( unsigned long long us, unsigned char wake )
+{
+    const unsigned long long end = SimNow + us;
+    unsigned char woken = FALSE;
+    unsigned long long next;
+
+    while( woken == FALSE )
+    {
+        next = SimNextSecond;
+        next = ( SimNextTim6 < next ) ? SimNextTim6 : next;
+        next = ( ( SimIrqsCount > 0u ) && ( SimIrqs[ 0 ].At < next ) ) ? SimIrqs[ 0 ].At : next;
+
+        if( next > end )
+        {
+            break;
+        }
+
+        SimNow = next;
+        Sim_Registers( );
+
+        if( ( Sim_Event( ) == TRUE ) && ( wake == TRUE ) )
+        {
+            woken = TRUE;
+        }
+    }
+
+    if( woken == FALSE )
+    {
+        SimNow = end;
+    }
+
+    Sim_Registers( );
+}
+
+/**
+ * @brief   Idle function of the scheduler in the simulation, called by AppSched_sleep.
+ *
+ * As the SysTick reload of AppSched_sleep, the sleep ends at a ms boundary of the HAL tick, a
+ * single ms is just the next SysTick interrupt, and any interrupt wakes up the CPU before.
+ *
+ * @param   ms [in] Time to sleep in ms.
+*/
+void Sim_Sleep( unsigned long ms )
+{
+    const unsigned long long start = SimNow;
+    const unsigned long long ticks = ( ms > 1u ) ? ms : 1u;
+    const unsigned long long end = ( ( SimNow / SIM_US_PER_MS ) + ticks ) * SIM_US_PER_MS;
+
+    Sim_Run( end - SimNow, TRUE );
+
+    SimSleptUs += SimNow - start;
+}
+
+/**
+ * @brief   Time spent in the idle function.
+ *
+ * @retval  Time in us.
+*/
+unsigned long long Sim_Slept( void )
+{
+    return SimSleptUs;
+}
+
+/**
+ * @brief   Frames received and FDCAN interrupts served to read them.
+ *
+ * @param   irqs [out] Number of FDCAN interrupts.
+ *
+ * @retval  Number of frames received in the FIFO0.
+*/
+unsigned long Sim_CanFrames( unsigned long *irqs )
+{
+    *irqs = SimRxIrqs;
+
+    return SimRxFrames;
+}
+
+/**
+ * @brief   End the simulation at the next loop of the scheduler.
+*/
+void Sim_Stop( void )
+{
+    SimStop = TRUE;
+}
+
+/**
+ * @brief   Know if the simulation must end.
+ *
+ * @retval  TRUE after Sim_Stop.
+*/
+unsigned char Sim_Stopped( void )
+{
+    return SimStop;
+}
+
+/**
+ * @brief   Schedule the reception of a CAN frame.
+ *
+ * @param   at [in] Simulated time of the reception in us.
+ * @param   id [in] Standard identifier of the frame.
+ * @param   data [in] Bytes of the frame.
+ * @param   size [in] Number of bytes, up to 8.
+*/
+void Sim_CanRx( unsigned long long at, uint16_t id, const uint8_t *data, uint8_t size )
+{
+    Sim_Irq irq = { 0 };
+
+    irq.At   = at;
+    irq.Kind = SIM_IRQ_CAN;
+    irq.Id   = id;
+    irq.Size = ( size > sizeof( irq.Data ) ) ? (uint8_t) sizeof( irq.Data ) : size;
+    (void) memcpy( irq.Data, data, irq.Size );
+
+    Sim_Schedule( &irq );
+}
+
+/**
+ * @brief   Schedule an edge of the button.
+ *
+ * @param   at [in] Simulated time of the edge in us.
+ * @param   pressed [in] TRUE for the falling edge when it's pressed, FALSE when it's released.
+*/
+void Sim_Button( unsigned long long at, unsigned char pressed )
+{
+    Sim_Irq irq = { 0 };
+
+    irq.At   = at;
+    irq.Kind = ( pressed == TRUE ) ? SIM_IRQ_PRESS : SIM_IRQ_RELEASE;
+
+    Sim_Schedule( &irq );
+}
+
+/**
+ * @brief   Calendar of the RTC.
+ *
+ * @retval  Address of the calendar, read only.
+*/
+const Sim_Calendar *Sim_Rtc( void )
+{
+    return &SimCalendar;
+}
+
+/**
+ * @brief   Process the events at the current time.
+ *
+ * @retval  TRUE if an interrupt was served.
+*/
+static unsigned char Sim_Event( void )
+{
+    unsigned char irq = FALSE;
+    unsigned char rx = FALSE;
+
+    if( SimNextSecond == SimNow )
+    {
+        SimNextSecond += SIM_US_PER_S;
+        Sim_Second( );
+
+        if( ( SimAlarmOn == TRUE ) && ( SimAlarm.AlarmTime.Hours == SimCalendar.Hours ) &&
+            ( SimAlarm.AlarmTime.Minutes == SimCalendar.Minutes ) &&
+            ( ( ( SimAlarm.AlarmMask & RTC_ALARMMASK_SECONDS ) != 0u ) || ( SimAlarm.AlarmTime.Seconds == SimCalendar.Seconds ) ) )
+        {
+            Sim_OnAlarm( );
+            TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_RTC, 0u );
+            HAL_RTC_AlarmAEventCallback( &h_rtc );
+            TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_RTC, 0u );
+            irq = TRUE;
+        }
+
+        Sim_OnSecond( );
+    }
+
+    if( SimNextTim6 == SimNow )
+    {
+        SimNextTim6 += SIM_TIM6_US;
+        HAL_TIM_PeriodElapsedCallback( &TIM6_Handler );
+        irq = TRUE;
+    }
+
+    while( ( SimIrqsCount > 0u ) && ( SimIrqs[ 0 ].At == SimNow ) )
+    {
+        Sim_Irq event = SimIrqs[ 0 ];
+        SimIrqsCount--;
+        (void) memmove( &SimIrqs[ 0 ], &SimIrqs[ 1 ], SimIrqsCount * sizeof( Sim_Irq ) );
+
+        if( event.Kind == SIM_IRQ_CAN )
+        {
+            if( ( Sim_Filter( event.Id ) < FILTERS_N ) && ( SimRxCount < SERIAL_RX_FIFO_N ) )
+            {
+                SimRxFifo[ SimRxCount ] = event;    /*with the FIFO0 full the frame is lost, as the FDCAN does*/
+                SimRxCount++;
+                SimRxFrames++;
+                rx = TRUE;
+            }
+        }
+        else if( event.Kind == SIM_IRQ_PRESS )
+        {
+            TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_EXTI, 0u );
+            HAL_GPIO_EXTI_Falling_Callback( GPIO_PIN_15 );
+            TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_EXTI, 0u );
+            irq = TRUE;
+        }
+        else
+        {
+            TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_EXTI, 0u );
+            HAL_GPIO_EXTI_Rising_Callback( GPIO_PIN_15 );
+            TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_EXTI, 0u );
+            irq = TRUE;
+        }
+    }
+
+    if( ( ( rx == TRUE ) && ( ( SimRxITs & FDCAN_IT_RX_FIFO0_NEW_MESSAGE ) != 0u ) ) ||
+        ( ( SimRxCount == SERIAL_RX_FIFO_N ) && ( ( SimRxITs & FDCAN_IT_RX_FIFO0_FULL ) != 0u ) ) )
+    {
+        TRACE_EVENT( TRACE_ISR_ENTER, TRACE_ISR_FDCAN, 0u );
+        HAL_FDCAN_RxFifo0Callback( &CANHandler, SimRxITs );
+        TRACE_EVENT( TRACE_ISR_EXIT, TRACE_ISR_FDCAN, 0u );
+        SimRxIrqs++;
+        irq = TRUE;
+    }
+
+    return irq;
+}
+
+/**
+ * @brief   Count a second in the calendar of the RTC.
+ *
+ * The years 20xx multiple of four are leap years, the same range of the RTC.
+*/
+static void Sim_Second( void )
+{
+    static const uint8_t days[ 12 ] = { 31u, 28u, 31u, 30u, 31u, 30u, 31u, 31u, 30u, 31u, 30u, 31u };
+    uint8_t monthDays;
+
+    SimCalendar.Seconds++;
+
+    if( SimCalendar.Seconds == 60u )
+    {
+        SimCalendar.Seconds = 0u;
+        SimCalendar.Minutes++;
+    }
+
+    if( SimCalendar.Minutes == 60u )
+    {
+        SimCalendar.Minutes = 0u;
+        SimCalendar.Hours++;
+    }
+
+    if( SimCalendar.Hours == 24u )
+    {
+        SimCalendar.Hours = 0u;
+        SimCalendar.Date++;
+        SimCalendar.WeekDay = ( SimCalendar.WeekDay % SIM_DAYS_WEEK ) + 1u;
+
+        monthDays = days[ SimCalendar.Month - 1u ];
+
+        if( ( SimCalendar.Month == 2u ) && ( ( SimCalendar.Year % SIM_LEAP_YEAR ) == 0u ) )
+        {
+            monthDays++;
+        }
+
+        if( SimCalendar.Date > monthDays )
+        {
+            SimCalendar.Date = 1u;
+            SimCalendar.Month++;
+        }
+
+        if( SimCalendar.Month > 12u )
+        {
+            SimCalendar.Month = 1u;
+            SimCalendar.Year = ( SimCalendar.Year + 1u ) % 100u;
+        }
+    }
+}
+
+/**
+ * @brief   Insert an interrupt in the list sorted by time.
+ *
+ * The interrupts at the same time keep the order they were scheduled, one scheduled in the past
+ * is served at the current time, and the interrupt is dropped with a message when the list is full.
+ *
+ * @param   irq [in] Interrupt to schedule.
+*/
+static void Sim_Schedule( const Sim_Irq *irq )
+{
+    unsigned long i = SimIrqsCount;
+
+    if( SimIrqsCount == SIM_IRQS )
+    {
+        (void) fprintf( stderr, "sim: too many interrupts scheduled, the one at %llu us is dropped\n", irq->At );
+    }
+    else
+    {
+        while( ( i > 0u ) && ( SimIrqs[ i - 1u ].At > irq->At ) )
+        {
+            SimIrqs[ i ] = SimIrqs[ i - 1u ];
+            i--;
+        }
+
+        SimIrqs[ i ] = *irq;
+        SimIrqs[ i ].At = ( irq->At < SimNow ) ? SimNow : irq->At;   /*the past is served now*/
+        SimIrqsCount++;
+    }
+}
+
+/**
+ * @brief   Write the counters of TIM6 (1 ms) and TIM7 (1 us) with the simulated time.
+*/
+static void Sim_Registers( void )
+{
+    TIM6->CNT = (uint32_t) ( ( SimNow / SIM_US_PER_MS ) & 0xFFFFu );
+    TIM7->CNT = (uint32_t) ( SimNow & 0xFFFFu );
+}
+
+/**
+ * @brief   Convert a value of the RTC to binary.
+ *
+ * @param   value [in] Value in the format given.
+ * @param   format [in] RTC_FORMAT_BIN or RTC_FORMAT_BCD.
+ *
+ * @retval  Value in binary.
+*/
+static uint8_t Sim_ToBin( uint8_t value, uint32_t format )
+{
+    return ( format == RTC_FORMAT_BCD ) ? (uint8_t) ( ( ( value >> 4u ) * 10u ) + ( value & 0x0Fu ) ) : value;
+}
+
+/**
+ * @brief   Convert a binary value of the RTC to the format requested.
+ *
+ * @param   value [in] Value in binary.
+ * @param   format [in] RTC_FORMAT_BIN or RTC_FORMAT_BCD.
+ *
+ * @retval  Value in the format requested.
+*/
+static uint8_t Sim_FromBin( uint8_t value, uint32_t format )
+{
+    return ( format == RTC_FORMAT_BCD ) ? (uint8_t) ( ( ( value / 10u ) << 4u ) | ( value % 10u ) ) : value;
+}
+
+/**
+ * @brief   Write a character at the cursor of the LCD, the cursor moves to the next column.
+ *
+ * @param   character [in] Character to write.
+*/
+static void Sim_LcdWrite( uint8_t character )
+{
+    if( ( SimLcdRow < SIM_LCD_ROWS ) && ( SimLcdColumn < SIM_LCD_COLUMNS ) )
+    {
+        SimLcd[ SimLcdRow ][ SimLcdColumn ] = (char) character;
+        SimLcdColumn++;
+    }
+
+    Sim_Run( SIM_LCD_BYTE_US, FALSE );
+}
+
+/**
+ * @brief   Find the first filter of the FIFO0 that accepts a CAN frame.
+ *
+ * The mask filters accept the ID with the bits of the mask equal to the ones of the filter ID, the
+ * dual filters accept any of its two IDs.
+ *
+ * @param   id [in] Identifier of the CAN frame.
+ *
+ * @retval  Index of the filter, FILTERS_N when the frame is rejected.
+*/
+static uint32_t Sim_Filter( uint16_t id )
+{
+    uint32_t index = FILTERS_N;
+
+    for( uint32_t i = FILTERS_N; i > 0u; i-- )
+    {
+        const FDCAN_FilterTypeDef *filter = &SimFilters[ i - 1u ];
+        uint32_t match = FALSE;
+
+        if( filter->FilterType == FDCAN_FILTER_MASK )
+        {
+            match = ( ( id & filter->FilterID2 ) == ( filter->FilterID1 & filter->FilterID2 ) ) ? TRUE : FALSE;
+        }
+        else if( filter->FilterType == FDCAN_FILTER_DUAL )
+        {
+            match = ( ( id == filter->FilterID1 ) || ( id == filter->FilterID2 ) ) ? TRUE : FALSE;
+        }
+        else
+        {
+            /*the range filters are not used by the firmware*/
+        }
+
+        if( ( match == TRUE ) && ( filter->FilterConfig == FDCAN_FILTER_TO_RXFIFO0 ) )
+        {
+            index = i - 1u;     /*from the last filter to the first one, the first that accepts it stays*/
+        }
+    }
+
+    return index;
+}
+
+/* cppcheck-suppress-begin misra-c2012-8.4 ; the prototypes are in the HAL, LCD and analogs headers */
+uint32_t HAL_GetTick( void )
+{
+    return (uint32_t) ( SimNow / SIM_US_PER_MS );
+}
+
+HAL_StatusTypeDef HAL_Init( void ) { return HAL_OK; }
+
+void HAL_NVIC_SetPriority( IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority )
+{ (void) IRQn; (void) PreemptPriority; (void) SubPriority; }
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn ) { (void) IRQn; }
+
+void HAL_NVIC_DisableIRQ( IRQn_Type IRQn ) { (void) IRQn; }
+
+void HAL_GPIO_Init( GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init ) { (void) GPIOx; (void) GPIO_Init; }
+
+void HAL_GPIO_TogglePin( GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin ) { (void) GPIOx; (void) GPIO_Pin; }
+
+void HAL_GPIO_WritePin( GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState )
+{ (void) GPIOx; (void) GPIO_Pin; (void) PinState; }
+
+HAL_StatusTypeDef HAL_WWDG_Init( WWDG_HandleTypeDef *hwwdg ) { (void) hwwdg; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_WWDG_Refresh( WWDG_HandleTypeDef *hwwdg )
+{
+    (void) hwwdg;
+    Sim_OnWatchdog( );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init( TIM_HandleTypeDef *htim ) { (void) htim; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel( TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *sConfig, uint32_t Channel )
+{ (void) htim; (void) sConfig; (void) Channel; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start( TIM_HandleTypeDef *htim, uint32_t Channel )
+{
+    (void) Channel;
+    Sim_OnBuzzer( ( htim->Instance == TIM14 ) ? TRUE : FALSE );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop( TIM_HandleTypeDef *htim, uint32_t Channel )
+{
+    (void) Channel;
+    (void) htim;
+    Sim_OnBuzzer( FALSE );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Init( SPI_HandleTypeDef *hspi ) { (void) hspi; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_RTC_Init( RTC_HandleTypeDef *hrtc ) { (void) hrtc; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_RTC_SetTime( RTC_HandleTypeDef *hrtc, RTC_TimeTypeDef *sTime, uint32_t Format )
+{
+    (void) hrtc;
+    SimCalendar.Hours   = Sim_ToBin( sTime->Hours, Format );
+    SimCalendar.Minutes = Sim_ToBin( sTime->Minutes, Format );
+    SimCalendar.Seconds = Sim_ToBin( sTime->Seconds, Format );
+    SimNextSecond = SimNow + SIM_US_PER_S;      /*the prescalers start again*/
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime( RTC_HandleTypeDef *hrtc, RTC_TimeTypeDef *sTime, uint32_t Format )
+{
+    (void) hrtc;
+    sTime->Hours   = Sim_FromBin( SimCalendar.Hours, Format );
+    sTime->Minutes = Sim_FromBin( SimCalendar.Minutes, Format );
+    sTime->Seconds = Sim_FromBin( SimCalendar.Seconds, Format );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetDate( RTC_HandleTypeDef *hrtc, RTC_DateTypeDef *sDate, uint32_t Format )
+{
+    (void) hrtc;
+    SimCalendar.Date    = Sim_ToBin( sDate->Date, Format );
+    SimCalendar.Month   = Sim_ToBin( sDate->Month, Format );
+    SimCalendar.Year    = Sim_ToBin( sDate->Year, Format );
+    SimCalendar.WeekDay = sDate->WeekDay;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate( RTC_HandleTypeDef *hrtc, RTC_DateTypeDef *sDate, uint32_t Format )
+{
+    (void) hrtc;
+    sDate->Date    = Sim_FromBin( SimCalendar.Date, Format );
+    sDate->Month   = Sim_FromBin( SimCalendar.Month, Format );
+    sDate->Year    = Sim_FromBin( SimCalendar.Year, Format );
+    sDate->WeekDay = SimCalendar.WeekDay;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetAlarm_IT( RTC_HandleTypeDef *hrtc, RTC_AlarmTypeDef *sAlarm, uint32_t Format )
+{
+    (void) hrtc;
+    SimAlarm = *sAlarm;
+    SimAlarm.AlarmTime.Hours   = Sim_ToBin( sAlarm->AlarmTime.Hours, Format );
+    SimAlarm.AlarmTime.Minutes = Sim_ToBin( sAlarm->AlarmTime.Minutes, Format );
+    SimAlarm.AlarmTime.Seconds = Sim_ToBin( sAlarm->AlarmTime.Seconds, Format );
+    SimAlarmOn = TRUE;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetAlarm( RTC_HandleTypeDef *hrtc, RTC_AlarmTypeDef *sAlarm, uint32_t Alarm, uint32_t Format )
+{
+    (void) hrtc;
+    (void) Alarm;
+    *sAlarm = SimAlarm;
+    sAlarm->AlarmTime.Hours   = Sim_FromBin( SimAlarm.AlarmTime.Hours, Format );
+    sAlarm->AlarmTime.Minutes = Sim_FromBin( SimAlarm.AlarmTime.Minutes, Format );
+    sAlarm->AlarmTime.Seconds = Sim_FromBin( SimAlarm.AlarmTime.Seconds, Format );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_DeactivateAlarm( RTC_HandleTypeDef *hrtc, uint32_t Alarm )
+{
+    (void) hrtc;
+    (void) Alarm;
+    SimAlarmOn = FALSE;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_Init( FDCAN_HandleTypeDef *hfdcan ) { (void) hfdcan; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter( FDCAN_HandleTypeDef *hfdcan, FDCAN_FilterTypeDef *sFilterConfig )
+{
+    HAL_StatusTypeDef status = HAL_ERROR;
+    (void) hfdcan;
+
+    if( sFilterConfig->FilterIndex < FILTERS_N )
+    {
+        SimFilters[ sFilterConfig->FilterIndex ] = *sFilterConfig;
+        status = HAL_OK;
+    }
+
+    return status;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigGlobalFilter( FDCAN_HandleTypeDef *hfdcan, uint32_t NonMatchingStd,
+    uint32_t NonMatchingExt, uint32_t RejectRemoteStd, uint32_t RejectRemoteExt )
+{ (void) hfdcan; (void) NonMatchingStd; (void) NonMatchingExt; (void) RejectRemoteStd; (void) RejectRemoteExt; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_Start( FDCAN_HandleTypeDef *hfdcan ) { (void) hfdcan; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification( FDCAN_HandleTypeDef *hfdcan, uint32_t ActiveITs, uint32_t BufferIndexes )
+{ (void) hfdcan; (void) BufferIndexes; SimRxITs |= ActiveITs; return HAL_OK; }
+
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel( FDCAN_HandleTypeDef *hfdcan )
+{ (void) hfdcan; return SIM_TX_FIFO_N; }
+
+uint32_t HAL_FDCAN_GetRxFifoFillLevel( FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo )
+{ (void) hfdcan; (void) RxFifo; return SimRxCount; }
+
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ( FDCAN_HandleTypeDef *hfdcan, FDCAN_TxHeaderTypeDef *pTxHeader, uint8_t *pTxData )
+{
+    (void) hfdcan;
+    Sim_OnCanTx( pTxHeader->Identifier, pTxData );
+    Sim_Run( SIM_CAN_TX_US, FALSE );
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage( FDCAN_HandleTypeDef *hfdcan, uint32_t RxLocation, FDCAN_RxHeaderTypeDef *pRxHeader, uint8_t *pRxData )
+{
+    (void) hfdcan;
+    (void) RxLocation;
+    pRxHeader->Identifier = SimRxFifo[ 0 ].Id;
+    pRxHeader->FilterIndex = Sim_Filter( SimRxFifo[ 0 ].Id );
+    pRxHeader->DataLength = SimRxFifo[ 0 ].Size;
+    (void) memcpy( pRxData, SimRxFifo[ 0 ].Data, sizeof( SimRxFifo[ 0 ].Data ) );
+
+    if( SimRxCount > 0u )
+    {
+        SimRxCount--;
+        (void) memmove( &SimRxFifo[ 0 ], &SimRxFifo[ 1 ], SimRxCount * sizeof( Sim_Irq ) );
+    }
+
+    return HAL_OK;
+}
+
+uint8_t HEL_LCD_Init( LCD_HandleTypeDef *hlcd ) { (void) hlcd; return HAL_OK; }
+
+uint8_t HEL_LCD_InitStep( LCD_HandleTypeDef *hlcd, uint8_t step, uint32_t *delay )
+{
+    /*same delays of the real routine, so the display task waits them in the simulated time*/
+    static const uint32_t delays[ HEL_LCD_INIT_STEPS ] = { 2u, 20u, 2u, 200u, 2u, 0u };
+    uint8_t Status = HAL_ERROR;
+
+    (void) hlcd;
+    *delay = 0u;
+
+    if ( step < HEL_LCD_INIT_STEPS )
+    {
+        *delay = delays[ step ];
+        Status = HAL_OK;
+    }
+
+    return Status;
+}
+
+uint8_t HEL_LCD_Data( LCD_HandleTypeDef *hlcd, uint8_t data )
+{
+    (void) hlcd;
+    Sim_LcdWrite( data );
+    Sim_OnLcd( SimLcdRow, SimLcdColumn, SimLcd[ SimLcdRow % SIM_LCD_ROWS ] );
+
+    return HAL_OK;
+}
+
+uint8_t HEL_LCD_String( LCD_HandleTypeDef *hlcd, const char *str )
+{
+    (void) hlcd;
+
+    for( const char *c = str; *c != '\0'; c++ )
+    {
+        Sim_LcdWrite( (uint8_t) *c );
+    }
+
+    Sim_OnLcd( SimLcdRow, SimLcdColumn, SimLcd[ SimLcdRow % SIM_LCD_ROWS ] );
+
+    return HAL_OK;
+}
+
+uint8_t HEL_LCD_SetCursor( LCD_HandleTypeDef *hlcd, uint8_t row, uint8_t col )
+{
+    (void) hlcd;
+    SimLcdRow    = row;
+    SimLcdColumn = col;
+    Sim_Run( SIM_LCD_BYTE_US, FALSE );
+
+    return HAL_OK;
+}
+
+uint8_t HEL_LCD_Backlight( LCD_HandleTypeDef *hlcd, uint8_t state ) { (void) hlcd; (void) state; return HAL_OK; }
+
+uint8_t HEL_LCD_Contrast( LCD_HandleTypeDef *hlcd, uint8_t contrast ) { (void) hlcd; (void) contrast; return HAL_OK; }
+
+uint8_t HEL_LCD_Intensity( LCD_HandleTypeDef *hlcd, uint8_t intensity ) { (void) hlcd; (void) intensity; return TRUE; }
+
+void Analogs_Init( void ) { }
+
+int8_t Analogs_GetTemperature( void ) { return 25; }
+
+uint8_t Analogs_GetContrast( void ) { return 0u; }
+
+uint8_t Analogs_GetIntensity( void ) { return 0u; }
+/* cppcheck-suppress-end misra-c2012-8.4 */
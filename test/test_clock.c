@@ -6,6 +6,7 @@
 #include "unity.h"
 #include "bsp.h"
 #include "clock.h"
+#include "display.h"
 #include "stdint.h"
 
 #include "mock_queue.h"
@@ -51,14 +52,14 @@ extern uint8_t AlarmSet_flg;
 /**
  * @brief   reference to the DisplayQueue.
 */
-AppQue_Queue DisplayQueue;
+DisplayQ_Queue DisplayQueue;
 
 /**
  * @brief   Function that runs before any unit test.
 */
 void setUp( void )
 {
-
+    DisplayQ_flush( &DisplayQueue );
 }
 
 /**
@@ -123,6 +124,24 @@ APP_MsgTypeDef Clock_ButtonReleased( APP_MsgTypeDef * );
 */
 APP_MsgTypeDef Clock_GetAlarm( APP_MsgTypeDef * );
 
+/** 
+ * @brief   Reference for the private function Clock_MsgLevel. 
+ * @return  Priority level of the message.
+*/
+unsigned char Clock_MsgLevel( const void * );
+
+/** 
+ * @brief   Reference for the private function Clock_Coalesce. 
+ * @return  Coalesce verdict.
+*/
+unsigned char Clock_Coalesce( const void *, const void * );
+
+/** 
+ * @brief   Reference for the private function Clock_DisplayCoalesce. 
+ * @return  Coalesce verdict.
+*/
+unsigned char Clock_DisplayCoalesce( const APP_MsgTypeDef *, const APP_MsgTypeDef * );
+
 /** 
  * @brief   Reference for the private function Clock_Get_Temperature. 
  * @return  Message with the next event.
@@ -141,7 +160,7 @@ void test__Clock_InitTask__( void )
     HAL_GPIO_Init_Ignore( );
     HAL_TIM_PWM_Init_IgnoreAndReturn( HAL_OK );
     HAL_TIM_PWM_ConfigChannel_IgnoreAndReturn( HAL_OK );
-    AppQueue_initQueue_Ignore( );
+    AppQueue_initPrioQueue_Ignore( );
     HAL_RTC_Init_IgnoreAndReturn( HAL_OK );
     HAL_RTC_SetTime_IgnoreAndReturn( HAL_OK );
     HAL_RTC_SetDate_IgnoreAndReturn( HAL_OK );
@@ -158,7 +177,7 @@ void test__Clock_InitTask__( void )
 */
 void test__ClockUpdate_Callback( void )
 {
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     AppSched_startTimer_ExpectAnyArgsAndReturn( TRUE );
     ClockUpdate_Callback( );
 }
@@ -171,10 +190,11 @@ void test__ClockUpdate_Callback( void )
 void test__TimerAlarmOneSecond_Callback__buzzer_flg_FALSE( void )
 {
     HAL_TIM_PWM_Start_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
     AppSched_startTimer_ExpectAnyArgsAndReturn( TRUE );
 
     TimerAlarmOneSecond_Callback( );
+
+    TEST_ASSERT_FALSE( DisplayQ_isEmpty( &DisplayQueue ) );
 }
 
 /**
@@ -185,7 +205,6 @@ void test__TimerAlarmOneSecond_Callback__buzzer_flg_FALSE( void )
 void test__TimerAlarmOneSecond_Callback__buzzer_flg_TRUE( void )
 {
     HAL_TIM_PWM_Start_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
     AppSched_startTimer_IgnoreAndReturn( TRUE );
     HAL_TIM_PWM_Stop_IgnoreAndReturn( HAL_OK );
     
@@ -201,7 +220,7 @@ void test__TimerAlarmOneSecond_Callback__buzzer_flg_TRUE( void )
 */
 void test__TimerDeactivateAlarm_Callback( void )
 {
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
 
     TimerDeactivateAlarm_Callback( );
 }
@@ -210,8 +229,8 @@ void test__TimerDeactivateAlarm_Callback( void )
  * @brief   test Clock_PeriodTask, queue with a time message.
  * 
  * It's defined message of type SERIAL_MSG_TIME.
- * Mock the function HIL_QUEUE_isQueueEmptyISR to return a FALSE value first, then a TRUE value.
- * Also mock the function HIL_QUEUE_readDataISR to return the defined message.
+ * Mock the function HIL_QUEUE_peekPrioISR to return the defined message first, then a NULL value.
+ * Also mock the function HIL_QUEUE_releasePrioISR to free the message after it was processed.
  * And finally call the function to ensure that the correct function is run. 
 */
 void test__Clock_PeriodicTask__time_msg_case_TIME( void )
@@ -219,12 +238,11 @@ void test__Clock_PeriodicTask__time_msg_case_TIME( void )
     APP_MsgTypeDef receivedMSG = {0};
     receivedMSG.msg = CLOCK_MSG_TIME;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_Messages ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( &receivedMSG );
     HAL_RTC_SetTime_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_releasePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( NULL );
 
     Clock_PeriodicTask( );
 }
@@ -233,8 +251,8 @@ void test__Clock_PeriodicTask__time_msg_case_TIME( void )
  * @brief   test Clock_PeriodTask, queue with a date message.
  * 
  * It's defined message of type SERIAL_MSG_DATE.
- * Mock the function HIL_QUEUE_isQueueEmptyISR to return a FALSE value first, then a TRUE value.
- * Also mock the function HIL_QUEUE_readDataISR to return the defined message.
+ * Mock the function HIL_QUEUE_peekPrioISR to return the defined message first, then a NULL value.
+ * Also mock the function HIL_QUEUE_releasePrioISR to free the message after it was processed.
  * And finally call the function to ensure that the correct function is run. 
 */
 void test__Clock_PeriodicTask__date_msg_case_DATE( void )
@@ -242,12 +260,11 @@ void test__Clock_PeriodicTask__date_msg_case_DATE( void )
     APP_MsgTypeDef receivedMSG = {0};
     receivedMSG.msg = CLOCK_MSG_DATE;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_Messages ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( &receivedMSG );
     HAL_RTC_SetDate_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_releasePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( NULL );
 
     Clock_PeriodicTask( );
 }
@@ -256,8 +273,8 @@ void test__Clock_PeriodicTask__date_msg_case_DATE( void )
  * @brief   test Clock_PeriodTask queue with a ALARM message.
  * 
  * It's defined message of type SERIAL_MSG_ALARM.
- * Mock the function HIL_QUEUE_isQueueEmptyISR to return a FALSE value first, then a TRUE value.
- * Also mock the function HIL_QUEUE_readDataISR to return the defined message.
+ * Mock the function HIL_QUEUE_peekPrioISR to return the defined message first, then a NULL value.
+ * Also mock the function HIL_QUEUE_releasePrioISR to free the message after it was processed.
  * And finally call the function to ensure that the correct function is run. 
 */
 void test__Clock_PeriodicTask__alarm_msg_case_alarm( void )
@@ -265,22 +282,22 @@ void test__Clock_PeriodicTask__alarm_msg_case_alarm( void )
     APP_MsgTypeDef receivedMSG = {0};
     receivedMSG.msg = CLOCK_MSG_ALARM;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_Messages ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( &receivedMSG );
     HAL_RTC_SetAlarm_IT_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_releasePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( NULL );
 
     Clock_PeriodicTask( );
+
+    TEST_ASSERT_FALSE( DisplayQ_isEmpty( &DisplayQueue ) );
 }
 
 /**
  * @brief   test Clock_PeriodTask queue with a DISPLAY message.
  * 
  * It's defined message of type SERIAL_MSG_DISPLAY.
- * Mock the function HIL_QUEUE_isQueueEmptyISR to return a FALSE value first, then a TRUE value.
- * Also mock the function HIL_QUEUE_readDataISR to return the defined message.
+ * Mock the function HIL_QUEUE_peekPrioISR to return the defined message first, then a NULL value.
+ * Also mock the function HIL_QUEUE_releasePrioISR to free the message after it was processed.
  * And finally call the function to ensure that the correct function is run. 
 */
 void test__Clock_PeriodicTask__display_msg_case_DISPLAY( void )
@@ -289,14 +306,12 @@ void test__Clock_PeriodicTask__display_msg_case_DISPLAY( void )
     receivedMSG.msg = CLOCK_MSG_DISPLAY;
     int8_t temp = 25;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_Messages ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( &receivedMSG );
     HAL_RTC_GetTime_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_RTC_GetDate_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
     Analogs_GetTemperature_IgnoreAndReturn( temp );
+    HIL_QUEUE_releasePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( NULL );
 
     Clock_PeriodicTask( );
 }
@@ -305,8 +320,8 @@ void test__Clock_PeriodicTask__display_msg_case_DISPLAY( void )
  * @brief   test Clock_PeriodTask queue with a unkown message.
  * 
  * It's defined message of type unkown.
- * Mock the function HIL_QUEUE_isQueueEmptyISR to return a FALSE value first, then a TRUE value.
- * Also mock the function HIL_QUEUE_readDataISR to return the defined message.
+ * Mock the function HIL_QUEUE_peekPrioISR to return the defined message first, then a NULL value.
+ * Also mock the function HIL_QUEUE_releasePrioISR to free the message after it was processed.
  * And finally call the function to ensure that any function is run. 
 */
 void test__Clock_PeriodicTask__uknown_msg_dont_run_any_function( void )
@@ -314,10 +329,9 @@ void test__Clock_PeriodicTask__uknown_msg_dont_run_any_function( void )
     APP_MsgTypeDef receivedMSG = {0};
     receivedMSG.msg = 0xFF;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_Messages ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( &receivedMSG );
+    HIL_QUEUE_releasePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_peekPrioISR_ExpectAnyArgsAndReturn( NULL );
 
     Clock_PeriodicTask( );
 }
@@ -334,7 +348,7 @@ void test__Clock_Set_Time__AlarmActivated_flg_FALSE( void )
     AlarmActivated_flg = FALSE;
 
     HAL_RTC_SetTime_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
 
     nextEvent = Clock_Set_Time( &msgReceived );
 
@@ -352,7 +366,7 @@ void test__Clock_Set_Time__AlarmActivated_flg_TRUE( void )
     APP_MsgTypeDef nextEvent = {0};
 
     HAL_RTC_SetTime_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_Set_Time( &msgReceived );
 
@@ -371,7 +385,7 @@ void test__Clock_Set_Date__AlarmActivated_flg_TRUE( void )
     APP_MsgTypeDef nextEvent = {0};
 
     HAL_RTC_SetDate_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_Set_Date( &msgReceived );
 
@@ -390,7 +404,7 @@ void test__Clock_Set_Date__AlarmActivated_flg_FALSE( void )
     APP_MsgTypeDef nextEvent = {0};
 
     HAL_RTC_SetDate_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_Set_Date( &msgReceived );
 
@@ -407,7 +421,6 @@ void test__Clock_Set_Alarm__AlarmActivated_flg_FALSE( void )
     APP_MsgTypeDef msgReceived = {0};
     APP_MsgTypeDef nextEvent = {0};
 
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
     HAL_RTC_SetAlarm_IT_ExpectAnyArgsAndReturn( HAL_OK );
 
     nextEvent = Clock_Set_Alarm( &msgReceived );
@@ -425,7 +438,7 @@ void test__Clock_Set_Alarm__AlarmActivated_flg_TRUE( void )
     APP_MsgTypeDef msgReceived = {0};
     APP_MsgTypeDef nextEvent = {0};
 
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
     HAL_RTC_SetAlarm_IT_ExpectAnyArgsAndReturn( HAL_OK );
 
     nextEvent = Clock_Set_Alarm( &msgReceived );
@@ -444,7 +457,6 @@ void test__Clock_Send_Display_Msg( void )
 
     HAL_RTC_GetTime_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_RTC_GetDate_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
     Analogs_GetTemperature_IgnoreAndReturn( temp );
 
     nextEvent = Clock_Send_Display_Msg( &msgReceived );
@@ -452,6 +464,35 @@ void test__Clock_Send_Display_Msg( void )
     TEST_ASSERT_EQUAL( nextEvent.msg, DISPLAY_MSG_UPDATE );
 }
 
+/**
+ * @brief   test Clock_Send_Display_Msg function called several times in a row.
+ * 
+ * The pending update and temperature messages shall be updated in place, the display task doesn't
+ * peek any of them meanwhile, so the DisplayQueue shall keep only two messages with the newest values.
+*/
+void test__Clock_Send_Display_Msg__repeated_refreshes_are_merged( void )
+{
+    APP_MsgTypeDef msgReceived = {0};
+    APP_MsgTypeDef msgRead = {0};
+    unsigned char count = 0u;
+
+    Analogs_GetTemperature_IgnoreAndReturn( 20 );
+    for( unsigned char i = 0u; i < 4u; i++ )
+    {
+        HAL_RTC_GetTime_ExpectAnyArgsAndReturn( HAL_OK );
+        HAL_RTC_GetDate_ExpectAnyArgsAndReturn( HAL_OK );
+        Clock_Send_Display_Msg( &msgReceived );
+    }
+
+    while( DisplayQ_read( &DisplayQueue, &msgRead ) == TRUE )
+    {
+        count++;
+    }
+
+    TEST_ASSERT_EQUAL( 2u, count );
+    TEST_ASSERT_EQUAL( DISPLAY_MSG_UPDATE, msgRead.msg );
+}
+
 /**
  * @brief   test Clock_Alarm_Activated function.
 */
@@ -460,10 +501,9 @@ void test__Clock_Alarm_Activated( void )
     APP_MsgTypeDef msgReceived = {0};
     APP_MsgTypeDef nextEvent = {0};
 
-    HIL_QUEUE_flushQueueISR_Ignore( );
     AppSched_stopTimer_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
     AppSched_startTimer_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_flushPrioISR_Ignore( );
     
     nextEvent = Clock_Alarm_Activated( &msgReceived );
 
@@ -479,7 +519,7 @@ void test__Clock_Deactivate_Alarm( void )
     APP_MsgTypeDef nextEvent = {0};
 
     HAL_TIM_PWM_Stop_IgnoreAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
     AppSched_stopTimer_IgnoreAndReturn( TRUE );
     AppSched_startTimer_IgnoreAndReturn( TRUE );
     
@@ -502,8 +542,8 @@ void test__Clock_ButtonPressed__AlarmActivated_flg_TRUE_return_msg_CLOCK_MSG_DEA
     AlarmActivated_flg = TRUE;
     
     AppSched_stopTimer_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_flushQueueISR_Ignore( ); 
+    HIL_QUEUE_flushPrioISR_Ignore( );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_ButtonPressed( &msgReceived );
 
@@ -526,8 +566,8 @@ void test__Clock_ButtonPressed__AlarmSet_flg_TRUE_return_msg_CLOCK_MSG_GET_ALARM
     AlarmSet_flg = TRUE;
     
     AppSched_stopTimer_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_flushQueueISR_Ignore( ); 
+    HIL_QUEUE_flushPrioISR_Ignore( );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_ButtonPressed( &msgReceived );
 
@@ -550,14 +590,122 @@ void test__Clock_ButtonPressed__AlarmSet_flg_FALSE_and_AlarmActivated_flg_FALSE_
     AlarmSet_flg = FALSE;
     
     AppSched_stopTimer_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
-    HIL_QUEUE_flushQueueISR_Ignore( ); 
+    HIL_QUEUE_flushPrioISR_Ignore( );
 
     nextEvent = Clock_ButtonPressed( &msgReceived );
 
     TEST_ASSERT_EQUAL( nextEvent.msg, DISPLAY_MSG_ALARM_NO_CONF );
 }
 
+/**
+ * @brief   Messages of the ClockQueue emulated in the test of the stale display refresh.
+*/
+static APP_MsgTypeDef ButtonMsg;
+static APP_MsgTypeDef StaleRefreshMsg;
+
+/**
+ * @brief   Number of messages released from the emulated ClockQueue.
+*/
+static uint8_t ReleasedMsgs;
+
+/**
+ * @brief   Flag set when the display lane of the emulated ClockQueue is flushed.
+*/
+static uint8_t DisplayLaneFlushed;
+
+/**
+ * @brief   Stub of HIL_QUEUE_peekPrioISR, a refresh was queued before the button was pressed.
+ * 
+ * The button message is in the highest lane so it's returned first, then the refresh of the
+ * lowest lane if it was not flushed.
+ * 
+ * @return  The pending message, or NULL when there is no one.
+*/
+static void *Stub_PeekPrio( AppQue_PrioQueue *prio, unsigned char *level, int cmock_num_calls )
+{
+    (void) prio;
+    (void) cmock_num_calls;
+    void *element = NULL;
+
+    if( ReleasedMsgs == 0u )
+    {
+        *level = 0u;
+        element = &ButtonMsg;
+    }
+    else if( ( ReleasedMsgs == 1u ) && ( DisplayLaneFlushed == FALSE ) )
+    {
+        *level = 2u;
+        element = &StaleRefreshMsg;
+    }
+    else
+    {
+        /*the emulated queue is empty*/
+    }
+
+    return element;
+}
+
+/**
+ * @brief   Stub of HIL_QUEUE_releasePrioISR, count the released messages.
+ * 
+ * @return  TRUE, the message is always there.
+*/
+static unsigned char Stub_ReleasePrio( AppQue_PrioQueue *prio, unsigned char level, int cmock_num_calls )
+{
+    (void) prio;
+    (void) level;
+    (void) cmock_num_calls;
+
+    ReleasedMsgs++;
+
+    return TRUE;
+}
+
+/**
+ * @brief   Stub of HIL_QUEUE_flushPrioISR, only the display lane can be flushed.
+*/
+static void Stub_FlushPrio( AppQue_PrioQueue *prio, unsigned char level, int cmock_num_calls )
+{
+    (void) prio;
+    (void) cmock_num_calls;
+
+    TEST_ASSERT_EQUAL( 2u, level );
+    DisplayLaneFlushed = TRUE;
+}
+
+/**
+ * @brief   test Clock_PeriodicTask with a display refresh queued before the button is pressed.
+ * 
+ * The button event runs first because of its priority and shows the alarm no config message, the
+ * refresh queued before it shall be discarded, so the RTC is not read and the last message in the
+ * DisplayQueue is still DISPLAY_MSG_ALARM_NO_CONF.
+*/
+void test__Clock_PeriodicTask__refresh_queued_before_button_is_not_drawn( void )
+{
+    APP_MsgTypeDef msgRead = {0};
+
+    AlarmActivated_flg = FALSE;
+    AlarmSet_flg = FALSE;
+    ReleasedMsgs = 0u;
+    DisplayLaneFlushed = FALSE;
+    ButtonMsg.msg = CLOCK_MSG_BTN_PRESSED;
+    StaleRefreshMsg.msg = CLOCK_MSG_DISPLAY;
+
+    HIL_QUEUE_peekPrioISR_StubWithCallback( Stub_PeekPrio );
+    HIL_QUEUE_releasePrioISR_StubWithCallback( Stub_ReleasePrio );
+    HIL_QUEUE_flushPrioISR_StubWithCallback( Stub_FlushPrio );
+    AppSched_stopTimer_IgnoreAndReturn( TRUE );
+
+    Clock_PeriodicTask( );
+
+    while( DisplayQ_read( &DisplayQueue, &msgRead ) == TRUE )
+    {
+    }
+
+    TEST_ASSERT_EQUAL( 1u, ReleasedMsgs );
+    TEST_ASSERT_EQUAL( DISPLAY_MSG_ALARM_NO_CONF, msgRead.msg );
+}
+
 /**
  * @brief   test Clock_ButtonReleased event, button is not pressed and the AlarmSet_flg is FALSE.
  * 
@@ -569,7 +717,7 @@ void test__Clock_ButtonReleased__AlarmSet_flg_FALSE_return_DISPLAY_MSG_CLEAR_SEC
     APP_MsgTypeDef msgReceived = {0};
     APP_MsgTypeDef nextEvent = {0};
 
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
     AppSched_startTimer_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_ButtonReleased( &msgReceived );
@@ -590,7 +738,7 @@ void test__Clock_ButtonReleased__AlarmSet_flg_TRUE_return_DISPLAY_MSG_ALARM_SET_
 
     AlarmSet_flg = TRUE;
 
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
     AppSched_startTimer_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_ButtonReleased( &msgReceived );
@@ -610,7 +758,6 @@ void test__Clock_GetAlarm__check_the_returned_message_expected_result_is_DISPLAY
     APP_MsgTypeDef nextEvent = {0};
 
     HAL_RTC_GetAlarm_IgnoreAndReturn( HAL_OK );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
 
     nextEvent = Clock_GetAlarm( &msgReceived );
 
@@ -633,7 +780,6 @@ void test__Clock_GetAlarm__check_the_returned_alarm_values( void )
 
     HAL_RTC_GetAlarm_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_RTC_GetAlarm_ReturnMemThruPtr_sAlarm( &sAlarm_expected, sizeof(RTC_AlarmTypeDef) );
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
 
     alarmMsg = Clock_GetAlarm( &msgReceived );
 
@@ -646,7 +792,7 @@ void test__Clock_GetAlarm__check_the_returned_alarm_values( void )
 */
 void test__HAL_RTC_AlarmAEventCallback( void )
 {
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
     HAL_RTC_DeactivateAlarm_IgnoreAndReturn( HAL_OK );
 
     HAL_RTC_AlarmAEventCallback( &h_rtc );
@@ -657,7 +803,7 @@ void test__HAL_RTC_AlarmAEventCallback( void )
 */
 void test__HAL_GPIO_EXTI_Falling_Callback( void )
 {
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     HAL_GPIO_EXTI_Falling_Callback( GPIO_PIN_5 );
 }
@@ -667,7 +813,70 @@ void test__HAL_GPIO_EXTI_Falling_Callback( void )
 */
 void test__HAL_GPIO_EXTI_Rising_Callback( void )
 {
-    HIL_QUEUE_writeDataISR_IgnoreAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_IgnoreAndReturn( TRUE );
 
     HAL_GPIO_EXTI_Rising_Callback( GPIO_PIN_5 );
-}
\ No newline at end of file
+}
+/**
+ * @brief   test Clock_MsgLevel, priority levels of the clock messages.
+ * 
+ * The alarm and button events shall have a higher priority (lower level) than the settings, and
+ * the settings higher than the display refresh, an unknown message takes the lowest priority.
+*/
+void test__Clock_MsgLevel__user_events_before_settings_before_display( void )
+{
+    APP_MsgTypeDef msg = {0};
+
+    msg.msg = CLOCK_MSG_BTN_PRESSED;
+    unsigned char button = Clock_MsgLevel( &msg );
+    msg.msg = CLOCK_MSG_ALARM_ACTIVATED;
+    unsigned char alarm = Clock_MsgLevel( &msg );
+    msg.msg = CLOCK_MSG_TIME;
+    unsigned char time = Clock_MsgLevel( &msg );
+    msg.msg = CLOCK_MSG_DISPLAY;
+    unsigned char display = Clock_MsgLevel( &msg );
+    msg.msg = CLK_MSG_NONE;
+    unsigned char none = Clock_MsgLevel( &msg );
+
+    TEST_ASSERT_EQUAL( button, alarm );
+    TEST_ASSERT_LESS_THAN( time, button );
+    TEST_ASSERT_LESS_THAN( display, time );
+    TEST_ASSERT_EQUAL( display, none );
+}
+
+/**
+ * @brief   test Clock_Coalesce, only the display refreshes are merged.
+*/
+void test__Clock_Coalesce__merge_only_display_refreshes( void )
+{
+    APP_MsgTypeDef data = { .msg = CLOCK_MSG_DISPLAY };
+    APP_MsgTypeDef pending = { .msg = CLOCK_MSG_DISPLAY };
+
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_MERGE, Clock_Coalesce( &data, &pending ) );
+
+    pending.msg = CLOCK_MSG_GET_TEMPERATURE;
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_SKIP, Clock_Coalesce( &data, &pending ) );
+
+    data.msg = CLOCK_MSG_GET_TEMPERATURE;
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_SKIP, Clock_Coalesce( &data, &pending ) );
+}
+
+/**
+ * @brief   test Clock_DisplayCoalesce.
+ * 
+ * The same type of message shall be merged, an update and a temperature message can pass each
+ * other, and any other message shall stop the search.
+*/
+void test__Clock_DisplayCoalesce__merge_skip_and_stop( void )
+{
+    APP_MsgTypeDef data = { .msg = DISPLAY_MSG_UPDATE };
+    APP_MsgTypeDef pending = { .msg = DISPLAY_MSG_UPDATE };
+
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_MERGE, Clock_DisplayCoalesce( &data, &pending ) );
+
+    pending.msg = DISPLAY_MSG_TEMPERATURE;
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_SKIP, Clock_DisplayCoalesce( &data, &pending ) );
+
+    pending.msg = DISPLAY_MSG_CLEAR_SECOND_LINE;
+    TEST_ASSERT_EQUAL( QUEUE_COALESCE_STOP, Clock_DisplayCoalesce( &data, &pending ) );
+}
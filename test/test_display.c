@@ -13,17 +13,30 @@
 #include "mock_stm32g0xx_hal_spi.h"
 #include "mock_stm32g0xx_hal_tim.h"
 #include "mock_analogs.h"
+#include "mock_scheduler.h"
 
 /**
  * @brief   reference to the ClockQueue.
 */
-AppQue_Queue ClockQueue;
+AppQue_PrioQueue ClockQueue;
+
+/**
+ * @brief   reference to the Scheduler.
+*/
+AppSched_Scheduler Scheduler;
+
+/**
+ * @brief   LCD ready flag reference.
+*/
+extern uint8_t LcdReady;
 
 /**
  * @brief   function that is executed before any unit test function.
 */
 void setUp( void )
 {
+    DisplayQ_flush( &DisplayQueue );
+    LcdReady = TRUE;
 }
 
 /**
@@ -82,6 +95,9 @@ APP_MsgTypeDef Display_ClearSecondLine( APP_MsgTypeDef * );
 */
 APP_MsgTypeDef Display_Temperature( APP_MsgTypeDef * );
 
+/** @brief Reference for the private function Display_LcdInit. */
+void Display_LcdInit( void );
+
 /** @brief Reference for the private function TimeString. */
 void TimeString( char *, uint8_t, uint8_t, uint8_t );
 
@@ -145,19 +161,72 @@ void test__AlarmString__expected_result_ALARM_08_00( void )
 */
 void test__Display_InitTask( void )
 {
-    AppQueue_initQueue_Ignore( );
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HAL_SPI_Init_IgnoreAndReturn( HAL_OK );
     HAL_TIM_PWM_Init_IgnoreAndReturn( HAL_OK );
     HAL_TIM_PWM_ConfigChannel_IgnoreAndReturn( HAL_OK );
     HAL_TIM_PWM_Start_IgnoreAndReturn( HAL_OK );
     HEL_LCD_MspInit_Ignore( );
-    HEL_LCD_Init_ExpectAnyArgsAndReturn( TRUE );
-    HEL_LCD_Backlight_ExpectAnyArgsAndReturn( HAL_OK );
 
     Display_InitTask( );
 }
 
+/**
+ * @brief Test Display_PeriodicTask while the LCD initialization is running.
+ * 
+ * Each run of the task sends the steps of the LCD initialization until one with a delay, the
+ * task waits for it in the scheduler. The message in the queue is not processed until the
+ * last step, then the backlight is turned on and the message is displayed in the same run.
+*/
+void test__Display_PeriodicTask__lcd_init_steps( void )
+{
+    uint32_t delays[ HEL_LCD_INIT_STEPS ] = { 2u, 20u, 2u, 200u, 2u, 0u };
+    APP_MsgTypeDef receivedMSG = {0};
+    receivedMSG.msg         = DISPLAY_MSG_UPDATE;
+
+    LcdReady = FALSE;
+    (void) DisplayQ_write( &DisplayQueue, &receivedMSG );
+
+    for ( uint8_t step = 0u; step < ( HEL_LCD_INIT_STEPS - 1u ); step++ )
+    {
+        HEL_LCD_InitStep_ExpectAndReturn( &LCD_Handler, step, NULL, HAL_OK );
+        HEL_LCD_InitStep_IgnoreArg_delay( );
+        HEL_LCD_InitStep_ReturnThruPtr_delay( &delays[ step ] );
+        AppSched_waitTask_ExpectAndReturn( &Scheduler, delays[ step ], TRUE );
+
+        Display_PeriodicTask( );
+
+        TEST_ASSERT_FALSE( LcdReady );
+        TEST_ASSERT_FALSE( DisplayQ_isEmpty( &DisplayQueue ) );
+    }
+
+    HEL_LCD_InitStep_ExpectAndReturn( &LCD_Handler, HEL_LCD_INIT_STEPS - 1u, NULL, HAL_OK );
+    HEL_LCD_InitStep_IgnoreArg_delay( );
+    HEL_LCD_InitStep_ReturnThruPtr_delay( &delays[ HEL_LCD_INIT_STEPS - 1u ] );
+    HEL_LCD_Backlight_ExpectAndReturn( &LCD_Handler, LCD_ON, HAL_OK );
+    HEL_LCD_SetCursor_ExpectAnyArgsAndReturn( HAL_OK );
+    HEL_LCD_String_ExpectAnyArgsAndReturn( HAL_OK );
+    HEL_LCD_SetCursor_ExpectAnyArgsAndReturn( HAL_OK );
+    HEL_LCD_String_ExpectAnyArgsAndReturn( HAL_OK );
+
+    Display_PeriodicTask( );
+
+    TEST_ASSERT_TRUE( LcdReady );
+    TEST_ASSERT_TRUE( DisplayQ_isEmpty( &DisplayQueue ) );
+}
+
+/**
+ * @brief   Display_LcdTask unit test while the LCD initialization is running.
+ * 
+ * The contrast and intensity are not read neither sent to the LCD.
+*/
+void test__Display_LcdTask__lcd_not_ready( void )
+{
+    LcdReady = FALSE;
+
+    Display_LcdTask( );
+}
+
 /**
  * @brief Test Display_PeriodicTask with a DISPLAY_MSG_UPDATE.
 */
@@ -166,16 +235,15 @@ void test__Display_PeriodicTask__Update_Display_message( void )
     APP_MsgTypeDef receivedMSG = {0};
     receivedMSG.msg         = DISPLAY_MSG_UPDATE;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_MsgTypeDef ) );
+    (void) DisplayQ_write( &DisplayQueue, &receivedMSG );
     HEL_LCD_SetCursor_ExpectAnyArgsAndReturn( HAL_OK );
     HEL_LCD_String_ExpectAnyArgsAndReturn( HAL_OK );
     HEL_LCD_SetCursor_ExpectAnyArgsAndReturn( HAL_OK );
     HEL_LCD_String_ExpectAnyArgsAndReturn( HAL_OK );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
 
     Display_PeriodicTask( );
+
+    TEST_ASSERT_TRUE( DisplayQ_isEmpty( &DisplayQueue ) );
 }
 
 /**
@@ -194,12 +262,11 @@ void test__Display_PeriodicTask__Update_Display_no_valid_message( void )
     receivedMSG.tm.tm_year  = 0x23;
     receivedMSG.tm.tm_wday  = RTC_WEEKDAY_TUESDAY;
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( FALSE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &receivedMSG, sizeof( APP_MsgTypeDef ) );
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    (void) DisplayQ_write( &DisplayQueue, &receivedMSG );
 
     Display_PeriodicTask( );
+
+    TEST_ASSERT_TRUE( DisplayQ_isEmpty( &DisplayQueue ) );
 }
 
 /**
@@ -69,6 +69,43 @@ void test__HEL_LCD_Init__return_HAL_ERROR_first_command_sent( void )
     TEST_ASSERT_EQUAL( retValue, HAL_ERROR );
 }
 
+/**
+ * @brief   Test case for HEL_LCD_InitStep, each step returns the delay before the next one.
+ * 
+ * The steps send the wake up, the seven commands of the first part, the three of the second part
+ * and the DDRAM address, and the last step needs no delay.
+*/
+void test__HEL_LCD_InitStep__delays_and_commands( void )
+{
+    const uint32_t delays[ HEL_LCD_INIT_STEPS ] = { 2u, 20u, 2u, 200u, 2u, 0u };
+    const uint8_t commands[ HEL_LCD_INIT_STEPS ] = { 0u, 0u, 1u, 7u, 3u, 1u };
+    uint32_t delay = 0xFFu;
+
+    HAL_GPIO_WritePin_Ignore( );
+
+    for( uint8_t step = 0u; step < HEL_LCD_INIT_STEPS; step++ )
+    {
+        for( uint8_t i = 0u; i < commands[ step ]; i++ )
+        {
+            HAL_SPI_Transmit_ExpectAnyArgsAndReturn( HAL_OK );
+        }
+
+        TEST_ASSERT_EQUAL( HAL_OK, HEL_LCD_InitStep( &LCD_Handler, step, &delay ) );
+        TEST_ASSERT_EQUAL( delays[ step ], delay );
+    }
+}
+
+/**
+ * @brief   Test case for HEL_LCD_InitStep with a step out of the routine.
+*/
+void test__HEL_LCD_InitStep__not_valid_step( void )
+{
+    uint32_t delay = 0xFFu;
+
+    TEST_ASSERT_EQUAL( HAL_ERROR, HEL_LCD_InitStep( &LCD_Handler, HEL_LCD_INIT_STEPS, &delay ) );
+    TEST_ASSERT_EQUAL( 0u, delay );
+}
+
 /**
  * @brief   Test case for HEL_LCD_Command function returning HAL_OK.
  * 
@@ -0,0 +1,190 @@
+/**
+ * @file    test_pool.c
+ *
+ * @brief   Unit test cases for the functions from pool file.
+*/
+#include "unity.h"
+#include "pool.h"
+#include <string.h>
+
+#define POOL_BLOCKS     4u      /*!< Number of blocks in hpool*/
+
+/**
+ * @struct  Block
+ * @brief   Struct used as the block of the pool, with the size of a CAN message.
+*/
+typedef struct
+{
+    unsigned short id;          /*!< element id to save a message identifier */
+    unsigned char bytes[ 10 ];  /*!< element bytes to save the message data */
+} Block;
+
+/** @brief  pool to test */
+AppPool_Pool hpool;
+/** @brief  blocks of hpool */
+Block blocks[ POOL_BLOCKS ];
+
+/**
+ * @brief   function that is executed before any unit test function.
+*/
+void setUp( void )
+{
+    memset( &hpool, 0, sizeof( hpool ) );
+    hpool.Buffer = blocks;
+    hpool.Blocks = POOL_BLOCKS;
+    hpool.Size   = sizeof( Block );
+}
+
+/**
+ * @brief   function that is executed after any unit test function.
+*/
+void tearDown( void )
+{
+}
+
+/**
+ * @brief   test AppPool_initPool, all the blocks are free.
+*/
+void test__AppPool_initPool__all_blocks_available( void )
+{
+    AppPool_initPool( &hpool );
+
+    TEST_ASSERT_EQUAL( POOL_BLOCKS, AppPool_available( &hpool ) );
+    TEST_ASSERT_EQUAL( POOL_BLOCKS, hpool.LowWater );
+    TEST_ASSERT_EQUAL_PTR( &blocks[ 0 ], hpool.Free );
+}
+
+/**
+ * @brief   test AppPool_alloc, the blocks are given in the order of the array.
+*/
+void test__AppPool_alloc__blocks_in_array_order( void )
+{
+    AppPool_initPool( &hpool );
+
+    for( unsigned long i = 0u; i < POOL_BLOCKS; i++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &blocks[ i ], AppPool_alloc( &hpool ) );
+    }
+}
+
+/**
+ * @brief   test AppPool_alloc, with all the blocks in use it returns NULL.
+*/
+void test__AppPool_alloc__empty_pool_returns_NULL( void )
+{
+    AppPool_initPool( &hpool );
+
+    for( unsigned long i = 0u; i < POOL_BLOCKS; i++ )
+    {
+        (void) AppPool_alloc( &hpool );
+    }
+
+    TEST_ASSERT_NULL( AppPool_alloc( &hpool ) );
+    TEST_ASSERT_EQUAL( 0u, AppPool_available( &hpool ) );
+    TEST_ASSERT_EQUAL( 0u, hpool.LowWater );
+}
+
+/**
+ * @brief   test AppPool_free, the freed block is the next one allocated.
+*/
+void test__AppPool_free__freed_block_is_allocated_again( void )
+{
+    AppPool_initPool( &hpool );
+
+    Block *first = (Block *) AppPool_alloc( &hpool );
+    (void) AppPool_alloc( &hpool );
+
+    TEST_ASSERT_TRUE( AppPool_free( &hpool, first ) );
+    TEST_ASSERT_EQUAL( POOL_BLOCKS - 1u, AppPool_available( &hpool ) );
+    TEST_ASSERT_EQUAL_PTR( first, AppPool_alloc( &hpool ) );
+}
+
+/**
+ * @brief   test AppPool_free, the content written in a block is kept until it's freed.
+ *
+ * All the blocks are allocated and filled, the content of each block must not be modified by
+ * the alloc of the others, then all of them are freed and allocated again.
+*/
+void test__AppPool_free__blocks_content_and_reuse( void )
+{
+    Block *used[ POOL_BLOCKS ];
+
+    AppPool_initPool( &hpool );
+
+    for( unsigned long i = 0u; i < POOL_BLOCKS; i++ )
+    {
+        used[ i ] = (Block *) AppPool_alloc( &hpool );
+        memset( used[ i ], (int) i, sizeof( Block ) );
+    }
+
+    for( unsigned long i = 0u; i < POOL_BLOCKS; i++ )
+    {
+        TEST_ASSERT_EQUAL_UINT8( i, used[ i ]->bytes[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT8( i, used[ i ]->bytes[ sizeof( used[ i ]->bytes ) - 1u ] );
+        TEST_ASSERT_TRUE( AppPool_free( &hpool, used[ i ] ) );
+    }
+
+    TEST_ASSERT_EQUAL( POOL_BLOCKS, AppPool_available( &hpool ) );
+
+    for( unsigned long i = 0u; i < POOL_BLOCKS; i++ )
+    {
+        TEST_ASSERT_NOT_NULL( AppPool_alloc( &hpool ) );
+    }
+    TEST_ASSERT_NULL( AppPool_alloc( &hpool ) );
+}
+
+/**
+ * @brief   test AppPool_free, a block outside the array is rejected.
+*/
+void test__AppPool_free__block_out_of_pool_rejected( void )
+{
+    Block other;
+
+    AppPool_initPool( &hpool );
+    (void) AppPool_alloc( &hpool );
+
+    TEST_ASSERT_FALSE( AppPool_free( &hpool, &other ) );
+    TEST_ASSERT_FALSE( AppPool_free( &hpool, &blocks[ POOL_BLOCKS ] ) );
+    TEST_ASSERT_EQUAL( POOL_BLOCKS - 1u, AppPool_available( &hpool ) );
+}
+
+/**
+ * @brief   test AppPool_free, an address inside the array that is not the start of a block is rejected.
+*/
+void test__AppPool_free__misaligned_address_rejected( void )
+{
+    AppPool_initPool( &hpool );
+    (void) AppPool_alloc( &hpool );
+
+    TEST_ASSERT_FALSE( AppPool_free( &hpool, &blocks[ 1 ].bytes[ 0 ] ) );
+    TEST_ASSERT_FALSE( AppPool_free( &hpool, (unsigned char *) &blocks[ 0 ] + 1 ) );
+    TEST_ASSERT_EQUAL( POOL_BLOCKS - 1u, AppPool_available( &hpool ) );
+    TEST_ASSERT_TRUE( AppPool_free( &hpool, &blocks[ 0 ] ) );
+}
+
+/**
+ * @brief   test AppPool_free, a block can not be freed when all of them are free.
+*/
+void test__AppPool_free__all_blocks_free_rejected( void )
+{
+    AppPool_initPool( &hpool );
+
+    TEST_ASSERT_FALSE( AppPool_free( &hpool, &blocks[ 0 ] ) );
+    TEST_ASSERT_EQUAL( POOL_BLOCKS, AppPool_available( &hpool ) );
+}
+
+/**
+ * @brief   test AppPool_alloc, LowWater keeps the min number of free blocks.
+*/
+void test__AppPool_alloc__LowWater( void )
+{
+    AppPool_initPool( &hpool );
+
+    Block *first = (Block *) AppPool_alloc( &hpool );
+    Block *second = (Block *) AppPool_alloc( &hpool );
+    (void) AppPool_free( &hpool, first );
+    (void) AppPool_free( &hpool, second );
+    (void) AppPool_alloc( &hpool );
+
+    TEST_ASSERT_EQUAL( POOL_BLOCKS - 2u, hpool.LowWater );
+}
@@ -5,8 +5,13 @@
 */
 #include "unity.h"
 #include "queue.h"
+#include <string.h>
+
+#include "mock_stm32g0xx_hal.h"
 
  #define HQUEUE_ELEM    8u      /*!< Number of elements in hqueue*/
+ #define SPSC_ELEM      4u      /*!< Number of elements in spscQueue*/
+ #define TYPED_ELEM     3u      /*!< Number of elements in typedQueue*/
 
 /**
  * @struct  Msg 
@@ -38,6 +43,11 @@ AppQue_Queue s_queue;
 /** @brief  buffer type Msg to s_queue */
 Msg bufferS[ 2 ];
 
+/** @brief  queue working in SPSC mode */
+AppQue_Queue spscQueue;
+/** @brief  buffer type uint8 to spscQueue */
+uint8_t bufferSpsc[ SPSC_ELEM ];
+
 /** @brief  variable to Write in char queue */
 uint8_t dataW = 'A';
 /** @brief  variable to save data read from char queue */    
@@ -48,6 +58,51 @@ Msg msgRead = {0};
 /** @brief  variable type Msg to read from buffer Msg */
 Msg msgWrite = {0};   
 
+/* Typed queue MsgQ_Queue with elements type Msg */
+QUEUE_DEFINE( MsgQ, Msg, TYPED_ELEM )
+
+/** @brief  typed queue, only needs to be zeroed to be empty */
+MsgQ_Queue typedQueue;
+
+/**
+ * @brief   Coalesce function used in the tests.
+ * 
+ * The messages 'D' are merged, a message 'S' stops the search and the rest are skipped.
+ * 
+ * @param   data [in] new message.
+ * @param   element [in] pending message.
+ * 
+ * @return  Coalesce verdict.
+*/
+static unsigned char Coalesce_Msg( const Msg *data, const Msg *element )
+{
+    unsigned char verdict = QUEUE_COALESCE_SKIP;
+
+    if( ( data->msg == 'D' ) && ( element->msg == 'D' ) )
+    {
+        verdict = QUEUE_COALESCE_MERGE;
+    }
+    else if( element->msg == 'S' )
+    {
+        verdict = QUEUE_COALESCE_STOP;
+    }
+
+    return verdict;
+}
+
+/**
+ * @brief   Coalesce function for AppQue_Queue, calls Coalesce_Msg.
+ * 
+ * @param   data [in] new message.
+ * @param   element [in] pending message.
+ * 
+ * @return  Coalesce verdict.
+*/
+static unsigned char Coalesce_Void( const void *data, const void *element )
+{
+    return Coalesce_Msg( (const Msg*) data, (const Msg*) element );
+}
+
 /**
  * @brief   function that is executed before any unit test function.
  * 
@@ -56,9 +111,12 @@ Msg msgWrite = {0};
 */
 void setUp(void)
 {
+    memset( &typedQueue, 0, sizeof( typedQueue ) );
+
     hqueue.Buffer   = buffer;
     hqueue.Elements = HQUEUE_ELEM;
     hqueue.Size     = sizeof( unsigned char );
+    hqueue.Pow2     = FALSE;
     AppQueue_initQueue( &hqueue );
 
     /*Queue full to test read Function*/
@@ -88,6 +146,14 @@ void setUp(void)
 
     AppQueue_initQueue( &queueRead );
     AppQueue_writeData( &queueRead, &msgWrite);
+
+    /*Queue in SPSC mode*/
+    spscQueue.Buffer   = bufferSpsc;
+    spscQueue.Elements = SPSC_ELEM;
+    spscQueue.Size     = sizeof( uint8_t );
+    spscQueue.Spsc     = TRUE;
+    spscQueue.Pow2     = FALSE;
+    AppQueue_initQueue( &spscQueue );
 }
 
 /**
@@ -435,4 +501,947 @@ void test__AppQueue_readData__readAllData_from_full_queue_return_False( void )
     }
 
     TEST_ASSERT_TRUE( queueFull.Empty );
-}
\ No newline at end of file
+}
+
+/**
+ * @brief   test AppQueue_writeData in SPSC mode, only the Head index is written.
+ * 
+ * The producer side of a SPSC queue shall only move the Head index, the Tail index and the flags
+ * Empty and Full belong to the consumer or are not used, then after a write they keep their values.
+*/
+void test__AppQueue_writeData__spsc_write_only_moves_Head( void )
+{
+    AppQueue_writeData( &spscQueue, &dataW );
+
+    TEST_ASSERT_EQUAL( 1, spscQueue.Head );
+    TEST_ASSERT_EQUAL( 0, spscQueue.Tail );
+    TEST_ASSERT_TRUE( spscQueue.Empty );
+    TEST_ASSERT_FALSE( spscQueue.Full );
+}
+
+/**
+ * @brief   test AppQueue_readData in SPSC mode, only the Tail index is written.
+ * 
+ * A single element is written and read back, the consumer side shall only move the Tail index.
+*/
+void test__AppQueue_readData__spsc_read_only_moves_Tail( void )
+{
+    AppQueue_writeData( &spscQueue, &dataW );
+    AppQueue_readData( &spscQueue, &dataR );
+
+    TEST_ASSERT_EQUAL( 1, spscQueue.Head );
+    TEST_ASSERT_EQUAL( 1, spscQueue.Tail );
+    TEST_ASSERT_EQUAL( dataW, dataR );
+}
+
+/**
+ * @brief   test AppQueue_writeData in SPSC mode, filling the queue.
+ * 
+ * All the elements of the queue can be used, then after SPSC_ELEM writes the next write shall
+ * return False and the queue shall not be empty.
+*/
+void test__AppQueue_writeData__spsc_fill_all_elements_then_return_False( void )
+{
+    for ( uint8_t i = 0; i < SPSC_ELEM; i++ )
+    {
+        TEST_ASSERT_TRUE( AppQueue_writeData( &spscQueue, &i ) );
+    }
+
+    TEST_ASSERT_FALSE( AppQueue_writeData( &spscQueue, &dataW ) );
+    TEST_ASSERT_FALSE( HIL_QUEUE_isQueueEmptyISR( &spscQueue ) );
+}
+
+/**
+ * @brief   test AppQueue_readData in SPSC mode, reading from an empty queue.
+ * 
+ * The spscQueue has no elements after the setUp, the read shall return False and the queue
+ * shall be reported as empty.
+*/
+void test__AppQueue_readData__spsc_read_from_empty_queue_return_False( void )
+{
+    TEST_ASSERT_FALSE( AppQueue_readData( &spscQueue, &dataR ) );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &spscQueue ) );
+}
+
+/**
+ * @brief   test SPSC mode interleaving producer and consumer steps.
+ * 
+ * The producer writes two elements every step while the consumer reads only one, when the queue
+ * gets full the producer stops and the consumer drains it, the indexes wrap several times, all the
+ * written values shall be read in the same order and no value can be lost.
+*/
+void test__AppQueue_readData__spsc_interleaved_producer_consumer_keeps_order( void )
+{
+    uint8_t produced = 0u;
+    uint8_t consumed = 0u;
+    uint8_t value    = 0u;
+
+    for ( uint8_t step = 0u; step < ( SPSC_ELEM * 8u ); step++ )
+    {
+        /*producer step (ISR)*/
+        for ( uint8_t j = 0u; j < 2u; j++ )
+        {
+            if ( AppQueue_writeData( &spscQueue, &produced ) == TRUE )
+            {
+                produced++;
+            }
+        }
+
+        /*consumer step (task)*/
+        if ( HIL_QUEUE_readDataISR( &spscQueue, &value ) == TRUE )
+        {
+            TEST_ASSERT_EQUAL( consumed, value );
+            consumed++;
+        }
+    }
+
+    while ( HIL_QUEUE_readDataISR( &spscQueue, &value ) == TRUE )
+    {
+        TEST_ASSERT_EQUAL( consumed, value );
+        consumed++;
+    }
+
+    TEST_ASSERT_EQUAL( produced, consumed );
+    TEST_ASSERT_TRUE( HIL_QUEUE_isQueueEmptyISR( &spscQueue ) );
+}
+
+/**
+ * @brief   test AppQueue_flushQueue in SPSC mode.
+ * 
+ * The flush is done by the consumer moving the Tail up to the Head, the Head index written by the
+ * producer shall keep its value.
+*/
+void test__AppQueue_flushQueue__spsc_flush_moves_Tail_to_Head( void )
+{
+    AppQueue_writeData( &spscQueue, &dataW );
+    AppQueue_writeData( &spscQueue, &dataW );
+
+    HIL_QUEUE_flushQueueISR( &spscQueue );
+
+    TEST_ASSERT_EQUAL( 2, spscQueue.Head );
+    TEST_ASSERT_EQUAL( 2, spscQueue.Tail );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &spscQueue ) );
+}
+
+/**
+ * @brief   test AppQueue_reserveData and AppQueue_commitData.
+ * 
+ * The reserved space shall be the one pointed by Head, and the element written in place shall be
+ * visible only after the commit, moving Head and clearing the Empty flag.
+*/
+void test__AppQueue_reserveData__write_in_place_then_commit( void )
+{
+    Msg *slot = AppQueue_reserveData( &s_queue );
+
+    TEST_ASSERT_EQUAL_PTR( &bufferS[ 0 ], slot );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &s_queue ) );
+
+    slot->msg = 'Z';
+    slot->val = 25u;
+
+    TEST_ASSERT_TRUE( AppQueue_commitData( &s_queue ) );
+    TEST_ASSERT_FALSE( AppQueue_isQueueEmpty( &s_queue ) );
+
+    AppQueue_readData( &s_queue, &msgRead );
+
+    TEST_ASSERT_EQUAL( 'Z', msgRead.msg );
+    TEST_ASSERT_EQUAL( 25u, msgRead.val );
+}
+
+/**
+ * @brief   test AppQueue_reserveData and AppQueue_commitData with a full queue.
+ * 
+ * There is no space to reserve, so NULL shall be returned and the commit shall fail.
+*/
+void test__AppQueue_reserveData__full_queue_return_NULL( void )
+{
+    TEST_ASSERT_NULL( AppQueue_reserveData( &queueFull ) );
+    TEST_ASSERT_FALSE( AppQueue_commitData( &queueFull ) );
+}
+
+/**
+ * @brief   test AppQueue_peekData and AppQueue_releaseData.
+ * 
+ * Peek shall return the element pointed by Tail without moving it, the release removes the element
+ * and let the queue empty.
+*/
+void test__AppQueue_peekData__read_in_place_then_release( void )
+{
+    const Msg *slot = AppQueue_peekData( &queueRead );
+
+    TEST_ASSERT_EQUAL_PTR( &bufferRead[ 0 ], slot );
+    TEST_ASSERT_EQUAL( 0, queueRead.Tail );
+    TEST_ASSERT_EQUAL( msgWrite.msg, slot->msg );
+
+    TEST_ASSERT_TRUE( AppQueue_releaseData( &queueRead ) );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &queueRead ) );
+}
+
+/**
+ * @brief   test AppQueue_peekData and AppQueue_releaseData with an empty queue.
+ * 
+ * There is no element, so NULL shall be returned and the release shall fail.
+*/
+void test__AppQueue_peekData__empty_queue_return_NULL( void )
+{
+    TEST_ASSERT_NULL( AppQueue_peekData( &hqueue ) );
+    TEST_ASSERT_FALSE( AppQueue_releaseData( &hqueue ) );
+}
+
+/**
+ * @brief   test reserve/commit and peek/release in SPSC mode.
+ * 
+ * The pointers returned shall follow the buffer slots, wrapping after SPSC_ELEM elements, and
+ * the queue shall refuse a reserve once it holds SPSC_ELEM elements.
+*/
+void test__AppQueue_reserveData__spsc_in_place_round_trip( void )
+{
+    uint8_t *slot;
+
+    for ( uint8_t i = 0; i < SPSC_ELEM; i++ )
+    {
+        slot = AppQueue_reserveData( &spscQueue );
+        TEST_ASSERT_EQUAL_PTR( &bufferSpsc[ i ], slot );
+        *slot = i;
+        AppQueue_commitData( &spscQueue );
+    }
+
+    TEST_ASSERT_NULL( AppQueue_reserveData( &spscQueue ) );
+
+    slot = AppQueue_peekData( &spscQueue );
+    TEST_ASSERT_EQUAL( 0, *slot );
+    AppQueue_releaseData( &spscQueue );
+
+    slot = AppQueue_reserveData( &spscQueue );
+    TEST_ASSERT_EQUAL_PTR( &bufferSpsc[ 0 ], slot );
+}
+
+/**
+ * @brief   test AppQueue_initQueue in Pow2 mode with a non power of two number of elements.
+ * 
+ * The configuration shall be rejected and the queue shall not be initialized.
+*/
+void test__AppQueue_initQueue__pow2_rejects_non_power_of_two_elements( void )
+{
+    hqueue.Elements = 6u;
+    hqueue.Pow2     = TRUE;
+
+    TEST_ASSERT_EQUAL( FALSE, AppQueue_initQueue( &hqueue ) );
+
+    hqueue.Elements = HQUEUE_ELEM;
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_initQueue( &hqueue ) );
+}
+
+/**
+ * @brief   test AppQueue_writeData and AppQueue_readData in Pow2 mode.
+ * 
+ * The indexes shall wrap to zero after HQUEUE_ELEM elements, the same as the modulo indexing,
+ * and the data shall keep its order.
+*/
+void test__AppQueue_writeData__pow2_indexes_wrap_and_keep_order( void )
+{
+    uint8_t value = 0;
+
+    hqueue.Pow2 = TRUE;
+    AppQueue_initQueue( &hqueue );
+
+    for ( uint8_t i = 0; i < ( HQUEUE_ELEM + 3u ); i++ )
+    {
+        AppQueue_writeData( &hqueue, &i );
+        AppQueue_readData( &hqueue, &value );
+        TEST_ASSERT_EQUAL( i, value );
+    }
+
+    TEST_ASSERT_EQUAL( 3, hqueue.Head );
+    TEST_ASSERT_EQUAL( 3, hqueue.Tail );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &hqueue ) );
+}
+
+/**
+ * @brief   test AppQueue_writeData in SPSC and Pow2 mode.
+ * 
+ * The queue shall accept only SPSC_ELEM elements and the indexes shall run up to 2*SPSC_ELEM - 1
+ * before wrap to zero.
+*/
+void test__AppQueue_writeData__spsc_pow2_fill_and_wrap( void )
+{
+    uint8_t value = 0;
+
+    spscQueue.Pow2 = TRUE;
+    AppQueue_initQueue( &spscQueue );
+
+    for ( uint8_t i = 0; i < SPSC_ELEM; i++ )
+    {
+        TEST_ASSERT_TRUE( AppQueue_writeData( &spscQueue, &i ) );
+    }
+    TEST_ASSERT_FALSE( AppQueue_writeData( &spscQueue, &dataW ) );
+
+    for ( uint8_t i = 0; i < ( SPSC_ELEM * 2u ); i++ )
+    {
+        AppQueue_readData( &spscQueue, &value );
+        AppQueue_writeData( &spscQueue, &i );
+    }
+
+    TEST_ASSERT_EQUAL( SPSC_ELEM, spscQueue.Head );
+    TEST_ASSERT_EQUAL( 0, spscQueue.Tail );
+}
+
+/**
+ * @brief   test AppQueue_writeBatch and AppQueue_readBatch across the end of the buffer.
+ * 
+ * The indexes are moved near the end of the buffer, then a batch that wraps around is written and
+ * read back, the elements shall keep its order and the flags shall be updated.
+*/
+void test__AppQueue_readBatch__wrap_around_keeps_order( void )
+{
+    uint8_t dataIn[ HQUEUE_ELEM ]  = { 10, 11, 12, 13, 14, 15, 16, 17 };
+    uint8_t dataOut[ HQUEUE_ELEM ] = { 0 };
+
+    for ( uint8_t i = 0; i < 5u; i++ )
+    {
+        AppQueue_writeData( &hqueue, &dataW );
+        AppQueue_readData( &hqueue, &dataR );
+    }
+
+    TEST_ASSERT_EQUAL( HQUEUE_ELEM, AppQueue_writeBatch( &hqueue, dataIn, HQUEUE_ELEM ) );
+    TEST_ASSERT_EQUAL( TRUE, hqueue.Full );
+
+    TEST_ASSERT_EQUAL( HQUEUE_ELEM, AppQueue_readBatch( &hqueue, dataOut, HQUEUE_ELEM ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( dataIn, dataOut, HQUEUE_ELEM );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &hqueue ) );
+}
+
+/**
+ * @brief   test AppQueue_writeBatch and AppQueue_readBatch with partial transfers.
+ * 
+ * The write shall stop when the queue is full and the read shall return only the stored
+ * elements, or zero if the queue is empty.
+*/
+void test__AppQueue_writeBatch__partial_transfers( void )
+{
+    uint8_t dataIn[ 6 ]  = { 1, 2, 3, 4, 5, 6 };
+    uint8_t dataOut[ 6 ] = { 0 };
+
+    TEST_ASSERT_EQUAL( 0, AppQueue_readBatch( &hqueue, dataOut, 6u ) );
+
+    AppQueue_writeBatch( &hqueue, dataIn, 6u );
+    TEST_ASSERT_EQUAL( 2, AppQueue_writeBatch( &hqueue, dataIn, 6u ) );
+
+    TEST_ASSERT_EQUAL( 6, AppQueue_readBatch( &hqueue, dataOut, 6u ) );
+    TEST_ASSERT_EQUAL( 2, AppQueue_readBatch( &hqueue, dataOut, 6u ) );
+    TEST_ASSERT_EQUAL( 1, dataOut[ 0 ] );
+    TEST_ASSERT_EQUAL( 2, dataOut[ 1 ] );
+}
+
+/**
+ * @brief   test AppQueue_writeBatch and AppQueue_readBatch in SPSC mode.
+ * 
+ * Batches mixed with single writes shall keep the order of the elements, and the queue shall
+ * accept only SPSC_ELEM elements.
+*/
+void test__AppQueue_readBatch__spsc_batches_keep_order( void )
+{
+    uint8_t dataIn[ SPSC_ELEM ]  = { 'a', 'b', 'c', 'd' };
+    uint8_t dataOut[ SPSC_ELEM ] = { 0 };
+
+    AppQueue_writeData( &spscQueue, &dataW );
+    AppQueue_writeData( &spscQueue, &dataW );
+    AppQueue_readBatch( &spscQueue, dataOut, SPSC_ELEM );
+
+    TEST_ASSERT_EQUAL( SPSC_ELEM, AppQueue_writeBatch( &spscQueue, dataIn, SPSC_ELEM ) );
+    TEST_ASSERT_FALSE( AppQueue_writeData( &spscQueue, &dataW ) );
+
+    TEST_ASSERT_EQUAL( SPSC_ELEM, AppQueue_readBatch( &spscQueue, dataOut, SPSC_ELEM ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( dataIn, dataOut, SPSC_ELEM );
+    TEST_ASSERT_TRUE( AppQueue_isQueueEmpty( &spscQueue ) );
+}
+
+/**
+ * @brief   function to get the level of the elements in the priority queue tests.
+ * 
+ * The level is the value of the element divided by ten, 'A'..'Z' elements use level 0.
+*/
+static unsigned char Prio_Level( const void *data )
+{
+    return ( *(const uint8_t*) data ) / 10u;
+}
+
+/**
+ * @brief   Initialize a priority queue with three lanes of two elements each.
+*/
+static void Prio_Init( AppQue_PrioQueue *prio, AppQue_Queue *lanes, uint8_t (*buffers)[ 2 ] )
+{
+    (void) memset( lanes, 0, 3u * sizeof( AppQue_Queue ) );
+
+    for ( uint8_t i = 0; i < 3u; i++ )
+    {
+        lanes[ i ].Buffer   = buffers[ i ];
+        lanes[ i ].Elements = 2u;
+        lanes[ i ].Size     = sizeof( uint8_t );
+        lanes[ i ].Spsc     = FALSE;
+        lanes[ i ].Pow2     = TRUE;
+    }
+
+    prio->Lanes  = lanes;
+    prio->Levels = 3u;
+    prio->Level  = Prio_Level;
+    AppQueue_initPrioQueue( prio );
+}
+
+/**
+ * @brief   test AppQueue_peekPrio and AppQueue_releasePrio order.
+ * 
+ * The elements are written from the lowest to the highest priority, the reads shall return them
+ * from the highest to the lowest, in FIFO order inside each level.
+*/
+void test__AppQueue_peekPrio__highest_level_first( void )
+{
+    AppQue_PrioQueue prio;
+    AppQue_Queue lanes[ 3 ];
+    uint8_t buffers[ 3 ][ 2 ];
+    const uint8_t dataIn[ 5 ]   = { 20, 21, 10, 0, 1 };
+    const uint8_t expected[ 5 ] = { 0, 1, 10, 20, 21 };
+    uint8_t level;
+
+    Prio_Init( &prio, lanes, buffers );
+
+    for ( uint8_t i = 0; i < 5u; i++ )
+    {
+        TEST_ASSERT_TRUE( AppQueue_writePrio( &prio, &dataIn[ i ] ) );
+    }
+
+    for ( uint8_t i = 0; i < 5u; i++ )
+    {
+        const uint8_t *element = AppQueue_peekPrio( &prio, &level );
+        TEST_ASSERT_EQUAL( expected[ i ], *element );
+        TEST_ASSERT_EQUAL( expected[ i ] / 10u, level );
+        TEST_ASSERT_TRUE( AppQueue_releasePrio( &prio, level ) );
+    }
+
+    TEST_ASSERT_NULL( AppQueue_peekPrio( &prio, &level ) );
+    TEST_ASSERT_TRUE( AppQueue_isPrioQueueEmpty( &prio ) );
+}
+
+/**
+ * @brief   test AppQueue_writePrio Ready bitmap and full lanes.
+ * 
+ * Each written level shall set its bit, a full lane shall reject the element without affect the
+ * other lanes, and a level out of range shall be written in the lowest priority lane.
+*/
+void test__AppQueue_writePrio__ready_bits_and_full_lane( void )
+{
+    AppQue_PrioQueue prio;
+    AppQue_Queue lanes[ 3 ];
+    uint8_t buffers[ 3 ][ 2 ];
+    const uint8_t high = 5;
+    const uint8_t outOfRange = 99;
+
+    Prio_Init( &prio, lanes, buffers );
+
+    AppQueue_writePrio( &prio, &high );
+    AppQueue_writePrio( &prio, &high );
+    TEST_ASSERT_FALSE( AppQueue_writePrio( &prio, &high ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x01, prio.Ready );
+
+    TEST_ASSERT_TRUE( AppQueue_writePrio( &prio, &outOfRange ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x05, prio.Ready );
+    TEST_ASSERT_FALSE( AppQueue_isQueueEmpty( &lanes[ 2 ] ) );
+}
+
+/**
+ * @brief   test AppQueue_freePrio, the free space of the lane of each element.
+ * 
+ * The free space shall drop with each write of the same level, without affect the other lanes.
+*/
+void test__AppQueue_freePrio__free_space_of_the_lane( void )
+{
+    AppQue_PrioQueue prio;
+    AppQue_Queue lanes[ 3 ];
+    uint8_t buffers[ 3 ][ 2 ];
+    const uint8_t high = 5;
+    const uint8_t low = 25;
+
+    Prio_Init( &prio, lanes, buffers );
+
+    TEST_ASSERT_EQUAL( 2u, AppQueue_freePrio( &prio, &high ) );
+    AppQueue_writePrio( &prio, &high );
+    TEST_ASSERT_EQUAL( 1u, AppQueue_freePrio( &prio, &high ) );
+    AppQueue_writePrio( &prio, &high );
+    TEST_ASSERT_EQUAL( 0u, AppQueue_freePrio( &prio, &high ) );
+    TEST_ASSERT_EQUAL( 2u, AppQueue_freePrio( &prio, &low ) );
+}
+
+/**
+ * @brief   test AppQueue_releasePrio when a higher level arrives before the release.
+ * 
+ * The element released shall be the one from the level given by the peek, and the bit of that
+ * level shall be cleared only when its lane is empty.
+*/
+void test__AppQueue_releasePrio__higher_level_written_after_peek( void )
+{
+    AppQue_PrioQueue prio;
+    AppQue_Queue lanes[ 3 ];
+    uint8_t buffers[ 3 ][ 2 ];
+    const uint8_t low = 25;
+    const uint8_t high = 3;
+    uint8_t level;
+
+    Prio_Init( &prio, lanes, buffers );
+
+    AppQueue_writePrio( &prio, &low );
+    (void) AppQueue_peekPrio( &prio, &level );
+    AppQueue_writePrio( &prio, &high );
+
+    AppQueue_releasePrio( &prio, level );
+
+    TEST_ASSERT_EQUAL_HEX8( 0x01, prio.Ready );
+    TEST_ASSERT_EQUAL( high, *(uint8_t*) AppQueue_peekPrio( &prio, &level ) );
+}
+
+/**
+ * @brief   test AppQueue_flushPrio discard only the given lane.
+ * 
+ * The elements of the flushed level shall be gone and its bit cleared, the other lanes shall keep
+ * their elements and a new write in the flushed lane shall be read normally.
+*/
+void test__AppQueue_flushPrio__discard_only_the_given_lane( void )
+{
+    AppQue_PrioQueue prio;
+    AppQue_Queue lanes[ 3 ];
+    uint8_t buffers[ 3 ][ 2 ];
+    const uint8_t high = 3;
+    const uint8_t low = 25;
+    uint8_t level;
+
+    Prio_Init( &prio, lanes, buffers );
+
+    AppQueue_writePrio( &prio, &low );
+    AppQueue_writePrio( &prio, &low );
+    AppQueue_writePrio( &prio, &high );
+
+    AppQueue_flushPrio( &prio, 2u );
+
+    TEST_ASSERT_EQUAL_HEX8( 0x01, prio.Ready );
+    TEST_ASSERT_EQUAL( high, *(uint8_t*) AppQueue_peekPrio( &prio, &level ) );
+    AppQueue_releasePrio( &prio, level );
+    TEST_ASSERT_NULL( AppQueue_peekPrio( &prio, &level ) );
+
+    TEST_ASSERT_TRUE( AppQueue_writePrio( &prio, &low ) );
+    TEST_ASSERT_EQUAL( low, *(uint8_t*) AppQueue_peekPrio( &prio, &level ) );
+}
+
+/**
+ * @brief   test a typed queue write and read in order.
+ * 
+ * The queue shall accept TYPED_ELEM messages, reject the next one and keep the order of the
+ * messages after its indexes wrap around.
+*/
+void test__QUEUE_DEFINE__write_read_keep_order_and_wrap( void )
+{
+    Msg in = {0};
+    Msg out = {0};
+
+    for( unsigned char i = 0u; i < TYPED_ELEM; i++ )
+    {
+        in.msg = 'a' + i;
+        TEST_ASSERT_EQUAL( TRUE, MsgQ_write( &typedQueue, &in ) );
+    }
+    TEST_ASSERT_EQUAL( FALSE, MsgQ_write( &typedQueue, &in ) );
+
+    for( unsigned char i = 0u; i < (2u * TYPED_ELEM) + 1u; i++ )
+    {
+        TEST_ASSERT_EQUAL( TRUE, MsgQ_read( &typedQueue, &out ) );
+        TEST_ASSERT_EQUAL( 'a' + i, out.msg );
+        in.msg = 'a' + TYPED_ELEM + i;
+        in.val = i;
+        TEST_ASSERT_EQUAL( TRUE, MsgQ_write( &typedQueue, &in ) );
+    }
+
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_read( &typedQueue, &out ) );
+    TEST_ASSERT_EQUAL( 'a' + (2u * TYPED_ELEM) + 1u, out.msg );
+    TEST_ASSERT_EQUAL( TYPED_ELEM + 1u, out.val );
+}
+
+/**
+ * @brief   test a typed queue peek and release.
+ * 
+ * The peek shall return a pointer to the oldest message inside the buffer, and NULL when the
+ * queue is empty, the release shall fail with an empty queue.
+*/
+void test__QUEUE_DEFINE__peek_in_place_then_release( void )
+{
+    Msg in = { .msg = 'x', .val = 7u };
+
+    TEST_ASSERT_NULL( MsgQ_peek( &typedQueue ) );
+    TEST_ASSERT_EQUAL( FALSE, MsgQ_release( &typedQueue ) );
+
+    MsgQ_write( &typedQueue, &in );
+    Msg *element = MsgQ_peek( &typedQueue );
+
+    TEST_ASSERT_EQUAL_PTR( &typedQueue.Buffer[ 0 ], element );
+    TEST_ASSERT_EQUAL( 'x', element->msg );
+    TEST_ASSERT_EQUAL( 7u, element->val );
+    TEST_ASSERT_EQUAL( FALSE, MsgQ_isEmpty( &typedQueue ) );
+
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_release( &typedQueue ) );
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_isEmpty( &typedQueue ) );
+}
+
+/**
+ * @brief   test a typed queue flush.
+ * 
+ * After the flush the queue shall be empty and accept again TYPED_ELEM messages.
+*/
+void test__QUEUE_DEFINE__flush_empties_the_queue( void )
+{
+    Msg in = {0};
+
+    MsgQ_write( &typedQueue, &in );
+    MsgQ_write( &typedQueue, &in );
+    MsgQ_flush( &typedQueue );
+
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_isEmpty( &typedQueue ) );
+    for( unsigned char i = 0u; i < TYPED_ELEM; i++ )
+    {
+        TEST_ASSERT_EQUAL( TRUE, MsgQ_write( &typedQueue, &in ) );
+    }
+}
+
+/**
+ * @brief   Init a queue of Msg with Coalesce_Void as Coalesce function.
+ * 
+ * @param   queue [out] queue to init.
+ * @param   msgs [in] buffer of the queue.
+ * @param   n [in] number of elements of msgs.
+*/
+static void Coalesce_Init( AppQue_Queue *queue, Msg *msgs, unsigned long n )
+{
+    memset( queue, 0, sizeof( AppQue_Queue ) );
+    queue->Buffer   = msgs;
+    queue->Elements = n;
+    queue->Size     = sizeof( Msg );
+    queue->Coalesce = Coalesce_Void;
+    AppQueue_initQueue( queue );
+}
+
+/**
+ * @brief   test the write of a queue with a Coalesce function.
+ * 
+ * A new 'D' message shall update the pending 'D' in place, keeping its place in the queue, and
+ * the queue shall keep the same number of elements.
+*/
+void test__AppQueue_writeData__coalesce_merges_pending_element( void )
+{
+    AppQue_Queue queue;
+    Msg msgs[ 4 ];
+    Msg in[ 4 ] = { { 'A', 0u }, { 'D', 1u }, { 'B', 0u }, { 'D', 2u } };
+    Msg out = {0};
+
+    Coalesce_Init( &queue, msgs, 4u );
+
+    for( unsigned char i = 0u; i < 4u; i++ )
+    {
+        TEST_ASSERT_EQUAL( TRUE, AppQueue_writeData( &queue, &in[ i ] ) );
+    }
+
+    AppQueue_readData( &queue, &out );
+    TEST_ASSERT_EQUAL( 'A', out.msg );
+    AppQueue_readData( &queue, &out );
+    TEST_ASSERT_EQUAL( 'D', out.msg );
+    TEST_ASSERT_EQUAL( 2u, out.val );
+    AppQueue_readData( &queue, &out );
+    TEST_ASSERT_EQUAL( 'B', out.msg );
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_isQueueEmpty( &queue ) );
+}
+
+/**
+ * @brief   test the merge with the oldest element and the elements that can not be merged.
+ * 
+ * The oldest element is merged while it's not peeked, after a peek the consumer could be
+ * processing it and the new 'D' is appended, and a 'S' message after a pending 'D' forces the
+ * new 'D' to be appended too.
+*/
+void test__AppQueue_writeData__coalesce_oldest_and_stop_append( void )
+{
+    AppQue_Queue queue;
+    Msg msgs[ 4 ];
+    Msg in[ 5 ] = { { 'D', 1u }, { 'D', 2u }, { 'D', 3u }, { 'S', 0u }, { 'D', 4u } };
+    Msg out = {0};
+    const Msg *element;
+
+    Coalesce_Init( &queue, msgs, 4u );
+
+    AppQueue_writeData( &queue, &in[ 0 ] );
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_writeData( &queue, &in[ 1 ] ) );
+    element = AppQueue_peekData( &queue );
+    TEST_ASSERT_EQUAL( 2u, element->val );
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_writeData( &queue, &in[ 2 ] ) );
+    AppQueue_releaseData( &queue );
+
+    AppQueue_writeData( &queue, &in[ 3 ] );
+    AppQueue_writeData( &queue, &in[ 4 ] );
+
+    for( unsigned char i = 2u; i < 5u; i++ )
+    {
+        TEST_ASSERT_EQUAL( TRUE, AppQueue_readData( &queue, &out ) );
+        TEST_ASSERT_EQUAL( in[ i ].msg, out.msg );
+        TEST_ASSERT_EQUAL( in[ i ].val, out.val );
+    }
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_isQueueEmpty( &queue ) );
+}
+
+/**
+ * @brief   test the merge in a full queue after the indexes wrap around.
+ * 
+ * A full queue shall still accept a 'D' message that can be merged.
+*/
+void test__AppQueue_writeData__coalesce_in_full_queue( void )
+{
+    AppQue_Queue queue;
+    Msg msgs[ 3 ];
+    Msg in = { 'A', 0u };
+    Msg out = {0};
+
+    Coalesce_Init( &queue, msgs, 3u );
+
+    AppQueue_writeData( &queue, &in );
+    AppQueue_writeData( &queue, &in );
+    AppQueue_readData( &queue, &out );
+    AppQueue_readData( &queue, &out );
+    AppQueue_writeData( &queue, &in );
+    in.msg = 'D';
+    AppQueue_writeData( &queue, &in );
+    in.msg = 'B';
+    AppQueue_writeData( &queue, &in );
+
+    TEST_ASSERT_EQUAL( FALSE, AppQueue_writeData( &queue, &in ) );
+    in.msg = 'D';
+    in.val = 9u;
+    TEST_ASSERT_EQUAL( TRUE, AppQueue_writeData( &queue, &in ) );
+
+    AppQueue_readData( &queue, &out );
+    AppQueue_readData( &queue, &out );
+    TEST_ASSERT_EQUAL( 'D', out.msg );
+    TEST_ASSERT_EQUAL( 9u, out.val );
+}
+
+/**
+ * @brief   test the writeCoalesce function of a typed queue.
+ * 
+ * The new 'D' message shall update the pending one, and with a 'S' after it shall be appended.
+*/
+void test__QUEUE_DEFINE__writeCoalesce_merge_and_stop( void )
+{
+    Msg in = { 'A', 0u };
+    Msg out = {0};
+
+    MsgQ_write( &typedQueue, &in );
+    in.msg = 'D';
+    MsgQ_write( &typedQueue, &in );
+    in.val = 5u;
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_writeCoalesce( &typedQueue, &in, Coalesce_Msg ) );
+
+    in.msg = 'S';
+    MsgQ_write( &typedQueue, &in );
+    in.msg = 'D';
+    TEST_ASSERT_EQUAL( FALSE, MsgQ_writeCoalesce( &typedQueue, &in, Coalesce_Msg ) );
+
+    MsgQ_read( &typedQueue, &out );
+    MsgQ_read( &typedQueue, &out );
+    TEST_ASSERT_EQUAL( 'D', out.msg );
+    TEST_ASSERT_EQUAL( 5u, out.val );
+}
+
+/**
+ * @brief   test the writeCoalesce function of a typed queue with the oldest element.
+ * 
+ * The oldest 'D' shall be merged until it's peeked, then the new 'D' shall be appended.
+*/
+void test__QUEUE_DEFINE__writeCoalesce_oldest_unless_peeked( void )
+{
+    Msg in = { 'D', 1u };
+    Msg out = {0};
+
+    MsgQ_write( &typedQueue, &in );
+    in.val = 2u;
+    MsgQ_writeCoalesce( &typedQueue, &in, Coalesce_Msg );
+    TEST_ASSERT_EQUAL( 2u, MsgQ_peek( &typedQueue )->val );
+
+    in.val = 3u;
+    MsgQ_writeCoalesce( &typedQueue, &in, Coalesce_Msg );
+    MsgQ_release( &typedQueue );
+
+    MsgQ_read( &typedQueue, &out );
+    TEST_ASSERT_EQUAL( 3u, out.val );
+    TEST_ASSERT_EQUAL( TRUE, MsgQ_isEmpty( &typedQueue ) );
+}
+
+#ifdef QUEUE_STATS
+/**
+ * @brief   test the occupancy counters of the queue.
+ * 
+ * The high-water mark shall keep the max number of elements, the writes shall count all the
+ * written elements and the rejects the ones that didn't fit, also in batches.
+*/
+void test__AppQueue_writeData__stats_high_water_writes_and_rejects( void )
+{
+    uint8_t dataIn[ 4 ] = { 0 };
+
+    AppQueue_writeData( &hqueue, &dataW );
+    AppQueue_writeData( &hqueue, &dataW );
+    AppQueue_writeData( &hqueue, &dataW );
+    AppQueue_readData( &hqueue, &dataR );
+    AppQueue_readData( &hqueue, &dataR );
+
+    TEST_ASSERT_EQUAL( 3, hqueue.Stats.HighWater );
+
+    AppQueue_writeBatch( &hqueue, dataIn, 4u );
+    AppQueue_writeBatch( &hqueue, dataIn, 4u );
+    AppQueue_writeData( &hqueue, &dataW );
+
+    TEST_ASSERT_EQUAL( HQUEUE_ELEM, hqueue.Stats.HighWater );
+    TEST_ASSERT_EQUAL( 3u + 4u + 3u, hqueue.Stats.Writes );
+    TEST_ASSERT_EQUAL( 1u + 1u, hqueue.Stats.Rejects );
+}
+
+/**
+ * @brief   test the max dwell time of the queue.
+ * 
+ * The elements are stamped with the HAL tick when they are written, the max dwell time shall be
+ * the longest difference between the read and the write ticks.
+*/
+void test__AppQueue_readData__stats_max_dwell_time( void )
+{
+    unsigned long stamps[ SPSC_ELEM ];
+
+    spscQueue.Stats.Stamps = stamps;
+    AppQueue_initQueue( &spscQueue );
+
+    HAL_GetTick_ExpectAndReturn( 100u );
+    AppQueue_writeData( &spscQueue, &dataW );
+    HAL_GetTick_ExpectAndReturn( 105u );
+    AppQueue_writeData( &spscQueue, &dataW );
+
+    HAL_GetTick_ExpectAndReturn( 130u );
+    AppQueue_readData( &spscQueue, &dataR );
+    HAL_GetTick_ExpectAndReturn( 140u );
+    AppQueue_readData( &spscQueue, &dataR );
+
+    TEST_ASSERT_EQUAL( 35u, spscQueue.Stats.MaxDwell );
+
+    spscQueue.Stats.Stamps = NULL;
+}
+
+/**
+ * @brief   test the occupancy counters of a typed queue.
+*/
+void test__QUEUE_DEFINE__stats_high_water_writes_and_rejects( void )
+{
+    Msg in = {0};
+
+    for( unsigned char i = 0u; i < TYPED_ELEM + 2u; i++ )
+    {
+        MsgQ_write( &typedQueue, &in );
+    }
+    MsgQ_read( &typedQueue, &in );
+    MsgQ_write( &typedQueue, &in );
+
+    TEST_ASSERT_EQUAL( TYPED_ELEM, typedQueue.Stats.HighWater );
+    TEST_ASSERT_EQUAL( TYPED_ELEM + 1u, typedQueue.Stats.Writes );
+    TEST_ASSERT_EQUAL( 2u, typedQueue.Stats.Rejects );
+}
+#endif
+
+/**
+ * @brief   test AppQueue_writeData, the Event flag is set by each write.
+ * 
+ * The flag is cleared before each write, it must be TRUE after a write and stay FALSE after a
+ * write rejected because the queue is full.
+*/
+void test__AppQueue_writeData__event_flag_set_on_write( void )
+{
+    volatile unsigned char event = FALSE;
+
+    queueFull.Event = &event;
+    spscQueue.Event = &event;
+
+    AppQueue_writeData( &spscQueue, &dataW );
+    TEST_ASSERT_EQUAL( TRUE, event );
+
+    event = FALSE;
+    AppQueue_writeData( &queueFull, &dataW );
+    TEST_ASSERT_EQUAL( FALSE, event );
+
+    AppQueue_readData( &queueFull, &dataR );
+    AppQueue_writeData( &queueFull, &dataW );
+    TEST_ASSERT_EQUAL( TRUE, event );
+
+    queueFull.Event = NULL;
+    spscQueue.Event = NULL;
+}
+
+/**
+ * @brief   test AppQueue_commitData and AppQueue_writeBatch, the Event flag is set.
+*/
+void test__AppQueue_writeBatch__event_flag_set_on_commit_and_batch( void )
+{
+    volatile unsigned char event = FALSE;
+    uint8_t data[ 2 ] = { 'A', 'B' };
+
+    hqueue.Event = &event;
+
+    (void) AppQueue_reserveData( &hqueue );
+    TEST_ASSERT_EQUAL( FALSE, event );
+    AppQueue_commitData( &hqueue );
+    TEST_ASSERT_EQUAL( TRUE, event );
+
+    event = FALSE;
+    AppQueue_writeBatch( &hqueue, data, 0u );
+    TEST_ASSERT_EQUAL( FALSE, event );
+    AppQueue_writeBatch( &hqueue, data, 2u );
+    TEST_ASSERT_EQUAL( TRUE, event );
+
+    hqueue.Event = NULL;
+}
+
+/**
+ * @brief   test AppQueue_writeData, the Event flag is set when the element is merged.
+*/
+void test__AppQueue_writeData__event_flag_set_on_coalesce( void )
+{
+    AppQue_Queue queue;
+    Msg msgs[ 3 ];
+    Msg in = { 'D', 1u };
+    volatile unsigned char event = FALSE;
+
+    Coalesce_Init( &queue, msgs, 3u );
+    queue.Event = &event;
+
+    AppQueue_writeData( &queue, &in );
+    AppQueue_writeData( &queue, &in );
+    event = FALSE;
+    AppQueue_writeData( &queue, &in );
+
+    TEST_ASSERT_EQUAL( TRUE, event );
+}
+
+/**
+ * @brief   test the Event flag of a typed queue, set by the write and the merge.
+*/
+void test__QUEUE_DEFINE__event_flag_set_on_write_and_merge( void )
+{
+    volatile unsigned char event = FALSE;
+    Msg in = { 'D', 1u };
+
+    MsgQ_write( &typedQueue, &in );
+    TEST_ASSERT_EQUAL( FALSE, event );
+
+    typedQueue.Event = &event;
+    MsgQ_write( &typedQueue, &in );
+    TEST_ASSERT_EQUAL( TRUE, event );
+
+    event = FALSE;
+    MsgQ_writeCoalesce( &typedQueue, &in, Coalesce_Msg );
+    TEST_ASSERT_EQUAL( TRUE, event );
+    TEST_ASSERT_EQUAL( 2u, MsgQ_used( typedQueue.Head, typedQueue.Tail ) );
+}
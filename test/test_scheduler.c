@@ -24,6 +24,21 @@ uint8_t numLoops;
 */
 TIM_HandleTypeDef TIM6_Handler;
 
+/**
+ * @brief   reference to TIM7 Handler.
+*/
+TIM_HandleTypeDef TIM7_Handler;
+
+/**
+ * @brief   Reference for the private function Scheduler_Profile.
+*/
+void Scheduler_Profile( AppSched_Task *task, unsigned long exec, unsigned long response );
+
+/**
+ * @brief   Reference for the private function Scheduler_CpuLoad.
+*/
+void Scheduler_CpuLoad( AppSched_Scheduler *scheduler, unsigned long ticks, unsigned long busy );
+
 /** @brief  Scheduler without registered tasks */
 AppSched_Scheduler Sche;
 /** @brief  Task control block for Sche*/
@@ -36,6 +51,9 @@ AppSched_Scheduler ScheWithTask;
 /** @brief  Task control block for ScheWithTask*/
 AppSched_Task taskSche[ 4 ];
 
+/** @brief  Task control block for ScheWithTask with the tasks of main.c */
+AppSched_Task mainTasks[ 6 ];
+
 /** @brief  Scheduler with registered timers */
 AppSched_Scheduler ScheWithTimer;
 /** @brief  Task control block for ScheWithTimer*/
@@ -671,6 +689,7 @@ void test__AppSched_startScheduler__start_scheduler_and_reach_timeout_timer( voi
     HAL_NVIC_EnableIRQ_Ignore( );
     HAL_TIM_Base_Init_IgnoreAndReturn( HAL_OK );
     HAL_TIM_Base_Start_IT_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IgnoreAndReturn( HAL_OK );
     
     HAL_GetTick_IgnoreAndReturn( 100 );
     HAL_GetTick_IgnoreAndReturn( 200 );
@@ -692,6 +711,7 @@ void test__AppSched_startScheduler__start_scheduler_and_reach_timeout_task( void
     HAL_NVIC_EnableIRQ_Ignore( );
     HAL_TIM_Base_Init_IgnoreAndReturn( HAL_OK );
     HAL_TIM_Base_Start_IT_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IgnoreAndReturn( HAL_OK );
     
     HAL_GetTick_IgnoreAndReturn( 100 );
     HAL_GetTick_IgnoreAndReturn( 200 );
@@ -714,4 +734,1239 @@ void test__HAL_TIM_PeriodElapsedCallback( void )
     TIM_HandleTypeDef htim;
 
     HAL_TIM_PeriodElapsedCallback( &htim );
-}
\ No newline at end of file
+}
+/** @brief  Tick of the simulated scheduler, the same used in main.c */
+#define SIM_TICK        5u
+/** @brief  Max number of runs recorded per task or timer in the simulation */
+#define SIM_RUNS        64u
+
+/** @brief  Scheduler of the host simulation */
+AppSched_Scheduler SimSche;
+/** @brief  Task control block for SimSche */
+AppSched_Task simTasks[ 3 ];
+/** @brief  Timer control block for SimSche */
+AppSched_Timer simTimers[ 1 ];
+
+/** @brief  virtual time of the simulation in ms */
+unsigned long simTime;
+/** @brief  ms that pass each time the tick is read, one to poll the tick and zero in tickless mode */
+unsigned long simStep;
+/** @brief  number of calls to the idle function */
+unsigned long simSleeps;
+/** @brief  times when each task and the timer were run, the timer is the last one */
+unsigned long simRuns[ 4 ][ SIM_RUNS ];
+/** @brief  number of runs of each task and the timer */
+unsigned long simCount[ 4 ];
+/** @brief  ms that the next run of the 50 ms task takes, to simulate an overrun */
+unsigned long simSlow;
+
+/** @brief  records the time of a run */
+static void Sim_Record( unsigned char index )
+{
+    if( simCount[ index ] < SIM_RUNS )
+    {
+        simRuns[ index ][ simCount[ index ] ] = simTime;
+    }
+    simCount[ index ]++;
+}
+
+/** @brief  task of the simulation with a period of 10 ms */
+void SimTask10( void )
+{
+    Sim_Record( 0 );
+}
+
+/** @brief  task of the simulation with a period of 50 ms */
+void SimTask50( void )
+{
+    Sim_Record( 1 );
+    simTime += simSlow;
+    simSlow = 0u;
+}
+
+/** @brief  task of the simulation with a period of 150 ms */
+void SimTask150( void )
+{
+    Sim_Record( 2 );
+}
+
+/** @brief  timer callback of the simulation, it restarts the timer */
+void SimTimer40( void )
+{
+    Sim_Record( 3 );
+    AppSched_startTimer( &SimSche, 1 );
+}
+
+/** @brief  HAL tick of the simulation, it advances simStep ms before each read */
+uint32_t Sim_GetTick( int cmock_num_calls )
+{
+    (void) cmock_num_calls;
+
+    simTime += simStep;
+
+    return simTime;
+}
+
+/** @brief  idle function of the simulation, the virtual time advances the ms requested */
+void Sim_Sleep( unsigned long ms )
+{
+    TEST_ASSERT_TRUE( ms > 0u );
+    simTime += ms;
+    simSleeps++;
+}
+
+/**
+ * @brief   Configure the simulated scheduler, polling the tick or in tickless mode.
+ * 
+ * The scheduler has the tick and three of the periods used in main.c, and a timer restarted every
+ * 40 ms, the first read of the tick is 1000 ms.
+ * 
+ * @param   idle [in] Idle function, NULL to poll the tick.
+*/
+static void Sim_Init( void (*idle)( unsigned long ms ) )
+{
+    HAL_NVIC_SetPriority_Ignore( );
+    HAL_NVIC_EnableIRQ_Ignore( );
+    HAL_TIM_Base_Init_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IT_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IgnoreAndReturn( HAL_OK );
+    HAL_GetTick_StubWithCallback( Sim_GetTick );
+
+    memset( simCount, 0, sizeof( simCount ) );
+    simSleeps = 0u;
+    simSlow = 0u;
+    simStep = ( idle == NULL ) ? 1u : 0u;
+    simTime = 1000u - simStep;      /*the first read, the tick start, is 1000*/
+
+    SimSche.tick     = SIM_TICK;
+    SimSche.tasks    = 3;
+    SimSche.taskPtr  = simTasks;
+    SimSche.timers   = 1;
+    SimSche.timerPtr = simTimers;
+    SimSche.idleFunc = idle;
+    SimSche.catchUp  = SCHED_CATCHUP_BURST;
+    AppSched_initScheduler( &SimSche );
+    AppSched_registerTask( &SimSche, NULL, SimTask10, 10 );
+    AppSched_registerTask( &SimSche, NULL, SimTask50, 50 );
+    AppSched_registerTask( &SimSche, NULL, SimTask150, 150 );
+    AppSched_registerTimer( &SimSche, 40, SimTimer40 );
+    AppSched_startTimer( &SimSche, 1 );
+}
+
+/**
+ * @brief   Run the simulated scheduler for 255 loops, polling the tick or in tickless mode.
+ * 
+ * @param   idle [in] Idle function, NULL to poll the tick.
+*/
+static void Sim_Run( void (*idle)( unsigned long ms ) )
+{
+    Sim_Init( idle );
+
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+}
+
+/**
+ * @brief   Check that each task and the timer run exactly at multiples of its period.
+ * 
+ * @param   periods [in] Periods of the three tasks and the timer.
+*/
+static void Sim_CheckPeriods( const unsigned long *periods )
+{
+    for( unsigned char i = 0; i < 4u; i++ )
+    {
+        for( unsigned long k = 0; ( k < simCount[ i ] ) && ( k < SIM_RUNS ); k++ )
+        {
+            TEST_ASSERT_EQUAL( 1000u + ( ( k + 1u ) * periods[ i ] ), simRuns[ i ][ k ] );
+        }
+    }
+}
+
+/**
+ * @brief   test AppSched_startScheduler polling the tick, host simulation.
+ * 
+ * Without idle function the tick is read every ms, the tasks and the timer run at their periods.
+*/
+void test__AppSched_startScheduler__simulation_polling_periods( void )
+{
+    const unsigned long periods[ 4 ] = { 10u, 50u, 150u, 40u };
+
+    Sim_Run( NULL );
+
+    TEST_ASSERT_EQUAL( 0u, simSleeps );
+    TEST_ASSERT_EQUAL( 25u, simCount[ 0 ] );
+    Sim_CheckPeriods( periods );
+}
+
+/**
+ * @brief   test AppSched_startScheduler in tickless mode, host simulation.
+ * 
+ * With the idle function the scheduler sleeps between the ticks with something to run, the tasks
+ * and the timer must run at the same times than polling the tick, and the same number of loops
+ * covers much more time.
+*/
+void test__AppSched_startScheduler__simulation_tickless_same_periods( void )
+{
+    const unsigned long periods[ 4 ] = { 10u, 50u, 150u, 40u };
+
+    Sim_Run( Sim_Sleep );
+
+    TEST_ASSERT_TRUE( simSleeps > 0u );
+    TEST_ASSERT_TRUE( simCount[ 0 ] > 25u );
+    TEST_ASSERT_TRUE( simCount[ 2 ] > 0u );
+    Sim_CheckPeriods( periods );
+}
+
+/**
+ * @brief   test AppSched_startScheduler in tickless mode, the sleep ends at the next task to run.
+ * 
+ * The only task has a period of 100 ms, each sleep goes up to the next multiple of 100 ms and
+ * the ticks in between are processed after waking up.
+*/
+void test__AppSched_startScheduler__simulation_tickless_sleep_to_next_task( void )
+{
+    Sim_Run( Sim_Sleep );
+
+    TEST_ASSERT_EQUAL( 1u, AppSched_stopTask( &SimSche, 1 ) );
+    TEST_ASSERT_EQUAL( 1u, AppSched_stopTask( &SimSche, 3 ) );
+    TEST_ASSERT_EQUAL( 1u, AppSched_periodTask( &SimSche, 2, 100 ) );
+    TEST_ASSERT_EQUAL( 1u, AppSched_stopTimer( &SimSche, 1 ) );
+    SimSche.taskPtr[ 1 ].elapsed = 0u;
+    memset( simCount, 0, sizeof( simCount ) );
+    simSleeps = 0u;
+    simTime = 1000u;
+    numLoops = 63;      /*three sleeps of 100 ms, each one followed by 20 ticks*/
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 3u, simSleeps );
+    TEST_ASSERT_EQUAL( 3u, simCount[ 1 ] );
+    TEST_ASSERT_EQUAL( 1300u, simRuns[ 1 ][ 2 ] );
+    TEST_ASSERT_EQUAL( 0u, simCount[ 0 ] );
+    TEST_ASSERT_EQUAL( 0u, SimSche.lateTicks );
+}
+
+/** @brief  Event flag of the simulation */
+volatile unsigned char simEvent;
+/** @brief  times when the event flag is set by Sim_SleepEvent, as an interrupt would do */
+unsigned long simEventAt;
+
+/** @brief  idle function of the simulation, an interrupt at simEventAt sets the event and wakes up */
+void Sim_SleepEvent( unsigned long ms )
+{
+    simSleeps++;
+
+    if( ( simTime < simEventAt ) && ( ( simTime + ms ) >= simEventAt ) )
+    {
+        simTime = simEventAt;
+        simEvent = TRUE;
+    }
+    else
+    {
+        simTime += ms;
+    }
+}
+
+/**
+ * @brief   test AppSched_eventTask with not valid taskIDs.
+*/
+void test__AppSched_eventTask__not_valid_taskID( void )
+{
+    TEST_ASSERT_FALSE( AppSched_eventTask( &ScheWithTask, 0, &simEvent ) );
+    TEST_ASSERT_FALSE( AppSched_eventTask( &ScheWithTask, 5, &simEvent ) );
+}
+
+/**
+ * @brief   test AppSched_eventTask with a valid taskID, the TCB keeps the flag.
+*/
+void test__AppSched_eventTask__valid_taskID( void )
+{
+    TEST_ASSERT_TRUE( AppSched_eventTask( &ScheWithTask, 4, &simEvent ) );
+    TEST_ASSERT_EQUAL_PTR( &simEvent, ScheWithTask.taskPtr[ 3 ].event );
+}
+
+/**
+ * @brief   test AppSched_registerTask, a new task is not bound to any event.
+*/
+void test__AppSched_registerTask__no_event( void )
+{
+    TEST_ASSERT_NULL( ScheWithTask.taskPtr[ 0 ].event );
+}
+
+/**
+ * @brief   test AppSched_startScheduler, a task bound to an event runs before its period.
+ * 
+ * The 10 ms task is bound to simEvent, the 150 ms task is the next one to run when the interrupt
+ * sets the flag at 1003 ms, so the scheduler is sleeping. The task must run at 1003 ms, and then
+ * keep its period, at 1010 ms and 1020 ms.
+*/
+void test__AppSched_startScheduler__simulation_event_wakes_task( void )
+{
+    simEventAt = 1003u;
+    simEvent = FALSE;
+
+    Sim_Run( Sim_Sleep );       /*just to configure SimSche*/
+
+    TEST_ASSERT_TRUE( AppSched_eventTask( &SimSche, 1, &simEvent ) );
+    SimSche.idleFunc = Sim_SleepEvent;
+    for( unsigned char i = 0; i < 3u; i++ )
+    {
+        SimSche.taskPtr[ i ].elapsed = 0u;
+    }
+    AppSched_stopTimer( &SimSche, 1 );
+    memset( simCount, 0, sizeof( simCount ) );
+    simTime = 1000u;
+    numLoops = 8;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( FALSE, simEvent );
+    TEST_ASSERT_EQUAL( 3u, simCount[ 0 ] );
+    TEST_ASSERT_EQUAL( 1003u, simRuns[ 0 ][ 0 ] );
+    TEST_ASSERT_EQUAL( 1010u, simRuns[ 0 ][ 1 ] );
+    TEST_ASSERT_EQUAL( 1020u, simRuns[ 0 ][ 2 ] );
+}
+
+/** @brief  task of the simulation that writes in its own queue while it runs, as an interrupt would do */
+void Sim_TaskEvent( void )
+{
+    Sim_Record( 0 );
+    simEvent = TRUE;
+}
+
+/**
+ * @brief   test AppSched_startScheduler, the scheduler does not sleep with an event pending.
+ * 
+ * The flag is set but the task is stopped, it must not run, and since a stopped task has no
+ * pending event the scheduler sleeps. After start the task, the event runs it, and the task sets
+ * the flag again while it runs, so the scheduler must not sleep.
+*/
+void test__AppSched_startScheduler__simulation_no_sleep_with_event( void )
+{
+    Sim_Run( Sim_Sleep );       /*just to configure SimSche*/
+
+    TEST_ASSERT_TRUE( AppSched_eventTask( &SimSche, 1, &simEvent ) );
+    SimSche.taskPtr[ 0 ].taskFunc = Sim_TaskEvent;
+    AppSched_stopTask( &SimSche, 1 );
+    memset( simCount, 0, sizeof( simCount ) );
+    simSleeps = 0u;
+    simEvent = TRUE;
+    numLoops = 1;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 0u, simCount[ 0 ] );
+    TEST_ASSERT_EQUAL( 1u, simSleeps );
+
+    AppSched_startTask( &SimSche, 1 );
+    simSleeps = 0u;
+    numLoops = 1;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 1u, simCount[ 0 ] );
+    TEST_ASSERT_EQUAL( 0u, simSleeps );
+    TEST_ASSERT_EQUAL( TRUE, simEvent );
+}
+
+/** @brief  Number of timers in WheelSche */
+#define WHEEL_TIMERS    12u
+
+/** @brief  Scheduler with a tick of 1 ms to test the timer wheel */
+AppSched_Scheduler WheelSche;
+/** @brief  Task control block for WheelSche, without tasks */
+AppSched_Task wheelTasks[ 1 ];
+/** @brief  Timer control block for WheelSche */
+AppSched_Timer wheelTimers[ WHEEL_TIMERS ];
+/** @brief  wheel tick when each timer of WheelSche expired, zero if not */
+unsigned long wheelFired[ WHEEL_TIMERS ];
+/** @brief  number of callbacks run in WheelSche */
+unsigned long wheelCalls;
+
+/** @brief  timer callback of WheelSche, records the tick of the timers that just expired */
+void WheelCallback( void )
+{
+    wheelCalls++;
+
+    for( unsigned char i = 0; i < WheelSche.timersCount; i++ )
+    {
+        if( ( WheelSche.timerPtr[ i ].startFlag == FALSE ) && ( WheelSche.timerPtr[ i ].count == 0u ) && ( wheelFired[ i ] == 0u ) )
+        {
+            wheelFired[ i ] = WheelSche.wheelTick;
+        }
+    }
+}
+
+/** @brief  timer callback of WheelSche, stops the second and third timers */
+void WheelStopCallback( void )
+{
+    AppSched_stopTimer( &WheelSche, 2 );
+    AppSched_stopTimer( &WheelSche, 3 );
+    WheelCallback( );
+}
+
+/** @brief  Configure WheelSche without timers, polling the tick of the simulation */
+static void Wheel_Init( void )
+{
+    HAL_NVIC_SetPriority_Ignore( );
+    HAL_NVIC_EnableIRQ_Ignore( );
+    HAL_TIM_Base_Init_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IT_IgnoreAndReturn( HAL_OK );
+    HAL_TIM_Base_Start_IgnoreAndReturn( HAL_OK );
+    HAL_GetTick_StubWithCallback( Sim_GetTick );
+
+    memset( wheelFired, 0, sizeof( wheelFired ) );
+    wheelCalls = 0u;
+    simStep = 1u;
+    simTime = 0u;
+
+    WheelSche.tick     = 1;
+    WheelSche.tasks    = 1;
+    WheelSche.taskPtr  = wheelTasks;
+    WheelSche.timers   = WHEEL_TIMERS;
+    WheelSche.timerPtr = wheelTimers;
+    WheelSche.idleFunc = NULL;
+    AppSched_initScheduler( &WheelSche );
+}
+
+/**
+ * @brief   Run WheelSche until the wheel reaches a tick.
+ * 
+ * Each loop of the scheduler reads the tick once and processes one tick, the scheduler is started
+ * again because numLoops only counts up to 255 loops.
+ * 
+ * @param   ticks [in] wheel tick to reach.
+*/
+static void Wheel_RunTo( unsigned long ticks )
+{
+    while( WheelSche.wheelTick < ticks )
+    {
+        unsigned long left = ticks - WheelSche.wheelTick;
+
+        numLoops = ( left > 255u ) ? 255u : (uint8_t) left;
+        AppSched_startScheduler( &WheelSche );
+    }
+}
+
+/**
+ * @brief   test the timer wheel, the timers expire at its timeout in all the levels.
+ * 
+ * The timeouts are at the limits of each level of the wheel, and beyond the last one, each timer
+ * must expire just at the tick of its timeout.
+*/
+void test__AppSched_startScheduler__wheel_timers_expire_on_time( void )
+{
+    const unsigned long timeouts[ WHEEL_TIMERS ] = 
+    { 1u, 15u, 16u, 17u, 255u, 256u, 4095u, 4096u, 4097u, 65535u, 65536u, 100000u };
+
+    Wheel_Init( );
+
+    for( unsigned char i = 0; i < WHEEL_TIMERS; i++ )
+    {
+        TEST_ASSERT_EQUAL( i + 1u, AppSched_registerTimer( &WheelSche, timeouts[ i ], WheelCallback ) );
+        TEST_ASSERT_TRUE( AppSched_startTimer( &WheelSche, i + 1u ) );
+    }
+
+    Wheel_RunTo( 4000u );
+    TEST_ASSERT_EQUAL( 96u, AppSched_getTimer( &WheelSche, 8 ) );
+    TEST_ASSERT_EQUAL( 0u, AppSched_getTimer( &WheelSche, 5 ) );
+
+    Wheel_RunTo( 100001u );
+
+    for( unsigned char i = 0; i < WHEEL_TIMERS; i++ )
+    {
+        TEST_ASSERT_EQUAL( timeouts[ i ], wheelFired[ i ] );
+        TEST_ASSERT_FALSE( WheelSche.timerPtr[ i ].startFlag );
+    }
+}
+
+/**
+ * @brief   test the timer wheel, stop a timer in the middle of a slot.
+ * 
+ * Three timers expire at the same tick, the second one is stopped after 4 ticks, it keeps the time
+ * left as its count and it must not expire, the other two are not affected.
+*/
+void test__AppSched_stopTimer__wheel_stop_timer_in_slot( void )
+{
+    Wheel_Init( );
+
+    for( unsigned char i = 1; i <= 3u; i++ )
+    {
+        AppSched_registerTimer( &WheelSche, 10, WheelCallback );
+        AppSched_startTimer( &WheelSche, i );
+    }
+
+    Wheel_RunTo( 4u );
+    TEST_ASSERT_EQUAL( 6u, AppSched_getTimer( &WheelSche, 2 ) );
+    TEST_ASSERT_TRUE( AppSched_stopTimer( &WheelSche, 2 ) );
+    TEST_ASSERT_TRUE( AppSched_stopTimer( &WheelSche, 2 ) );     /*stop a stopped timer*/
+
+    Wheel_RunTo( 30u );
+
+    TEST_ASSERT_EQUAL( 10u, wheelFired[ 0 ] );
+    TEST_ASSERT_EQUAL( 0u, wheelFired[ 1 ] );
+    TEST_ASSERT_EQUAL( 10u, wheelFired[ 2 ] );
+    TEST_ASSERT_EQUAL( 2u, wheelCalls );
+    TEST_ASSERT_EQUAL( 6u, AppSched_getTimer( &WheelSche, 2 ) );
+}
+
+/**
+ * @brief   test the timer wheel, a callback stops a timer that expires in the same tick.
+ * 
+ * The second and third timers stop each other, the first one that expires stops the other, so
+ * only one of their callbacks runs whatever the order in the slot is.
+*/
+void test__AppSched_startScheduler__wheel_callback_stops_timer( void )
+{
+    Wheel_Init( );
+
+    AppSched_registerTimer( &WheelSche, 20, WheelCallback );
+    AppSched_registerTimer( &WheelSche, 20, WheelStopCallback );
+    AppSched_registerTimer( &WheelSche, 20, WheelStopCallback );
+    AppSched_startTimer( &WheelSche, 1 );
+    AppSched_startTimer( &WheelSche, 2 );
+    AppSched_startTimer( &WheelSche, 3 );
+
+    Wheel_RunTo( 40u );
+
+    TEST_ASSERT_EQUAL( 20u, wheelFired[ 0 ] );
+    TEST_ASSERT_EQUAL( 2u, wheelCalls );
+}
+
+/**
+ * @brief   test the timer wheel, restart and reload a started timer.
+ * 
+ * The timer is linked again with the new expiration, and it expires only once.
+*/
+void test__AppSched_reloadTimer__wheel_restart_started_timer( void )
+{
+    Wheel_Init( );
+
+    AppSched_registerTimer( &WheelSche, 20, WheelCallback );
+    AppSched_startTimer( &WheelSche, 1 );
+    Wheel_RunTo( 10u );
+    AppSched_startTimer( &WheelSche, 1 );
+    Wheel_RunTo( 25u );
+    TEST_ASSERT_EQUAL( 0u, wheelFired[ 0 ] );
+    TEST_ASSERT_TRUE( AppSched_reloadTimer( &WheelSche, 1, 300 ) );
+    TEST_ASSERT_EQUAL( 300u, AppSched_getTimer( &WheelSche, 1 ) );
+
+    Wheel_RunTo( 400u );
+
+    TEST_ASSERT_EQUAL( 325u, wheelFired[ 0 ] );
+    TEST_ASSERT_EQUAL( 1u, wheelCalls );
+}
+
+/**
+ * @brief   test AppSched_statsTask with not valid taskIDs.
+*/
+void test__AppSched_statsTask__not_valid_taskID( void )
+{
+    AppSched_Stats stats;
+
+    TEST_ASSERT_FALSE( AppSched_statsTask( &ScheWithTask, 0, &stats ) );
+    TEST_ASSERT_FALSE( AppSched_statsTask( &ScheWithTask, 5, &stats ) );
+    TEST_ASSERT_FALSE( AppSched_clearStatsTask( &ScheWithTask, 5 ) );
+}
+
+/**
+ * @brief   test AppSched_statsTask, a registered task that has not run has all the values in zero.
+*/
+void test__AppSched_statsTask__task_without_runs( void )
+{
+    AppSched_Stats stats;
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &ScheWithTask, 1, &stats ) );
+
+    TEST_ASSERT_EQUAL( 0u, stats.runs );
+    TEST_ASSERT_EQUAL( 0u, stats.overruns );
+    TEST_ASSERT_EQUAL( 0u, stats.minTime );
+    TEST_ASSERT_EQUAL( 0u, stats.maxTime );
+    TEST_ASSERT_EQUAL( 0u, stats.avgTime );
+}
+
+/**
+ * @brief   test Scheduler_Profile, the min, max and average execution time of three runs.
+*/
+void test__Scheduler_Profile__min_max_avg( void )
+{
+    AppSched_Stats stats;
+
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 0 ], 100, 0 );
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 0 ], 300, 0 );
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 0 ], 200, 0 );
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &ScheWithTask, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 3u, stats.runs );
+    TEST_ASSERT_EQUAL( 100u, stats.minTime );
+    TEST_ASSERT_EQUAL( 300u, stats.maxTime );
+    TEST_ASSERT_EQUAL( 200u, stats.avgTime );
+    TEST_ASSERT_EQUAL( 0u, stats.overruns );
+}
+
+/**
+ * @brief   test Scheduler_Profile, a response time longer than the period is an overrun.
+ * 
+ * The first task has a period of 200 ms, a response of 200000 us is still on time.
+*/
+void test__Scheduler_Profile__overrun( void )
+{
+    AppSched_Stats stats;
+
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 0 ], 50, 200000 );
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 0 ], 50, 200001 );
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &ScheWithTask, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 2u, stats.runs );
+    TEST_ASSERT_EQUAL( 1u, stats.overruns );
+}
+
+/**
+ * @brief   test AppSched_clearStatsTask, the statistics start again.
+*/
+void test__AppSched_clearStatsTask__clear_stats( void )
+{
+    AppSched_Stats stats;
+
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 1 ], 500, 900000 );
+    TEST_ASSERT_TRUE( AppSched_clearStatsTask( &ScheWithTask, 2 ) );
+    Scheduler_Profile( &ScheWithTask.taskPtr[ 1 ], 20, 0 );
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &ScheWithTask, 2, &stats ) );
+    TEST_ASSERT_EQUAL( 1u, stats.runs );
+    TEST_ASSERT_EQUAL( 0u, stats.overruns );
+    TEST_ASSERT_EQUAL( 0u, stats.skips );
+    TEST_ASSERT_EQUAL( 20u, stats.minTime );
+    TEST_ASSERT_EQUAL( 20u, stats.maxTime );
+}
+
+/**
+ * @brief   test AppSched_startScheduler, the runs of each task are counted, periodic and by event.
+ * 
+ * In the polling simulation the 10 ms task runs 25 times, and two more by its event, the 150 ms
+ * task runs once.
+*/
+void test__AppSched_startScheduler__simulation_stats_runs( void )
+{
+    AppSched_Stats stats;
+
+    simEvent = FALSE;
+    Sim_Run( NULL );
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 25u, stats.runs );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 3, &stats ) );
+    TEST_ASSERT_EQUAL( 1u, stats.runs );
+
+    TEST_ASSERT_TRUE( AppSched_eventTask( &SimSche, 1, &simEvent ) );
+    simEvent = TRUE;
+    numLoops = 1;
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 26u, stats.runs );
+    TEST_ASSERT_EQUAL( 0u, stats.overruns );
+}
+
+/** @brief  Number of tasks of main.c */
+#define MAIN_TASKS      6u
+
+/**
+ * @brief   Register in ScheWithTask the tasks of main.c with the same tick and periods.
+*/
+static void Main_Tasks( void )
+{
+    const unsigned long periods[ MAIN_TASKS ] = { 10u, 50u, 300u, 100u, 50u, 150u };
+
+    ScheWithTask.tasks = MAIN_TASKS;
+    ScheWithTask.tick = 5;
+    ScheWithTask.taskPtr = mainTasks;
+    AppSched_initScheduler( &ScheWithTask );
+
+    for( unsigned char i = 0; i < MAIN_TASKS; i++ )
+    {
+        TEST_ASSERT_EQUAL( i + 1u, AppSched_registerTask( &ScheWithTask, NULL, Task01, periods[ i ] ) );
+    }
+}
+
+/** @brief  Max value of a load profile */
+static unsigned char Load_Max( const unsigned char *load, unsigned long ticks )
+{
+    unsigned char max = 0;
+
+    for( unsigned long k = 0; k < ticks; k++ )
+    {
+        max = ( load[ k ] > max ) ? load[ k ] : max;
+    }
+
+    return max;
+}
+
+/**
+ * @brief   test AppSched_offsetTask with not valid arguments.
+ * 
+ * The first task of ScheWithTask has a period of 200 ms and the tick is 100 ms.
+*/
+void test__AppSched_offsetTask__not_valid_arguments( void )
+{
+    TEST_ASSERT_FALSE( AppSched_offsetTask( &ScheWithTask, 0, 100 ) );
+    TEST_ASSERT_FALSE( AppSched_offsetTask( &ScheWithTask, 5, 100 ) );
+    TEST_ASSERT_FALSE( AppSched_offsetTask( &ScheWithTask, 1, 0 ) );
+    TEST_ASSERT_FALSE( AppSched_offsetTask( &ScheWithTask, 1, 150 ) );
+    TEST_ASSERT_FALSE( AppSched_offsetTask( &ScheWithTask, 1, 300 ) );
+}
+
+/**
+ * @brief   test AppSched_offsetTask, the task runs for the first time at the tick of the offset.
+*/
+void test__AppSched_offsetTask__first_run_at_offset( void )
+{
+    unsigned char load[ 10 ];
+
+    TEST_ASSERT_TRUE( AppSched_offsetTask( &ScheWithTask, 1, 100 ) );
+    TEST_ASSERT_EQUAL( 100u, ScheWithTask.taskPtr[ 0 ].offset );
+    TEST_ASSERT_EQUAL( 100u, ScheWithTask.taskPtr[ 0 ].elapsed );
+
+    /*running tasks of 200, 500 and 1000 ms, the first one released in the ticks 1, 3, 5...*/
+    TEST_ASSERT_EQUAL( 10u, AppSched_loadProfile( &ScheWithTask, load, 10 ) );
+    TEST_ASSERT_EQUAL( 1u, load[ 0 ] );
+    TEST_ASSERT_EQUAL( 0u, load[ 1 ] );
+    TEST_ASSERT_EQUAL( 2u, load[ 4 ] );
+    TEST_ASSERT_EQUAL( 2u, load[ 9 ] );
+}
+
+/**
+ * @brief   test AppSched_loadProfile, the buffer is shorter than the hyperperiod.
+*/
+void test__AppSched_loadProfile__short_buffer( void )
+{
+    unsigned char load[ 10 ];
+
+    Main_Tasks( );
+
+    TEST_ASSERT_EQUAL( 0u, AppSched_loadProfile( &ScheWithTask, load, 10 ) );
+}
+
+/**
+ * @brief   test AppSched_loadProfile, without offsets all the tasks of main.c run together every 300 ms.
+*/
+void test__AppSched_loadProfile__main_tasks_without_offset( void )
+{
+    unsigned char load[ 60 ];
+
+    Main_Tasks( );
+
+    TEST_ASSERT_EQUAL( 60u, AppSched_loadProfile( &ScheWithTask, load, 60 ) );
+    TEST_ASSERT_EQUAL( MAIN_TASKS, load[ 59 ] );
+    TEST_ASSERT_EQUAL( MAIN_TASKS, Load_Max( load, 60 ) );
+}
+
+/**
+ * @brief   test AppSched_staggerTasks, the tasks of main.c never run in the same tick.
+ * 
+ * The watchdog task keeps its offset of 150 ms, the 48 releases of the 60 ticks of the hyperperiod
+ * fit in different ticks.
+*/
+void test__AppSched_staggerTasks__main_tasks( void )
+{
+    unsigned char load[ 60 ];
+    unsigned long releases = 0;
+
+    Main_Tasks( );
+    TEST_ASSERT_TRUE( AppSched_offsetTask( &ScheWithTask, 6, 150 ) );
+
+    TEST_ASSERT_TRUE( AppSched_staggerTasks( &ScheWithTask ) );
+
+    TEST_ASSERT_EQUAL( 0u, ScheWithTask.taskPtr[ 5 ].elapsed );
+    TEST_ASSERT_EQUAL( 60u, AppSched_loadProfile( &ScheWithTask, load, 60 ) );
+    TEST_ASSERT_EQUAL( 1u, Load_Max( load, 60 ) );
+
+    for( unsigned long k = 0; k < 60u; k++ )
+    {
+        releases += load[ k ];
+    }
+    TEST_ASSERT_EQUAL( 48u, releases );
+}
+
+/**
+ * @brief   test AppSched_staggerTasks, the hyperperiod is too long.
+ * 
+ * The periods of 7 and 241 ticks have a hyperperiod of 1687 ticks.
+*/
+void test__AppSched_staggerTasks__long_hyperperiod( void )
+{
+    ScheWithTask.tasks = 2;
+    ScheWithTask.tick = 1;
+    AppSched_initScheduler( &ScheWithTask );
+    AppSched_registerTask( &ScheWithTask, NULL, Task01, 7 );
+    AppSched_registerTask( &ScheWithTask, NULL, Task01, 241 );
+
+    TEST_ASSERT_FALSE( AppSched_staggerTasks( &ScheWithTask ) );
+}
+
+/**
+ * @brief   test AppSched_startScheduler, the staggered tasks keep its periods with its offsets.
+ * 
+ * After staggering the simulation, each task runs first at its offset and then with its period,
+ * and two tasks never run in the same ms.
+*/
+void test__AppSched_startScheduler__simulation_staggered_tasks( void )
+{
+    const unsigned long periods[ 3 ] = { 10u, 50u, 150u };
+    unsigned long offsets[ 3 ];
+
+    Sim_Init( NULL );
+    TEST_ASSERT_TRUE( AppSched_staggerTasks( &SimSche ) );
+
+    for( unsigned char i = 0; i < 3u; i++ )
+    {
+        offsets[ i ] = SimSche.taskPtr[ i ].period - SimSche.taskPtr[ i ].elapsed;
+    }
+
+    numLoops = 255;
+    AppSched_startScheduler( &SimSche );
+
+    for( unsigned char i = 0; i < 3u; i++ )
+    {
+        TEST_ASSERT_TRUE( simCount[ i ] > 0u );
+
+        for( unsigned long k = 0; ( k < simCount[ i ] ) && ( k < SIM_RUNS ); k++ )
+        {
+            TEST_ASSERT_EQUAL( 1000u + offsets[ i ] + ( k * periods[ i ] ), simRuns[ i ][ k ] );
+        }
+    }
+
+    for( unsigned long k = 0; k < simCount[ 1 ]; k++ )
+    {
+        TEST_ASSERT_TRUE( ( ( simRuns[ 1 ][ k ] - 1000u - offsets[ 0 ] ) % periods[ 0 ] ) != 0u );
+    }
+}
+
+/** @brief  Frame table for the tests of the cyclic executive */
+unsigned char frameTable[ 120 ];
+
+/**
+ * @brief   test AppSched_buildTable without buffer or with a buffer too short.
+*/
+void test__AppSched_buildTable__not_valid_buffer( void )
+{
+    Main_Tasks( );
+
+    TEST_ASSERT_FALSE( AppSched_buildTable( &ScheWithTask ) );
+
+    ScheWithTask.framePtr = frameTable;
+    ScheWithTask.frames = 107;
+    TEST_ASSERT_FALSE( AppSched_buildTable( &ScheWithTask ) );
+    TEST_ASSERT_EQUAL( 0u, ScheWithTask.framesCount );
+}
+
+/**
+ * @brief   test AppSched_buildTable, the frames of the tasks of main.c without offsets.
+ * 
+ * 60 frames plus 48 runs, the first frame is empty, the second one has the 10 ms task, and the
+ * last one has all the tasks in the order of its taskID.
+*/
+void test__AppSched_buildTable__main_tasks_frames( void )
+{
+    const unsigned char last[ 7 ] = { 1, 2, 3, 4, 5, 6, 0 };
+
+    Main_Tasks( );
+    ScheWithTask.framePtr = frameTable;
+    ScheWithTask.frames = sizeof( frameTable );
+
+    TEST_ASSERT_TRUE( AppSched_buildTable( &ScheWithTask ) );
+
+    TEST_ASSERT_EQUAL( 108u, ScheWithTask.framesCount );
+    TEST_ASSERT_EQUAL( 0u, frameTable[ 0 ] );
+    TEST_ASSERT_EQUAL( 1u, frameTable[ 1 ] );
+    TEST_ASSERT_EQUAL( 0u, frameTable[ 2 ] );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( last, &frameTable[ 101 ], 7 );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with a frame table polling the tick, host simulation.
+ * 
+ * The tasks and the timer run at the same times than without table.
+*/
+void test__AppSched_startScheduler__simulation_table_polling( void )
+{
+    const unsigned long periods[ 4 ] = { 10u, 50u, 150u, 40u };
+
+    Sim_Init( NULL );
+    SimSche.framePtr = frameTable;
+    SimSche.frames = sizeof( frameTable );
+    TEST_ASSERT_TRUE( AppSched_buildTable( &SimSche ) );
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 25u, simCount[ 0 ] );
+    TEST_ASSERT_EQUAL( 5u, simCount[ 1 ] );
+    TEST_ASSERT_EQUAL( 1u, simCount[ 2 ] );
+    Sim_CheckPeriods( periods );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with a frame table in tickless mode, host simulation.
+ * 
+ * The staggered tasks keep its periods, the scheduler sleeps to the next frame with tasks, and a
+ * stopped task is skipped.
+*/
+void test__AppSched_startScheduler__simulation_table_tickless( void )
+{
+    const unsigned long periods[ 3 ] = { 10u, 50u, 150u };
+    unsigned long offsets[ 3 ];
+
+    Sim_Init( Sim_Sleep );
+    AppSched_stopTimer( &SimSche, 1 );
+    TEST_ASSERT_TRUE( AppSched_staggerTasks( &SimSche ) );
+    SimSche.framePtr = frameTable;
+    SimSche.frames = sizeof( frameTable );
+    TEST_ASSERT_TRUE( AppSched_buildTable( &SimSche ) );
+    AppSched_stopTask( &SimSche, 2 );
+
+    for( unsigned char i = 0; i < 3u; i++ )
+    {
+        offsets[ i ] = SimSche.taskPtr[ i ].period - SimSche.taskPtr[ i ].elapsed;
+    }
+
+    numLoops = 200;
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_TRUE( simSleeps > 0u );
+    TEST_ASSERT_EQUAL( 0u, simCount[ 1 ] );
+    TEST_ASSERT_TRUE( simCount[ 2 ] > 0u );
+
+    for( unsigned char i = 0; i < 3u; i++ )
+    {
+        for( unsigned long k = 0; ( k < simCount[ i ] ) && ( k < SIM_RUNS ); k++ )
+        {
+            TEST_ASSERT_EQUAL( 1000u + offsets[ i ] + ( k * periods[ i ] ), simRuns[ i ][ k ] );
+        }
+    }
+}
+
+/**
+ * @brief   Run the polling simulation with an overrun of the 50 ms task at 1050 ms.
+ * 
+ * The task takes 17 ms, up to 1067 ms, the ticks of 1055, 1060 and 1065 ms are processed late.
+ * 
+ * @param   catchUp [in] Catch up policy of the scheduler.
+*/
+static void Sim_RunOverrun( unsigned char catchUp )
+{
+    Sim_Init( NULL );
+    SimSche.catchUp = catchUp;
+    simSlow = 17u;
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with SCHED_CATCHUP_BURST after an overrun.
+ * 
+ * Each late tick is processed in its own loop, the 10 ms task runs twice in a row to recover the
+ * activations of 1060 and 1070 ms, and then it goes back to its period.
+*/
+void test__AppSched_startScheduler__catchup_burst_runs_all( void )
+{
+    AppSched_Stats stats;
+
+    Sim_RunOverrun( SCHED_CATCHUP_BURST );
+
+    TEST_ASSERT_EQUAL( 1069u, simRuns[ 0 ][ 5 ] );
+    TEST_ASSERT_EQUAL( 1071u, simRuns[ 0 ][ 6 ] );
+    TEST_ASSERT_EQUAL( 1080u, simRuns[ 0 ][ 7 ] );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 0u, stats.skips );
+    TEST_ASSERT_EQUAL( 3u, SimSche.lateTicks );
+    TEST_ASSERT_EQUAL( 13u, SimSche.maxLate );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with SCHED_CATCHUP_ONCE after an overrun.
+ * 
+ * The late ticks are processed together, the 10 ms task runs once for the activation of 1060 ms and
+ * the next runs stay in the multiples of its period.
+*/
+void test__AppSched_startScheduler__catchup_once_keeps_period( void )
+{
+    AppSched_Stats stats;
+
+    Sim_RunOverrun( SCHED_CATCHUP_ONCE );
+
+    TEST_ASSERT_EQUAL( 1068u, simRuns[ 0 ][ 5 ] );
+    TEST_ASSERT_EQUAL( 1070u, simRuns[ 0 ][ 6 ] );
+    TEST_ASSERT_EQUAL( 1080u, simRuns[ 0 ][ 7 ] );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 0u, stats.skips );
+    TEST_ASSERT_EQUAL( 2u, SimSche.lateTicks );
+    TEST_ASSERT_EQUAL( 13u, SimSche.maxLate );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with SCHED_CATCHUP_SKIP after an overrun.
+ * 
+ * The activation of 1060 ms is not in the last tick processed, it's skipped and the task runs again
+ * at 1070 ms.
+*/
+void test__AppSched_startScheduler__catchup_skip_drops_activation( void )
+{
+    AppSched_Stats stats;
+
+    Sim_RunOverrun( SCHED_CATCHUP_SKIP );
+
+    TEST_ASSERT_EQUAL( 1050u, simRuns[ 0 ][ 4 ] );
+    TEST_ASSERT_EQUAL( 1070u, simRuns[ 0 ][ 5 ] );
+    TEST_ASSERT_EQUAL( 1080u, simRuns[ 0 ][ 6 ] );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 1u, stats.skips );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 2, &stats ) );
+    TEST_ASSERT_EQUAL( 0u, stats.skips );
+    TEST_ASSERT_EQUAL( 2u, SimSche.lateTicks );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with SCHED_CATCHUP_ONCE in tickless mode.
+ * 
+ * The ticks slept are processed in a single pass after waking up, they are not late and the tasks
+ * and the timer run at the same times than in bursts.
+*/
+void test__AppSched_startScheduler__catchup_once_tickless( void )
+{
+    const unsigned long periods[ 4 ] = { 10u, 50u, 150u, 40u };
+
+    Sim_Init( Sim_Sleep );
+    SimSche.catchUp = SCHED_CATCHUP_ONCE;
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_TRUE( simCount[ 2 ] > 0u );
+    Sim_CheckPeriods( periods );
+    TEST_ASSERT_EQUAL( 0u, SimSche.lateTicks );
+    TEST_ASSERT_EQUAL( 0u, SimSche.maxLate );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with a frame table and the policies to skip or run once.
+ * 
+ * After the overrun the frames of 1055, 1060 and 1065 ms are processed together, the 10 ms task
+ * listed in the frame of 1060 ms runs once or it's skipped.
+*/
+void test__AppSched_startScheduler__catchup_table_frames( void )
+{
+    AppSched_Stats stats;
+
+    Sim_Init( NULL );
+    SimSche.framePtr = frameTable;
+    SimSche.frames = sizeof( frameTable );
+    TEST_ASSERT_TRUE( AppSched_buildTable( &SimSche ) );
+    SimSche.catchUp = SCHED_CATCHUP_SKIP;
+    simSlow = 17u;
+    numLoops = 255;
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 1070u, simRuns[ 0 ][ 5 ] );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 1u, stats.skips );
+
+    Sim_Init( NULL );
+    SimSche.framePtr = frameTable;
+    SimSche.frames = sizeof( frameTable );
+    TEST_ASSERT_TRUE( AppSched_buildTable( &SimSche ) );
+    SimSche.catchUp = SCHED_CATCHUP_ONCE;
+    simSlow = 17u;
+    numLoops = 255;
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 1068u, simRuns[ 0 ][ 5 ] );
+    TEST_ASSERT_EQUAL( 1070u, simRuns[ 0 ][ 6 ] );
+    TEST_ASSERT_TRUE( AppSched_statsTask( &SimSche, 1, &stats ) );
+    TEST_ASSERT_EQUAL( 0u, stats.skips );
+}
+
+/**
+ * @brief   test AppSched_waitTask and AppSched_untilTask, out of a task they do nothing.
+*/
+void test__AppSched_waitTask__out_of_task( void )
+{
+    Sim_Init( NULL );
+
+    TEST_ASSERT_FALSE( AppSched_waitTask( &SimSche, 10 ) );
+    TEST_ASSERT_FALSE( AppSched_untilTask( &SimSche, &simEvent ) );
+    TEST_ASSERT_EQUAL( 0u, SimSche.taskPtr[ 0 ].wait );
+    TEST_ASSERT_NULL( SimSche.taskPtr[ 0 ].until );
+}
+
+/**
+ * @brief   test AppSched_waitTask, the wait is rounded up to ticks, one more from an event run.
+*/
+void test__AppSched_waitTask__ticks( void )
+{
+    Sim_Init( NULL );
+    SimSche.running = 2;
+
+    TEST_ASSERT_TRUE( AppSched_waitTask( &SimSche, 10 ) );
+    TEST_ASSERT_EQUAL( 2u, SimSche.taskPtr[ 1 ].wait );
+    TEST_ASSERT_TRUE( AppSched_waitTask( &SimSche, 11 ) );
+    TEST_ASSERT_EQUAL( 3u, SimSche.taskPtr[ 1 ].wait );
+    TEST_ASSERT_TRUE( AppSched_waitTask( &SimSche, 0 ) );
+    TEST_ASSERT_EQUAL( 1u, SimSche.taskPtr[ 1 ].wait );
+
+    SimSche.runEvent = TRUE;
+    TEST_ASSERT_TRUE( AppSched_waitTask( &SimSche, 10 ) );
+    TEST_ASSERT_EQUAL( 3u, SimSche.taskPtr[ 1 ].wait );
+    TEST_ASSERT_FALSE( AppSched_untilTask( &SimSche, NULL ) );
+    TEST_ASSERT_TRUE( AppSched_untilTask( &SimSche, &simEvent ) );
+    TEST_ASSERT_EQUAL_PTR( &simEvent, SimSche.taskPtr[ 1 ].until );
+}
+
+/**
+ * @brief   test the bitmap flagged and the count held, only the tasks with a flag are in the bitmap
+ * and a wait renewed before it ends is counted once.
+*/
+void test__AppSched_waitTask__flagged_and_held( void )
+{
+    Sim_Init( NULL );
+    SimSche.running = 2;
+
+    TEST_ASSERT_EQUAL( 0u, SimSche.flagged );
+    AppSched_waitTask( &SimSche, 10 );
+    AppSched_waitTask( &SimSche, 20 );
+    TEST_ASSERT_EQUAL( 1u, SimSche.held );
+
+    AppSched_untilTask( &SimSche, &simEvent );
+    TEST_ASSERT_EQUAL( 0x02u, SimSche.flagged );
+    AppSched_eventTask( &SimSche, 3, &simEvent );
+    TEST_ASSERT_EQUAL( 0x06u, SimSche.flagged );
+    AppSched_eventTask( &SimSche, 3, NULL );
+    TEST_ASSERT_EQUAL( 0x02u, SimSche.flagged );
+}
+
+/** @brief  resume point of Sim_Coroutine */
+AppSched_Coroutine simCo;
+
+/**
+ * @brief   resumable task of the simulation in place of the 50 ms task.
+ * 
+ * It waits 23 ms, then until the 10 ms task has run ten times, and records each step.
+*/
+void Sim_Coroutine( void )
+{
+    SCHED_CO_BEGIN( &simCo );
+
+    Sim_Record( 1 );
+    SCHED_CO_WAIT_MS( &SimSche, &simCo, 23u );
+    Sim_Record( 1 );
+    SCHED_CO_WAIT_UNTIL( &SimSche, &simCo, simCount[ 0 ] >= 10u, &simEvent );
+    Sim_Record( 1 );
+
+    SCHED_CO_END( &simCo );
+}
+
+/**
+ * @brief   test AppSched_startScheduler with a resumable task, host simulation polling the tick.
+ * 
+ * The coroutine starts at 1050 ms, its wait of 23 ms ends in the tick of 1075 ms, then the 10 ms task
+ * sets the flag on each run and the coroutine checks its condition until the run of 1100 ms. The
+ * period is not released while it's held, and it restarts from 1100 ms, so the next start is at
+ * 1150 ms. The other tasks keep their periods.
+*/
+void test__AppSched_startScheduler__coroutine_waits( void )
+{
+    Sim_Init( NULL );
+    AppSched_stopTimer( &SimSche, 1 );
+    SimSche.taskPtr[ 0 ].taskFunc = Sim_TaskEvent;
+    SimSche.taskPtr[ 1 ].taskFunc = Sim_Coroutine;
+    memset( &simCo, 0, sizeof( simCo ) );
+    simEvent = FALSE;
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 1050u, simRuns[ 1 ][ 0 ] );
+    TEST_ASSERT_EQUAL( 1075u, simRuns[ 1 ][ 1 ] );
+    TEST_ASSERT_EQUAL( 1100u, simRuns[ 1 ][ 2 ] );
+    TEST_ASSERT_EQUAL( 1150u, simRuns[ 1 ][ 3 ] );
+    TEST_ASSERT_EQUAL( 0u, SimSche.running );
+
+    for( unsigned long k = 0; ( k < simCount[ 0 ] ) && ( k < SIM_RUNS ); k++ )
+    {
+        TEST_ASSERT_EQUAL( 1000u + ( ( k + 1u ) * 10u ), simRuns[ 0 ][ k ] );
+    }
+}
+
+/**
+ * @brief   test AppSched_startScheduler with a resumable task and a frame table, polling the tick.
+ * 
+ * The wait of the coroutine ends at 1075 ms, but it's not listed in that frame, it runs again in its
+ * next frame at 1100 ms.
+*/
+void test__AppSched_startScheduler__coroutine_table_frames( void )
+{
+    Sim_Init( NULL );
+    AppSched_stopTimer( &SimSche, 1 );
+    SimSche.taskPtr[ 1 ].taskFunc = Sim_Coroutine;
+    SimSche.framePtr = frameTable;
+    SimSche.frames = sizeof( frameTable );
+    TEST_ASSERT_TRUE( AppSched_buildTable( &SimSche ) );
+    memset( &simCo, 0, sizeof( simCo ) );
+    numLoops = 255;
+
+    AppSched_startScheduler( &SimSche );
+
+    TEST_ASSERT_EQUAL( 1050u, simRuns[ 1 ][ 0 ] );
+    TEST_ASSERT_EQUAL( 1100u, simRuns[ 1 ][ 1 ] );
+}
+
+/**
+ * @brief   test AppSched_cpuLoad, there is no load before the first window ends.
+*/
+void test__AppSched_cpuLoad__before_first_window( void )
+{
+    unsigned short peak = 1u;
+
+    Scheduler_CpuLoad( &ScheWithTask, 9, 500000 );
+
+    TEST_ASSERT_EQUAL( 0u, AppSched_cpuLoad( &ScheWithTask, &peak ) );
+    TEST_ASSERT_EQUAL( 0u, peak );
+}
+
+/**
+ * @brief   test Scheduler_CpuLoad, each window of one second gives its own load and keeps the peak.
+ * 
+ * With a tick of 100 ms the window has 10 ticks, 250 ms busy is 25 % and 12.34 ms busy is 1.23 %.
+*/
+void test__Scheduler_CpuLoad__windows_and_peak( void )
+{
+    unsigned short peak;
+
+    for ( unsigned char i = 0; i < 10u; i++ )
+    {
+        Scheduler_CpuLoad( &ScheWithTask, 1, 25000 );
+    }
+
+    TEST_ASSERT_EQUAL( 2500u, AppSched_cpuLoad( &ScheWithTask, NULL ) );
+
+    Scheduler_CpuLoad( &ScheWithTask, 4, 12340 );
+    Scheduler_CpuLoad( &ScheWithTask, 6, 0 );
+
+    TEST_ASSERT_EQUAL( 123u, AppSched_cpuLoad( &ScheWithTask, &peak ) );
+    TEST_ASSERT_EQUAL( 2500u, peak );
+}
+
+/**
+ * @brief   test Scheduler_CpuLoad, a pass longer than the window is limited to 100 %.
+*/
+void test__Scheduler_CpuLoad__full_load( void )
+{
+    unsigned short peak;
+
+    Scheduler_CpuLoad( &ScheWithTask, 12, 1500000 );
+
+    TEST_ASSERT_EQUAL( SCHED_LOAD_FULL, AppSched_cpuLoad( &ScheWithTask, &peak ) );
+    TEST_ASSERT_EQUAL( SCHED_LOAD_FULL, peak );
+}
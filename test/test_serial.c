@@ -7,10 +7,12 @@
 #include "unity.h"
 #include "serial.h"
 #include "bsp.h"
+#include "pool.h"
 #include <stdint.h>
 
 #include "mock_queue.h"
 #include "mock_stm32g0xx_hal_fdcan.h"
+#include "mock_scheduler.h"
 
 #define BYTES_CAN_MESSAGE       0x08u   /*!< Number of bytes in a standard CAN message */
 #define SINGLE_FRAME_7_PAYLOAD  0x07u   /*!< Byte 0 of a CAN-TP single frame message  */
@@ -50,18 +52,67 @@
 /**
  * @brief   reference to the ClockQueue.
 */
-AppQue_Queue ClockQueue;
+AppQue_PrioQueue ClockQueue;
 
 /**
- * @brief   variable to test SerialTask with a valid time message
+ * @brief   reference to the Scheduler.
 */
-uint8_t dataTime[BYTES_CAN_MESSAGE] = {VALID_BCD_HOUR, VALID_BCD_MIN, VALID_BCD_SEC, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+AppSched_Scheduler Scheduler;
+
+/**
+ * @brief   reference to the timer ID that sends the CPU load.
+*/
+uint8_t LoadTimerID;
+
+/**
+ * @brief   reference to the timer ID of the ISO-TP transfers received.
+*/
+uint8_t TpRxTimerID;
+
+/**
+ * @brief   reference to the timer ID of the ISO-TP transfers sent.
+*/
+uint8_t TpTxTimerID;
+
+/**
+ * @brief   reference to the ISO-TP channel of the transfers received.
+*/
+extern APP_TpTypeDef TpRx;
+
+/**
+ * @brief   reference to the ISO-TP channel of the transfers sent.
+*/
+extern APP_TpTypeDef TpTx;
+
+/** @brief  last message written in a queue by the stubs HIL_QUEUE_writeDataISR and HIL_QUEUE_writeBatchISR */
+static APP_CanTypeDef writtenMsg;
+
+/** @brief  ID of the last message sent by the stub HAL_FDCAN_AddMessageToTxFifoQ */
+static uint32_t sentId;
+
+/** @brief  bytes of the last message sent by the stub HAL_FDCAN_AddMessageToTxFifoQ */
+static uint8_t sentData[ BYTES_CAN_MESSAGE ];
+
+/**
+ * @brief   variable to test SerialTask with a valid time message, as it is left in the block by the interrupt
+*/
+uint8_t dataTime[BYTES_CAN_MESSAGE] = {SERIAL_MSG_TIME, VALID_BCD_HOUR, VALID_BCD_MIN, VALID_BCD_SEC, 0xFF, 0xFF, 0xFF, 0xFF};
 
 /**
  * @brief   function that is executed before any unit test function.
+ * 
+ * Serial_InitTask is called to free all the blocks of the messages pool.
 */
 void setUp( void )
 {
+    HAL_FDCAN_Init_IgnoreAndReturn( HAL_OK );
+    HAL_FDCAN_ConfigGlobalFilter_IgnoreAndReturn( HAL_OK );
+    HAL_FDCAN_ConfigFilter_IgnoreAndReturn( HAL_OK );
+    HAL_FDCAN_Start_IgnoreAndReturn( HAL_OK );
+    HAL_FDCAN_ActivateNotification_IgnoreAndReturn( HAL_OK );
+    AppQueue_initQueue_IgnoreAndReturn( TRUE );
+
+    Serial_InitTask( );
 }
 
 /**
@@ -80,7 +131,7 @@ void Serial_SingleFrameTx( uint8_t*, uint8_t );
  * @brief   Reference for private function  Serial_SingleFrameRx
  * @retval  Return TRUE if its a can-tp single frame format, FALSE if it isn't.
 */
-uint8_t Serial_SingleFrameRx( uint8_t*, uint8_t* );
+uint8_t Serial_SingleFrameRx( const uint8_t*, uint8_t* );
 
 /**
  * @brief   Reference for private function  Evaluate_Time_Parameters
@@ -112,6 +163,12 @@ APP_Messages Send_Ok_Message( APP_CanTypeDef* );
 */
 APP_Messages Send_Error_Message( APP_CanTypeDef* );
 
+/**
+ * @brief   Reference for private fucntion  Send_Load_Message
+ * @retval  Return the event type that was writed in the queue (None).
+*/
+APP_Messages Send_Load_Message( APP_CanTypeDef* );
+
 /**
  * @brief   Reference for private fucntion Validate_Date
  * @retval  Returns TRUE when its a valid date and FALSE when it is not.
@@ -136,6 +193,16 @@ uint8_t Validate_Time ( uint8_t, uint8_t, uint8_t );
 */
 uint8_t WeekDay( uint8_t, uint8_t, uint16_t );
 
+/**
+ * @brief   Reference for private function Serial_TpReceive.
+*/
+void Serial_TpReceive( const uint8_t* );
+
+/**
+ * @brief   Reference for private function Serial_TpSend.
+*/
+void Serial_TpSend( const uint8_t*, uint16_t );
+
 
 /**
  * @brief   Test for Serial_InitTask
@@ -150,7 +217,7 @@ void test__Serial_InitTask__init_FDCAN_module( void )
     HAL_FDCAN_ConfigFilter_IgnoreAndReturn( HAL_OK );
     HAL_FDCAN_Start_IgnoreAndReturn( HAL_OK );
     HAL_FDCAN_ActivateNotification_IgnoreAndReturn( HAL_OK );
-    AppQueue_initQueue_Ignore( );
+    AppQueue_initQueue_IgnoreAndReturn( TRUE );
 
     Serial_InitTask( );
 }
@@ -159,24 +226,25 @@ void test__Serial_InitTask__init_FDCAN_module( void )
  * @brief   Test for serial periodic task, mock read queue with time msg.
  * 
  * In this function it is necessary check if the msg have a valid event index, to do that mock 
- * functions HIL_QUEUE_isQueueEmptyISR and HIL_QUEUE_writeDataISR to simulate a queue with a 
- * time message.
+ * functions HIL_QUEUE_readBatchISR and HIL_QUEUE_writeDataISR to simulate a queue with a 
+ * time message, and then an empty ResponseQueue.
 */
 void test__Serial_PeriodicTask__queue_with_time_msg( void )
 {
     APP_CanTypeDef SerialMsg;
-    dataTime[MSG] = SERIAL_MSG_TIME;
+    APP_CanTypeDef *SerialMsgPtr = &SerialMsg;
+    SerialMsg.id = ID_TIME_MSG;
+    SerialMsg.event = SERIAL_MSG_TIME;
     memcpy( SerialMsg.bytes, &dataTime, BYTES_CAN_MESSAGE );
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &SerialMsg, sizeof( APP_CanTypeDef ) );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 1u );
+    HIL_QUEUE_readBatchISR_ReturnMemThruPtr_data( &SerialMsgPtr, sizeof( APP_CanTypeDef * ) );
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HAL_FDCAN_GetTxFifoFreeLevel_ExpectAnyArgsAndReturn( 3u );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
 
     Serial_PeriodicTask( );
 }
@@ -185,21 +253,22 @@ void test__Serial_PeriodicTask__queue_with_time_msg( void )
  * @brief   Test for serial periodic task, mock read queue with none msg.
  * 
  * In this function it is necessary check if the msg have a valid event index, to do that mock 
- * functions HIL_QUEUE_isQueueEmptyISR  to simulate a queue with a message with a event index
- * of 6 (SERIAL_MSG_NONE).
+ * functions HIL_QUEUE_readBatchISR to simulate a queue with a message with a event index
+ * of SERIAL_MSG_NONE.
 */
 void test__Serial_PeriodicTask__queue_with_none_msg( void )
 {
     APP_CanTypeDef SerialMsg;
-    dataTime[MSG] = SERIAL_MSG_NONE;
+    APP_CanTypeDef *SerialMsgPtr = &SerialMsg;
+    SerialMsg.id = ID_TIME_MSG;
+    SerialMsg.event = SERIAL_MSG_NONE;
     memcpy( SerialMsg.bytes, &dataTime, BYTES_CAN_MESSAGE );
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( FALSE );
-
-    HIL_QUEUE_readDataISR_ExpectAnyArgsAndReturn( TRUE );
-    HIL_QUEUE_readDataISR_ReturnMemThruPtr_data( &SerialMsg, sizeof( APP_CanTypeDef ) );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 1u );
+    HIL_QUEUE_readBatchISR_ReturnMemThruPtr_data( &SerialMsgPtr, sizeof( APP_CanTypeDef * ) );
 
-    HIL_QUEUE_isQueueEmptyISR_IgnoreAndReturn( TRUE );
+    HAL_FDCAN_GetTxFifoFreeLevel_ExpectAnyArgsAndReturn( 3u );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
 
     Serial_PeriodicTask( );
 }
@@ -347,11 +416,11 @@ void test__Evaluate_Time_Parameters__valid_time_OK_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = VALID_BCD_HOUR;
-    msgRead.bytes[ PARAMETER_2 ] = VALID_BCD_MIN;
-    msgRead.bytes[ PARAMETER_3 ] = VALID_BCD_SEC;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_SEC;
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
     eventRet = Evaluate_Time_Parameters( &msgRead );
@@ -359,6 +428,28 @@ void test__Evaluate_Time_Parameters__valid_time_OK_MSG( void )
     TEST_ASSERT_EQUAL( eventRet, SERIAL_MSG_OK );
 }
 
+/**
+ * @brief   test Evaluate_Time_Parameters with a valid time and the ClockQueue full.
+ * 
+ * The time can not be applied, then the ERROR event shall be answered instead of OK.
+*/
+void test__Evaluate_Time_Parameters__clock_queue_full_ERROR_MSG( void )
+{
+    APP_Messages eventRet;
+    APP_CanTypeDef msgRead;
+
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_SEC;
+
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( FALSE );
+    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+
+    eventRet = Evaluate_Time_Parameters( &msgRead );
+
+    TEST_ASSERT_EQUAL( SERIAL_MSG_ERROR, eventRet );
+}
+
 /**
  * @brief   test Evaluate_Time_Parameters transition to ERROR event.
  * 
@@ -372,9 +463,9 @@ void test__Evaluate_Time_Parameters__no_valid_hour_ERROR_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = NO_VALID_BCD_HOUR;
-    msgRead.bytes[ PARAMETER_2 ] = VALID_BCD_MIN;
-    msgRead.bytes[ PARAMETER_3 ] = VALID_BCD_SEC;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = NO_VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_SEC;
 
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
@@ -396,12 +487,12 @@ void test__Evaluate_Date_Parameters__valid_date_OK_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = VALID_BCD_DAY;
-    msgRead.bytes[ PARAMETER_2 ] = VALID_BCD_MONTH;
-    msgRead.bytes[ PARAMETER_3 ] = VALID_BCD_YEAR_MS;
-    msgRead.bytes[ PARAMETER_4 ] = VALID_BCD_YEAR_LS;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_DAY;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MONTH;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_YEAR_MS;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_4 ] = VALID_BCD_YEAR_LS;
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
     eventRet = Evaluate_Date_Parameters( &msgRead );
@@ -422,12 +513,12 @@ void test__Evaluate_Date_Parameters__valid_date_leap_year_OK_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = VALID_BCD_DAY_LEAP;
-    msgRead.bytes[ PARAMETER_2 ] = VALID_BCD_MONTH_LEAP;
-    msgRead.bytes[ PARAMETER_3 ] = VALID_BCD_YEAR_MS_LEAP;
-    msgRead.bytes[ PARAMETER_4 ] = VALID_BCD_YEAR_LS_LEAP;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_DAY_LEAP;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MONTH_LEAP;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_YEAR_MS_LEAP;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_4 ] = VALID_BCD_YEAR_LS_LEAP;
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
     eventRet = Evaluate_Date_Parameters( &msgRead );
@@ -448,10 +539,10 @@ void test__Evaluate_Date_Parameters__no_valid_date_ERROR_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = NO_VALID_BCD_DAY;
-    msgRead.bytes[ PARAMETER_2 ] = NO_VALID_BCD_MONTH;
-    msgRead.bytes[ PARAMETER_3 ] = NO_VALID_BCD_YEAR_MS;
-    msgRead.bytes[ PARAMETER_4 ] = VALID_BCD_YEAR_LS;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = NO_VALID_BCD_DAY;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = NO_VALID_BCD_MONTH;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = NO_VALID_BCD_YEAR_MS;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_4 ] = VALID_BCD_YEAR_LS;
 
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
@@ -473,10 +564,10 @@ void test__Evaluate_Alarm_Parameters__valid_Alarm_OK_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = VALID_BCD_HOUR;
-    msgRead.bytes[ PARAMETER_2 ] = VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MIN;
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
     eventRet = Evaluate_Alarm_Parameters( &msgRead );
@@ -497,8 +588,8 @@ void test__Evaluate_Alarm_Parameters__no_valid_Alarm_ERROR_MSG( void )
     APP_Messages eventRet;
     APP_CanTypeDef msgRead;
 
-    msgRead.bytes[ PARAMETER_1 ] = NO_VALID_BCD_HOUR;
-    msgRead.bytes[ PARAMETER_2 ] = NO_VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = NO_VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = NO_VALID_BCD_MIN;
 
     HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
 
@@ -558,12 +649,15 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_time( void
     uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     FDCAN_RxHeaderTypeDef RxHeader;
     RxHeader.Identifier = ID_TIME_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_TIME;
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
     HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
     HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+    HIL_QUEUE_writeBatchISR_ExpectAnyArgsAndReturn( 1u );
 
     HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
 }
@@ -581,12 +675,15 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_date( void
     uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     FDCAN_RxHeaderTypeDef RxHeader;
     RxHeader.Identifier = ID_DATE_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_DATE;
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
     HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
     HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+    HIL_QUEUE_writeBatchISR_ExpectAnyArgsAndReturn( 1u );
 
     HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
 }
@@ -604,12 +701,15 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_alarm( voi
     uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     FDCAN_RxHeaderTypeDef RxHeader;
     RxHeader.Identifier = ID_ALARM_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_ALARM;
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
     HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
     HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+    HIL_QUEUE_writeBatchISR_ExpectAnyArgsAndReturn( 1u );
 
     HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
 }
@@ -617,8 +717,9 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_alarm( voi
 /**
  * @brief   test HAL_FDCAN_RxFifo0Callback with a msg with an ID unknown.
  * 
- * The aim of this test is cover the default branch in the switch statement for this use the
- * mock function from HAL library to indicate the unknown ID of the received message
+ * The aim of this test is cover a frame not accepted by any of the filters, for this use the
+ * mock function from HAL library to indicate a filter index out of range, the frame is discarded
+ * and nothing is written in the queue.
 */
 void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_id_unknown( void )
 {
@@ -626,12 +727,14 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_single_frame_CAN_TP_msg_id_unknown
     uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     FDCAN_RxHeaderTypeDef RxHeader;
     RxHeader.Identifier = UNKNOW_ID;
+    RxHeader.FilterIndex = FILTERS_N;
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
     HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
     HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
 
-    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( TRUE );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
 
     HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
 }
@@ -647,14 +750,142 @@ void test__HAL_FDCAN_RxFifo0Callback__receive_first_frame_CAN_TP_msg( void )
 {
     /*0xFF is a don't care value*/
     uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {FIRST_FRAME_CAN_TP, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_TIME_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_TIME;
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
     HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
     HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
-    HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
+    HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
 
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
     HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
 }
 
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback, the block of a message not written is freed.
+ * 
+ * More first frame messages than blocks in the pool are received, since none of them is written
+ * in the queue each block is freed, and there is always a block to read the next message.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__discarded_msgs_free_the_block( void )
+{
+    /*0xFF is a don't care value*/
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {FIRST_FRAME_CAN_TP, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_TIME_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_TIME;
+
+    for( uint8_t i = 0u; i <= MESSAGES_N; i++ )
+    {
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+        HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+        HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
+        HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+        HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+    }
+}
+
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback, the block is freed when the queue is full.
+ * 
+ * The write in the queue fails for more messages than blocks in the pool, each block is freed
+ * and there is always a block to read the next message, every message is counted as dropped.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__queue_full_frees_the_block( void )
+{
+    /*0xFF is a don't care value*/
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_TIME_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_TIME;
+
+    for( uint8_t i = 0u; i <= MESSAGES_N; i++ )
+    {
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+        HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+        HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
+        HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+        HIL_QUEUE_writeBatchISR_ExpectAnyArgsAndReturn( 0u );
+
+        HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+    }
+
+    TEST_ASSERT_EQUAL( MESSAGES_N + 1u, SerialStats.RxDropped );
+}
+
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback, with all the blocks in use the message is dropped.
+ * 
+ * MESSAGES_N messages are written in the queue and none is processed, so the next message has
+ * no block, it's read out of the FIFO0 and counted as dropped, nothing is written in the queue.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__pool_empty_msg_dropped( void )
+{
+    /*0xFF is a don't care value*/
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_TIME_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_TIME;
+
+    for( uint8_t i = 0u; i < MESSAGES_N; i++ )
+    {
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+        HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+        HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
+        HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+        HIL_QUEUE_writeBatchISR_ExpectAnyArgsAndReturn( 1u );
+
+        HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+    }
+
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+    HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+
+    HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+
+    TEST_ASSERT_EQUAL( 1u, SerialStats.RxDropped );
+}
+
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback, a burst of frames is drained in one call.
+ * 
+ * The FIFO0 is full with a time, a date and an alarm message, the three are read in the same
+ * interrupt and written in the queue with a single batch write, then the loop stops at the size
+ * of the FIFO without read the fill level again.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__full_fifo_drained_in_one_batch( void )
+{
+    /*0xFF is a don't care value*/
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {SINGLE_FRAME_7_PAYLOAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader[ SERIAL_RX_FIFO_N ];
+    RxHeader[ 0 ].Identifier = ID_TIME_MSG;
+    RxHeader[ 1 ].Identifier = ID_DATE_MSG;
+    RxHeader[ 2 ].Identifier = ID_ALARM_MSG;
+    RxHeader[ 0 ].FilterIndex = SERIAL_FILTER_TIME;
+    RxHeader[ 1 ].FilterIndex = SERIAL_FILTER_DATE;
+    RxHeader[ 2 ].FilterIndex = SERIAL_FILTER_ALARM;
+
+    for( uint8_t i = 0u; i < SERIAL_RX_FIFO_N; i++ )
+    {
+        HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( SERIAL_RX_FIFO_N - i );
+        HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+        HAL_FDCAN_GetRxMessage_ReturnThruPtr_pRxData( msg_CanTP );
+        HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader[ i ], sizeof(FDCAN_RxHeaderTypeDef) );
+    }
+
+    HIL_QUEUE_writeBatchISR_ExpectAndReturn( NULL, NULL, SERIAL_RX_FIFO_N, SERIAL_RX_FIFO_N );
+    HIL_QUEUE_writeBatchISR_IgnoreArg_queue( );
+    HIL_QUEUE_writeBatchISR_IgnoreArg_data( );
+
+    HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_FULL );
+}
+
 /**
  * @brief test Validate_Date with day parameter not valid.
  * 
@@ -1104,4 +1335,498 @@ void test__WeekDay__date_02_04_2029_return_1_monday( void )
     varRet = WeekDay( days, month, year );
 
     TEST_ASSERT_EQUAL( MONDAY, varRet );
-}
\ No newline at end of file
+}
+
+/**
+ * @brief   stub of HIL_QUEUE_writeDataISR that keeps a copy of the message written.
+ * @retval  Always TRUE.
+*/
+static unsigned char Stub_WriteData( AppQue_Queue *queue, const void *data, int cmock_num_calls )
+{
+    (void) queue;
+    (void) cmock_num_calls;
+    writtenMsg = *(const APP_CanTypeDef *) data;
+
+    return TRUE;
+}
+
+/**
+ * @brief   stub of HIL_QUEUE_writeBatchISR that keeps a copy of the first block written.
+ * @retval  The number of blocks, all of them are written.
+*/
+static unsigned long Stub_WriteBatch( AppQue_Queue *queue, const void *data, unsigned long count, int cmock_num_calls )
+{
+    (void) queue;
+    (void) cmock_num_calls;
+    writtenMsg = **(APP_CanTypeDef *const *) data;
+
+    return count;
+}
+
+/**
+ * @brief   stub of HAL_FDCAN_AddMessageToTxFifoQ that keeps the ID and bytes of the message sent.
+ * @retval  Always HAL_OK.
+*/
+static HAL_StatusTypeDef Stub_AddMessage( FDCAN_HandleTypeDef *hfdcan, FDCAN_TxHeaderTypeDef *pTxHeader, uint8_t *pTxData, int cmock_num_calls )
+{
+    (void) hfdcan;
+    (void) cmock_num_calls;
+    sentId = pTxHeader->Identifier;
+
+    for( uint8_t i = 0; i < BYTES_CAN_MESSAGE; i++ )
+    {
+        sentData[ i ] = pTxData[ i ];
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   test SerialLoad_Callback.
+ * 
+ * The load 12.34 % and the peak 56.78 % read from the scheduler are written in the ResponseQueue as
+ * a SERIAL_MSG_LOAD event, most significant byte first, and the timer is restarted.
+*/
+void test__SerialLoad_Callback__write_load_event( void )
+{
+    unsigned short peak = 5678u;
+
+    AppSched_cpuLoad_ExpectAndReturn( &Scheduler, NULL, 1234u );
+    AppSched_cpuLoad_IgnoreArg_peak( );
+    AppSched_cpuLoad_ReturnThruPtr_peak( &peak );
+    HIL_QUEUE_writeDataISR_StubWithCallback( Stub_WriteData );
+    AppSched_startTimer_ExpectAndReturn( &Scheduler, LoadTimerID, TRUE );
+
+    SerialLoad_Callback( );
+
+    TEST_ASSERT_EQUAL_HEX8( 0x04u, writtenMsg.bytes[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0xD2u, writtenMsg.bytes[ 1 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x16u, writtenMsg.bytes[ 2 ] );
+    TEST_ASSERT_EQUAL_HEX8( 0x2Eu, writtenMsg.bytes[ 3 ] );
+    TEST_ASSERT_EQUAL( SERIAL_MSG_LOAD, writtenMsg.bytes[ 4 ] );
+}
+
+/**
+ * @brief   test Send_Load_Message.
+ * 
+ * The four bytes of the load and peak are sent in a CAN-TP single frame with the LOAD_ID.
+*/
+void test__Send_Load_Message( void )
+{
+    APP_Messages eventRet;
+    APP_CanTypeDef msgRead = { 0, { 0x04u, 0xD2u, 0x16u, 0x2Eu, SERIAL_MSG_LOAD, 0, 0, 0 }, 0 };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x04u, 0x04u, 0xD2u, 0x16u, 0x2Eu, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+
+    eventRet = Send_Load_Message( &msgRead );
+
+    TEST_ASSERT_EQUAL( eventRet, SERIAL_MSG_NONE );
+    TEST_ASSERT_EQUAL_HEX32( LOAD_ID, sentId );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback with a frame of the CONFIG ID.
+ * 
+ * The frame is not a single frame, but it's written in the queue as it is with the CONFIG event,
+ * the serial task reassembles the ISO-TP transfer.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__config_frame_written_as_it_is( void )
+{
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x09u, 0x00u, 0x23u, 0x58u, 0x00u, 0x01u, 0x31u };
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_CONFIG_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_CONFIG;
+
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+    HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+    HAL_FDCAN_GetRxMessage_ReturnArrayThruPtr_pRxData( msg_CanTP, BYTES_CAN_MESSAGE );
+    HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
+
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+    HIL_QUEUE_writeBatchISR_StubWithCallback( Stub_WriteBatch );
+
+    HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+
+    TEST_ASSERT_EQUAL( SERIAL_MSG_CONFIG, writtenMsg.event );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( msg_CanTP, writtenMsg.bytes, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   Test for serial periodic task, mock read queue with a frame of the CONFIG ID.
+ * 
+ * The message has the SERIAL_MSG_CONFIG event, so the frame goes to the ISO-TP reassembly, a single
+ * frame with a wrong item that is answered at once with an ERROR response.
+*/
+void test__Serial_PeriodicTask__queue_with_config_frame( void )
+{
+    uint8_t single[ BYTES_CAN_MESSAGE ] = { 0x04u, SERIAL_MSG_ALARM, NO_VALID_BCD_HOUR, 0x00u, 0u, 0u, 0u, 0u };
+    APP_CanTypeDef SerialMsg;
+    APP_CanTypeDef *SerialMsgPtr = &SerialMsg;
+    SerialMsg.id = ID_CONFIG_MSG;
+    SerialMsg.event = SERIAL_MSG_CONFIG;
+    memcpy( SerialMsg.bytes, single, BYTES_CAN_MESSAGE );
+    sentId = 0u;
+
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 1u );
+    HIL_QUEUE_readBatchISR_ReturnMemThruPtr_data( &SerialMsgPtr, sizeof( APP_CanTypeDef * ) );
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+
+    HAL_FDCAN_GetTxFifoFreeLevel_ExpectAnyArgsAndReturn( 3u );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
+
+    Serial_PeriodicTask( );
+
+    TEST_ASSERT_EQUAL_HEX32( RESPONSE_ID, sentId );
+    TEST_ASSERT_EQUAL( ERROR_RESPONSE, sentData[ 1 ] );
+}
+
+/**
+ * @brief   test HAL_FDCAN_RxFifo0Callback, the frame is parsed in the block where it was read.
+ * 
+ * A date message is received, the block written in the queue has the DATE event in place of the
+ * CAN-TP header, the parameters where they were received and the payload size.
+*/
+void test__HAL_FDCAN_RxFifo0Callback__single_frame_parsed_in_place( void )
+{
+    uint8_t msg_CanTP[ BYTES_CAN_MESSAGE ] = {0x04u, VALID_BCD_DAY, VALID_BCD_MONTH, VALID_BCD_YEAR_MS, VALID_BCD_YEAR_LS, 0xFF, 0xFF, 0xFF};
+    FDCAN_RxHeaderTypeDef RxHeader;
+    RxHeader.Identifier = ID_DATE_MSG;
+    RxHeader.FilterIndex = SERIAL_FILTER_DATE;
+
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 1u );
+    HAL_FDCAN_GetRxMessage_ExpectAnyArgsAndReturn( HAL_OK );
+    HAL_FDCAN_GetRxMessage_ReturnArrayThruPtr_pRxData( msg_CanTP, BYTES_CAN_MESSAGE );
+    HAL_FDCAN_GetRxMessage_ReturnMemThruPtr_pRxHeader( &RxHeader, sizeof(FDCAN_RxHeaderTypeDef) );
+    HAL_FDCAN_GetRxFifoFillLevel_ExpectAnyArgsAndReturn( 0u );
+
+    HIL_QUEUE_writeBatchISR_StubWithCallback( Stub_WriteBatch );
+
+    HAL_FDCAN_RxFifo0Callback( &CANHandler, FDCAN_IT_RX_FIFO0_NEW_MESSAGE );
+
+    TEST_ASSERT_EQUAL( ID_DATE_MSG, writtenMsg.id );
+    TEST_ASSERT_EQUAL( 4u, writtenMsg.lenght );
+    TEST_ASSERT_EQUAL( SERIAL_MSG_DATE, writtenMsg.event );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( &msg_CanTP[ SERIAL_RX_PAYLOAD ], &writtenMsg.bytes[ SERIAL_RX_PAYLOAD ], 4u );
+}
+
+/**
+ * @brief   test Serial_TpReceive with a first frame.
+ * 
+ * The reassembly starts, a flow control CTS with the block size and STmin is sent on the RESPONSE ID
+ * and the RX timer is started.
+*/
+void test__Serial_TpReceive__first_frame_sends_flow_control( void )
+{
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x09u, 0x00u, 0x23u, 0x58u, 0x00u, 0x01u, 0x31u };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x30u, SERIAL_TP_BLOCK_SIZE, SERIAL_TP_STMIN_MS, 0, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_startTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+
+    Serial_TpReceive( first );
+
+    TEST_ASSERT_EQUAL( TP_RECEIVING, TpRx.state );
+    TEST_ASSERT_EQUAL( 9u, TpRx.length );
+    TEST_ASSERT_EQUAL_HEX32( RESPONSE_ID, sentId );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test Serial_TpReceive with a first frame longer than the buffer.
+ * 
+ * The transfer doesn't fit in SERIAL_TP_SIZE, a flow control OVERFLOW is sent and nothing starts.
+*/
+void test__Serial_TpReceive__first_frame_too_long_overflow( void )
+{
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, SERIAL_TP_SIZE + 1u, 0, 0, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+
+    Serial_TpReceive( first );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpRx.state );
+    TEST_ASSERT_EQUAL_HEX8( 0x32u, sentData[ 0 ] );
+}
+
+/**
+ * @brief   test Serial_TpReceive with a whole transfer, a time and a date.
+ * 
+ * The consecutive frame completes the transfer, the timer is stopped, both settings are written in
+ * the ClockQueue and the response OK, OK, OK is sent in a single frame.
+*/
+void test__Serial_TpReceive__transfer_applied_and_answered( void )
+{
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x09u, SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_DATE, 0x31u };
+    uint8_t consecutive[ BYTES_CAN_MESSAGE ] = { 0x21u, 0x12u, 0x20u, 0x23u, 0, 0, 0, 0 };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x03u, OK_RESPONSE, OK_RESPONSE, OK_RESPONSE, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_startTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+    AppSched_stopTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+    HIL_QUEUE_freePrioISR_ExpectAnyArgsAndReturn( 2u );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
+
+    Serial_TpReceive( first );
+    Serial_TpReceive( consecutive );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpRx.state );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test Serial_TpReceive with valid items and no space for all of them in the ClockQueue.
+ * 
+ * Nothing is written in the ClockQueue and the response is ERROR for the transfer and each item.
+*/
+void test__Serial_TpReceive__lane_without_space_nothing_applied( void )
+{
+    uint8_t single[ BYTES_CAN_MESSAGE ] = { 0x07u, SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_ALARM, 0x07u, 0x30u };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x03u, ERROR_RESPONSE, ERROR_RESPONSE, ERROR_RESPONSE, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    HIL_QUEUE_freePrioISR_ExpectAnyArgsAndReturn( 1u );
+
+    Serial_TpReceive( single );
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test Serial_TpReceive with a single frame and a wrong item.
+ * 
+ * The time is valid but the alarm is not, nothing is written in the ClockQueue and the response
+ * is ERROR followed by the status of each item.
+*/
+void test__Serial_TpReceive__wrong_item_nothing_applied( void )
+{
+    uint8_t single[ BYTES_CAN_MESSAGE ] = { 0x07u, SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_ALARM, NO_VALID_BCD_HOUR, 0x00u };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x03u, ERROR_RESPONSE, OK_RESPONSE, ERROR_RESPONSE, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+
+    Serial_TpReceive( single );
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test Serial_TpReceive with a consecutive frame out of sequence.
+ * 
+ * The transfer is aborted, the timer is stopped and an ERROR response is sent.
+*/
+void test__Serial_TpReceive__wrong_sequence_aborts( void )
+{
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x09u, SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_DATE, 0x31u };
+    uint8_t consecutive[ BYTES_CAN_MESSAGE ] = { 0x22u, 0x12u, 0x20u, 0x23u, 0, 0, 0, 0 };
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x01u, ERROR_RESPONSE, 0, 0, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_startTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+    AppSched_stopTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+
+    Serial_TpReceive( first );
+    Serial_TpReceive( consecutive );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpRx.state );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test SerialTpRx_Callback while a transfer is received.
+ * 
+ * The next consecutive frame is late, the transfer is discarded and an ERROR response is sent.
+*/
+void test__SerialTpRx_Callback__timeout_aborts( void )
+{
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x09u, SERIAL_MSG_TIME, 0x23u, 0x58u, 0x00u, SERIAL_MSG_DATE, 0x31u };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_startTimer_ExpectAndReturn( &Scheduler, TpRxTimerID, TRUE );
+
+    Serial_TpReceive( first );
+    SerialTpRx_Callback( );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpRx.state );
+    TEST_ASSERT_EQUAL_HEX8( 0x01u, sentData[ 0 ] );
+    TEST_ASSERT_EQUAL_HEX8( ERROR_RESPONSE, sentData[ 1 ] );
+}
+
+/**
+ * @brief   test Serial_TpSend with a payload longer than a single frame.
+ * 
+ * The first frame is sent and the channel waits for the flow control, with a CTS without block
+ * size the last consecutive frame is sent at once and the channel is idle.
+*/
+void test__Serial_TpSend__first_frame_then_consecutive( void )
+{
+    uint8_t payload[ 10 ] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    uint8_t control[ BYTES_CAN_MESSAGE ] = { 0x30u, 0x00u, 0x00u, 0, 0, 0, 0, 0 };
+    uint8_t first[ BYTES_CAN_MESSAGE ] = { 0x10u, 0x0Au, 1, 2, 3, 4, 5, 6 };
+    uint8_t consecutive[ BYTES_CAN_MESSAGE ] = { 0x21u, 7, 8, 9, 10, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS, TRUE );
+
+    Serial_TpSend( payload, sizeof( payload ) );
+
+    TEST_ASSERT_EQUAL( TP_WAIT_FC, TpTx.state );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( first, sentData, BYTES_CAN_MESSAGE );
+
+    AppSched_stopTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, TRUE );
+
+    Serial_TpReceive( control );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpTx.state );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( consecutive, sentData, BYTES_CAN_MESSAGE );
+}
+
+/**
+ * @brief   test Serial_TpSend paced by the STmin of the flow control.
+ * 
+ * An STmin of 7 ms is rounded up to two ticks of 5 ms, the second consecutive frame is sent when
+ * the TX timer expires.
+*/
+void test__Serial_TpSend__consecutive_frames_paced_by_stmin( void )
+{
+    uint8_t payload[ 20 ] = { 0 };
+    uint8_t control[ BYTES_CAN_MESSAGE ] = { 0x30u, 0x00u, 0x07u, 0, 0, 0, 0, 0 };
+
+    Scheduler.tick = 5u;
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS, TRUE );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, 10u, TRUE );
+
+    Serial_TpSend( payload, sizeof( payload ) );
+    Serial_TpReceive( control );
+
+    TEST_ASSERT_EQUAL( TP_SENDING, TpTx.state );
+    TEST_ASSERT_EQUAL_HEX8( 0x21u, sentData[ 0 ] );
+
+    AppSched_stopTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, TRUE );
+
+    SerialTpTx_Callback( );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpTx.state );
+    TEST_ASSERT_EQUAL_HEX8( 0x22u, sentData[ 0 ] );
+}
+
+/**
+ * @brief   test Serial_TpReceive with the flow controls of a block size of one.
+ * 
+ * After the first block the channel waits for the next flow control, a WAIT reloads the timeout
+ * and an OVERFLOW aborts the transfer.
+*/
+void test__Serial_TpReceive__flow_control_wait_and_overflow( void )
+{
+    uint8_t payload[ 20 ] = { 0 };
+    uint8_t cts[ BYTES_CAN_MESSAGE ] = { 0x30u, 0x01u, 0x00u, 0, 0, 0, 0, 0 };
+    uint8_t wait[ BYTES_CAN_MESSAGE ] = { 0x31u, 0, 0, 0, 0, 0, 0, 0 };
+    uint8_t overflow[ BYTES_CAN_MESSAGE ] = { 0x32u, 0, 0, 0, 0, 0, 0, 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS, TRUE );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS, TRUE );
+    AppSched_reloadTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, SERIAL_TP_TIMEOUT_MS, TRUE );
+    AppSched_stopTimer_ExpectAndReturn( &Scheduler, TpTxTimerID, TRUE );
+
+    Serial_TpSend( payload, sizeof( payload ) );
+    Serial_TpReceive( cts );
+
+    TEST_ASSERT_EQUAL( TP_WAIT_FC, TpTx.state );
+
+    Serial_TpReceive( wait );
+
+    TEST_ASSERT_EQUAL( TP_WAIT_FC, TpTx.state );
+
+    Serial_TpReceive( overflow );
+
+    TEST_ASSERT_EQUAL( TP_IDLE, TpTx.state );
+}
+
+/**
+ * @brief   test Serial_PeriodicTask, the frames dropped are answered with a BUSY response.
+ * 
+ * Three frames were dropped by the interrupt and one response by the ResponseQueue, a BUSY response
+ * with the count of four is sent before the responses, and they are marked as reported.
+*/
+void test__Serial_PeriodicTask__dropped_frames_answered_busy( void )
+{
+    uint8_t expected[ BYTES_CAN_MESSAGE ] = { 0x02u, BUSY_RESPONSE, 4u, 0, 0, 0, 0, 0 };
+
+    SerialStats.RxDropped = 3u;
+    SerialStats.RespDropped = 1u;
+
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
+    HAL_FDCAN_GetTxFifoFreeLevel_ExpectAnyArgsAndReturn( 3u );
+    HAL_FDCAN_AddMessageToTxFifoQ_StubWithCallback( Stub_AddMessage );
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
+
+    Serial_PeriodicTask( );
+
+    TEST_ASSERT_EQUAL_HEX32( RESPONSE_ID, sentId );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, sentData, BYTES_CAN_MESSAGE );
+    TEST_ASSERT_EQUAL( 4u, SerialStats.Reported );
+    TEST_ASSERT_EQUAL( 1u, SerialStats.BusySent );
+}
+
+/**
+ * @brief   test Serial_PeriodicTask, with the TX FIFO full the responses wait in the ResponseQueue.
+ * 
+ * No response is read from the ResponseQueue, it's not empty so the retry is counted, and the BUSY
+ * response of a frame dropped waits too, it's still pending to report.
+*/
+void test__Serial_PeriodicTask__tx_fifo_full_responses_wait( void )
+{
+    SerialStats.RxDropped = 1u;
+
+    HIL_QUEUE_readBatchISR_ExpectAnyArgsAndReturn( 0u );
+    HAL_FDCAN_GetTxFifoFreeLevel_ExpectAnyArgsAndReturn( 0u );
+    HIL_QUEUE_readBatchISR_ExpectAndReturn( NULL, NULL, 0u, 0u );
+    HIL_QUEUE_readBatchISR_IgnoreArg_queue( );
+    HIL_QUEUE_readBatchISR_IgnoreArg_data( );
+    HIL_QUEUE_isQueueEmptyISR_ExpectAnyArgsAndReturn( FALSE );
+
+    Serial_PeriodicTask( );
+
+    TEST_ASSERT_EQUAL( 1u, SerialStats.TxRetries );
+    TEST_ASSERT_EQUAL( 0u, SerialStats.Reported );
+}
+
+/**
+ * @brief   test Send_Ok_Message with the TX FIFO full.
+ * 
+ * The frame is dropped and counted instead of going to safe_state.
+*/
+void test__Send_Ok_Message__tx_fifo_full_counted( void )
+{
+    APP_CanTypeDef msgRead = { 0 };
+
+    HAL_FDCAN_AddMessageToTxFifoQ_ExpectAnyArgsAndReturn( HAL_ERROR );
+
+    (void) Send_Ok_Message( &msgRead );
+
+    TEST_ASSERT_EQUAL( 1u, SerialStats.TxDropped );
+}
+
+/**
+ * @brief   test Evaluate_Time_Parameters with the ResponseQueue full.
+ * 
+ * The time is applied and the response is dropped and counted, to be reported in a BUSY response.
+*/
+void test__Evaluate_Time_Parameters__response_queue_full_counted( void )
+{
+    APP_CanTypeDef msgRead = { 0 };
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_1 ] = VALID_BCD_HOUR;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_2 ] = VALID_BCD_MIN;
+    msgRead.bytes[ SERIAL_RX_PAYLOAD + PARAMETER_3 ] = VALID_BCD_SEC;
+
+    HIL_QUEUE_writePrioISR_ExpectAnyArgsAndReturn( TRUE );
+    HIL_QUEUE_writeDataISR_ExpectAnyArgsAndReturn( FALSE );
+
+    (void) Evaluate_Time_Parameters( &msgRead );
+
+    TEST_ASSERT_EQUAL( 1u, SerialStats.RespDropped );
+}
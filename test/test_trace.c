@@ -0,0 +1,101 @@
+/**
+ * @file    test_trace.c
+ *
+ * @brief   Unit test cases for the functions from trace file.
+*/
+#include "unity.h"
+#include "trace.h"
+#include "bsp.h"
+#include <string.h>
+#include "mock_stm32g0xx_hal.h"
+
+/**
+ * @brief   function that is executed before any unit test function.
+*/
+void setUp( void )
+{
+    memset( &TraceRing, 0, sizeof( TraceRing ) );
+}
+
+/**
+ * @brief   function that is executed after any unit test function.
+*/
+void tearDown( void )
+{
+}
+
+/**
+ * @brief   test AppTrace_init, the ring is marked, empty and enabled.
+*/
+void test__AppTrace_init__ring_marked_and_enabled( void )
+{
+    TraceRing.Head = 7u;
+    TraceRing.Records[ 3 ].Event = TRACE_TASK_START;
+
+    AppTrace_init( );
+
+    TEST_ASSERT_EQUAL_HEX32( TRACE_MAGIC, TraceRing.Magic );
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Head );
+    TEST_ASSERT_EQUAL( TRUE, TraceRing.Enabled );
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Records[ 3 ].Event );
+}
+
+/**
+ * @brief   test AppTrace_record, the event is written in the head with the tick.
+*/
+void test__AppTrace_record__event_written_in_head( void )
+{
+    AppTrace_init( );
+
+    HAL_GetTick_ExpectAndReturn( 0x12345u );
+    AppTrace_record( TRACE_QUEUE_WRITE, 2u, 0xBEEFu );
+
+    TEST_ASSERT_EQUAL( 1u, TraceRing.Head );
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Records[ 0 ].Stamp );
+    TEST_ASSERT_EQUAL_HEX16( 0x2345u, TraceRing.Records[ 0 ].Tick );
+    TEST_ASSERT_EQUAL( TRACE_QUEUE_WRITE, TraceRing.Records[ 0 ].Event );
+    TEST_ASSERT_EQUAL( 2u, TraceRing.Records[ 0 ].Id );
+    TEST_ASSERT_EQUAL_HEX16( 0xBEEFu, TraceRing.Records[ 0 ].Arg );
+}
+
+/**
+ * @brief   test AppTrace_record, a full ring overwrites the oldest event.
+*/
+void test__AppTrace_record__full_ring_overwrites_oldest( void )
+{
+    AppTrace_init( );
+    HAL_GetTick_IgnoreAndReturn( 1u );
+
+    for( uint32_t i = 0u; i <= TRACE_RECORDS; i++ )
+    {
+        AppTrace_record( TRACE_TASK_START, (uint8_t) i, 0u );
+    }
+
+    TEST_ASSERT_EQUAL( TRACE_RECORDS + 1u, TraceRing.Head );
+    TEST_ASSERT_EQUAL( (uint8_t) TRACE_RECORDS, TraceRing.Records[ 0 ].Id );
+    TEST_ASSERT_EQUAL( 1u, TraceRing.Records[ 1 ].Id );
+}
+
+/**
+ * @brief   test AppTrace_record, nothing is recorded while the recording is stopped.
+*/
+void test__AppTrace_record__stopped_nothing_recorded( void )
+{
+    AppTrace_init( );
+    AppTrace_enable( FALSE );
+
+    AppTrace_record( TRACE_ISR_ENTER, TRACE_ISR_FDCAN, 0u );
+
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Head );
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Records[ 0 ].Event );
+}
+
+/**
+ * @brief   test AppTrace_record, nothing is recorded before the ring is initialized.
+*/
+void test__AppTrace_record__not_initialized_nothing_recorded( void )
+{
+    AppTrace_record( TRACE_TIMER_START, 1u, 0u );
+
+    TEST_ASSERT_EQUAL( 0u, TraceRing.Head );
+}
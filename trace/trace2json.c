@@ -0,0 +1,202 @@
+/**
+ * @file    trace2json.c
+ *
+ * @brief   Host tool to convert a dump of the trace ring to Chrome trace JSON.
+ *
+ * The input is the AppTrace_Ring variable as it is in the RAM of the board, taken with gdb while
+ * the target is halted, "dump binary value trace.bin TraceRing", or written by the host simulation.
+ * The output opens in Perfetto (ui.perfetto.dev) or in chrome://tracing, with a track for the
+ * tasks, one for the timer callbacks, one for the interrupts and one for the queue writes and reads.
+ *
+ * The records are read from the oldest to the newest one. Each record has the 16 bits count of
+ * TIM7 in us, which wraps every 65.536 ms, and the lower 16 bits of the ms tick, so the time
+ * between two records is the difference of the us counts plus the number of wraps that brings it
+ * closest to the difference of the ticks. An interrupt that wakes up the CPU from a sleep of the
+ * scheduler has the tick of before the sleep and can be placed early, the next records are not
+ * affected since each one is computed against the previous.
+ *
+ * usage: trace2json <dump file> <json file> [task names]
+ *
+ * the task names are given in the order of its taskID, by default they are named task 1, task 2...
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+#define TRACE_WRAP_US       65536.0     /*!< us between two wraps of the TIM7 count */
+#define TRACE_US_PER_MS     1000.0      /*!< us in one ms */
+#define TRACE_TID_TASKS     1u          /*!< Track of the tasks */
+#define TRACE_TID_TIMERS    2u          /*!< Track of the timer callbacks */
+#define TRACE_TID_ISRS      3u          /*!< Track of the interrupts */
+#define TRACE_TID_QUEUES    4u          /*!< Track of the queue writes and reads */
+
+static double Trace_Delta( const AppTrace_Record *prev, const AppTrace_Record *record );
+
+static void Trace_Event( FILE *json, const AppTrace_Record *record, double ts, int names, char *task[] );
+
+static void Trace_Track( FILE *json, unsigned tid, const char *name );
+
+/**
+ * @brief   Entry point of the converter.
+ *
+ * @param   argc [in] Number of arguments.
+ * @param   argv [in] Arguments, the dump file, the JSON file and the names of the tasks.
+ *
+ * @retval  Zero when the dump was converted.
+*/
+int main( int argc, char *argv[] )
+{
+    static AppTrace_Ring ring;
+    FILE *dump;
+    FILE *json;
+    int varRet = 1;
+
+    if( argc < 3 )
+    {
+        (void) fprintf( stderr, "usage: trace2json <dump file> <json file> [task names]\n" );
+    }
+    else if( ( dump = fopen( argv[ 1 ], "rb" ) ) == NULL )
+    {
+        (void) fprintf( stderr, "trace2json: can not open %s\n", argv[ 1 ] );
+    }
+    else
+    {
+        size_t read = fread( &ring, sizeof( ring ), 1u, dump );
+        (void) fclose( dump );
+
+        if( ( read != 1u ) || ( ring.Magic != TRACE_MAGIC ) )
+        {
+            (void) fprintf( stderr, "trace2json: %s is not a dump of the trace ring\n", argv[ 1 ] );
+        }
+        else if( ( json = fopen( argv[ 2 ], "w" ) ) == NULL )
+        {
+            (void) fprintf( stderr, "trace2json: can not create %s\n", argv[ 2 ] );
+        }
+        else
+        {
+            /*before the first wrap the oldest record is the first one of the array*/
+            uint32_t count = ( ring.Head < TRACE_RECORDS ) ? ring.Head : TRACE_RECORDS;
+            uint32_t first = ring.Head - count;
+            const AppTrace_Record *prev = NULL;
+            double ts = 0.0;
+
+            (void) fprintf( json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+            (void) fprintf( json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CasioCAN\"}}" );
+            Trace_Track( json, TRACE_TID_TASKS, "tasks" );
+            Trace_Track( json, TRACE_TID_TIMERS, "timers" );
+            Trace_Track( json, TRACE_TID_ISRS, "interrupts" );
+            Trace_Track( json, TRACE_TID_QUEUES, "queues" );
+
+            for( uint32_t i = first; i != ring.Head; i++ )
+            {
+                const AppTrace_Record *record = &ring.Records[ i & TRACE_MASK ];
+
+                /*the first record starts at its tick, the clock has no better reference*/
+                ts = ( prev == NULL ) ? ( record->Tick * TRACE_US_PER_MS ) : ( ts + Trace_Delta( prev, record ) );
+                Trace_Event( json, record, ts, argc - 3, &argv[ 3 ] );
+                prev = record;
+            }
+
+            (void) fprintf( json, "\n]}\n" );
+            (void) fclose( json );
+            (void) printf( "%u of %u events converted to %s\n", (unsigned) count, (unsigned) ring.Head, argv[ 2 ] );
+            varRet = 0;
+        }
+    }
+
+    return varRet;
+}
+
+/**
+ * @brief   Time between two records.
+ *
+ * @param   prev [in] Previous record.
+ * @param   record [in] Current record.
+ *
+ * @retval  Time in us, the difference of the us counts plus the wraps closest to the ms ticks.
+*/
+static double Trace_Delta( const AppTrace_Record *prev, const AppTrace_Record *record )
+{
+    double us = (double) (uint16_t) ( record->Stamp - prev->Stamp );
+    double ms = (double) (uint16_t) ( record->Tick - prev->Tick );
+    double wraps = ( ( ms * TRACE_US_PER_MS ) - us ) / TRACE_WRAP_US;
+
+    wraps = ( wraps > 0.0 ) ? (double) (long) ( wraps + 0.5 ) : 0.0;
+
+    return us + ( wraps * TRACE_WRAP_US );
+}
+
+/**
+ * @brief   Write a record as a trace event.
+ *
+ * @param   json [in] Output file.
+ * @param   record [in] Record to write.
+ * @param   ts [in] Time of the record in us.
+ * @param   names [in] Number of task names.
+ * @param   task [in] Names of the tasks, in the order of its taskID.
+*/
+static void Trace_Event( FILE *json, const AppTrace_Record *record, double ts, int names, char *task[] )
+{
+    static const char *const isrs[ ] = { "irq", "FDCAN", "RTC", "EXTI" };
+    const char *phase = ( ( record->Event & 1u ) == 1u ) ? "B" : "E";   /*the starts are the odd codes*/
+    char name[ 32 ];
+
+    switch( record->Event )
+    {
+        case TRACE_TASK_START:
+        case TRACE_TASK_END:
+            if( ( record->Id > 0u ) && ( (int) record->Id <= names ) )
+            {
+                (void) snprintf( name, sizeof( name ), "%s", task[ record->Id - 1u ] );
+            }
+            else
+            {
+                (void) snprintf( name, sizeof( name ), "task %u", (unsigned) record->Id );
+            }
+            (void) fprintf( json, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", name, phase,
+                TRACE_TID_TASKS, ts );
+            if( record->Event == TRACE_TASK_START )
+            {
+                (void) fprintf( json, ",\"args\":{\"event\":%s}", ( record->Arg != 0u ) ? "true" : "false" );
+            }
+            (void) fprintf( json, "}" );
+            break;
+
+        case TRACE_TIMER_START:
+        case TRACE_TIMER_END:
+            (void) fprintf( json, ",\n{\"name\":\"timer %u\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", (unsigned) record->Id,
+                phase, TRACE_TID_TIMERS, ts );
+            break;
+
+        case TRACE_ISR_ENTER:
+        case TRACE_ISR_EXIT:
+            (void) fprintf( json, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                ( record->Id <= TRACE_ISR_EXTI ) ? isrs[ record->Id ] : isrs[ 0 ], phase, TRACE_TID_ISRS, ts );
+            break;
+
+        case TRACE_QUEUE_WRITE:
+        case TRACE_QUEUE_READ:
+            (void) fprintf( json, ",\n{\"name\":\"%s 0x%04x\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                "\"args\":{\"elements\":%u}}", ( record->Event == TRACE_QUEUE_WRITE ) ? "write" : "read",
+                (unsigned) record->Arg, TRACE_TID_QUEUES, ts, (unsigned) record->Id );
+            break;
+
+        default:
+            /*unknown event, the dump is newer than the converter*/
+            break;
+    }
+}
+
+/**
+ * @brief   Write the name of a track.
+ *
+ * @param   json [in] Output file.
+ * @param   tid [in] Track.
+ * @param   name [in] Name of the track.
+*/
+static void Trace_Track( FILE *json, unsigned tid, const char *name )
+{
+    (void) fprintf( json, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", tid, name );
+    (void) fprintf( json, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", tid, tid );
+}